@@ -161,8 +161,11 @@ bool DRM_msgs(char *msg, int rx_chan)
             d->s2p = ((d->test == 1)? d->info->s2p_start1 : d->info->s2p_start2);
             d->tsamp = 0;
             
-            // misuse ext_register_receive_iq_samps() to pushback audio samples from the test file
-            ext_register_receive_iq_samps(drm_pushback_file_data, rx_chan);
+            // pushback audio samples from the test file in place of the channel's IQ samples
+            if (!ext_register_pushback_iq_samps(drm_pushback_file_data, rx_chan)) {
+                printf("DRM test=%d rx_chan=%d refused, another extension is using the IQ samples\n", test, rx_chan);
+                d->test = 0;
+            }
         } else {
             ext_unregister_receive_iq_samps(rx_chan);
         }
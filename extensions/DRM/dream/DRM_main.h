@@ -84,6 +84,14 @@ static const char *drm_argv[] = {
                 last_time = now; \
             } \
         }
+#elif defined(DRM_BENCH)
+    // tools/drm_bench: accumulate only, totals are reported at the end of the run
+    #define MEASURE_TIME(id, acc, func) \
+        { \
+            u4_t start = timer_us(); \
+            func; \
+            DRM_SHMEM->drm[(int) FROM_VOID_PARAM(TaskGetUserParam())].MeasureTime[acc] += timer_us() - start; \
+        }
 #else
     #define MEASURE_TIME(id, acc, func) func;
 #endif
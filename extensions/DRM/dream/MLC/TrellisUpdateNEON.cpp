@@ -0,0 +1,91 @@
+/******************************************************************************\
+ *
+ * Description:
+ *
+	NEON fixed-point implementation of trellis update
+
+	Same algorithm and results as TrellisUpdateSSE2.cpp (saturating 8-bit
+	path metrics, decision bytes all ones for the high bit = 1 path and
+	normalization when the first output metric is greater than 150) so the
+	decoded bits do not depend on the architecture.
+
+	- vcleq_u8() gives the decisions directly, a tie goes to the high
+	  bit = 1 path as in the c++ BUTTERFLY()
+	- vst2q_u8() interleaves the two sets of 16 states (2j, 2j + 1) on the
+	  store, so no zip is needed
+	- Only ARMv7 instructions are used (pairwise minimum for the
+	  normalization instead of vminvq_u8)
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "ViterbiDecoder.h"
+
+
+/* Implementation *************************************************************/
+#ifdef USE_NEON
+#include <arm_neon.h>
+
+void CViterbiDecoder::TrellisUpdateNEON(const _DECISIONTYPE* pCurDec,
+                                        const _VITMETRTYPE* pCurTrelMetric, const _VITMETRTYPE* pOldTrelMetric,
+                                        const _VITMETRTYPE* pchMet1, const _VITMETRTYPE* pchMet2)
+{
+    _DECISIONTYPE* pDec = (_DECISIONTYPE*) pCurDec;
+    _VITMETRTYPE* pCur = (_VITMETRTYPE*) pCurTrelMetric;
+
+    /* Each group does 16 butterflies in parallel */
+    for (int iGroup = 0; iGroup < 2; iGroup++)
+    {
+        /* Compute branch metrics */
+        const uint8x16_t vOld0 = vld1q_u8(&pOldTrelMetric[16 * iGroup]); /* high bit = 0 */
+        const uint8x16_t vOld1 = vld1q_u8(&pOldTrelMetric[16 * iGroup + 32]); /* high bit = 1 */
+        const uint8x16_t vMet1 = vld1q_u8(&pchMet1[16 * iGroup]);
+        const uint8x16_t vMet2 = vld1q_u8(&pchMet2[16 * iGroup]);
+
+        const uint8x16_t vFiSt0 = vqaddq_u8(vOld0, vMet1); /* first set: decision for bit = 0 */
+        const uint8x16_t vFiSt1 = vqaddq_u8(vOld1, vMet2); /* first set: decision for bit = 1 */
+        const uint8x16_t vSecSt0 = vqaddq_u8(vOld0, vMet2); /* second set: decision for bit = 0 */
+        const uint8x16_t vSecSt1 = vqaddq_u8(vOld1, vMet1); /* second set: decision for bit = 1 */
+
+        uint8x16x2_t vDec, vSurv;
+        vDec.val[0] = vcleq_u8(vFiSt1, vFiSt0);
+        vDec.val[1] = vcleq_u8(vSecSt1, vSecSt0);
+        vSurv.val[0] = vminq_u8(vFiSt0, vFiSt1);
+        vSurv.val[1] = vminq_u8(vSecSt0, vSecSt1);
+
+        /* Interleave & store decisions and new metrics */
+        vst2q_u8(&pDec[32 * iGroup], vDec);
+        vst2q_u8(&pCur[32 * iGroup], vSurv);
+    }
+
+    /* Normalize by finding smallest metric and subtracting it from all metrics */
+    if (pCur[0] <= 150)
+        return;
+
+    const uint8x16_t vMin16 = vminq_u8(vminq_u8(vld1q_u8(&pCur[0]), vld1q_u8(&pCur[16])),
+                                       vminq_u8(vld1q_u8(&pCur[32]), vld1q_u8(&pCur[48])));
+    uint8x8_t vMin = vmin_u8(vget_low_u8(vMin16), vget_high_u8(vMin16));
+    vMin = vpmin_u8(vMin, vMin);
+    vMin = vpmin_u8(vMin, vMin);
+    vMin = vpmin_u8(vMin, vMin);
+    const uint8x16_t vSub = vdupq_lane_u8(vMin, 0);
+
+    for (int i = 0; i < MC_NUM_STATES; i += 16)
+        vst1q_u8(&pCur[i], vqsubq_u8(vld1q_u8(&pCur[i]), vSub));
+}
+#endif
@@ -29,6 +29,13 @@
 #include "ViterbiDecoder.h"
 #include "printf.h"
 
+/* Append the input of every Decode() call to VITERBI_RECORD_FN for replay by
+   tools/drm_viterbi. Per call: int number of steps (incl. memory), int number
+   of distances, int puncturing pattern per step, float pair (to 0, to 1) per
+   distance */
+//#define VITERBI_RECORD
+#define VITERBI_RECORD_FN "/root/drm_viterbi.dat"
+
 /* Implementation *************************************************************/
 _REAL CViterbiDecoder::Decode(CVector<CDistance>& vecNewDistance,
                               CVector<_DECISION>& vecOutputBits)
@@ -39,24 +46,45 @@ _REAL CViterbiDecoder::Decode(CVector<CDistance>& vecNewDistance,
     _VITMETRTYPE*	pCurTrelMetric;
     _VITMETRTYPE*	pOldTrelMetric;
 
+    #ifdef VITERBI_RECORD
+        static FILE* pFileRec = fopen(VITERBI_RECORD_FN, "w");
+        if (pFileRec != NULL)
+        {
+            const int iNumDist = vecNewDistance.Size();
+            fwrite(&iNumOutBitsWithMemory, sizeof(int), 1, pFileRec);
+            fwrite(&iNumDist, sizeof(int), 1, pFileRec);
+            for (i = 0; i < iNumOutBitsWithMemory; i++)
+                fwrite(&veciTablePuncPat[i], sizeof(int), 1, pFileRec);
+            for (i = 0; i < iNumDist; i++)
+            {
+                const float rDist[2] = {(float) vecNewDistance[i].rTow0, (float) vecNewDistance[i].rTow1};
+                fwrite(rDist, sizeof(float), 2, pFileRec);
+            }
+            fflush(pFileRec);
+        }
+    #endif
+
     #ifdef USE_SIMD
         /* -------------------------------------------------------------------------
            Since the metric is 8-bit fixed-point type, we need to scale the input
            metrics to avoid overflows */
-        /* Calculate average value of input metrics */
+        /* Calculate average value of input metrics. All encoded bits (the size
+           of the input vector), not only one per trellis step, otherwise the
+           unscaled remainder saturates the metrics for the punctured codes */
+        const int iNumDist = vecNewDistance.Size();
         _REAL rAverage = (_REAL) 0.0;
-        for (i = 0; i < iNumOutBitsWithMemory; i++)
+        for (i = 0; i < iNumDist; i++)
         {
             rAverage += vecNewDistance[i].rTow0;
             rAverage += vecNewDistance[i].rTow1;
         }
     
         /* Scale input metrics */
-        const _REAL rAmp = rAverage / (2 * iNumOutBitsWithMemory) / 10;
-        for (i = 0; i < iNumOutBitsWithMemory; i++)
+        const _REAL rAmpInv = (2 * iNumDist) * 10 / rAverage;
+        for (i = 0; i < iNumDist; i++)
         {
-            vecNewDistance[i].rTow0 /= rAmp;
-            vecNewDistance[i].rTow1 /= rAmp;
+            vecNewDistance[i].rTow0 *= rAmpInv;
+            vecNewDistance[i].rTow1 *= rAmpInv;
         }
     #endif
 
@@ -199,11 +227,20 @@ _REAL CViterbiDecoder::Decode(CVector<CDistance>& vecNewDistance,
 
         /* Update trellis --------------------------------------------------- */
         #ifdef USE_SIMD
+            /* At this point we convert from float to char, once for each of the
+               eight metrics used. Clip so an outlier saturates like the trellis
+               adds do instead of wrapping */
+            _VITMETRTYPE chMetricSet[MC_NUM_OUTPUT_COMBINATIONS];
+            #define CONV_METRIC(met) \
+                chMetricSet[met] = (METRICSET(i)[met] < (_REAL) 255)? (_VITMETRTYPE) METRICSET(i)[met] : 255;
+            CONV_METRIC( 0) CONV_METRIC( 2) CONV_METRIC( 4) CONV_METRIC( 6)
+            CONV_METRIC( 9) CONV_METRIC(11) CONV_METRIC(13) CONV_METRIC(15)
+            #undef CONV_METRIC
+
             /* Use the butterfly unroll for reordering the metrics for SIMD trellis */
             #define BUTTERFLY(cur, next, prev0, prev1, met0, met1) { \
-                /* At this point we convert from float to char! No overflow-check is done here */ \
-                chMet1[prev0] = (_VITMETRTYPE) METRICSET(i)[met0]; \
-                chMet2[prev0] = (_VITMETRTYPE) METRICSET(i)[met1]; \
+                chMet1[prev0] = chMetricSet[met0]; \
+                chMet2[prev0] = chMetricSet[met1]; \
             }
         #else
             /* c++ version of trellis update */
@@ -289,6 +326,9 @@ _REAL CViterbiDecoder::Decode(CVector<CDistance>& vecNewDistance,
             #endif
             #ifdef USE_SSE2
                 TrellisUpdateSSE2
+            #endif
+            #ifdef USE_NEON
+                TrellisUpdateNEON
             #endif
                 (&matdecDecisions[i][0], pCurTrelMetric, pOldTrelMetric, chMet1, chMet2);
         #endif
@@ -37,11 +37,19 @@
 
 /* Definitions ****************************************************************/
 /* SIMD implementation is always fixed-point (is disabled if MAP decoder is
-   activated!) */
-#define USE_SIMD
-#undef USE_SIMD
+   activated!). SSE2 is used on x86. The NEON trellis is opt-in (define
+   VITERBI_NEON) until tools/drm_viterbi has been run and timed on a Beagle.
+   Define VITERBI_NO_SIMD to force the floating point trellis */
+//#define VITERBI_NEON
+#if defined(__SSE2__) || (defined(__ARM_NEON) && defined(VITERBI_NEON))
+# define USE_SIMD
+#endif
+//#define VITERBI_NO_SIMD
+#ifdef VITERBI_NO_SIMD
+# undef USE_SIMD
+#endif
 
-/* Use MMX or SSE2 */
+/* Use MMX (32-bit x86 inline assembler only) */
 #define USE_MMX
 #undef USE_MMX
 
@@ -52,7 +60,10 @@
 #endif
 
 #ifdef USE_SIMD
-# ifndef USE_MMX
+# if defined(USE_MMX)
+# elif defined(__ARM_NEON)
+#  define USE_NEON
+# else
 #  define USE_SSE2
 # endif
 #endif
@@ -132,6 +143,9 @@ protected:
 #endif
 #ifdef USE_SSE2
         void TrellisUpdateSSE2(
+#endif
+#ifdef USE_NEON
+        void TrellisUpdateNEON(
 #endif
             const _DECISIONTYPE* pCurDec,
             const _VITMETRTYPE* pCurTrelMetric, const _VITMETRTYPE* pOldTrelMetric,
@@ -26,6 +26,7 @@
  *
 \******************************************************************************/
 
+#include "DRM_main.h"
 #include "ChannelEstimation.h"
 #include <limits>
 #include "../matlib/MatlibSigProToolbox.h"
@@ -96,13 +97,14 @@ void CChannelEstimation::ProcessDataInternal(CParameter& Parameters)
 
     /* Get symbol-counter for next symbol. Use the count from the frame
        synchronization (in OFDM.cpp). Call estimation routine */
-    const _REAL rSNRAftTiInt =
+    _REAL rSNRAftTiInt;
+    MEASURE_TIME("e", 6, rSNRAftTiInt =
         pTimeInt->Estimate(pvecInputData, veccPilots,
                            Parameters.CellMappingTable.matiMapTab[iCurSymbIDTiInt],
                            Parameters.CellMappingTable.matcPilotCells[iCurSymbIDTiInt],
                            /* The channel estimation is based on the pilots so
                               it needs the SNR on the pilots. Do a correction */
-                           rSNREstimate * rSNRTotToPilCorrFact);
+                           rSNREstimate * rSNRTotToPilCorrFact));
 
     /* Debar initialization of channel estimation in time direction */
     if (iInitCnt > 0)
@@ -127,9 +129,9 @@ void CChannelEstimation::ProcessDataInternal(CParameter& Parameters)
     /* -------------------------------------------------------------------------
        Use time-interpolated channel estimate for timing synchronization
        tracking */
-    TimeSyncTrack.Process(Parameters, veccPilots,
+    MEASURE_TIME("t", 7, TimeSyncTrack.Process(Parameters, veccPilots,
                           (*pvecInputData).GetExData().iCurTimeCorr, rLenPDSEst /* out */,
-                          rOffsPDSEst /* out */);
+                          rOffsPDSEst /* out */));
 
     /* Store current delay in history */
     vecrDelayHist.AddEnd(rLenPDSEst);
@@ -122,6 +122,9 @@ bool sstv_msgs(char *msg, int rx_chan)
 	if (strcmp(msg, "SET ext_server_init") == 0) {
 	    memset(e, 0, sizeof(*e));
 		e->rx_chan = rx_chan;	// remember our receiver channel number
+		#ifdef SSTV_FM_SDFT
+		    e->adaptive = true;
+		#endif
 
         e->fft.in1k = SSTV_FFTW_ALLOC_REAL(1024);
         assert(e->fft.in1k != NULL);
@@ -149,8 +152,9 @@ bool sstv_msgs(char *msg, int rx_chan)
         #ifdef SSTV_TEST_FILE
             e->s2p = e->s22p = sstv.s2p_start;
             
-            // misuse ext_register_receive_real_samps() to pushback audio samples from the test file
-		    ext_register_receive_real_samps(sstv_file_data, rx_chan);
+            // pushback audio samples from the test file in place of the channel's real samples
+		    if (!ext_register_pushback_real_samps(sstv_file_data, rx_chan))
+		        printf("SSTV: test file refused, another extension is using the real samples\n");
 		#endif
 
         if (!e->task_created) {
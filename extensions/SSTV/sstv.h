@@ -90,6 +90,13 @@
 #define SSTV_TEST_FILE
 #define SSTV_TEST_FILE_RATE 12000
 
+// FM demodulate the long adaptive windows (SDFT_MIN_WINLEN and up) with a sliding DFT of the
+// video band bins, updated every sample, instead of a 1024 point FFT every fm_sample_interval.
+// Cheap enough that those windows can be used. The shorter ones keep the FFT, which is more accurate for them.
+// Compared with the FFT path by tools/sstv_fm_bench
+#define SSTV_FM_SDFT
+#define SDFT_MIN_WINLEN 256
+
 #define MINSLANT 30
 #define MAXSLANT 150
 #define SYNCPIXLEN 1.5e-3
@@ -204,6 +211,15 @@ typedef struct {
     int fm_sample_interval;
     bool adaptive;
 
+    #ifdef SSTV_FM_SDFT
+    struct {
+        #define SDFT_MAXBINS 80
+        int N, lo, nbins;
+        SSTV_REAL rN;
+        SSTV_FFTW_COMPLEX c[SDFT_MAXBINS], S[SDFT_MAXBINS];
+    } sdft;
+    #endif
+
 
     // shared between video and sync processes
     int HasSync_len;        // init
@@ -247,6 +263,11 @@ void sstv_pcm_read(sstv_chan_t *e, s4_t numsamples);
 
 u1_t sstv_get_vis(sstv_chan_t *e);
 
+SSTV_REAL sstv_fm_fft_freq(sstv_chan_t *e, SSTV_REAL *Hann, int WinLength);
+void sstv_fm_sdft_init(sstv_chan_t *e, int WinLength);
+void sstv_fm_sdft_update(sstv_chan_t *e);
+SSTV_REAL sstv_fm_sdft_freq(sstv_chan_t *e);
+
 void sstv_video_once(sstv_chan_t *e);
 void sstv_video_init(sstv_chan_t *e, SSTV_REAL rate, u1_t mode);
 bool sstv_video_get(sstv_chan_t *e, const char *from, int Skip, bool Redraw);
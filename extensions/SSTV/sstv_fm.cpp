@@ -0,0 +1,129 @@
+/*
+ * slowrx - an SSTV decoder
+ * * * * * * * * * * * * * *
+ *
+ * Copyright (c) 2007-2013, Oona Räisänen (OH2EIQ [at] sral.fi)
+ */
+
+#include "sstv.h"
+
+// FM demodulation: frequency of the strongest video tone (1500-2300 Hz) in the window
+// centered on pcm.WindowPtr, by Gaussian interpolation of the peak bin.
+
+// Hann windowed, zero padded to 1024 point FFT of the samples
+SSTV_REAL sstv_fm_fft_freq(sstv_chan_t *e, SSTV_REAL *Hann, int WinLength)
+{
+    const int   FFTLen = 1024;
+    u4_t        MaxBin = 0;
+    SSTV_REAL   Power[1024];
+    SSTV_REAL   Freq;
+    int         i, n;
+
+    memset(e->fft.in1k, 0, sizeof(SSTV_REAL) * FFTLen);
+
+    // Apply window function
+    for (i = 0; i < WinLength; i++)
+        e->fft.in1k[i] = e->pcm.Buffer[e->pcm.WindowPtr + i - WinLength/2] / 32768.0 * Hann[i];
+
+    SSTV_FFTW_EXECUTE(e->fft.Plan1024);
+
+    // Find the bin with most power
+    for (n = GET_BIN(1500 + e->pic.HeaderShift, FFTLen) - 1; n <= GET_BIN(2300 + e->pic.HeaderShift, FFTLen) + 1; n++) {
+        assert(n < 1024);
+        Power[n] = POWER(e->fft.out1k[n]);
+        if (MaxBin == 0 || Power[n] > Power[MaxBin]) MaxBin = n;
+    }
+
+    // Find the peak frequency by Gaussian interpolation
+    if (MaxBin > GET_BIN(1500 + e->pic.HeaderShift, FFTLen) - 1 && MaxBin < GET_BIN(2300 + e->pic.HeaderShift, FFTLen) + 1) {
+        Freq = MaxBin + (SSTV_MLOG( Power[MaxBin + 1] / Power[MaxBin - 1] )) /
+            (2 * SSTV_MLOG( SSTV_MPOW(Power[MaxBin], 2) / (Power[MaxBin + 1] * Power[MaxBin - 1])));
+        // In Hertz
+        Freq = Freq / FFTLen * sstv.nom_rate;
+    } else {
+        // Clip if out of bounds
+        Freq = ( (MaxBin > GET_BIN(1900 + e->pic.HeaderShift, FFTLen)) ? 2300 : 1500 ) + e->pic.HeaderShift;
+    }
+
+    return Freq;
+}
+
+
+#ifdef SSTV_FM_SDFT
+
+// Sliding DFT over only the bins of the video band, bin spacing nom_rate/WinLength.
+// Every sample: S[k] = x[new] - r^N x[old] + r e^(j2πk/N) S[k], i.e. S[k] = sum over the window of
+// r^m e^(j2πkm/N) x[new-m]. The damping r < 1 keeps the float rounding errors from accumulating.
+// The Hann window is applied in the frequency domain: 0.5 S[k] - 0.25 (S[k-1] + S[k+1]).
+
+#define SDFT_R 0.99999
+
+// (re)start with the window length, summing the current window directly
+void sstv_fm_sdft_init(sstv_chan_t *e, int WinLength)
+{
+    int i, k;
+    e->sdft.N = WinLength;
+    e->sdft.lo = GET_BIN(1500 + e->pic.HeaderShift, WinLength) - 2;
+    e->sdft.nbins = GET_BIN(2300 + e->pic.HeaderShift, WinLength) + 2 - e->sdft.lo + 1;
+    assert(e->sdft.lo >= 0 && e->sdft.nbins <= SDFT_MAXBINS);
+    e->sdft.rN = pow(SDFT_R, WinLength);
+
+    s2_t *x = &e->pcm.Buffer[e->pcm.WindowPtr - WinLength/2];
+    for (k = 0; k < e->sdft.nbins; k++) {
+        double w = 2 * M_PI * (e->sdft.lo + k) / WinLength;
+        SSTV_REAL cr = e->sdft.c[k][0] = SDFT_R * cos(w);
+        SSTV_REAL ci = e->sdft.c[k][1] = SDFT_R * sin(w);
+        SSTV_REAL sr = 0, si = 0, t;
+        for (i = 0; i < WinLength; i++) {
+            t = x[i] + cr * sr - ci * si;
+            si = ci * sr + cr * si;
+            sr = t;
+        }
+        e->sdft.S[k][0] = sr;
+        e->sdft.S[k][1] = si;
+    }
+}
+
+// advance the window by one sample, to be centered on pcm.WindowPtr again
+void sstv_fm_sdft_update(sstv_chan_t *e)
+{
+    int N = e->sdft.N;
+    SSTV_REAL d = e->pcm.Buffer[e->pcm.WindowPtr + N/2 - 1] - e->sdft.rN * e->pcm.Buffer[e->pcm.WindowPtr - N/2 - 1];
+    SSTV_FFTW_COMPLEX *c = e->sdft.c, *S = e->sdft.S;
+
+    for (int k = 0; k < e->sdft.nbins; k++) {
+        SSTV_REAL sr = S[k][0], si = S[k][1];
+        S[k][0] = d + c[k][0] * sr - c[k][1] * si;
+        S[k][1] =     c[k][1] * sr + c[k][0] * si;
+    }
+}
+
+SSTV_REAL sstv_fm_sdft_freq(sstv_chan_t *e)
+{
+    int N = e->sdft.N, lo = e->sdft.lo;
+    SSTV_FFTW_COMPLEX *S = e->sdft.S;
+    SSTV_REAL Power[SDFT_MAXBINS];
+    int MaxBin = 0, n;
+
+    // Find the bin with most power
+    for (n = GET_BIN(1500 + e->pic.HeaderShift, N) - 1; n <= (int) GET_BIN(2300 + e->pic.HeaderShift, N) + 1; n++) {
+        int k = n - lo;
+        SSTV_REAL re = 0.5 * S[k][0] - 0.25 * (S[k-1][0] + S[k+1][0]);
+        SSTV_REAL im = 0.5 * S[k][1] - 0.25 * (S[k-1][1] + S[k+1][1]);
+        Power[k] = re*re + im*im;
+        if (MaxBin == 0 || Power[k] > Power[MaxBin - lo]) MaxBin = n;
+    }
+
+    // Find the peak frequency by Gaussian interpolation
+    if (MaxBin > (int) GET_BIN(1500 + e->pic.HeaderShift, N) - 1 && MaxBin < (int) GET_BIN(2300 + e->pic.HeaderShift, N) + 1) {
+        SSTV_REAL *P = &Power[MaxBin - lo];
+        SSTV_REAL Freq = MaxBin + (SSTV_MLOG( P[1] / P[-1] )) / (2 * SSTV_MLOG( P[0] * P[0] / (P[1] * P[-1])));
+        // In Hertz
+        return Freq / N * sstv.nom_rate;
+    }
+
+    // Clip if out of bounds
+    return ( (MaxBin > (int) GET_BIN(1900 + e->pic.HeaderShift, N)) ? 2300 : 1500 ) + e->pic.HeaderShift;
+}
+
+#endif
@@ -58,7 +58,6 @@ void sstv_video_done(sstv_chan_t *e)
 bool sstv_video_get(sstv_chan_t *e, const char *from, int Skip, bool Redraw)
 {
 
-    u4_t        MaxBin = 0;
     u4_t        VideoPlusNoiseBins=0, ReceiverBins=0, NoiseOnlyBins=0;
     int         n=0;
     u4_t        SyncSampleNum;
@@ -73,7 +72,6 @@ bool sstv_video_get(sstv_chan_t *e, const char *from, int Skip, bool Redraw)
     //SSTV_REAL   PrevFreq = 0;
     int         NextSNRtime = 0, NextSyncTime = 0;
     SSTV_REAL   Praw, Psync;
-    SSTV_REAL   Power[1024] = {0};
     SSTV_REAL   Pvideo_plus_noise=0, Pnoise_only=0, Pnoise=0, Psignal=0;
     SSTV_REAL   SNR = 0;
     SSTV_REAL   ChanStart[4] = {0}, ChanLen[4] = {0};
@@ -355,7 +353,9 @@ bool sstv_video_get(sstv_chan_t *e, const char *from, int Skip, bool Redraw)
 
         /*** FM demodulation ***/
 
-        if (SampleNum % e->fm_sample_interval == 0) {   // Take FFT every fm_sample_interval samples
+        bool fm_sample = (SampleNum % e->fm_sample_interval == 0);   // new Freq every fm_sample_interval samples
+
+        if (fm_sample) {
 
             //PrevFreq = Freq;
     
@@ -365,50 +365,55 @@ bool sstv_video_get(sstv_chan_t *e, const char *from, int Skip, bool Redraw)
             else if (SNR >=  20) WinIdx = 0;
             else if (SNR >=  10) WinIdx = 1;
             else if (SNR >=   9) WinIdx = 2;
-            else                 WinIdx = 3;
+            #ifdef SSTV_FM_SDFT
+                // the sliding DFT cost only grows with the number of video band bins
+                else if (SNR >=   3) WinIdx = 3;
+                else if (SNR >=  -5) WinIdx = 4;
+                else if (SNR >= -10) WinIdx = 5;
+                else                 WinIdx = 6;
+            #else
+                else                 WinIdx = 3;
             
-            /*  these are too cpu intensive for the Kiwi
-            else if (SNR >=   3) WinIdx = 3;
-            else if (SNR >=  -5) WinIdx = 4;
-            else if (SNR >= -10) WinIdx = 5;
-            else                 WinIdx = 6;
-            */
+                /*  these are too cpu intensive for the Kiwi with the FFT
+                else if (SNR >=   3) WinIdx = 3;
+                else if (SNR >=  -5) WinIdx = 4;
+                else if (SNR >= -10) WinIdx = 5;
+                else                 WinIdx = 6;
+                */
+            #endif
         
             // Minimum winlength can be doubled for Scottie DX
             if (Mode == SDX && WinIdx < 6) WinIdx++;
-    
-            memset(e->fft.in1k, 0, sizeof(SSTV_REAL) * FFTLen);
-            memset(Power,  0, sizeof(SSTV_REAL) * 1024);
-    
-            // Apply window function
-            
             WinLength = HannLens[WinIdx];
-            for (i = 0; i < WinLength; i++)
-                e->fft.in1k[i] = e->pcm.Buffer[e->pcm.WindowPtr + i - WinLength/2] / 32768.0 * Hann[WinIdx][i];
-    
-            SSTV_FFTW_EXECUTE(e->fft.Plan1024);
-            NextTask("sstv FFT FM");
-
-            MaxBin = 0;
-          
-            // Find the bin with most power
-            for (n = GET_BIN(1500 + e->pic.HeaderShift, FFTLen) - 1; n <= GET_BIN(2300 + e->pic.HeaderShift, FFTLen) + 1; n++) {
-                assert(n < 1024);
-                Power[n] = POWER(e->fft.out1k[n]);
-                if (MaxBin == 0 || Power[n] > Power[MaxBin]) MaxBin = n;
-            }
+        }
 
-            // Find the peak frequency by Gaussian interpolation
-            if (MaxBin > GET_BIN(1500 + e->pic.HeaderShift, FFTLen) - 1 && MaxBin < GET_BIN(2300 + e->pic.HeaderShift, FFTLen) + 1) {
-                Freq = MaxBin + (SSTV_MLOG( Power[MaxBin + 1] / Power[MaxBin - 1] )) /
-                    (2 * SSTV_MLOG( SSTV_MPOW(Power[MaxBin], 2) / (Power[MaxBin + 1] * Power[MaxBin - 1])));
-                // In Hertz
-                Freq = Freq / FFTLen * sstv.nom_rate;
+        #ifdef SSTV_FM_SDFT
+            // The sliding DFT only for the long windows. With the few wide bins of the short ones its
+            // Gaussian interpolation is less accurate than that of the zero padded FFT.
+            if (WinLength >= SDFT_MIN_WINLEN) {
+                // restart the sliding DFT when the window length changes, else slide it by one sample
+                if (SampleNum == 0 || WinLength != e->sdft.N)
+                    sstv_fm_sdft_init(e, WinLength);
+                else
+                    sstv_fm_sdft_update(e);
+    
+                if (fm_sample) {
+                    Freq = sstv_fm_sdft_freq(e);
+                    NextTask("sstv SDFT FM");
+                }
             } else {
-                // Clip if out of bounds
-                Freq = ( (MaxBin > GET_BIN(1900 + e->pic.HeaderShift, FFTLen)) ? 2300 : 1500 ) + e->pic.HeaderShift;
+                e->sdft.N = 0;      // so it restarts when next used
+                if (fm_sample) {
+                    Freq = sstv_fm_fft_freq(e, Hann[WinIdx], WinLength);
+                    NextTask("sstv FFT FM");
+                }
+            }
+        #else
+            if (fm_sample) {
+                Freq = sstv_fm_fft_freq(e, Hann[WinIdx], WinLength);
+                NextTask("sstv FFT FM");
             }
-        } /* endif FM SampleNum % fm_sample_interval */
+        #endif
 
         // Linear interpolation of (chronologically) intermediate frequencies, for redrawing
         //InterpFreq = PrevFreq + (Freq-PrevFreq) * ...  // TODO!
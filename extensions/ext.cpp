@@ -73,65 +73,256 @@ void ext_adjust_clock_offset(int rx_chan, double offset)
     */
 }
 
+// Subscribing the same routine or task again is a no-op.
+// Subscribe/unsubscribe and the extint_receive_*() delivery run only on the coroutine thread, never from a
+// work pool job, so the subscriber slots need no locking (see snd_dsp_block() in rx_sound.cpp).
+// Several extensions can subscribe to the same channel and stage. Each ext_unregister_*() call only
+// removes the subscriptions of its owner, so the other subscribers keep their samples. The owner is the
+// ext_t passed to the *_ext() versions, or the extension the channel is bound to (ext_users[rx_chan].ext)
+// for the original API. That is NULL if no extension is bound, and such subscriptions go at the next
+// extint_ext_users_init() as they did before.
+
+#define EXT_NAME(ext) ((ext)? (ext)->name : "(no ext)")
+
+static bool ext_subscribe(ext_t *ext, int rx_chan, ext_stage_e stage, void *func, tid_t tid, bool pushback)
+{
+    ext_subs_t *subs = &ext_users[rx_chan].subs[stage];
+    ext_sub_t *free_sub = NULL;
+    int i;
+
+    for (i=0; i < subs->n; i++) {
+        ext_sub_t *s = &subs->sub[i];
+        if (s->func == NULL && s->tid == (tid_t) NULL) {
+            if (free_sub == NULL) free_sub = s;
+            continue;
+        }
+        
+        // a pushback routine overwrites the samples every other subscriber would see
+        if (s->owner != ext && (pushback || s->pushback)) {
+            printf("ext_subscribe: RX%d stage %d %s refused, %s test pushback must be the only extension subscribed\n",
+                rx_chan, stage, EXT_NAME(ext), EXT_NAME(pushback? ext : s->owner));
+            return false;
+        }
+        
+        if (s->owner == ext && s->func == func && s->tid == tid)
+            return true;
+    }
+    
+    if (free_sub == NULL) {
+        if (subs->n == EXT_MAX_SUBS) {
+            printf("ext_subscribe: RX%d stage %d already has %d subscribers\n", rx_chan, stage, EXT_MAX_SUBS);
+            return false;
+        }
+        free_sub = &subs->sub[subs->n++];
+    }
+    free_sub->func = func;
+    free_sub->tid = tid;
+    free_sub->owner = ext;
+    free_sub->pushback = pushback;
+    return true;
+}
+
+static void ext_unsubscribe(ext_t *ext, int rx_chan, ext_stage_e stage, bool funcs, bool tasks)
+{
+    ext_subs_t *subs = &ext_users[rx_chan].subs[stage];
+    int i;
+
+    // slots are cleared rather than compacted so a routine can unsubscribe while its stage is being delivered
+    for (i=0; i < subs->n; i++) {
+        ext_sub_t *s = &subs->sub[i];
+        if (s->owner != ext) continue;
+        if (!(s->func != NULL && funcs) && !(s->tid != (tid_t) NULL && tasks)) continue;
+        memset(s, 0, sizeof(ext_sub_t));
+    }
+    while (subs->n && subs->sub[subs->n-1].func == NULL && subs->sub[subs->n-1].tid == (tid_t) NULL)
+        subs->n--;
+}
+
+void ext_register_receive_iq_samps_ext(ext_t *ext, ext_receive_iq_samps_t func, int rx_chan)
+{
+	ext_subscribe(ext, rx_chan, EXT_STAGE_IQ, (void *) func, (tid_t) NULL, false);
+}
+
 void ext_register_receive_iq_samps(ext_receive_iq_samps_t func, int rx_chan)
 {
-	ext_users[rx_chan].receive_iq = func;
+	ext_register_receive_iq_samps_ext(ext_users[rx_chan].ext, func, rx_chan);
+}
+
+bool ext_register_pushback_iq_samps_ext(ext_t *ext, ext_receive_iq_samps_t func, int rx_chan)
+{
+	return ext_subscribe(ext, rx_chan, EXT_STAGE_IQ, (void *) func, (tid_t) NULL, true);
+}
+
+bool ext_register_pushback_iq_samps(ext_receive_iq_samps_t func, int rx_chan)
+{
+	return ext_register_pushback_iq_samps_ext(ext_users[rx_chan].ext, func, rx_chan);
+}
+
+void ext_register_receive_iq_samps_task_ext(ext_t *ext, tid_t tid, int rx_chan)
+{
+	ext_subscribe(ext, rx_chan, EXT_STAGE_IQ, NULL, tid, false);
 }
 
 void ext_register_receive_iq_samps_task(tid_t tid, int rx_chan)
 {
-	ext_users[rx_chan].receive_iq_tid = tid;
+	ext_register_receive_iq_samps_task_ext(ext_users[rx_chan].ext, tid, rx_chan);
+}
+
+void ext_unregister_receive_iq_samps_ext(ext_t *ext, int rx_chan)
+{
+	ext_unsubscribe(ext, rx_chan, EXT_STAGE_IQ, true, false);
 }
 
 void ext_unregister_receive_iq_samps(int rx_chan)
 {
-	ext_users[rx_chan].receive_iq = NULL;
+	ext_unregister_receive_iq_samps_ext(ext_users[rx_chan].ext, rx_chan);
+}
+
+void ext_unregister_receive_iq_samps_task_ext(ext_t *ext, int rx_chan)
+{
+	ext_unsubscribe(ext, rx_chan, EXT_STAGE_IQ, false, true);
 }
 
 void ext_unregister_receive_iq_samps_task(int rx_chan)
 {
-	ext_users[rx_chan].receive_iq_tid = (tid_t) NULL;
+	ext_unregister_receive_iq_samps_task_ext(ext_users[rx_chan].ext, rx_chan);
+}
+
+void ext_register_receive_real_samps_ext(ext_t *ext, ext_receive_real_samps_t func, int rx_chan)
+{
+	ext_subscribe(ext, rx_chan, EXT_STAGE_REAL, (void *) func, (tid_t) NULL, false);
 }
 
 void ext_register_receive_real_samps(ext_receive_real_samps_t func, int rx_chan)
 {
-	ext_users[rx_chan].receive_real = func;
+	ext_register_receive_real_samps_ext(ext_users[rx_chan].ext, func, rx_chan);
+}
+
+bool ext_register_pushback_real_samps_ext(ext_t *ext, ext_receive_real_samps_t func, int rx_chan)
+{
+	return ext_subscribe(ext, rx_chan, EXT_STAGE_REAL, (void *) func, (tid_t) NULL, true);
+}
+
+bool ext_register_pushback_real_samps(ext_receive_real_samps_t func, int rx_chan)
+{
+	return ext_register_pushback_real_samps_ext(ext_users[rx_chan].ext, func, rx_chan);
+}
+
+void ext_register_receive_real_samps_task_ext(ext_t *ext, tid_t tid, int rx_chan)
+{
+	ext_subscribe(ext, rx_chan, EXT_STAGE_REAL, NULL, tid, false);
 }
 
 void ext_register_receive_real_samps_task(tid_t tid, int rx_chan)
 {
-	ext_users[rx_chan].receive_real_tid = tid;
+	ext_register_receive_real_samps_task_ext(ext_users[rx_chan].ext, tid, rx_chan);
+}
+
+void ext_unregister_receive_real_samps_ext(ext_t *ext, int rx_chan)
+{
+	ext_unsubscribe(ext, rx_chan, EXT_STAGE_REAL, true, false);
 }
 
 void ext_unregister_receive_real_samps(int rx_chan)
 {
-	ext_users[rx_chan].receive_real = NULL;
+	ext_unregister_receive_real_samps_ext(ext_users[rx_chan].ext, rx_chan);
+}
+
+void ext_unregister_receive_real_samps_task_ext(ext_t *ext, int rx_chan)
+{
+	ext_unsubscribe(ext, rx_chan, EXT_STAGE_REAL, false, true);
 }
 
 void ext_unregister_receive_real_samps_task(int rx_chan)
 {
-	ext_users[rx_chan].receive_real_tid = (tid_t) NULL;
+	ext_unregister_receive_real_samps_task_ext(ext_users[rx_chan].ext, rx_chan);
+}
+
+void ext_register_receive_FFT_samps_ext(ext_t *ext, ext_receive_FFT_samps_t func, int rx_chan, ext_FFT_filtering_e filtering)
+{
+	ext_subscribe(ext, rx_chan, (ext_stage_e) (EXT_STAGE_FFT_PRE + filtering), (void *) func, (tid_t) NULL, false);
 }
 
 void ext_register_receive_FFT_samps(ext_receive_FFT_samps_t func, int rx_chan, ext_FFT_filtering_e filtering)
 {
-	ext_users[rx_chan].receive_FFT = func;
-	ext_users[rx_chan].filtering = filtering;
+	ext_register_receive_FFT_samps_ext(ext_users[rx_chan].ext, func, rx_chan, filtering);
+}
+
+void ext_unregister_receive_FFT_samps_ext(ext_t *ext, int rx_chan)
+{
+	ext_unsubscribe(ext, rx_chan, EXT_STAGE_FFT_PRE, true, false);
+	ext_unsubscribe(ext, rx_chan, EXT_STAGE_FFT_POST, true, false);
 }
 
 void ext_unregister_receive_FFT_samps(int rx_chan)
 {
-	ext_users[rx_chan].receive_FFT = NULL;
+	ext_unregister_receive_FFT_samps_ext(ext_users[rx_chan].ext, rx_chan);
+}
+
+void ext_register_receive_S_meter_ext(ext_t *ext, ext_receive_S_meter_t func, int rx_chan)
+{
+	ext_subscribe(ext, rx_chan, EXT_STAGE_S_METER, (void *) func, (tid_t) NULL, false);
 }
 
 void ext_register_receive_S_meter(ext_receive_S_meter_t func, int rx_chan)
 {
-	ext_users[rx_chan].receive_S_meter = func;
+	ext_register_receive_S_meter_ext(ext_users[rx_chan].ext, func, rx_chan);
+}
+
+void ext_unregister_receive_S_meter_ext(ext_t *ext, int rx_chan)
+{
+	ext_unsubscribe(ext, rx_chan, EXT_STAGE_S_METER, true, false);
 }
 
 void ext_unregister_receive_S_meter(int rx_chan)
 {
-	ext_users[rx_chan].receive_S_meter = NULL;
+	ext_unregister_receive_S_meter_ext(ext_users[rx_chan].ext, rx_chan);
+}
+
+void extint_receive_iq_samps(int rx_chan, int ns_out, TYPECPX *samps)
+{
+    ext_subs_t *subs = &ext_users[rx_chan].subs[EXT_STAGE_IQ];
+    for (int i=0; i < subs->n; i++) {
+        ext_sub_t *s = &subs->sub[i];
+        if (s->func != NULL)
+            ((ext_receive_iq_samps_t) s->func)(rx_chan, 0, ns_out, samps);
+        else
+        if (s->tid != (tid_t) NULL)
+            TaskWakeup(s->tid, TWF_CHECK_WAKING, TO_VOID_PARAM(rx_chan));
+    }
+}
+
+void extint_receive_real_samps(int rx_chan, int ns_out, TYPEMONO16 *samps)
+{
+    ext_subs_t *subs = &ext_users[rx_chan].subs[EXT_STAGE_REAL];
+    for (int i=0; i < subs->n; i++) {
+        ext_sub_t *s = &subs->sub[i];
+        if (s->func != NULL)
+            ((ext_receive_real_samps_t) s->func)(rx_chan, 0, ns_out, samps);
+        else
+        if (s->tid != (tid_t) NULL)
+            TaskWakeup(s->tid, TWF_CHECK_WAKING, TO_VOID_PARAM(rx_chan));
+    }
+}
+
+void extint_receive_FFT_samps(int rx_chan, ext_stage_e stage, int ratio, int ns_out, TYPECPX *samps)
+{
+    ext_subs_t *subs = &ext_users[rx_chan].subs[stage];
+    for (int i=0; i < subs->n; i++) {
+        ext_sub_t *s = &subs->sub[i];
+        if (s->func != NULL)
+            ((ext_receive_FFT_samps_t) s->func)(rx_chan, 0, ratio, ns_out, samps);
+    }
+}
+
+void extint_receive_S_meter(int rx_chan, float S_meter_dBm)
+{
+    ext_subs_t *subs = &ext_users[rx_chan].subs[EXT_STAGE_S_METER];
+    for (int i=0; i < subs->n; i++) {
+        ext_sub_t *s = &subs->sub[i];
+        if (s->func != NULL)
+            ((ext_receive_S_meter_t) s->func)(rx_chan, S_meter_dBm);
+    }
 }
 
 static int n_exts;
@@ -266,7 +457,18 @@ void extint_ext_users_init(int rx_chan)
     // so that rx_chan_free_count() doesn't count EXT_FLAGS_HEAVY when extension isn't running
     //printf("extint_ext_users_init rx_chan=%d\n", rx_chan);
     rx_channels[rx_chan].ext = NULL;
-    memset(&ext_users[rx_chan], 0, sizeof(ext_users_t));
+    ext_users_t *eusr = &ext_users[rx_chan];
+
+    // only the departing extension's subscriptions (and any made with no extension bound) go,
+    // other subscribers to the channel keep theirs
+    for (int stage = 0; stage < EXT_N_STAGES; stage++) {
+        if (eusr->ext != NULL)
+            ext_unsubscribe(eusr->ext, rx_chan, (ext_stage_e) stage, true, true);
+        ext_unsubscribe(NULL, rx_chan, (ext_stage_e) stage, true, true);
+    }
+    eusr->valid = FALSE;
+    eusr->ext = NULL;
+    eusr->conn_ext = NULL;
 }
 
 void extint_setup_c2s(void *param)
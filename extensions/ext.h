@@ -74,6 +74,13 @@ void ext_register_receive_real_samps_task(tid_t tid, int rx_chan);
 void ext_unregister_receive_real_samps(int rx_chan);
 void ext_unregister_receive_real_samps_task(int rx_chan);
 
+// Test file pushback: func overwrites the channel samples in place, so it must be the only extension
+// subscribed to the stage. Returns false without subscribing if another extension already is, and while
+// registered other extensions' subscriptions to the stage are refused.
+// Unregister with ext_unregister_receive_*_samps().
+bool ext_register_pushback_iq_samps(ext_receive_iq_samps_t func, int rx_chan);
+bool ext_register_pushback_real_samps(ext_receive_real_samps_t func, int rx_chan);
+
 // call to start/stop receiving audio channel FFT samples, pre- or post-FIR filter, detection & AGC
 typedef enum { PRE_FILTERED, POST_FILTERED } ext_FFT_filtering_e;
 void ext_register_receive_FFT_samps(ext_receive_FFT_samps_t func, int rx_chan, ext_FFT_filtering_e filtering);
@@ -83,6 +90,27 @@ void ext_unregister_receive_FFT_samps(int rx_chan);
 void ext_register_receive_S_meter(ext_receive_S_meter_t func, int rx_chan);
 void ext_unregister_receive_S_meter(int rx_chan);
 
+// The routines above subscribe on behalf of the extension the channel is bound to. A channel's samples
+// can be fed to several subscribers, and the *_ext() versions below name the subscribing extension
+// explicitly so server-side code can share a channel with it. Unregistering only removes that
+// extension's routines/tasks.
+// Note the client still binds a single extension per channel (ext_users[rx_chan]), so two user-facing
+// extensions (e.g. CW decoder and IQ display) on one channel is not supported.
+void ext_register_receive_iq_samps_ext(ext_t *ext, ext_receive_iq_samps_t func, int rx_chan);
+void ext_register_receive_iq_samps_task_ext(ext_t *ext, tid_t tid, int rx_chan);
+void ext_unregister_receive_iq_samps_ext(ext_t *ext, int rx_chan);
+void ext_unregister_receive_iq_samps_task_ext(ext_t *ext, int rx_chan);
+void ext_register_receive_real_samps_ext(ext_t *ext, ext_receive_real_samps_t func, int rx_chan);
+void ext_register_receive_real_samps_task_ext(ext_t *ext, tid_t tid, int rx_chan);
+void ext_unregister_receive_real_samps_ext(ext_t *ext, int rx_chan);
+void ext_unregister_receive_real_samps_task_ext(ext_t *ext, int rx_chan);
+bool ext_register_pushback_iq_samps_ext(ext_t *ext, ext_receive_iq_samps_t func, int rx_chan);
+bool ext_register_pushback_real_samps_ext(ext_t *ext, ext_receive_real_samps_t func, int rx_chan);
+void ext_register_receive_FFT_samps_ext(ext_t *ext, ext_receive_FFT_samps_t func, int rx_chan, ext_FFT_filtering_e filtering);
+void ext_unregister_receive_FFT_samps_ext(ext_t *ext, int rx_chan);
+void ext_register_receive_S_meter_ext(ext_t *ext, ext_receive_S_meter_t func, int rx_chan);
+void ext_unregister_receive_S_meter_ext(ext_t *ext, int rx_chan);
+
 // general routines
 double ext_update_get_sample_rateHz(int rx_chan);		// return sample rate of audio channel
 void ext_adjust_clock_offset(int rx_chan, double offset);
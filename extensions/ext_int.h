@@ -27,18 +27,37 @@ Boston, MA  02110-1301, USA.
 #include "coroutines.h"
 #include "ext.h"
 
+// Sample stages an extension can subscribe to. Each channel keeps a short list of subscribers per stage
+// so one channel's samples can feed several consumers.
+typedef enum {
+    EXT_STAGE_IQ,               // IQ post-FIR filter, pre- detector & AGC
+    EXT_STAGE_REAL,             // real audio post- detector & AGC
+    EXT_STAGE_FFT_PRE,          // FIR FFT blocks before the filter is applied
+    EXT_STAGE_FFT_POST,         // .. and after (order as ext_FFT_filtering_e)
+    EXT_STAGE_S_METER,
+    EXT_N_STAGES
+} ext_stage_e;
+
+#define EXT_MAX_SUBS    4       // subscribers per channel and stage
+
+typedef struct {
+    void *func;                 // ext_receive_*_t of the stage, NULL if a task subscriber (or a free slot)
+    tid_t tid;                  // task to TaskWakeup() instead
+    ext_t *owner;               // subscribing extension
+    bool pushback;              // func overwrites the samples, no other extension may subscribe to the stage
+} ext_sub_t;
+
+typedef struct {
+    int n;                      // high water mark, unsubscribed slots are cleared not compacted
+    ext_sub_t sub[EXT_MAX_SUBS];
+} ext_subs_t;
+
 // extension information when active on a particular RX_CHAN
 typedef struct {
     bool valid;
 	ext_t *ext;
 	conn_t *conn_ext;                       // used by ext_send_* routines
-	ext_receive_iq_samps_t receive_iq;		// server-side routine for receiving IQ data
-	tid_t receive_iq_tid;
-	ext_receive_real_samps_t receive_real;	// server-side routine for receiving real data
-	tid_t receive_real_tid;
-	ext_receive_FFT_samps_t receive_FFT;	// server-side routine for receiving FFT data
-	ext_FFT_filtering_e filtering;          // FFT data post-FIR filtering
-	ext_receive_S_meter_t receive_S_meter;	// server-side routine for receiving S-meter data
+	ext_subs_t subs[EXT_N_STAGES];          // server-side routines/tasks receiving sample data
 } ext_users_t;
 
 extern ext_users_t ext_users[MAX_RX_CHANS];
@@ -52,3 +71,12 @@ void extint_load_extension_configs(conn_t *conn);
 void extint_ext_users_init(int rx_chan);
 void extint_setup_c2s(void *param);
 void extint_c2s(void *param);
+
+// Sample delivery from the audio path. Subscribers get the channel's own buffer (no copy) and must
+// treat it as read-only, except the test file pushback routines (DRM, SSTV) which replace the samples.
+// ext_subscribe() refuses to mix a pushback routine with another extension's subscription to the same stage.
+static inline bool extint_subscribed(int rx_chan, ext_stage_e stage) { return ext_users[rx_chan].subs[stage].n != 0; }
+void extint_receive_iq_samps(int rx_chan, int ns_out, TYPECPX *samps);
+void extint_receive_real_samps(int rx_chan, int ns_out, TYPEMONO16 *samps);
+void extint_receive_FFT_samps(int rx_chan, ext_stage_e stage, int ratio, int ns_out, TYPECPX *samps);
+void extint_receive_S_meter(int rx_chan, float S_meter_dBm);
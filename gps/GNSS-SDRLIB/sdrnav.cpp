@@ -304,11 +304,11 @@ extern void predecodefec(sdrnav_t *nav)
     if (nav->ctype==CTYPE_L1SAIF||
         nav->ctype==CTYPE_L1SBAS) {
         /* 1/2 convolutional code */
-        init_viterbi27_port(nav->fec,0);
+        init_viterbi27(nav->fec,0);
         for (i=0;i<NAVFLEN_SBAS+NAVADDFLEN_SBAS;i++)
             enc[i]=(nav->fbits[i]==1)? 0:255;
-        update_viterbi27_blk_port(nav->fec,enc,(nav->flen+nav->addflen)/2);
-        chainback_viterbi27_port(nav->fec,dec,nav->flen/2,0);
+        update_viterbi27_blk(nav->fec,enc,(nav->flen+nav->addflen)/2);
+        chainback_viterbi27(nav->fec,dec,nav->flen/2,0);
         for (i=0;i<94;i++) {
             for (j=0;j<8;j++) {
                 dec2[8*i+j]=((dec[i]<<j)&0x80)>>7;
@@ -63,6 +63,43 @@ public:
 #else
     virtual bool solve(mat_type sv, vec_type weight, uint64_t adc_ticks) final {
 #endif
+        return solve_impl(sv, weight, adc_ticks, NULL, ivec_type());
+    }
+
+#ifdef KIWI_DEBIAN7
+    virtual bool solve(mat_type sv, vec_type weight, uint64_t adc_ticks, PosSolver const& all, ivec_type const& idx) {
+#else
+    virtual bool solve(mat_type sv, vec_type weight, uint64_t adc_ticks, PosSolver const& all, ivec_type const& idx) final {
+#endif
+        // PosSolverImpl is the only implementation
+        return solve_impl(sv, weight, adc_ticks, &static_cast<PosSolverImpl const&>(all)._spp, idx);
+    }
+
+    PosSolverImpl(double uere,
+                  double fOsc,
+                  kiwi_yield::wptr yield)
+        : PosSolver()
+        , _uere(uere)
+        , _fOsc(fOsc)
+        , _use_kalman(true)
+        , _spp(20, yield)
+        , _ekf(yield)
+        , _pos(3, 0.0)
+        , _t_rx(0)
+        , _osc_corr(-1)
+        , _llh()
+        , _pos_valid(false)
+        , _ekf_running(-1)
+        , _state_spp{{false, false}}
+        , _ticks_spp{{0,0}}
+        , _ticks_ekf{{0,0}}
+        , _ct_rx{{0,0}} {}
+
+    virtual ~PosSolverImpl() {}
+
+protected:
+    bool solve_impl(mat_type sv, vec_type weight, uint64_t adc_ticks,
+                    SinglePointPositionSolver const* spp_all, ivec_type const& idx) {
         assert(sv.dim2() == weight.dim());
 
         int nsv = sv.dim2();
@@ -79,7 +116,9 @@ public:
         _ticks_ekf[0] = _ticks_spp[0] = adc_ticks;
 
         // SPP solution
-        bool const status = _spp.Solve(sv, TNT::makeDiag(weight));
+        bool const status = spp_all?
+            _spp.Solve(sv, TNT::makeDiag(weight), *spp_all, idx) :
+            _spp.Solve(sv, TNT::makeDiag(weight));
 
         // update SPP status
         _state_spp[1] = _state_spp[0];
@@ -143,29 +182,6 @@ public:
         return true;
     }
 
-    PosSolverImpl(double uere,
-                  double fOsc,
-                  kiwi_yield::wptr yield)
-        : PosSolver()
-        , _uere(uere)
-        , _fOsc(fOsc)
-        , _use_kalman(true)
-        , _spp(20, yield)
-        , _ekf(yield)
-        , _pos(3, 0.0)
-        , _t_rx(0)
-        , _osc_corr(-1)
-        , _llh()
-        , _pos_valid(false)
-        , _ekf_running(-1)
-        , _state_spp{{false, false}}
-        , _ticks_spp{{0,0}}
-        , _ticks_ekf{{0,0}}
-        , _ct_rx{{0,0}} {}
-
-    virtual ~PosSolverImpl() {}
-
-protected:
     double dadc_ticks_sec(std::array<uint64_t,2> const& adc_ticks) const {
         // 48-bit overflow protection (assuming that clock ticks increase monotonously)
         return (adc_ticks[0] + (adc_ticks[0] < adc_ticks[1])*(1ULL<<48) - adc_ticks[1])/_fOsc;
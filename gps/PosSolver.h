@@ -23,6 +23,7 @@ class PosSolver {
 public:
     typedef TNT::Array1D<double> vec_type;
     typedef TNT::Array2D<double> mat_type;
+    typedef TNT::Array1D<int>    ivec_type;
 
     struct ElevAzim {
         double elev_deg, azim_deg;
@@ -56,6 +57,10 @@ public:
     // input: GNSS observables + oscillator tick counter
     virtual bool solve(mat_type sv, vec_type weight, uint64_t ticks) = 0;
 
+    // same for the subset idx (columns of its sv) of the satellites "all" has just solved for in this epoch,
+    // sharing its linearization instead of starting the single point iteration from scratch
+    virtual bool solve(mat_type sv, vec_type weight, uint64_t ticks, PosSolver const& all, ivec_type const& idx) = 0;
+
     virtual void set_use_kalman(bool ) = 0;
 
     // need to propagate information to kiwisdr global variables
@@ -12,7 +12,9 @@ public:
     SinglePointPositionSolver(int max_iter,
                               kiwi_yield::wptr yield=kiwi_yield::wptr())
         : PositionSolverBase(4, yield)
-        , _max_iter(max_iter) {}
+        , _max_iter(max_iter)
+        , _lin_valid(false)
+        , _lin_state(4, 0.0) {}
     virtual ~SinglePointPositionSolver() {}
 
     int max_iter() const { return _max_iter; }
@@ -20,6 +22,7 @@ public:
     bool Solve(mat_type sv,
                mat_type weight) {
         int const nsv = sv.dim2();
+        _lin_valid = false;
         if (nsv < 4)
             return false;
 
@@ -29,29 +32,72 @@ public:
         double const ct0 = TNT::mean(sv.subarray(3,3, 0,sv.dim2()-1)) + c()*75e-3;
         _state.inject(TNT::makeVector<double>({0,0,0,ct0}));
 
+        return Iterate(sv, weight, mat_type(), vec_type());
+    }
+
+    // Solution for the subset idx of the satellites spp has just solved for (sv = columns idx of spp's sv).
+    // Starts at spp's last linearization point and takes the subset's rows of spp's design matrix and
+    // residuals for the first step, so typically only one or two more linearizations are needed.
+    bool Solve(mat_type sv,
+               mat_type weight,
+               SinglePointPositionSolver const& spp,
+               TNT::Array1D<int> const& idx) {
+        int const nsv = sv.dim2();
+        if (nsv < 4)
+            return false;
+        if (!spp._lin_valid)
+            return Solve(sv, weight);
+
+        assert(sv.dim1() == 4 && weight.dim1() == nsv && weight.dim2() == nsv && idx.dim() == nsv);
+
+        mat_type h(nsv,4);
+        vec_type drho(nsv);
+        for (int i_sv=0; i_sv<nsv; ++i_sv) {
+            for (int j=0; j<4; ++j)
+                h(i_sv,j) = spp._lin_h(idx(i_sv),j);
+            drho(i_sv) = spp._lin_drho(idx(i_sv));
+        }
+        _state.inject(spp._lin_state);
+
+        return Iterate(sv, weight, h, drho);
+    }
+
+protected:
+    // Gauss-Newton iteration from _state; h,drho if non-empty are the rows for the first step
+    bool Iterate(mat_type sv, mat_type const& weight, mat_type h, vec_type drho) {
+        int const nsv = sv.dim2();
+        _lin_valid = false;
+
         int i=0;
         for (; i<max_iter(); ++i) {
-            mat_type h(nsv,4, 0.0);
-            vec_type drho(nsv, 0.0);
-            Iter(ct_rx(), sv, [&h,&drho,this](int i_sv, const vec_type& dp, double cdt) {
-                    yield();
-                    double const dpn = TNT::norm(dp);
-                    h.subarray(i_sv,i_sv,0,2).inject(dp/dpn);
-                    h(i_sv,3)  = -1;
-                    drho(i_sv) = dpn - cdt;
-                });
+            if (i > 0 || h.dim1() != nsv) {
+                h    = mat_type(nsv,4, 0.0);
+                drho = vec_type(nsv, 0.0);
+                Iter(ct_rx(), sv, [&h,&drho,this](int i_sv, const vec_type& dp, double cdt) {
+                        yield();
+                        double const dpn = TNT::norm(dp);
+                        h.subarray(i_sv,i_sv,0,2).inject(dp/dpn);
+                        h(i_sv,3)  = -1;
+                        drho(i_sv) = dpn - cdt;
+                    });
+            }
             if (!ComputeCov(h, weight))
                 return false;
+            _lin_state.inject(_state);
             vec_type dxyzt = cov() * TNT::transpose(h) * weight * drho;
             _state   -= dxyzt;
             _state(3) = mod_gpsweek_abs(_state(3));
             if (TNT::norm(dxyzt.subarray(0,2)) < 0.001)
                 break;
         }
-        return (i < max_iter());
+
+        // keep the converged linearization for subset solutions
+        _lin_h     = h;
+        _lin_drho  = drho;
+        _lin_valid = (i < max_iter());
+        return _lin_valid;
     }
 
-protected:
     bool ComputeCov(mat_type const& h, mat_type const& weight) {
         double det = 0;
         mat_type const tmp     = TNT::transpose(h) * weight * h;
@@ -65,6 +111,12 @@ protected:
 
 private:
     int _max_iter;
+
+    // last linearization: state, design matrix and residuals
+    bool     _lin_valid;
+    vec_type _lin_state;
+    mat_type _lin_h;
+    vec_type _lin_drho;
 } ;
 
 #endif // _GPS_SINGLE_POINT_POSITION_SOLVER_H_
@@ -79,7 +79,7 @@ struct CHANNEL { // Locally-held channel data
     sdrnav_t nav;
 	SPI_MISO *miso;
 	
-    void  Reset(int sat, int codegen_init);
+    void  Reset(int sat, int codegen_init, bool e1b_download);
     void  Start(int sat, int t_sample, int lo_shift, int ca_shift, int snr);
     void  SetGainAdjLO(int);
     int   GetGainAdjLO();
@@ -195,7 +195,45 @@ void CHANNEL::SetGainAdjCG(int adj) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
-void CHANNEL::Reset(int sat, int codegen_init) {
+// Download the E1B code table for all channels.
+// The BRAM write address is zeroed by the sampler reset (CmdSample), so there must be
+// at most one download between samples.
+void ChanE1BDownload() {
+    int dbg = 0;
+    SPI_MOSI *code_buf = &SPI_SHMEM->gps_e1b_code_mosi;
+
+    for (int i=0; i < E1B_CODE_XFERS; i++) {    // number of SPIBUF_W sized xfers needed (currently 2)
+        if (dbg && i == 0) printf("E1B download\nprn: ");
+
+        for (int j=0; j < E1B_CODE_LOOP; j++) {     // code amount needed that also fits in SPIBUF_W
+            u2_t *code = &code_buf->words[j+1];     // NB: spi_mosi_data_t.cmd is in words[0]
+            *code = 0;
+            for (int chan = 0; chan < GPS_CHANS; chan++) {
+                CHANNEL *c = &Chans[chan];
+                //int busy = BusyFlags & (1<<chan);
+                //int prn = (busy && c->isE1B)? Sats[c->sat].prn : 0;
+                int prn = c->isE1B? Sats[c->sat].prn : 0;
+                if (dbg && i == 0 && j == 0) printf("%d ", prn);
+                int bit = (prn > 0)? E1B_code1[prn-1][(i*E1B_CODE_LOOP)+j] : 0;
+                *code = (*code >> 1) | (bit? (1 << (GPS_CHANS-1)): 0);  // ch0 in lsb
+                //if (0 && j == 0) printf("ch%2d busy=%d isE1B=%d prn%02d code 0x%03x\n",
+                //    chan+1, busy? 1:0, busy? c->isE1B:0, prn, *code);
+            }
+            if (dbg && i == 0 && j == 0) printf("\n");
+            if (dbg && i == 0 && j < 16) printf("code(%4d) 0x%03x\n", j, *code);
+            if (dbg && i == 1 && j >= (E1B_CODE_LOOP-16)) printf("code(%4d) 0x%03x\n", (i*E1B_CODE_LOOP)+j, *code);
+        }
+        spi_set_buf_noduplex(CmdSetE1Bcode, code_buf, S2B(E1B_CODE_LOOP));
+
+        // pause so as not to potentially starve other eCPU tasks
+        TaskSleepMsec(1);
+    }
+    //printf("**** downloaded E1B code table\n");
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+void CHANNEL::Reset(int sat, int codegen_init, bool e1b_download) {
     this->sat = sat;
     isE1B = is_E1B(sat);
     this->codegen_init = codegen_init;
@@ -203,40 +241,7 @@ void CHANNEL::Reset(int sat, int codegen_init) {
     spi_set(CmdSetSat, ch, codegen_init);
     //printf("Reset ch%02d codegen_init=0x%03x %s\n", ch+1, codegen_init, PRN(sat));
 
-    if (isE1B) {
-        // download E1B code table
-        // assumes BRAM write address is zero from when channel was last reset on signal loss
-        int dbg = 0;
-        SPI_MOSI *code_buf = &SPI_SHMEM->gps_e1b_code_mosi;
-
-        for (int i=0; i < E1B_CODE_XFERS; i++) {    // number of SPIBUF_W sized xfers needed (currently 2)
-            if (dbg && i == 0) printf("E1B download ch%2d try %s\nprn: ", ch+1, PRN(sat));
-
-            for (int j=0; j < E1B_CODE_LOOP; j++) {     // code amount needed that also fits in SPIBUF_W
-                u2_t *code = &code_buf->words[j+1];     // NB: spi_mosi_data_t.cmd is in words[0]
-                *code = 0;
-                for (int chan = 0; chan < GPS_CHANS; chan++) {
-                    CHANNEL *c = &Chans[chan];
-                    //int busy = BusyFlags & (1<<chan);
-                    //int prn = (busy && c->isE1B)? Sats[c->sat].prn : 0;
-                    int prn = c->isE1B? Sats[c->sat].prn : 0;
-                    if (dbg && i == 0 && j == 0) printf("%d ", prn);
-                    int bit = (prn > 0)? E1B_code1[prn-1][(i*E1B_CODE_LOOP)+j] : 0;
-                    *code = (*code >> 1) | (bit? (1 << (GPS_CHANS-1)): 0);  // ch0 in lsb
-                    //if (0 && j == 0) printf("ch%2d busy=%d isE1B=%d prn%02d code 0x%03x\n",
-                    //    chan+1, busy? 1:0, busy? c->isE1B:0, prn, *code);
-                }
-                if (dbg && i == 0 && j == 0) printf("\n");
-                if (dbg && i == 0 && j < 16) printf("code(%4d) 0x%03x\n", j, *code);
-                if (dbg && i == 1 && j >= (E1B_CODE_LOOP-16)) printf("code(%4d) 0x%03x\n", (i*E1B_CODE_LOOP)+j, *code);
-            }
-            spi_set_buf_noduplex(CmdSetE1Bcode, code_buf, S2B(E1B_CODE_LOOP));
-
-            // pause so as not to potentially starve other eCPU tasks
-            TaskSleepMsec(1);
-        }
-        //printf("**** downloaded E1B code table ch%02d %s\n", ch+1, PRN(sat));
-    }
+    if (isE1B && e1b_download) ChanE1BDownload();
     
     uint32_t ca_rate = CPS/FS*powf(2,32);
     spi_set(CmdSetRateCG, ch, ca_rate);
@@ -411,8 +416,8 @@ void CHANNEL::Tracking() {
     if (isE1B) {
         //int polys[2] = { 0x4f, -0x6d };       // k=7; Galileo E1B; "-" means G2 inverted
         int polys[2] = { 0x4f, 0x6d };          // k=7; Galileo E1B
-        set_viterbi27_polynomial_port(polys);
-        nav.fec = create_viterbi27_port(E1B_NBIT);
+        set_viterbi27_polynomial(polys);
+        nav.fec = create_viterbi27(E1B_NBIT);
 
         spi_set(CmdSetPolarity, ch, 0);
     }
@@ -545,7 +550,7 @@ void CHANNEL::Tracking() {
         }
     }
 
-    if (isE1B) delete_viterbi27_port(nav.fec);
+    if (isE1B) delete_viterbi27(nav.fec);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
@@ -882,7 +887,9 @@ void ChanTask(void *param) { // one thread per channel
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
-int ChanReset(int sat, int codegen_init) {  // called from search thread before sampling
+// Called from search thread before sampling, or after sampling for Navstar and E1B (see SearchTask).
+// Channels in the claimed mask are skipped.
+int ChanReset(int sat, int codegen_init, unsigned claimed, bool e1b_download) {
     int ch, nbusy, cur_QZSS;
     
     bool QZSS_JA = (gps.acq_QZSS && gps.QZSS_prio);
@@ -899,7 +906,7 @@ int ChanReset(int sat, int codegen_init) {  // called from search thread before
     bool QZSS_limit = (QZSS_JA && nfree <= nresv);
 
     for (ch = 0; ch < gps_chans; ch++) {
-        if (BusyFlags & (1<<ch)) continue;
+        if ((BusyFlags | claimed) & (1<<ch)) continue;
 
         // if QZSS_JA mode enabled don't let non-QZSS get last QZSS_RESERVED channels (reduced by number currently active)
         if (QZSS_limit && Sats[sat].type != QZSS) {
@@ -907,13 +914,43 @@ int ChanReset(int sat, int codegen_init) {  // called from search thread before
             return -1;
         }
 
-        Chans[ch].Reset(sat, codegen_init);
+        Chans[ch].Reset(sat, codegen_init, e1b_download);
         return ch;
     }
 
     return -1; // all channels busy
 }
 
+int ChanFree(unsigned claimed) {
+    for (int ch = 0; ch < gps_chans; ch++) {
+        if (!((BusyFlags | claimed) & (1<<ch))) return ch;
+    }
+    return -1;
+}
+
+// Channels whose code length (C/A or E1B) was last loaded for the other type.
+// The code length is only loaded by CmdSetSat, not by the sampler reset, so a channel assigned
+// after sampling must already have the length of the sat it is given.
+unsigned ChanOtherCode(bool isE1B) {
+    unsigned mask = 0;
+    for (int ch = 0; ch < gps_chans; ch++) {
+        if ((Chans[ch].isE1B? true:false) != isE1B) mask |= 1 << ch;
+    }
+    return mask;
+}
+
+// Called from search thread before sampling.
+// The sampler reset restarts the code generators of all free channels. Running them at the nominal
+// rate from then on means a channel assigned after the correlation is still aligned to the sample.
+void ChanSearchPrep() {
+    uint32_t ca_rate = CPS/FS*powf(2,32);
+
+    for (int ch = 0; ch < gps_chans; ch++) {
+        if (BusyFlags & (1<<ch)) continue;
+        spi_set(CmdSetRateCG, ch, ca_rate);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
 void ChanStart( // called from search thread to initiate acquisition of detected sat
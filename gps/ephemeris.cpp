@@ -120,7 +120,9 @@ double EPHEM::TimeOfEphemerisAge(double t) const {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
-double EPHEM::EccentricAnomaly(double t_k) const {
+// E_k0, if given, is a nearby solution (e.g. from the clock correction a few msec earlier)
+// used as the starting point so the fixed point iteration only needs a step or two.
+double EPHEM::EccentricAnomaly(double t_k, const double *E_k0) const {
     // Computed mean motion (rad/sec)
     double n_0 = sqrt(MU/(A()*A()*A()));
 
@@ -131,7 +133,7 @@ double EPHEM::EccentricAnomaly(double t_k) const {
     double M_k = M_0 + n*t_k;
 
     // Solve Kepler's Equation for Eccentric Anomaly
-    double E_k = M_k;
+    double E_k = E_k0? *E_k0 : M_k;
     int i;
     for(i=0; i<10000; i++) {
         double temp = E_k;
@@ -145,13 +147,13 @@ double EPHEM::EccentricAnomaly(double t_k) const {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
-void EPHEM::GetXYZ(double *x, double *y, double *z, double t) const { // Get satellite position at time t
+void EPHEM::GetXYZ(double *x, double *y, double *z, double t, const double *E_k0) const { // Get satellite position at time t
 
      // Time from ephemeris reference epoch
     double t_k = TimeFromEpoch(t, t_oe);
 
     // Eccentric Anomaly
-    double E_k = EccentricAnomaly(t_k);
+    double E_k = EccentricAnomaly(t_k, E_k0);
 
     // True Anomaly
     double v_k = atan2(
@@ -186,13 +188,14 @@ void EPHEM::GetXYZ(double *x, double *y, double *z, double t) const { // Get sat
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
-double EPHEM::GetClockCorrection(double t) const {
+double EPHEM::GetClockCorrection(double t, double *E_k_out) const {
 
      // Time from ephemeris reference epoch
     double t_k = TimeFromEpoch(t, t_oe);
 
     // Eccentric Anomaly
     double E_k = EccentricAnomaly(t_k);
+    if (E_k_out) *E_k_out = E_k;
 
     // Relativistic correction
     double t_R = F*e*sqrtA*sin(E_k);
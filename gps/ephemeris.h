@@ -49,7 +49,7 @@ class EPHEM {
     void Subframe4(char *nav);
 //  void Subframe5(char *nav);
 
-    double EccentricAnomaly(double t_k) const;
+    double EccentricAnomaly(double t_k, const double *E_k0 = NULL) const;
 
 public:
     double A() const { return sqrtA*sqrtA; }     // Semi-major axis
@@ -76,8 +76,8 @@ public:
     void   Init(int sat);
     void   Subframe(char *buf);
     bool   Valid();
-    double GetClockCorrection(double t) const;
-    void   GetXYZ(double *x, double *y, double *z, double t) const;
+    double GetClockCorrection(double t, double *E_k = NULL) const;
+    void   GetXYZ(double *x, double *y, double *z, double t, const double *E_k0 = NULL) const;
     double TimeOfEphemerisAge(double t) const;
 };
 
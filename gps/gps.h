@@ -152,7 +152,11 @@ void SearchParams(int argc, char *argv[]);
 #define PARITY 6
 
 void ChanTask(void *param);
-int  ChanReset(int sat, int codegen_init);
+int  ChanReset(int sat, int codegen_init, unsigned claimed = 0, bool e1b_download = true);
+int  ChanFree(unsigned claimed = 0);
+unsigned ChanOtherCode(bool isE1B);
+void ChanSearchPrep();
+void ChanE1BDownload();
 void ChanStart(int ch, int sat, int t_sample, int lo_shift, int ca_shift, int snr);
 bool ChanSnapshot(int ch, uint16_t wpos, int *p_sat, int *p_bits, int *p_bits_tow, float *p_pwr);
 void ChanRemove(sat_e type);
@@ -8,6 +8,27 @@
 unsigned char Partab[256];
 int P_init;
 
+enum cpu_mode Cpu_mode;
+
+/* Select the SIMD instruction set the decoders use.
+ * Only what the build targets is considered: SSE2 on x86_64 devsys. The NEON update is opt-in
+ * (define VITERBI27_NEON, Beagles built with -mfpu=neon) until tools/viterbi27_simd has been run
+ * on the target, otherwise the Beagles use the portable code.
+ * Setting Cpu_mode = PORT before the first create forces the portable code.
+ */
+//#define VITERBI27_NEON
+void find_cpu_mode(void){
+  if(Cpu_mode != UNKNOWN)
+    return;
+#if defined(__ARM_NEON) && defined(VITERBI27_NEON)
+  Cpu_mode = NEON;
+#elif defined(__SSE2__)
+  Cpu_mode = SSE2;
+#else
+  Cpu_mode = PORT;
+#endif
+}
+
 /* Create 256-entry odd-parity lookup table
  * Needed only on non-ia32 machines
  */
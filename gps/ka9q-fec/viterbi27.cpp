@@ -0,0 +1,59 @@
+/* K=7 r=1/2 Viterbi decoder with SIMD switch
+ * Copyright Feb 2004, Phil Karn, KA9Q
+ * May be used under the terms of the GNU Lesser General Public License (LGPL)
+ */
+#include <stdio.h>
+#include "fec.h"
+
+/* All versions share the portable decoder's state, only the update is vectorized */
+
+/* Create a new instance of a Viterbi decoder */
+void *create_viterbi27(int len){
+  find_cpu_mode();
+  return create_viterbi27_port(len);
+}
+
+void set_viterbi27_polynomial(int polys[2]){
+  set_viterbi27_polynomial_port(polys);
+}
+
+/* Initialize Viterbi decoder for start of new frame */
+int init_viterbi27(void *p,int starting_state){
+  return init_viterbi27_port(p,starting_state);
+}
+
+/* Viterbi chainback */
+int chainback_viterbi27(
+      void *p,
+      unsigned char *data, /* Decoded output data */
+      unsigned int nbits, /* Number of data bits */
+      unsigned int endstate){ /* Terminal encoder state */
+  return chainback_viterbi27_port(p,data,nbits,endstate);
+}
+
+/* Delete instance of a Viterbi decoder */
+void delete_viterbi27(void *p){
+  delete_viterbi27_port(p);
+}
+
+/* Update decoder with a block of demodulated symbols
+ * Note that nbits is the number of decoded data bits, not the number
+ * of symbols!
+ */
+int update_viterbi27_blk(void *p,unsigned char syms[],int nbits){
+  if(p == NULL)
+    return -1;
+
+  switch(Cpu_mode){
+#ifdef __ARM_NEON
+  case NEON:
+    return update_viterbi27_blk_neon(p,syms,nbits);
+#endif
+#if defined(__SSE2__) && !defined(__ARM_NEON)
+  case SSE2:
+    return update_viterbi27_blk_sse2(p,syms,nbits);
+#endif
+  default:
+    return update_viterbi27_blk_port(p,syms,nbits);
+  }
+}
@@ -8,6 +8,12 @@
 #include <limits.h>
 #include "fec.h"
 
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 
 typedef union { unsigned int w[64]; } metric_t;
 typedef union { unsigned long w[2];} decision_t;
@@ -189,3 +195,136 @@ int update_viterbi27_blk_port(void *p,unsigned char *syms,int nbits){
   vp->dp = d;
   return 0;
 }
+
+/* Vectorized butterflies, four states per 32-bit lane vector.
+ * These use the same struct v27, 32-bit metrics and arithmetic as BFLY() above
+ * so the path metrics and decisions are bit-exact with the portable version
+ * (checked by tools/viterbi27_simd.cpp). Only the update differs, init/chainback are shared.
+ */
+
+#if defined(__ARM_NEON)
+
+int update_viterbi27_blk_neon(void *p,unsigned char *syms,int nbits){
+  struct v27 *vp = (struct v27 *) p;
+  metric_t *tmp;
+  decision_t *d;
+  static const uint32_t w0[4] = { 1<<0, 1<<2, 1<<4, 1<<6 }, w1[4] = { 1<<1, 1<<3, 1<<5, 1<<7 };
+  const uint32x4_t wt0 = vld1q_u32(w0), wt1 = vld1q_u32(w1);
+  const uint32x4_t v510 = vdupq_n_u32(510);
+  const int32x4_t zero = vdupq_n_s32(0);
+
+  if(p == NULL)
+    return -1;
+  d = (decision_t *)vp->dp;
+  while(nbits--){
+    uint8x16_t s0 = vdupq_n_u8(*syms++);
+    uint8x16_t s1 = vdupq_n_u8(*syms++);
+    unsigned int *old = vp->old_metrics->w, *nw = vp->new_metrics->w;
+    unsigned int dw[2] = { 0, 0 };
+    int h,k;
+
+    for(h=0;h<2;h++){
+      /* branch metrics for states 16h .. 16h+15 */
+      uint8x16_t x0 = veorq_u8(vld1q_u8(&Branchtab27[0].c[16*h]), s0);
+      uint8x16_t x1 = veorq_u8(vld1q_u8(&Branchtab27[1].c[16*h]), s1);
+      uint16x8_t ml = vaddl_u8(vget_low_u8(x0), vget_low_u8(x1));
+      uint16x8_t mh = vaddl_u8(vget_high_u8(x0), vget_high_u8(x1));
+      uint32x4_t metric[4] = { vmovl_u16(vget_low_u16(ml)), vmovl_u16(vget_high_u16(ml)),
+                               vmovl_u16(vget_low_u16(mh)), vmovl_u16(vget_high_u16(mh)) };
+
+      for(k=0;k<4;k++){
+        int i = 16*h + 4*k;
+        uint32x4_t m0 = vaddq_u32(vld1q_u32(&old[i]), metric[k]);
+        uint32x4_t m1 = vaddq_u32(vld1q_u32(&old[i+32]), vsubq_u32(v510, metric[k]));
+        uint32x4_t d0 = vcgtq_s32(vreinterpretq_s32_u32(vsubq_u32(m0, m1)), zero);
+        uint32x4x2_t n;
+        n.val[0] = vbslq_u32(d0, m1, m0);
+
+        uint32x4_t t = vsubq_u32(vaddq_u32(metric[k], metric[k]), v510);
+        m0 = vsubq_u32(m0, t);
+        m1 = vaddq_u32(m1, t);
+        uint32x4_t d1 = vcgtq_s32(vreinterpretq_s32_u32(vsubq_u32(m0, m1)), zero);
+        n.val[1] = vbslq_u32(d1, m1, m0);
+        vst2q_u32(&nw[2*i], n);     /* interleaves to new[2i], new[2i+1] */
+
+        uint32x4_t b = vorrq_u32(vandq_u32(d0, wt0), vandq_u32(d1, wt1));
+        uint32x2_t b2 = vpadd_u32(vget_low_u32(b), vget_high_u32(b));
+        b2 = vpadd_u32(b2, b2);
+        dw[h] |= vget_lane_u32(b2, 0) << (8*k);
+      }
+    }
+    d->w[0] = dw[0];
+    d->w[1] = dw[1];
+    d++;
+    /* Swap pointers to old and new metrics */
+    tmp = vp->old_metrics;
+    vp->old_metrics = vp->new_metrics;
+    vp->new_metrics = tmp;
+  }
+  vp->dp = d;
+  return 0;
+}
+
+#elif defined(__SSE2__)
+
+int update_viterbi27_blk_sse2(void *p,unsigned char *syms,int nbits){
+  struct v27 *vp = (struct v27 *) p;
+  metric_t *tmp;
+  decision_t *d;
+  const __m128i v510 = _mm_set1_epi32(510);
+  const __m128i zero = _mm_setzero_si128();
+
+  if(p == NULL)
+    return -1;
+  d = (decision_t *)vp->dp;
+  while(nbits--){
+    __m128i s0 = _mm_set1_epi8(*syms++);
+    __m128i s1 = _mm_set1_epi8(*syms++);
+    unsigned int *old = vp->old_metrics->w, *nw = vp->new_metrics->w;
+    unsigned int dw[2] = { 0, 0 };
+    int h,k;
+
+    for(h=0;h<2;h++){
+      /* branch metrics for states 16h .. 16h+15 */
+      __m128i x0 = _mm_xor_si128(_mm_load_si128((__m128i *) &Branchtab27[0].c[16*h]), s0);
+      __m128i x1 = _mm_xor_si128(_mm_load_si128((__m128i *) &Branchtab27[1].c[16*h]), s1);
+      __m128i ml = _mm_add_epi16(_mm_unpacklo_epi8(x0, zero), _mm_unpacklo_epi8(x1, zero));
+      __m128i mh = _mm_add_epi16(_mm_unpackhi_epi8(x0, zero), _mm_unpackhi_epi8(x1, zero));
+      __m128i metric[4] = { _mm_unpacklo_epi16(ml, zero), _mm_unpackhi_epi16(ml, zero),
+                            _mm_unpacklo_epi16(mh, zero), _mm_unpackhi_epi16(mh, zero) };
+
+      for(k=0;k<4;k++){
+        int i = 16*h + 4*k;
+        __m128i m0 = _mm_add_epi32(_mm_loadu_si128((__m128i *) &old[i]), metric[k]);
+        __m128i m1 = _mm_add_epi32(_mm_loadu_si128((__m128i *) &old[i+32]), _mm_sub_epi32(v510, metric[k]));
+        __m128i d0 = _mm_cmpgt_epi32(_mm_sub_epi32(m0, m1), zero);
+        __m128i n0 = _mm_or_si128(_mm_and_si128(d0, m1), _mm_andnot_si128(d0, m0));
+
+        __m128i t = _mm_sub_epi32(_mm_add_epi32(metric[k], metric[k]), v510);
+        m0 = _mm_sub_epi32(m0, t);
+        m1 = _mm_add_epi32(m1, t);
+        __m128i d1 = _mm_cmpgt_epi32(_mm_sub_epi32(m0, m1), zero);
+        __m128i n1 = _mm_or_si128(_mm_and_si128(d1, m1), _mm_andnot_si128(d1, m0));
+
+        /* interleave to new[2i], new[2i+1] */
+        _mm_storeu_si128((__m128i *) &nw[2*i], _mm_unpacklo_epi32(n0, n1));
+        _mm_storeu_si128((__m128i *) &nw[2*i+4], _mm_unpackhi_epi32(n0, n1));
+
+        unsigned int b = _mm_movemask_ps(_mm_castsi128_ps(_mm_unpacklo_epi32(d0, d1))) |
+                         (_mm_movemask_ps(_mm_castsi128_ps(_mm_unpackhi_epi32(d0, d1))) << 4);
+        dw[h] |= b << (8*k);
+      }
+    }
+    d->w[0] = dw[0];
+    d->w[1] = dw[1];
+    d++;
+    /* Swap pointers to old and new metrics */
+    tmp = vp->old_metrics;
+    vp->old_metrics = vp->new_metrics;
+    vp->new_metrics = tmp;
+  }
+  vp->dp = d;
+  return 0;
+}
+
+#endif
@@ -56,6 +56,24 @@ static fftwf_complex code[MAX_SATS][2*FFT_LEN] __attribute__ ((aligned (16)));
 static fftwf_complex fwd_buf[NSAMPLES + 2*NTAPS] __attribute__ ((aligned (16)));
 static fftwf_complex rev_buf[FFT_LEN]  __attribute__ ((aligned (16)));
 
+// Pruned-output correlator.
+// Only the first code period of the inverse FFT output is examined, which for the 1 msec L1 C/A code
+// is 1/4 of the 4 msec FFT. Splitting the product spectrum into its 4 decimated sub-sequences (k mod 4)
+// gives 4 quarter-length inverse FFTs whose outputs are combined with twiddles:
+//     x[n] = sum(r=0..3) e^(+j*2*pi*r*n/FFT_LEN) * IFFT_M(prod[4m+r])[n],  n < M = FFT_LEN/4
+// The result is the same as the full inverse FFT (to float rounding) but only the needed outputs are
+// computed and the quarter-length transforms fit in the Beagle's L1 cache.
+// E1B (4 msec code period) needs all the outputs and uses the full inverse FFT.
+#define CORR_PRUNED
+#define CORR_SPLIT  4
+#define CORR_M      (FFT_LEN/CORR_SPLIT)
+
+#ifdef CORR_PRUNED
+    static fftwf_plan rev_plan_split;
+    static fftwf_complex rev_split[FFT_LEN] __attribute__ ((aligned (16)));
+    static fftwf_complex corr_twiddle[CORR_SPLIT-1][CORR_M] __attribute__ ((aligned (16)));
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
 static float inline Bipolar(int bit) {
@@ -239,6 +257,23 @@ void SearchInit() {
     fwd_plan = fftwf_plan_dft_1d(FFT_LEN, fwd_buf, fwd_buf, FFTW_FORWARD,  FFTW_ESTIMATE);
     rev_plan = fftwf_plan_dft_1d(FFT_LEN, rev_buf, rev_buf, FFTW_BACKWARD, FFTW_ESTIMATE);
 
+    #ifdef CORR_PRUNED
+        assert((FFT_LEN % CORR_SPLIT) == 0);
+        int corr_m = CORR_M;
+        rev_plan_split = fftwf_plan_many_dft(1, &corr_m, CORR_SPLIT,
+            rev_buf, NULL, CORR_SPLIT, 1,       // input: prod[CORR_SPLIT*m + r]
+            rev_split, NULL, 1, CORR_M,         // output: CORR_SPLIT consecutive sub-transforms
+            FFTW_BACKWARD, FFTW_ESTIMATE);
+
+        for (int r=1; r < CORR_SPLIT; r++) {
+            for (int n=0; n < CORR_M; n++) {
+                double ph = K_2PI * r * n / FFT_LEN;
+                corr_twiddle[r-1][n][0] = cos(ph);
+                corr_twiddle[r-1][n][1] = sin(ph);
+            }
+        }
+    #endif
+
     for (sp = Sats; sp->prn != -1; sp++) {
         if (sp->type != Navstar && sp->type != QZSS) continue;
         int T1 = sp->T1, T2 = sp->T2;
@@ -353,6 +388,9 @@ void SearchInit() {
 void SearchFree() {
     fftwf_destroy_plan(fwd_plan);
     fftwf_destroy_plan(rev_plan);
+    #ifdef CORR_PRUNED
+        fftwf_destroy_plan(rev_plan_split);
+    #endif
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
@@ -360,12 +398,16 @@ void SearchFree() {
 //#define GPS_SAMPLES_FROM_FILE
 #ifdef GPS_SAMPLES_FROM_FILE
 
+#ifndef GPS_SAMPLES_FN
+    #define GPS_SAMPLES_FN "../samples/SiGe_Bands-L1.fs.16368.if.4092.rs81p.dat"
+#endif
+
 void GenSamples(char *rbuf, int bytes) {
 	int i, j;
 	static int rfd;
 
 	if (!rfd) {
-		rfd = open("../samples/SiGe_Bands-L1.fs.16368.if.4092.rs81p.dat", O_RDONLY);
+		rfd = open(GPS_SAMPLES_FN, O_RDONLY);
 		assert(rfd > 0);
 	}
 
@@ -448,11 +490,17 @@ static void Sample() {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
-static float Correlate(int sat, const fftwf_complex *data, int *max_snr_dop, int *max_snr_i) {
+static float Correlate(int sat, const fftwf_complex *data, int *max_snr_dop, int *max_snr_i, bool pruned = true) {
     fftwf_complex *prod = rev_buf;
     float max_snr=0;
     int code_period_ms = is_E1B(sat)? E1B_CODE_PERIOD : L1_CODE_PERIOD;
-    int i;
+    int i, nout = SAMPLE_RATE/1000*code_period_ms;
+    
+    #ifdef CORR_PRUNED
+        pruned = pruned && (nout <= CORR_M);
+    #else
+        pruned = false;
+    #endif
     
     // see paper about baseband FFT symmetry (since input from GPS FE is a real signal)
     // this simulates throwing away the upper 1/2 of the FFT so subsequent FFT
@@ -476,16 +524,42 @@ static float Correlate(int sat, const fftwf_complex *data, int *max_snr_dop, int
 		#endif
         NextTaskP("corr FFT LONG RUN", NT_LONG_RUN);
         //u4_t us = timer_us();
-		fftwf_execute(rev_plan);
+        #ifdef CORR_PRUNED
+            if (pruned) {
+                fftwf_execute(rev_plan_split);
+                NextTask("corr FFT end");
+
+                static_assert(CORR_SPLIT == 4, "combining loop below is unrolled for CORR_SPLIT == 4");
+                const fftwf_complex *y0 = rev_split, *y1 = y0 + CORR_M, *y2 = y1 + CORR_M, *y3 = y2 + CORR_M;
+                const fftwf_complex *w1 = corr_twiddle[0], *w2 = corr_twiddle[1], *w3 = corr_twiddle[2];
+
+                for (i=0; i < nout; i++) {		// 1 msec of samples
+                    const float re = y0[i][0]
+                        + w1[i][0]*y1[i][0] - w1[i][1]*y1[i][1]
+                        + w2[i][0]*y2[i][0] - w2[i][1]*y2[i][1]
+                        + w3[i][0]*y3[i][0] - w3[i][1]*y3[i][1];
+                    const float im = y0[i][1]
+                        + w1[i][0]*y1[i][1] + w1[i][1]*y1[i][0]
+                        + w2[i][0]*y2[i][1] + w2[i][1]*y2[i][0]
+                        + w3[i][0]*y3[i][1] + w3[i][1]*y3[i][0];
+                    const float pwr = re*re + im*im;
+                    if (pwr>max_pwr) max_pwr=pwr, max_pwr_i=i;
+                    tot_pwr += pwr;
+                }
+            } else
+        #endif
+        {
+		    fftwf_execute(rev_plan);
+            NextTask("corr FFT end");
+
+            for (i=0; i < nout; i++) {		// 1 msec of samples
+                const float pwr = prod[i][0]*prod[i][0] + prod[i][1]*prod[i][1];
+                if (pwr>max_pwr) max_pwr=pwr, max_pwr_i=i;
+                tot_pwr += pwr;
+            }
+        }
         //u4_t us2 = timer_us();
-        NextTask("corr FFT end");
         //printf("Correlate FFT %.1f msec\n", (float)(us2-us)/1e3);
-
-        for (i=0; i < SAMPLE_RATE/1000*code_period_ms; i++) {		// 1 msec of samples
-            const float pwr = prod[i][0]*prod[i][0] + prod[i][1]*prod[i][1];
-            if (pwr>max_pwr) max_pwr=pwr, max_pwr_i=i;
-            tot_pwr += pwr;
-        }
         NextTask("corr pwr");
 
         const float ave_pwr = tot_pwr/i;
@@ -496,6 +570,35 @@ static float Correlate(int sat, const fftwf_complex *data, int *max_snr_dop, int
     return max_snr;
 }
 
+#ifdef GPS_SAMPLES_FROM_FILE
+
+// Compare the full and pruned correlators on the same sample.
+// Reports the seconds per PRN of each and any difference in the results.
+static void CorrelateBench(int sat, const fftwf_complex *data) {
+    static int n_prn, n_diff;
+    static double secs_full, secs_pruned;
+    int dop_f = 0, i_f = 0, dop_p = 0, i_p = 0;    // not set if max_snr is never improved on
+    
+    u4_t us = timer_us();
+    float snr_f = Correlate(sat, data, &dop_f, &i_f, false);
+    u4_t us2 = timer_us();
+    float snr_p = Correlate(sat, data, &dop_p, &i_p, true);
+    u4_t us3 = timer_us();
+    
+    n_prn++;
+    secs_full += (us2 - us) / 1e6;
+    secs_pruned += (us3 - us2) / 1e6;
+    bool diff = (dop_f != dop_p || i_f != i_p || fabsf(snr_f - snr_p) > snr_f * 1e-3);
+    if (diff) n_diff++;
+    
+    printf("CORR %s full %.3f pruned %.3f sec/PRN (avg %.3f %.3f, %d PRNs) snr %.1f/%.1f dop %d/%d ca %d/%d %s\n",
+        PRN(sat), (us2 - us) / 1e6, (us3 - us2) / 1e6, secs_full / n_prn, secs_pruned / n_prn, n_prn,
+        snr_f, snr_p, dop_f, dop_p, i_f, i_p, diff? "DIFFERENT" : "same");
+    if (diff) printf("CORR %d/%d PRNs with different results\n", n_diff, n_prn);
+}
+
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
 
@@ -507,10 +610,67 @@ void SearchEnable(int sat) {
 
 static int searchTaskID = -1;
 
+// Candidates are correlated against a single sample for at most this long.
+// The code phase found is relative to the sample time and the code creep correction
+// ChanStart() applies for the delay is only as good as the +/- BIN_SIZE/2 Doppler estimate.
+#define SEARCH_MAX_AGE_US   2000000
+
+struct search_t {
+    int sat, ch, lo_shift, ca_shift;
+    float snr;
+};
+
+static int search_snr_cmp(const void *a, const void *b) {
+    float d = ((search_t *) b)->snr - ((search_t *) a)->snr;
+    return (d > 0) - (d < 0);
+}
+
+static bool search_enabled(SATELLITE *sp) {
+    if (sp->type == Navstar && !gps.acq_Navstar) return false;
+    if (sp->type == QZSS && !gps.acq_QZSS) return false;
+    if (sp->type == E1B && !gps.acq_Galileo) return false;
+
+    //jks2
+    if (gps_debug > 0 && sp->prn != gps_debug) return false;    //jks2
+    if (gps_debug) if (sp->type == E1B) return false;
+    if (gps_e1b_only && sp->type != E1B) return false;
+    //if (sp->type != Navstar) return false;
+    //if (sp->type != E1B) return false;
+    //if (sp->prn != 14) return false;
+    return true;
+}
+
+static int search_codegen_init(SATELLITE *sp) {
+    switch (sp->type) {
+        case Navstar: default: return (sp->T1<<4) + sp->T2;
+        case QZSS: return G2_INIT | sp->T2;
+        case E1B: return E1B_MODE | (sp->prn-1);
+    }
+}
+
+static int search_min_sig(int sat) {
+    //jks2
+    return is_E1B(sat)? 16 : minimum_sig;
+}
+
+// One sample (and its forward FFT) is correlated against every idle sat, then the detected sats
+// are started on free channels in SNR order.
+//
+// The sampler reset restarts the code generators of all free channels (see gps.v) so a channel
+// can be assigned to a sat after the correlation, with these exceptions:
+//  QZSS: the G2 initial state is loaded by the reset, so QZSS candidates get their channel before sampling.
+//  Code length: C/A or E1B is only loaded by CmdSetSat, so a sat is only assigned after sampling to a
+//      channel whose code length already matches. If no free channel has it the first candidate of
+//      that type gets a channel before sampling (as QZSS), converting one channel per round.
+//  E1B: the code table BRAM write address is zeroed by the reset, so all E1B channels started
+//      from one sample share a single code table download.
+
 void SearchTask(void *param) {
-    int i, us, ret, ch, last_ch=-1, sat, t_sample, min_sig, lo_shift=0, ca_shift=0;
+    int i, us, ch, last_ch=-1, sat, t_sample, n_sats, next=0;
+    bool last_found = true;
     SATELLITE *sp;
-    float snr=0;
+    search_t *s;
+    static search_t found[MAX_SATS];
     
     TaskSleepSec(20);   // jks2 TEMP due to printf/log shared memory malloc/free crash problem
 
@@ -518,6 +678,9 @@ void SearchTask(void *param) {
 
     GPSstat(STAT_PARAMS, 0, DECIM, minimum_sig);
 	GPSstat(STAT_ACQUIRE, 0, 1);
+	
+	for (n_sats = 0; Sats[n_sats].prn != -1; n_sats++)
+	    ;
 
     for(;;) {
         if (!gps.acq_Navstar && !gps.acq_QZSS && !gps.acq_Galileo) {
@@ -525,79 +688,118 @@ void SearchTask(void *param) {
             continue;
         }
         
-        for (sp = Sats; sp->prn != -1; sp++) {
-            sat = sp->sat;
-
-            if (sp->type == Navstar && !gps.acq_Navstar) continue;
-            if (sp->type == QZSS && !gps.acq_QZSS) continue;
-            if (sp->type == E1B && !gps.acq_Galileo) continue;
-
-            //jks2
-            if (gps_debug > 0 && sp->prn != gps_debug) continue;    //jks2
-            if (gps_debug) if (sp->type == E1B) continue;
-            if (gps_e1b_only && sp->type != E1B) continue;
-            //if (sp->type != Navstar) continue;
-            //if (sp->type != E1B) continue;
-            //if (sp->prn != 14) continue;
-            //if (sp->prn != 14 && sp->prn != 30) continue;
-            //if (sp->prn != 11 && sp->prn != 12) continue;
-            //if (sp->prn != 11) continue;
-            
-            //jks2
-            min_sig = (sp->type == E1B)? 16 : minimum_sig;
-
-            if (sp->busy) {     // sat already acquired?
-            	NextTask("busy1");		// let cpu run
-                continue;
-            }
-
-            int T1 = sp->T1, T2 = sp->T2;
-            int codegen_init;
-            
-            switch (sp->type) {
-                case Navstar: default: codegen_init = (T1<<4) + T2; break;
-                case QZSS: codegen_init = G2_INIT | T2; break;
-                case E1B: codegen_init = E1B_MODE | (sp->prn-1); break;
-            }
-
-            if ((ch = ChanReset(sat, codegen_init)) < 0) {      // all channels busy?
-                continue;
+        // channel whose status display shows the search, also checks all channels busy
+        if ((ch = ChanFree()) < 0) {
+            NextTask("busy1");		// let cpu run
+            continue;
+        }
+        
+        if ((last_ch != ch) && !last_found) GPSstat(STAT_SAT, 0, last_ch, -1, 0, 0);
+        last_ch = ch;
+        last_found = false;
+
+        // Candidate list starts where the last round left off if it ran out of time.
+        // QZSS candidates go first since they hold a channel.
+        unsigned claimed = 0;
+        int ncand = 0;
+        bool converted[2] = { false, false };
+        for (int qzss = 1; qzss >= 0; qzss--) {
+            for (i = 0; i < n_sats; i++) {
+                sp = &Sats[(next + i) % n_sats];
+                if ((sp->type == QZSS) != qzss || sp->busy || !search_enabled(sp)) continue;
+                s = &found[ncand];
+                s->sat = sp->sat;
+                s->ch = -1;
+                s->snr = 0;
+                bool e1b = (sp->type == E1B);
+
+                if (sp->type == QZSS ||
+                    (!converted[e1b] && ChanFree(claimed | ChanOtherCode(e1b)) < 0)) {
+                    if ((s->ch = ChanReset(s->sat, search_codegen_init(sp), claimed)) < 0)
+                        continue;
+                    claimed |= 1 << s->ch;
+                    if (sp->type != QZSS) converted[e1b] = true;
+                }
+                ncand++;
             }
-			
-			if ((last_ch != ch) && (snr < min_sig)) GPSstat(STAT_SAT, 0, last_ch, -1, 0, 0);
-
-            us = t_sample = timer_us(); // sample time
-            Sample();
+        }
+        
+        if (ncand == 0) {
+            NextTask("busy2");
+            continue;
+        }
 
-			snr = Correlate(sat, fwd_buf, &lo_shift, &ca_shift);
-			ca_shift *= DECIM;
-            
+        ChanSearchPrep();
+        t_sample = timer_us(); // sample time
+        Sample();
+
+        int ndone;
+        for (ndone = 0; ndone < ncand;) {
+            s = &found[ndone++];
+            sat = s->sat;
+            #ifdef GPS_SAMPLES_FROM_FILE
+                if (test_mode) CorrelateBench(sat, fwd_buf);
+            #endif
+
+            us = timer_us();
+			s->snr = Correlate(sat, fwd_buf, &s->lo_shift, &s->ca_shift);
+			s->ca_shift *= DECIM;
             us = timer_us()-us;
-            //printf("Correlate %s %.3f secs snr=%.0f\n", PRN(sat), (float)us/1000000.0, snr);
+            //printf("Correlate %s %.3f secs snr=%.0f\n", PRN(sat), (float)us/1000000.0, s->snr);
 
-            GPSstat(STAT_SAT, snr, ch, sat, snr < min_sig, us);
-            last_ch = ch;
+            GPSstat(STAT_SAT, s->snr, last_ch, sat, s->snr < search_min_sig(sat), us);
 
 //#define GPS_SEARCH_ONLY
 #if defined(GPS_SEARCH_ONLY) || defined(GPS_SAMPLES_FROM_FILE)
-            if (snr >= min_sig)
+            if (s->snr >= search_min_sig(sat))
 			printf("ch%02d %s decim=%d pow2=%d %.3f sec lo_shift %5d ca_shift %5d snr %5.1f%c \n",
-			    ch+1, PRN(sat), DECIM, GPS_FFT_POW2, (float) us/1e6, (int) (lo_shift*BIN_SIZE), ca_shift, snr, (snr < 16)? '.':'*');
-			continue;
+			    last_ch+1, PRN(sat), DECIM, GPS_FFT_POW2, (float) us/1e6, (int) (s->lo_shift*BIN_SIZE), s->ca_shift, s->snr,
+			    (s->snr < 16)? '.':'*');
+			s->snr = 0;
 #endif
 
-            if (snr < min_sig) {
-                continue;
+            if ((int) (timer_us() - t_sample) > SEARCH_MAX_AGE_US) break;
+        }
+        
+        // continue with the next sat if not all of them were correlated
+        next = (ndone < ncand)? (found[ndone-1].sat + 1) % n_sats : 0;
+
+        // undetected sats assigned before sampling give up their channel
+        for (i = 0; i < ndone; i++) {
+            s = &found[i];
+            if (s->ch >= 0 && s->snr < search_min_sig(s->sat)) claimed &= ~(1 << s->ch);
+        }
+
+        qsort(found, ndone, sizeof(search_t), search_snr_cmp);
+
+        int nstart = 0;
+        bool e1b = false;
+        for (i = 0; i < ndone; i++) {
+            s = &found[i];
+            sat = s->sat;
+            if (s->snr < search_min_sig(sat)) break;
+
+            if (s->ch < 0) {
+                if ((s->ch = ChanReset(sat, search_codegen_init(&Sats[sat]), claimed | ChanOtherCode(is_E1B(sat)), false)) < 0)
+                    continue;   // all channels busy, reserved or with the other code length
+                claimed |= 1 << s->ch;
+                if (is_E1B(sat)) e1b = true;
             }
-            
-            GPSstat(STAT_DOP, 0, ch, lo_shift*BIN_SIZE, ca_shift);
+            found[nstart++] = *s;
+        }
+        
+        if (e1b) ChanE1BDownload();
 
-            sp->busy = true;
+        for (i = 0; i < nstart; i++) {
+            s = &found[i];
+            GPSstat(STAT_DOP, 0, s->ch, s->lo_shift*BIN_SIZE, s->ca_shift);
+            Sats[s->sat].busy = true;
+            if (s->ch == last_ch) last_found = true;
 
-			//printf("ChanStart ch%02d %s snr=%.0f init=0x%x lo_shift=%d ca_shift=%d\n",
-			//    ch+1, PRN(sat), snr, init, (int) (lo_shift*BIN_SIZE), ca_shift);
-            ChanStart(ch, sat, t_sample, lo_shift, ca_shift, (int) snr);
-    	}
+			//printf("ChanStart ch%02d %s snr=%.0f lo_shift=%d ca_shift=%d\n",
+			//    s->ch+1, PRN(s->sat), s->snr, (int) (s->lo_shift*BIN_SIZE), s->ca_shift);
+            ChanStart(s->ch, s->sat, t_sample, s->lo_shift, s->ca_shift, (int) s->snr);
+        }
 	}
 }
 
@@ -37,6 +37,9 @@
 // user-equivalen range error (m)
 #define UERE 6.0
 
+// Log the solver input of each epoch in the format read by gps_test.cpp and tools/gps_replay.cpp
+//#define GPS_SOLVE_LOG
+
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
 struct SNAPSHOT {
@@ -227,7 +230,7 @@ class GNSSDataForEpoch {
 public:
     typedef PosSolver::vec_type vec_type;
     typedef PosSolver::mat_type mat_type;
-    typedef TNT::Array1D<int>  ivec_type;
+    typedef PosSolver::ivec_type ivec_type;
 
     GNSSDataForEpoch(int max_channels)
         : _chans(0)
@@ -255,44 +258,41 @@ public:
         return bitmap;
     }
 
+    // columns of sv() whose satellite type satisfies pred
     template<typename PRED>
-    vec_type weight(PRED const& pred) const {
-        if (!_chans)
-            return PosSolver::vec_type();
-        vec_type weight_filtered = weight().copy();
-        int i_filtered=0;
+    ivec_type index(PRED const& pred) const {
+        ivec_type idx(_chans);
+        int n=0;
         for (int i=0; i<_chans; ++i) {
-            if (!pred(type(i)))
-                continue;
-            weight_filtered[i_filtered] = _weight[i];
-            ++i_filtered;
+            if (pred(type(i)))
+                idx[n++] = i;
         }
-        if (!i_filtered)
-            return PosSolver::vec_type();
-        return weight_filtered.subarray(0,i_filtered-1).copy();
+        return n ? idx.subarray(0,n-1).copy() : ivec_type();
     }
-    template<typename PRED>
-    mat_type sv(PRED const& pred) const {
-        if (!_chans)
+    vec_type weight(ivec_type const& idx) const {
+        vec_type weight_filtered(idx.dim());
+        for (int i=0; i<idx.dim(); ++i)
+            weight_filtered[i] = _weight[idx[i]];
+        return weight_filtered;
+    }
+    mat_type sv(ivec_type const& idx) const {
+        if (!idx.dim())
             return PosSolver::mat_type();
-        mat_type sv_filtered = sv().copy();
-        int i_filtered=0;
-        for (int i=0; i<_chans; ++i) {
-            if (!pred(type(i)))
-                continue;
+        mat_type sv_filtered(4, idx.dim());
+        for (int i=0; i<idx.dim(); ++i) {
             for (int j=0; j<4; ++j)
-                sv_filtered[j][i_filtered] = _sv[j][i];
-            ++i_filtered;
+                sv_filtered[j][i] = _sv[j][idx[i]];
         }
-        if (!i_filtered)
-            return PosSolver::mat_type();
-        return sv_filtered.subarray(0,3,0,i_filtered-1).copy();
+        return sv_filtered;
     }
 
     bool LoadFromReplicas(int chans, const SNAPSHOT* replicas, u64_t adc_ticks) {
         clear();
         _adc_ticks = adc_ticks;
         _chans     = 0;
+        #ifdef GPS_SOLVE_LOG
+            printf("GNSS_start %llu\n", adc_ticks);
+        #endif
         for (int i=0; i<chans; ++i) {
             NextTask("solve1");
 
@@ -309,7 +309,9 @@ public:
                 continue;
 
             // apply clock correction
-            t_tx -= replicas[i].eph.GetClockCorrection(t_tx);
+            // (its eccentric anomaly seeds the one for the SV position a few msec later)
+            double E_k;
+            t_tx -= replicas[i].eph.GetClockCorrection(t_tx, &E_k);
             _sv[3][_chans] = C*t_tx; // [s] -> [m]
             
             double t_k = replicas[i].eph.TimeOfEphemerisAge(t_tx);
@@ -324,14 +326,22 @@ public:
             replicas[i].eph.GetXYZ(&_sv[0][_chans],
                                    &_sv[1][_chans],
                                    &_sv[2][_chans],
-                                   t_tx);
+                                   t_tx, &E_k);
+
+            _sat[_chans]  = replicas[i].sat;
+            _ch[_chans]   = replicas[i].ch;
+            _prn[_chans]  = Sats[_sat[_chans]].prn;
+            _type[_chans] = Sats[_sat[_chans]].type;
 
-            _sat[_chans]  = Replicas[i].sat;
-            _ch[_chans]   = Replicas[i].ch;
-            _prn[_chans]  = Sats[_sat[i]].prn;
-            _type[_chans] = Sats[_sat[i]].type;
+            #ifdef GPS_SOLVE_LOG
+                printf("GNSS_sat %s %.3f %.3f %.3f %.12f %.0f\n", PRN(_sat[_chans]),
+                    _sv[0][_chans], _sv[1][_chans], _sv[2][_chans], t_tx, _weight[_chans]);
+            #endif
             _chans       += 1;
         }
+        #ifdef GPS_SOLVE_LOG
+            printf("GNSS_end\n");
+        #endif
         return (_chans > 0);
     }
 protected:
@@ -595,13 +605,19 @@ void SolveTask(void *param) {
 
             if (plot_E1B) {
                 // make separate position solutions for Galileo and ~Galileo stats
-                posSolvers[1]->solve(gnssDataForEpoch.sv(predNotGalileo),
-                                     gnssDataForEpoch.weight(predNotGalileo),
-                                     gnssDataForEpoch.adc_ticks());
+                // starting from the all satellite solution's linearization
+                const auto idxNotGalileo  = gnssDataForEpoch.index(predNotGalileo);
+                const auto idxOnlyGalileo = gnssDataForEpoch.index(predOnlyGalileo);
+
+                posSolvers[1]->solve(gnssDataForEpoch.sv(idxNotGalileo),
+                                     gnssDataForEpoch.weight(idxNotGalileo),
+                                     gnssDataForEpoch.adc_ticks(),
+                                     *posSolvers[0], idxNotGalileo);
                 
-                posSolvers[2]->solve(gnssDataForEpoch.sv(predOnlyGalileo),
-                                     gnssDataForEpoch.weight(predOnlyGalileo),
-                                     gnssDataForEpoch.adc_ticks());
+                posSolvers[2]->solve(gnssDataForEpoch.sv(idxOnlyGalileo),
+                                     gnssDataForEpoch.weight(idxOnlyGalileo),
+                                     gnssDataForEpoch.adc_ticks(),
+                                     *posSolvers[0], idxOnlyGalileo);
             }
         }
 
@@ -217,6 +217,163 @@ void _cfg_release(cfg_t *cfg)
 	    kiwi_free("json buf", cfg->json);
 	}
 	cfg->json = NULL;
+	if (cfg->hash) {
+	    kiwi_free("cfg hash", cfg->hash);
+	}
+	cfg->hash = NULL;
+}
+
+// Hash index from key path to token so lookups don't scan the whole token array.
+// Rebuilt after every parse (which all the _cfg_set_* functions do after editing the JSON).
+// Matches the linear lookups it replaces:
+//   "id" is the first key "id" anywhere in the document (_cfg_lookup_id)
+//   "id1.id2" is key id2 directly inside the object value of a key id1, the last one if
+//   there are several (_cfg_walk with _cfg_lookup_json_cb)
+
+#define CFG_HASH_INIT	2166136261U		// FNV-1a
+#define CFG_HASH_EMPTY	-1
+
+static u4_t cfg_hash_str(u4_t h, const char *s, int n)
+{
+	for (int i = 0; i < n; i++) {
+		h ^= (u1_t) s[i];
+		h *= 16777619;
+	}
+	return h;
+}
+
+static u4_t cfg_hash_tok(cfg_t *cfg, u4_t h, int tok)
+{
+	jsmntok_t *jt = &cfg->tokens[tok];
+	return cfg_hash_str(h, &cfg->json[jt->start], jt->end - jt->start);
+}
+
+static bool cfg_tok_eq(cfg_t *cfg, int tok, const char *s, int n)
+{
+	jsmntok_t *jt = &cfg->tokens[tok];
+	return (jt->end - jt->start == n && strncmp(&cfg->json[jt->start], s, n) == 0);
+}
+
+static void cfg_hash_alloc(cfg_hash_t **hash, u4_t size)
+{
+	*hash = (cfg_hash_t *) kiwi_malloc("cfg hash", sizeof(cfg_hash_t) * size);
+	for (u4_t i = 0; i < size; i++)
+		(*hash)[i].key = CFG_HASH_EMPTY;
+}
+
+static void cfg_hash_insert(cfg_t *cfg, cfg_hash_t **hash, u4_t *size, u4_t *used, int parent, int key, bool replace)
+{
+	u4_t i, mask;
+
+	if ((*used + 1) * 2 > *size) {
+		cfg_hash_t *old = *hash;
+		u4_t old_size = *size;
+		*size *= 2;
+		cfg_hash_alloc(hash, *size);
+		mask = *size - 1;
+		for (u4_t j = 0; j < old_size; j++) {
+			if (old[j].key == CFG_HASH_EMPTY) continue;
+			for (i = old[j].hash & mask; (*hash)[i].key != CFG_HASH_EMPTY; i = (i+1) & mask)
+				;
+			(*hash)[i] = old[j];
+		}
+		kiwi_free("cfg hash", old);
+	}
+
+	u4_t h = CFG_HASH_INIT;
+	if (parent >= 0) {
+		h = cfg_hash_tok(cfg, h, parent);
+		h = cfg_hash_str(h, ".", 1);
+	}
+	h = cfg_hash_tok(cfg, h, key);
+	
+	jsmntok_t *kt = &cfg->tokens[key], *pt = (parent >= 0)? &cfg->tokens[parent] : NULL;
+	mask = *size - 1;
+	for (i = h & mask; (*hash)[i].key != CFG_HASH_EMPTY; i = (i+1) & mask) {
+		cfg_hash_t *e = &(*hash)[i];
+		if (e->hash != h || (e->parent >= 0) != (parent >= 0)) continue;
+		if (!cfg_tok_eq(cfg, e->key, &cfg->json[kt->start], kt->end - kt->start)) continue;
+		if (parent >= 0 && !cfg_tok_eq(cfg, e->parent, &cfg->json[pt->start], pt->end - pt->start)) continue;
+		if (replace) {
+			e->key = key;
+			e->parent = parent;
+		}
+		return;
+	}
+	
+	(*hash)[i].hash = h;
+	(*hash)[i].key = key;
+	(*hash)[i].parent = parent;
+	(*used)++;
+}
+
+static void _cfg_hash_build(cfg_t *cfg, bool yield)
+{
+	#define CFG_HASH_LVL 32
+	struct { int rem, key; } stk[CFG_HASH_LVL];
+	int i, lvl = 0;
+	cfg_hash_t *hash;
+	u4_t size = 64, used = 0;
+	
+	// built on the side and swapped in at the end since we may yield
+	cfg_hash_alloc(&hash, size);
+
+	for (i = 0; i < cfg->ntok; i++) {
+		jsmntok_t *jt = &cfg->tokens[i];
+		if (yield && (i & 0xfff) == 0) NextTask("cfg hash");
+		
+		if (JSMN_IS_ID(jt)) {
+			cfg_hash_insert(cfg, &hash, &size, &used, -1, i, false);
+			if (lvl && stk[lvl].key >= 0)
+				cfg_hash_insert(cfg, &hash, &size, &used, stk[lvl].key, i, true);
+		} else
+		if (lvl) {
+			stk[lvl].rem--;
+		}
+		
+		if (JSMN_IS_OBJECT(jt) || JSMN_IS_ARRAY(jt)) {
+			if (++lvl == CFG_HASH_LVL) {
+				// too deep, lookups fall back to the linear scan
+				kiwi_free("cfg hash", hash);
+				hash = NULL;
+				size = used = 0;
+				break;
+			}
+			stk[lvl].rem = jt->size;
+			stk[lvl].key = (JSMN_IS_OBJECT(jt) && i && JSMN_IS_ID(jt-1))? i-1 : -1;
+		}
+		
+		while (lvl && stk[lvl].rem == 0)
+			lvl--;
+	}
+	
+	cfg->hash = hash;
+	cfg->hash_size = size;
+	cfg->hash_used = used;
+}
+
+static jsmntok_t *_cfg_hash_lookup(cfg_t *cfg, const char *id1, int n1, const char *id2, int n2)
+{
+	u4_t h = cfg_hash_str(CFG_HASH_INIT, id1, n1);
+	if (id2) {
+		h = cfg_hash_str(h, ".", 1);
+		h = cfg_hash_str(h, id2, n2);
+	}
+
+	u4_t i, mask = cfg->hash_size - 1;
+	for (i = h & mask; cfg->hash[i].key != CFG_HASH_EMPTY; i = (i+1) & mask) {
+		cfg_hash_t *e = &cfg->hash[i];
+		if (e->hash != h) continue;
+		if (id2) {
+			if (e->parent >= 0 && cfg_tok_eq(cfg, e->parent, id1, n1) && cfg_tok_eq(cfg, e->key, id2, n2))
+				return &cfg->tokens[e->key + 1];
+		} else {
+			if (e->parent < 0 && cfg_tok_eq(cfg, e->key, id1, n1))
+				return &cfg->tokens[e->key + 1];
+		}
+	}
+	
+	return NULL;
 }
 
 static jsmntok_t *_cfg_lookup_id(cfg_t *cfg, jsmntok_t *jt_start, const char *id)
@@ -269,6 +426,27 @@ jsmntok_t *_cfg_lookup_json(cfg_t *cfg, const char *id, cfg_lookup_e option)
 	char *dot = (char *) strchr(id, '.');
 	char *dotdot = dot? (char *) strchr(dot+1, '.') : NULL;
 
+	if (cfg->hash != NULL) {
+		if (dot && !dotdot && option != CFG_OPT_NO_DOT) {
+			// split the same way as the sscanf("%m[^.].%ms") below
+			int n1 = dot - id;
+			const char *id2 = dot+1;
+			while (isspace(*id2)) id2++;
+			int n2 = 0;
+			while (id2[n2] != '\0' && !isspace(id2[n2])) n2++;
+			if (n1 == 0 || n2 == 0) return NULL;
+			
+			if (option == CFG_OPT_ID1)
+				return _cfg_hash_lookup(cfg, id, n1, NULL, 0);
+			jt = _cfg_hash_lookup(cfg, id, n1, id2, n2);
+			if (jt == NULL && _cfg_hash_lookup(cfg, id, n1, NULL, 0) != NULL)
+				return CFG_LOOKUP_LVL1;		// id1 exists but id2 is missing
+			return jt;
+		}
+		
+		return _cfg_hash_lookup(cfg, id, strlen(id), NULL, 0);
+	}
+
 	// handle two levels of id scope, i.e. id1.id2, but ignore more like ip addresses with three dots
 	if (dot && !dotdot && option != CFG_OPT_NO_DOT) {
 		char *id1_m = NULL, *id2_m = NULL;
@@ -1066,6 +1244,14 @@ static bool _cfg_parse_json(cfg_t *cfg, bool doPanic)
 	assert(cfg->json_buf_size >= slen + SPACE_FOR_NULL);
 	jsmn_parser parser;
 	
+	// The hash index refers to the token array about to be rewritten. Lookups from other tasks
+	// while we yield below, or after a failed parse, use the linear scan until it is rebuilt.
+	if (cfg->hash) {
+	    kiwi_free("cfg hash", cfg->hash);
+	    cfg->hash = NULL;
+	    cfg->hash_size = cfg->hash_used = 0;
+	}
+	
 	int rc;
 	do {
 		if (cfg->tokens)
@@ -1110,6 +1296,8 @@ static bool _cfg_parse_json(cfg_t *cfg, bool doPanic)
 
 	//printf("using %d of %d tokens\n", rc, cfg->tok_size);
 	cfg->ntok = rc;
+	_cfg_hash_build(cfg, yield);
+    TMEAS(printf("cfg_parse_json: DONE hash index %d/%d\n", cfg->hash_used, cfg->hash_size);)
     TMEAS(printf("cfg_parse_json: DONE json string -> json struct\n");)
     cfg->flags |= CFG_PARSE_VALID;
 	return true;
@@ -1213,6 +1401,9 @@ void _cfg_save_json(cfg_t *cfg, char *json)
         _cfg_parse_json(cfg, true);
     #endif
     TMEAS(u4_t now = timer_ms(); printf("cfg_save_json DONE reparse %.3f/%.3f msec\n", TIME_DIFF_MS(now, split), TIME_DIFF_MS(now, start));)
+
+    // /status is built from config values
+    rx_server_ajax_invalidate();
 }
 
 void _cfg_update_json(cfg_t *cfg)
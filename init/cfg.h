@@ -26,6 +26,11 @@ Boston, MA  02110-1301, USA.
 
 // configuration
 
+typedef struct {
+	u4_t hash;
+	int key, parent;		// key token index, parent key token index for "id1.id2" entries (else -1)
+} cfg_hash_t;
+
 typedef struct {
 	bool init, init_load, isJSON;
 	lock_t lock;    // FIXME: now that parsing the dx list is yielding probably need to lock
@@ -37,6 +42,9 @@ typedef struct {
 
 	int tok_size, ntok;
 	jsmntok_t *tokens;
+
+	cfg_hash_t *hash;		// key path -> token index, rebuilt on every parse
+	u4_t hash_size, hash_used;
 } cfg_t;
 
 extern cfg_t cfg_cfg, cfg_adm, cfg_dx;
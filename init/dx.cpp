@@ -34,6 +34,7 @@ Boston, MA  02110-1301, USA.
 #include <stdlib.h>
 #include <time.h>
 #include <signal.h>
+#include <sys/stat.h>
 
 // maintains a dx_t/dxlist_t struct parallel to JSON for fast lookups
 
@@ -42,8 +43,29 @@ Boston, MA  02110-1301, USA.
 
 dxlist_t dx;
 
+// Edits from DX_UPD are applied to the sorted dx_t list in place and appended as one line each to
+// dx.journal instead of regenerating and rewriting all of dx.json. The journal is replayed over dx.json
+// at reload and folded back into dx.json (compacted) then, or after DX_JOURNAL_COMPACT edits.
+//
+// The first line of the journal records the size and mtime of the dx.json it applies to so a journal
+// left over from a compaction that didn't complete, or from before dx.json was edited by hand, is ignored.
+//
+// "# <dx.json size> <dx.json mtime sec.nsec>"
+// "+ <new>"               add
+// "= <gid> <old> <new>"   modify
+// "- <gid> <old>"         delete
+// where <old>/<new> are "<freq> <flags> <lo> <hi> <o> <ts> <tag> <ident>x <notes>x <params>x"
+//
+// The old fields locate the entry on replay (gid is only a hint) and reject records that don't apply.
+// Strings are stored URL encoded (so contain no whitespace) with a trailing 'x' so empty ones survive sscanf.
+
+#define DX_JOURNAL_FN	DIR_CFG "/" CFG_PREFIX "dx.journal"
+#define DX_JOURNAL_COMPACT	256
+
+static int dx_journal_recs;
+
 // create JSON string from dx_t struct representation
-void dx_save_as_json()
+static void dx_build_json()
 {
 	int i, n;
 	cfg_t *cfg = &cfg_dx;
@@ -118,7 +140,22 @@ void dx_save_as_json()
 	n = sprintf(cp, "]}"); cp += n;
     assert((cp - cfg->json) < cfg->json_buf_size);
 	TMEAS(printf("dx_save_as_json: dx struct -> json string\n");)
-	dxcfg_save_json(cfg->json);
+	dx.json_up_to_date = true;
+}
+
+// regenerate the JSON string if edits have been made since, without writing the file
+void dx_json_update()
+{
+    if (!dx.json_up_to_date) dx_build_json();
+}
+
+// rewrite dx.json from the dx_t struct and discard the journal now folded into it
+void dx_save_as_json()
+{
+	dx_build_json();
+	dxcfg_save_json(cfg_dx.json);
+	unlink(DX_JOURNAL_FN);
+	dx_journal_recs = 0;
 	TMEAS(printf("dx_save_as_json: DONE\n");)
 }
 
@@ -152,6 +189,12 @@ static void dx_flag(dx_t *dxp, const char *flag)
 	lprintf("%.2f \"%s\": unknown dx flag \"%s\"\n", dxp->freq, dxp->ident, flag);
 }
 
+static int dx_interval_comp(const void *elem1, const void *elem2)
+{
+	const dx_interval_t *i1 = (const dx_interval_t *) elem1, *i2 = (const dx_interval_t *) elem2;
+	return (i1->lo < i2->lo)? -1 : ((i1->lo > i2->lo)? 1 : 0);
+}
+
 // prepare dx list by conditionally sorting, initializing self indexes and constructing new masked freq list
 void dx_prep_list(bool need_sort, dx_t *_dx_list, int _dx_list_len, int _dx_list_len_new)
 {
@@ -173,6 +216,8 @@ void dx_prep_list(bool need_sort, dx_t *_dx_list, int _dx_list_len, int _dx_list
             dx.masked_idx[j++] = i;
     }
 
+    free(dx.masked_iv); dx.masked_iv = NULL;
+    if (dx.masked_len > 0) dx.masked_iv = (dx_interval_t *) malloc(dx.masked_len * sizeof(dx_interval_t));
     for (i = 0; i < dx.masked_len; i++) {
         dxp = &_dx_list[dx.masked_idx[i]];
         int mode = dxp->flags & DX_MODE;
@@ -181,10 +226,303 @@ void dx_prep_list(bool need_sort, dx_t *_dx_list, int _dx_list_len, int _dx_list
         int offset = mode_offset[mode];
         dxp->masked_lo = masked_f + offset + (dxp->low_cut? dxp->low_cut : -hbw);
         dxp->masked_hi = masked_f + offset + (dxp->high_cut? dxp->high_cut : hbw);
+        dx.masked_iv[i].lo = dxp->masked_lo;
+        dx.masked_iv[i].hi = dxp->masked_hi;
         //printf("masked %.3f %d-%d %s hbw=%d off=%d lc=%d hc=%d\n",
         //    dxp->freq, dxp->masked_lo, dxp->masked_hi, modu_s[mode], hbw, offset, dxp->low_cut, dxp->high_cut);
     }
+
+    // Merge the masked ranges into disjoint intervals sorted by freq so dx_masked() is a binary search.
+    // Not already in order because passband offsets and cutoffs differ per entry.
+    dx.masked_iv_len = 0;
+    if (dx.masked_len > 0) {
+        qsort(dx.masked_iv, dx.masked_len, sizeof(dx_interval_t), dx_interval_comp);
+        for (i = 1, j = 0; i < dx.masked_len; i++) {
+            if (dx.masked_iv[i].lo <= dx.masked_iv[j].hi) {
+                if (dx.masked_iv[i].hi > dx.masked_iv[j].hi) dx.masked_iv[j].hi = dx.masked_iv[i].hi;
+            } else {
+                dx.masked_iv[++j] = dx.masked_iv[i];
+            }
+        }
+        dx.masked_iv_len = j+1;
+    }
+
     dx.masked_seq++;
+    dx.seq++;
+}
+
+// does [lo, hi] (Hz, inclusive) overlap any masked freq range
+bool dx_masked(int lo, int hi)
+{
+    // last interval starting at or below hi, the only one that can overlap since intervals are disjoint
+    int l = 0, h = dx.masked_iv_len;
+    while (l < h) {
+        int mid = l + (h - l) / 2;
+        if (dx.masked_iv[mid].lo <= hi) l = mid + 1; else h = mid;
+    }
+    return (l > 0 && dx.masked_iv[l-1].hi >= lo);
+}
+	
+static void dx_free_strings(dx_t *dxp)
+{
+	// previous allocators better have used malloc(), strdup() et al for these and not kiwi_malloc()
+	free((void *) dxp->ident_s);
+	free((void *) dxp->ident);
+	free((void *) dxp->notes_s);
+	free((void *) dxp->notes);
+	free((void *) dxp->params);
+}
+
+static bool dx_same_str(const char *s1, const char *s2)
+{
+	return strcmp(s1? s1:"", s2? s2:"") == 0;
+}
+
+// entries are the same as far as what is saved in dx.json
+static bool dx_same(dx_t *a, dx_t *b)
+{
+	return (a->freq == b->freq && a->flags == b->flags && a->low_cut == b->low_cut && a->high_cut == b->high_cut &&
+		a->offset == b->offset && a->timestamp == b->timestamp && a->tag == b->tag &&
+		dx_same_str(a->ident, b->ident) && dx_same_str(a->notes, b->notes) && dx_same_str(a->params, b->params));
+}
+
+// first entry in [lo, hi) with freq > f
+static int dx_upper_bound(float f, int lo, int hi)
+{
+	while (lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+		if (dx.list[mid].freq > f) hi = mid; else lo = mid + 1;
+	}
+	return lo;
+}
+
+// Position of the entry matching *dxp, starting with gid as a hint. The order of entries with equal freqs
+// after a reload of dx.json can be different from the order that built up from in-place edits.
+static int dx_find(int gid, dx_t *dxp)
+{
+	if (gid >= 0 && gid < dx.len && dx_same(&dx.list[gid], dxp))
+		return gid;
+
+	int lo = 0, hi = dx.len;
+	while (lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+		if (dx.list[mid].freq < dxp->freq) lo = mid + 1; else hi = mid;
+	}
+	for (; lo < dx.len && dx.list[lo].freq == dxp->freq; lo++) {
+		if (dx_same(&dx.list[lo], dxp))
+			return lo;
+	}
+	return -1;
+}
+
+// move entry i, whose freq may have changed, to its sorted position and return that position
+static int dx_resort(int i)
+{
+	dx_t t = dx.list[i];
+
+	int p = dx_upper_bound(t.freq, 0, i);
+	if (p < i) {
+		memmove(&dx.list[p+1], &dx.list[p], (i - p) * sizeof(dx_t));
+		dx.list[p] = t;
+		return p;
+	}
+
+	int q = dx_upper_bound(t.freq, i+1, dx.len) - 1;
+	if (q > i) {
+		memmove(&dx.list[i], &dx.list[i+1], (q - i) * sizeof(dx_t));
+		dx.list[q] = t;
+		return q;
+	}
+
+	return i;
+}
+
+// Apply one edit to the sorted list in place: add (old == NULL), modify or delete (dxp == NULL).
+// Takes ownership of the strings in *dxp. Returns false if the old entry isn't in the list.
+static bool dx_apply(int gid, dx_t *old, dx_t *dxp)
+{
+	if (old) {
+		if ((gid = dx_find(gid, old)) < 0) {
+			if (dxp) dx_free_strings(dxp);
+			return false;
+		}
+	}
+
+	if (dxp == NULL) {
+		dx_free_strings(&dx.list[gid]);
+		memmove(&dx.list[gid], &dx.list[gid+1], (dx.len - gid - 1) * sizeof(dx_t));
+		dx.len--;
+		memset(&dx.list[dx.len], 0, sizeof(dx_t));
+	} else {
+		if (old == NULL) {
+			// new entry goes in the hidden slot then a new hidden slot is allocated
+			gid = dx.len;
+			dx.len++;
+		} else {
+			dx_free_strings(&dx.list[gid]);
+		}
+		dx.list[gid] = *dxp;
+		dx_resort(gid);
+
+		if (old == NULL) {
+			dx.list = (dx_t *) kiwi_realloc("dx_list", dx.list, (dx.len + DX_HIDDEN_SLOT) * sizeof(dx_t));
+			memset(&dx.list[dx.len], 0, sizeof(dx_t));
+		}
+	}
+
+	// renumber and rebuild masked list, but no sort needed
+	dx_prep_list(false, dx.list, dx.len, dx.len);
+	dx.json_up_to_date = false;
+	return true;
+}
+
+static char *dx_journal_fields(char *rec, dx_t *dxp)
+{
+	return kstr_asprintf(rec, " %.9g %d %d %d %d %d %d %sx %sx %sx",
+		dxp->freq, dxp->flags, dxp->low_cut, dxp->high_cut, dxp->offset, dxp->timestamp, dxp->tag,
+		dxp->ident, dxp->notes? dxp->notes:"", dxp->params? dxp->params:"");
+}
+
+// parse fields written by dx_journal_fields(), returns number of chars consumed or 0 on error
+static int dx_journal_parse(const char *s, dx_t *dxp)
+{
+	int n, len = 0;
+	char *ident_m = NULL, *notes_m = NULL, *params_m = NULL;
+	
+	memset(dxp, 0, sizeof(dx_t));
+	n = sscanf(s, " %f %d %d %d %d %d %d %ms %ms %ms%n", &dxp->freq, &dxp->flags, &dxp->low_cut, &dxp->high_cut,
+		&dxp->offset, &dxp->timestamp, &dxp->tag, &ident_m, &notes_m, &params_m, &len);
+	if (n != 10) {
+		free(ident_m); free(notes_m); free(params_m);
+		return 0;
+	}
+
+	// remove trailing 'x'
+	ident_m[strlen(ident_m)-1] = '\0';
+	notes_m[strlen(notes_m)-1] = '\0';
+	params_m[strlen(params_m)-1] = '\0';
+	dxp->ident = ident_m;
+	dxp->ident_s = kiwi_str_decode_inplace(strdup(ident_m));
+	dxp->notes = notes_m;
+	dxp->notes_s = kiwi_str_decode_inplace(strdup(notes_m));
+	dxp->params = params_m;
+	return len;
+}
+
+static void dx_journal_append(const char *rec)
+{
+	FILE *fp;
+	
+	if (dx_journal_recs == 0) {
+		struct stat st;
+		if (stat(cfg_dx.filename, &st) != 0 || (fp = fopen(DX_JOURNAL_FN, "w")) == NULL) {
+			lprintf("DX journal: can't create %s, saving dx.json instead\n", DX_JOURNAL_FN);
+			dx_save_as_json();
+			return;
+		}
+		fprintf(fp, "# %lld %lld.%09ld\n", (long long) st.st_size, (long long) st.st_mtim.tv_sec, st.st_mtim.tv_nsec);
+	} else {
+		if ((fp = fopen(DX_JOURNAL_FN, "a")) == NULL) {
+			dx_save_as_json();
+			return;
+		}
+	}
+	
+	fputs(rec, fp);
+	fclose(fp);
+	dx_journal_recs++;
+
+	if (dx_journal_recs >= DX_JOURNAL_COMPACT) {
+		TMEAS(printf("DX journal: compacting after %d edits\n", dx_journal_recs);)
+		dx_save_as_json();
+	}
+}
+
+// Add (gid == -1), modify or delete (dxp == NULL) an entry and journal the edit.
+// Takes ownership of the strings in *dxp. Returns false if gid is invalid.
+bool dx_update(int gid, dx_t *dxp)
+{
+	if (gid < -1 || gid >= dx.len || (gid == -1 && dxp == NULL)) {
+		if (dxp) dx_free_strings(dxp);
+		return false;
+	}
+
+	// Freq is rounded as dx.json would store it so the in-memory list matches
+	// what a reload would produce and later journal records still find their entries.
+	if (dxp) {
+		char freq_s[32];
+		snprintf(freq_s, sizeof(freq_s), "%.2f", dxp->freq);
+		dxp->freq = strtod(freq_s, NULL);
+	}
+
+	char *rec = kstr_asprintf(NULL, "%c", (gid == -1)? '+' : (dxp? '=' : '-'));
+	dx_t old;
+	if (gid != -1) {
+		old = dx.list[gid];
+		rec = kstr_asprintf(rec, " %d", gid);
+		rec = dx_journal_fields(rec, &old);
+	}
+	if (dxp) rec = dx_journal_fields(rec, dxp);
+	rec = kstr_cat(rec, "\n");
+
+	// old strings are only referenced until dx_apply() frees them
+	bool ok = dx_apply(gid, (gid != -1)? &old : NULL, dxp);
+	if (ok) dx_journal_append(kstr_sp(rec));
+	kstr_free(rec);
+	return ok;
+}
+
+// replay edits journaled since dx.json was last written, returns number applied
+static int dx_journal_replay()
+{
+	FILE *fp;
+	struct stat st;
+	char *line = NULL;
+	size_t line_size = 0;
+	int recs = 0, bad = 0;
+	long long size, mtime;
+	long mtime_ns;
+
+	if ((fp = fopen(DX_JOURNAL_FN, "r")) == NULL)
+		return 0;
+
+	if (getline(&line, &line_size, fp) <= 0 || sscanf(line, "# %lld %lld.%ld", &size, &mtime, &mtime_ns) != 3 ||
+	    stat(cfg_dx.filename, &st) != 0 || st.st_size != size || st.st_mtim.tv_sec != mtime || st.st_mtim.tv_nsec != mtime_ns) {
+		lprintf("DX journal: %s doesn't match %s, ignored\n", DX_JOURNAL_FN, cfg_dx.filename);
+		fclose(fp);
+		free(line);
+		unlink(DX_JOURNAL_FN);
+		return 0;
+	}
+
+	while (getline(&line, &line_size, fp) > 0) {
+		char op = line[0];
+		char *s = line + 1;
+		int n, gid = -1;
+		dx_t old, e;
+		bool ok = false;
+		
+		if (op == '+') {
+			ok = (dx_journal_parse(s, &e) != 0);
+			if (ok) ok = dx_apply(-1, NULL, &e);
+		} else
+		if ((op == '=' || op == '-') && sscanf(s, " %d%n", &gid, &n) == 1 && (n = dx_journal_parse(s += n, &old)) != 0) {
+			if (op == '=') {
+				ok = (dx_journal_parse(s + n, &e) != 0);
+				if (ok) ok = dx_apply(gid, &old, &e);
+			} else {
+				ok = dx_apply(gid, &old, NULL);
+			}
+			dx_free_strings(&old);
+		}
+
+		if (ok) recs++; else bad++;
+	}
+	
+	fclose(fp);
+	free(line);
+	if (bad) lprintf("DX journal: %d bad or mismatched records skipped\n", bad);
+	return recs;
 }
 	
 // create and switch to new dx_t struct from JSON token list representation
@@ -309,14 +647,8 @@ static void dx_reload_json(cfg_t *cfg)
 	// release previous
 	if (prev_dx_list) {
 		int i;
-		for (i=0, dxp = prev_dx_list; i < prev_dx_list_len; i++, dxp++) {
-			// previous allocators better have used malloc(), strdup() et al for these and not kiwi_malloc()
-			free((void *) dxp->ident_s);
-			free((void *) dxp->ident);
-			free((void *) dxp->notes_s);
-			free((void *) dxp->notes);
-			free((void *) dxp->params);
-		}
+		for (i=0, dxp = prev_dx_list; i < prev_dx_list_len; i++, dxp++)
+			dx_free_strings(dxp);
 	}
 	
 	kiwi_free("dx_list", prev_dx_list);
@@ -336,4 +668,11 @@ void dx_reload()
 	TMEAS(u4_t split = timer_ms(); printf("DX_RELOAD json file read and json struct %.3f sec\n", TIME_DIFF_MS(split, start));)
 	dx_reload_json(cfg);
 	TMEAS(u4_t now = timer_ms(); printf("DX_RELOAD DONE json struct -> dx struct %.3f/%.3f sec\n", TIME_DIFF_MS(now, split), TIME_DIFF_MS(now, start));)
+
+	// fold any journaled edits into a new dx.json so the journal starts out empty
+	int recs = dx_journal_replay();
+	if (recs) {
+		lprintf("DX journal: %d edits replayed\n", recs);
+		dx_save_as_json();
+	}
 }
@@ -40,13 +40,20 @@ typedef struct {
 	int masked_lo, masked_hi;   // Hz
 } dx_t;
 
+typedef struct {
+	int lo, hi;             // Hz, inclusive
+} dx_interval_t;
+
 typedef struct {
 	dx_t *list;
 	int len;                // malloc'd length is always len + DX_HIDDEN_SLOT
+	int seq;                // incremented whenever list contents or order change
 	bool hidden_used;
 	bool json_up_to_date;
 	int *masked_idx;
 	int masked_len, masked_seq;
+	dx_interval_t *masked_iv;   // union of masked_lo/hi ranges as disjoint intervals sorted by freq
+	int masked_iv_len;
 } dxlist_t;
 
 extern dxlist_t dx;
@@ -65,4 +72,7 @@ extern dxlist_t dx;
 
 void dx_reload();
 void dx_save_as_json();
+void dx_json_update();
+bool dx_update(int gid, dx_t *dxp);
+bool dx_masked(int lo, int hi);
 void dx_prep_list(bool need_sort, dx_t *_dx_list, int _dx_list_len, int _dx_list_len_new);
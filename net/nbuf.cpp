@@ -40,8 +40,24 @@
 	static lock_t nbuf_lock;
 	#define NNBUF 1024
 	static nbuf_t nbuf[NNBUF];
+	static nbuf_t *nbuf_free_list;		// linked through nb->next
 #endif
 
+// payload pool: power-of-two size classes, freed payloads are kept for reuse
+#define NB_PKT_CLASS_MIN	6		// 64 bytes
+#define NB_PKT_CLASS_MAX	16		// 64k bytes, larger payloads are malloc()ed and freed each time
+#define NB_PKT_NCLASS		(NB_PKT_CLASS_MAX - NB_PKT_CLASS_MIN + 1)
+static nbuf_pkt_t *nb_pkt_free[NB_PKT_NCLASS];
+static int nb_pkt_nalloc[NB_PKT_NCLASS], nb_pkt_nfree[NB_PKT_NCLASS];
+
+#define check_pkt(pkt) { \
+	if (pkt->magic != NB_PKT_MAGIC || pkt->refs <= 0) { \
+		lprintf("BAD NBUF PKT magic 0x%x refs %d, %s line %d #################################\n", \
+			pkt->magic, pkt->refs, __FILE__, __LINE__); \
+		dump_panic("check_pkt"); \
+	} \
+}
+
 void nbuf_init()
 {
 #ifdef NBUF_STATIC_ALLOC
@@ -52,7 +68,9 @@ void nbuf_init()
 	for (i=0; i<NNBUF; i++) {
 		nbuf_t *nb = &nbuf[i];
 		nb->isFree = TRUE;
+		nb->next = (i < NNBUF-1)? &nbuf[i+1] : NULL;
 	}
+	nbuf_free_list = &nbuf[0];
 #endif
 }
 
@@ -66,9 +84,64 @@ void nbuf_stat()
 		if (!nb->isFree) busy++;
 	}
 	printf("NBUF %d/%d busy\n", busy, NNBUF);
+	for (i=0; i < NB_PKT_NCLASS; i++) {
+		if (nb_pkt_nalloc[i])
+			printf("NBUF pkt %d: %d/%d free\n", 1 << (i + NB_PKT_CLASS_MIN), nb_pkt_nfree[i], nb_pkt_nalloc[i]);
+	}
 #endif
 }
 
+nbuf_pkt_t *nbuf_pkt_alloc(int size)
+{
+	nbuf_pkt_t *pkt;
+	int cls;
+	
+	// +1 so buffers which are strings can be null terminated after the fact
+	size++;
+	for (cls = 0; cls < NB_PKT_NCLASS && (1 << (cls + NB_PKT_CLASS_MIN)) < size; cls++)
+		;
+	
+	if (cls == NB_PKT_NCLASS) {
+		pkt = (nbuf_pkt_t *) kiwi_malloc("nbuf:pkt", sizeof(nbuf_pkt_t) + size);
+		cls = -1;
+	} else
+	if ((pkt = nb_pkt_free[cls]) != NULL) {
+		nb_pkt_free[cls] = pkt->free_next;
+		nb_pkt_nfree[cls]--;
+	} else {
+		pkt = (nbuf_pkt_t *) kiwi_malloc("nbuf:pkt", sizeof(nbuf_pkt_t) + (1 << (cls + NB_PKT_CLASS_MIN)));
+		nb_pkt_nalloc[cls]++;
+	}
+	
+	pkt->magic = NB_PKT_MAGIC;
+	pkt->refs = 1;
+	pkt->cls = cls;
+	pkt->free_next = NULL;
+	pkt->buf = (char *) (pkt + 1);
+	return pkt;
+}
+
+void nbuf_pkt_ref(nbuf_pkt_t *pkt)
+{
+	check_pkt(pkt);
+	pkt->refs++;
+}
+
+void nbuf_pkt_unref(nbuf_pkt_t *pkt)
+{
+	check_pkt(pkt);
+	if (--pkt->refs) return;
+	pkt->magic = 0;
+	
+	if (pkt->cls < 0) {
+		kiwi_free("nbuf:pkt", pkt);
+	} else {
+		pkt->free_next = nb_pkt_free[pkt->cls];
+		nb_pkt_free[pkt->cls] = pkt;
+		nb_pkt_nfree[pkt->cls]++;
+	}
+}
+
 void ndesc_init(ndesc_t *nd, struct mg_connection *mc)
 {
 	memset(nd, 0, sizeof(ndesc_t));
@@ -90,13 +163,10 @@ static nbuf_t *nbuf_malloc()
 #ifdef NBUF_STATIC_ALLOC
 	// FIXME: don't need a lock here because there is no task preemption to cause contention
 	lock_enter(&nbuf_lock);
-		int i;
-		for (i=0; i<NNBUF; i++) {
-			nb = &nbuf[i];
-			if (nb->isFree)
-				break;
-		}
-		if (i == NNBUF) panic("out of nbufs");
+		nb = nbuf_free_list;
+		if (nb == NULL) panic("out of nbufs");
+		assert(nb->isFree);
+		nbuf_free_list = nb->next;
 	lock_leave(&nbuf_lock);
 #else
 	nb = (nbuf_t*) kiwi_malloc("nbuf", sizeof(nbuf_t));
@@ -112,9 +182,16 @@ static nbuf_t *nbuf_malloc()
 static void nbuf_free(nbuf_t *nb)
 {
 	check_nbuf(nb);
+	if (nb->pkt) nbuf_pkt_unref(nb->pkt);
+	nb->pkt = NULL;
+	nb->buf = NULL;
 	nb->magic = nb->magic_b = nb->magic_e = 0;
 	nb->isFree = TRUE;
 #ifdef NBUF_STATIC_ALLOC
+	lock_enter(&nbuf_lock);
+		nb->next = nbuf_free_list;
+		nbuf_free_list = nb;
+	lock_leave(&nbuf_lock);
 #else
 	kiwi_free("nbuf", nb);
 #endif
@@ -166,7 +243,6 @@ static bool nbuf_enqueue(ndesc_t *nd, nbuf_t *nb)
 			if (nd->dbug) printf("R%d ", dp->id);
 			if (nd->dbug) nbuf_dumpq(nd);
 			assert(dp->buf);
-			kiwi_free("nbuf:buf", dp->buf);
 			*q_head = dp->prev;
 			if (*q == dp) {
 				*q = NULL;
@@ -203,23 +279,27 @@ static bool nbuf_enqueue(ndesc_t *nd, nbuf_t *nb)
 	return ovfl;
 }
 
-void nbuf_allocq(ndesc_t *nd, char *s, int sl)
+// Queue a reference to len bytes of pkt->buf starting at off, preceded by hl bytes of hdr (copied).
+// The caller keeps its own reference and must nbuf_pkt_unref() it when done.
+void nbuf_allocq_pkt(ndesc_t *nd, const char *hdr, int hl, nbuf_pkt_t *pkt, int off, int len)
 {
 	check_ndesc(nd);
 	nbuf_t *nb;
 	bool ovfl;
 	static int id;
 	
-	assert(s != NULL);
-	assert(sl > 0);
+	check_pkt(pkt);
+	assert(len > 0);
+	assert(hl >= 0 && hl <= NB_HDR_MAX);
 	nb = nbuf_malloc();
 	//assert(nd->mc);
 	nb->mc = nd->mc;
-	// +1 so buffers which are strings can be null terminated after the fact
-	// but don't reflect this extra byte in the nb->len count
-	nb->buf = (char*) kiwi_malloc("nbuf:buf", sl+1);
-    memcpy(nb->buf, s, sl);
-	nb->len = sl;
+	nbuf_pkt_ref(pkt);
+	nb->pkt = pkt;
+	nb->buf = pkt->buf + off;
+	nb->len = len;
+	if (hl) memcpy(nb->hdr, hdr, hl);
+	nb->hdr_len = hl;
 	nb->done = FALSE;
 	nb->dequeued = FALSE;
 	nb->ttl = nd->ttl;
@@ -230,11 +310,22 @@ void nbuf_allocq(ndesc_t *nd, char *s, int sl)
 	
 	check_nbuf(nb);
 	if (ovfl) {
-		kiwi_free("nbuf:buf", nb->buf);
 		nbuf_free(nb);
 	}
 }
 
+void nbuf_allocq(ndesc_t *nd, char *s, int sl)
+{
+	assert(s != NULL);
+	assert(sl > 0);
+	// nbuf_pkt_alloc() adds a byte so buffers which are strings can be null terminated after the fact
+	// but don't reflect this extra byte in the nb->len count
+	nbuf_pkt_t *pkt = nbuf_pkt_alloc(sl);
+    memcpy(pkt->buf, s, sl);
+	nbuf_allocq_pkt(nd, NULL, 0, pkt, 0, sl);
+	nbuf_pkt_unref(pkt);
+}
+
 nbuf_t *nbuf_dequeue(ndesc_t *nd)
 {
 	check_ndesc(nd);
@@ -299,8 +390,6 @@ void nbuf_cleanup(ndesc_t *nd)
 			//assert(dp->buf);
 			if (dp->buf == 0)
 				lprintf("WARNING: dp->buf == NULL\n");
-			else
-			kiwi_free("nbuf:buf", dp->buf);
 
 			*q_head = dp->prev;
 			if (dp == *q) *q = NULL;
@@ -5,6 +5,18 @@
 #include "coroutines.h"     // lock_t
 #include "mongoose.h"       // struct mg_connection *
 
+// Refcounted payload from a size-class pool.
+// Producers fill pkt->buf in place and queue it with nbuf_allocq_pkt(), which takes its own reference.
+// The same pkt can be queued on several connections (e.g. identical waterfall frames).
+typedef struct nbuf_pkt_st {
+	#define NB_PKT_MAGIC 0xbabe9a7e
+	u4_t magic;
+	int refs;
+	int cls;				// pool size class, -1 if too large to pool
+	struct nbuf_pkt_st *free_next;
+	char *buf;
+} nbuf_pkt_t;
+
 #define NBUF_MAGIC_B	0xbbbbbbbb
 #define NBUF_MAGIC_E	0xbbbbeeee
 
@@ -12,8 +24,12 @@ typedef struct nbuf_st {
 	#define NB_MAGIC 0xbabecafe
 	u4_t magic;
 	struct mg_connection *mc;
+	nbuf_pkt_t *pkt;		// buf points into pkt->buf
 	char *buf;
 	u2_t len, ttl, id;
+	#define NB_HDR_MAX 32
+	char hdr[NB_HDR_MAX];	// per-connection header sent ahead of buf (s2c only)
+	u2_t hdr_len;
 	bool done, expecting_done, dequeued, isFree;
 	u4_t magic_b;
 	struct nbuf_st *next, *prev;
@@ -42,6 +58,10 @@ void ndesc_register(ndesc_t *nd);
 void nbuf_init();
 void nbuf_stat();
 void nbuf_allocq(ndesc_t *nd, char *s, int sl);
+void nbuf_allocq_pkt(ndesc_t *nd, const char *hdr, int hl, nbuf_pkt_t *pkt, int off, int len);
+nbuf_pkt_t *nbuf_pkt_alloc(int size);
+void nbuf_pkt_ref(nbuf_pkt_t *pkt);
+void nbuf_pkt_unref(nbuf_pkt_t *pkt);
 nbuf_t *nbuf_dequeue(ndesc_t *nd);
 int nbuf_queued(ndesc_t *nd);
 void nbuf_cleanup(ndesc_t *nd);
@@ -41,6 +41,9 @@
 #define NS_ENABLE_IPV6
 #define MONGOOSE_NO_THREADS
 //#define NS_ENABLE_SSL
+#ifdef __linux__
+ #define NS_ENABLE_EPOLL
+#endif
 
 #ifndef NS_SKELETON_HEADER_INCLUDED
 #define NS_SKELETON_HEADER_INCLUDED
@@ -121,6 +124,10 @@
 	#include <netinet/in.h>
 	#include <sys/socket.h>
 	#include <sys/select.h>
+	#include <sys/uio.h>
+	#ifdef NS_ENABLE_EPOLL
+	 #include <sys/epoll.h>
+	#endif
 	#define closesocket(x) close(x)
 	#define __cdecl
 	#define INVALID_SOCKET (-1)
@@ -183,6 +190,13 @@ struct ns_server {
   SSL_CTX *ssl_ctx;
   SSL_CTX *client_ssl_ctx;
   sock_t ctl[2];
+#ifdef NS_ENABLE_EPOLL
+  int epfd;                                 // -1 if epoll unavailable, select() used instead
+  sock_t ep_listening_sock;                 // listening_sock as registered with epfd
+  struct ns_connection *pending;            // connections to visit on the next poll
+  struct ns_connection *pending_todo;       // those being visited by the current poll
+  time_t ep_sweep_time;
+#endif
 };
 
 struct ns_connection {
@@ -205,6 +219,11 @@ struct ns_connection {
 #define NSF_USER_2                  (1 << 7)
 #define NSF_USER_3                  (1 << 8)
 #define NSF_USER_4                  (1 << 9)
+#define NSF_EPOLL_PENDING           (1 << 10)
+#ifdef NS_ENABLE_EPOLL
+  struct ns_connection *pending_next;
+  uint32_t ep_events;                       // as registered with epfd
+#endif
 };
 
 void ns_server_init(struct ns_server *, void *server_data, ns_callback_t);
@@ -342,17 +361,77 @@ printf("pthread_create f %p th %p\n", f, thread_id);
 }
 #endif  // NS_DISABLE_THREADS
 
+#ifdef NS_ENABLE_EPOLL
+// With epoll a poll only visits the connections that have a ready socket or have been
+// queued here because they have something to send or need closing.
+static void ns_mark_pending(struct ns_connection *conn) {
+  struct ns_server *server = conn->server;
+  if (server->epfd < 0 || (conn->flags & NSF_EPOLL_PENDING)) return;
+  conn->flags |= NSF_EPOLL_PENDING;
+  conn->pending_next = server->pending;
+  server->pending = conn;
+}
+
+static void ns_unmark_pending(struct ns_connection *conn) {
+  struct ns_server *server = conn->server;
+  struct ns_connection **lists[2] = { &server->pending, &server->pending_todo }, **pp;
+  int i;
+
+  if (!(conn->flags & NSF_EPOLL_PENDING)) return;
+  conn->flags &= ~NSF_EPOLL_PENDING;
+  for (i = 0; i < 2; i++) {
+    for (pp = lists[i]; *pp != NULL; pp = &(*pp)->pending_next) {
+      if (*pp == conn) {
+        *pp = conn->pending_next;
+        return;
+      }
+    }
+  }
+}
+
+static void ns_epoll_ctl(struct ns_server *server, int op, sock_t sock, uint32_t events, void *ptr) {
+  struct epoll_event ev;
+  if (server->epfd < 0 || sock == INVALID_SOCKET) return;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = events;
+  ev.data.ptr = ptr;
+  epoll_ctl(server->epfd, op, sock, &ev);
+}
+
+// EPOLLOUT only while connecting or when the socket wouldn't take all of send_iobuf,
+// so a blocked connection waits for the socket rather than being retried every poll.
+static void ns_epoll_update(struct ns_connection *conn) {
+  int want_out = (conn->flags & NSF_CONNECTING) ||
+    (conn->send_iobuf.len > 0 && !(conn->flags & NSF_BUFFER_BUT_DONT_SEND));
+  uint32_t events = EPOLLIN | (want_out? EPOLLOUT : 0);
+  if (events == conn->ep_events) return;
+  conn->ep_events = events;
+  ns_epoll_ctl(conn->server, EPOLL_CTL_MOD, conn->sock, events, conn);
+}
+#else
+#define ns_mark_pending(conn)
+#endif
+
 static void ns_add_conn(struct ns_server *server, struct ns_connection *c) {
   c->next = server->active_connections;
   server->active_connections = c;
   c->prev = NULL;
   if (c->next != NULL) c->next->prev = c;
+#ifdef NS_ENABLE_EPOLL
+  // EPOLLOUT only while connecting, new output is found via ns_mark_pending() (see ns_epoll_update())
+  c->ep_events = EPOLLIN | ((c->flags & NSF_CONNECTING)? EPOLLOUT : 0);
+  ns_epoll_ctl(server, EPOLL_CTL_ADD, c->sock, c->ep_events, c);
+#endif
 }
 
 static void ns_remove_conn(struct ns_connection *conn) {
   if (conn->prev == NULL) conn->server->active_connections = conn->next;
   if (conn->prev) conn->prev->next = conn->next;
   if (conn->next) conn->next->prev = conn->prev;
+#ifdef NS_ENABLE_EPOLL
+  ns_unmark_pending(conn);
+  ns_epoll_ctl(conn->server, EPOLL_CTL_DEL, conn->sock, 0, NULL);
+#endif
 }
 
 // Print message to buffer. If buffer is large enough to hold the message,
@@ -399,6 +478,7 @@ int ns_vprintf(struct ns_connection *conn, const char *fmt, va_list ap) {
 
   if ((len = ns_avprintf(&buf, sizeof(mem), fmt, ap)) > 0) {
     iobuf_append(&conn->send_iobuf, buf, len);
+    ns_mark_pending(conn);
   }
   if (buf != mem && buf != NULL) {
     free(buf);
@@ -769,6 +849,7 @@ static void ns_write_to_socket(struct ns_connection *conn) {
 }
 
 int ns_send(struct ns_connection *conn, const void *buf, int len) {
+  ns_mark_pending(conn);
   return iobuf_append(&conn->send_iobuf, buf, len);
 }
 
@@ -781,6 +862,79 @@ static void ns_add_to_set(sock_t sock, fd_set *set, sock_t *max_fd) {
   }
 }
 
+#ifdef NS_ENABLE_EPOLL
+#define NS_EPOLL_MAX_EVENTS 64
+
+// Unlike the select() version this doesn't visit every connection on every poll.
+// Only sockets epoll reports ready and connections queued by ns_mark_pending() are visited.
+// The sweep of all connections (NS_POLL for idle timeouts, websocket pings and file transfer,
+// and anything flagged for closing that wasn't queued) is only done once a second.
+// Returns the number of ready sockets rather than the number of connections.
+static int ns_server_epoll(struct ns_server *server, int milli) {
+  struct epoll_event ev[NS_EPOLL_MAX_EVENTS];
+  struct ns_connection *conn;
+  time_t current_time = time(NULL);
+  int i, n;
+
+  if (server->listening_sock != server->ep_listening_sock) {
+    ns_epoll_ctl(server, EPOLL_CTL_ADD, server->listening_sock, EPOLLIN, &server->listening_sock);
+    server->ep_listening_sock = server->listening_sock;
+  }
+
+  if (current_time != server->ep_sweep_time) {
+    server->ep_sweep_time = current_time;
+    for (conn = server->active_connections; conn != NULL; conn = conn->next) {
+      ns_call(conn, NS_POLL, &current_time);
+      if (conn->send_iobuf.len > 0 || (conn->flags & NSF_CLOSE_IMMEDIATELY))
+        ns_mark_pending(conn);
+    }
+  }
+
+  // NB: no connection is closed (freed) until all events have been handled
+  n = epoll_wait(server->epfd, ev, NS_EPOLL_MAX_EVENTS, milli);
+  for (i = 0; i < n; i++) {
+    if (ev[i].data.ptr == &server->listening_sock) {
+      // one accept per poll, as with select()
+      if ((conn = accept_conn(server)) != NULL) {
+        conn->last_io_time = current_time;
+      }
+    } else
+    if (ev[i].data.ptr == &server->ctl[1]) {
+      unsigned char ch;
+      recv(server->ctl[1], &ch, 1, 0);
+      send(server->ctl[1], &ch, 1, 0);
+    } else {
+      conn = (struct ns_connection *) ev[i].data.ptr;
+      conn->last_io_time = current_time;
+      if ((conn->flags & NSF_CONNECTING) || (ev[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)))
+        ns_read_from_socket(conn);
+      ns_mark_pending(conn);      // EPOLLOUT: the write is retried below
+    }
+  }
+
+  // New entries queued while visiting go on server->pending for the next poll.
+  // A socket that wouldn't take all the pending output gets EPOLLOUT and is visited again once writable.
+  server->pending_todo = server->pending;
+  server->pending = NULL;
+  while ((conn = server->pending_todo) != NULL) {
+    server->pending_todo = conn->pending_next;
+    conn->flags &= ~NSF_EPOLL_PENDING;
+    ns_call(conn, NS_POLL, &current_time);      // e.g. next chunk of a file transfer
+    if (conn->send_iobuf.len > 0 && !(conn->flags & (NSF_CONNECTING | NSF_BUFFER_BUT_DONT_SEND))) {
+      conn->last_io_time = current_time;
+      ns_write_to_socket(conn);
+    }
+    if (conn->flags & NSF_CLOSE_IMMEDIATELY) {
+      ns_close_conn(conn);
+    } else {
+      ns_epoll_update(conn);
+    }
+  }
+
+  return n;
+}
+#endif
+
 int ns_server_poll(struct ns_server *server, int milli) {
   struct ns_connection *conn, *tmp_conn;
   struct timeval tv;
@@ -792,6 +946,10 @@ int ns_server_poll(struct ns_server *server, int milli) {
   if (server->listening_sock == INVALID_SOCKET &&
       server->active_connections == NULL) return 0;
 
+#ifdef NS_ENABLE_EPOLL
+  if (server->epfd >= 0) return ns_server_epoll(server, milli);
+#endif
+
   FD_ZERO(&read_set);
   FD_ZERO(&write_set);
   ns_add_to_set(server->listening_sock, &read_set, &max_fd);
@@ -965,6 +1123,12 @@ void ns_server_init(struct ns_server *s, void *server_data, ns_callback_t cb) {
   } while (s->ctl[0] == INVALID_SOCKET);
 #endif
 
+#ifdef NS_ENABLE_EPOLL
+  s->ep_listening_sock = INVALID_SOCKET;
+  s->epfd = epoll_create1(EPOLL_CLOEXEC);
+  ns_epoll_ctl(s, EPOLL_CTL_ADD, s->ctl[1], EPOLLIN, &s->ctl[1]);
+#endif
+
 #ifdef NS_ENABLE_SSL
   SSL_library_init();
   s->client_ssl_ctx = SSL_CTX_new(SSLv23_client_method());
@@ -989,6 +1153,11 @@ void ns_server_free(struct ns_server *s) {
     ns_close_conn(conn);
   }
 
+#ifdef NS_ENABLE_EPOLL
+  if (s->epfd >= 0) close(s->epfd);
+  s->epfd = -1;
+#endif
+
 #ifdef NS_ENABLE_SSL
   if (s->ssl_ctx != NULL) SSL_CTX_free(s->ssl_ctx);
   if (s->client_ssl_ctx != NULL) SSL_CTX_free(s->client_ssl_ctx);
@@ -2582,52 +2751,87 @@ static int deliver_websocket_frame(struct connection *conn) {
   return buffered;
 }
 
-int mg_websocket_write(struct mg_connection* conn, int opcode,
-                       const char *data, size_t data_len) {
-    unsigned char *copy;
-    size_t copy_len = 0;
-    int retval = -1;
+// Gather write of a websocket frame: the frame header and the iov[] pieces are
+// sent directly with writev() when nothing is already queued on the connection
+// (the usual case) and only what the socket didn't take is copied to send_iobuf.
+int mg_websocket_writev(struct mg_connection* conn, int opcode,
+                        const struct iovec *iov, int iovcnt) {
+    struct ns_connection *nc = MG_CONN_2_CONN(conn)->ns_conn;
+    unsigned char hdr[10];
+    struct iovec v[MG_WEBSOCKET_MAX_IOV + 1];
+    size_t data_len = 0, hdr_len, sent = 0;
+    int i, n;
 
-    if ((copy = (unsigned char *) malloc(data_len + 10)) == NULL) {
-      return -1;
-    }
+    if (iovcnt > MG_WEBSOCKET_MAX_IOV) return -1;
+    for (i = 0; i < iovcnt; i++) data_len += iov[i].iov_len;
 
-    copy[0] = 0x80 + (opcode & 0x0f);
+    hdr[0] = 0x80 + (opcode & 0x0f);
 
     // Frame format: http://tools.ietf.org/html/rfc6455#section-5.2
     if (data_len < 126) {
       // Inline 7-bit length field
-      copy[1] = data_len;
-      memcpy(copy + 2, data, data_len);
-      copy_len = 2 + data_len;
+      hdr[1] = data_len;
+      hdr_len = 2;
     } else if (data_len <= 0xFFFF) {
       // 16-bit length field
-      copy[1] = 126;
-      * (uint16_t *) (copy + 2) = (uint16_t) htons((uint16_t) data_len);
-      memcpy(copy + 4, data, data_len);
-      copy_len = 4 + data_len;
+      hdr[1] = 126;
+      * (uint16_t *) (hdr + 2) = (uint16_t) htons((uint16_t) data_len);
+      hdr_len = 4;
     } else {
       // 64-bit length field
-      copy[1] = 127;
-      * (uint32_t *) (copy + 2) = (uint32_t)
+      hdr[1] = 127;
+      * (uint32_t *) (hdr + 2) = (uint32_t)
         htonl((uint32_t) ((uint64_t) data_len >> 32));
-      * (uint32_t *) (copy + 6) = (uint32_t) htonl(data_len & 0xffffffff);
-      memcpy(copy + 10, data, data_len);
-      copy_len = 10 + data_len;
+      * (uint32_t *) (hdr + 6) = (uint32_t) htonl(data_len & 0xffffffff);
+      hdr_len = 10;
+    }
+
+    v[0].iov_base = hdr;
+    v[0].iov_len = hdr_len;
+    memcpy(&v[1], iov, iovcnt * sizeof(struct iovec));
+
+#ifndef NS_ENABLE_SSL
+    // closing frame is always queued so ns_write_to_socket() sees NSF_FINISHED_SENDING_DATA
+    if (nc->send_iobuf.len == 0 && opcode != 0x08 &&
+        !(nc->flags & (NSF_CONNECTING | NSF_BUFFER_BUT_DONT_SEND))) {
+      n = writev(nc->sock, v, iovcnt + 1);
+      if (n > 0) {
+        sent = n;
+        nc->last_io_time = time(NULL);
+      } else if (ns_is_error(n)) {
+        nc->flags |= NSF_CLOSE_IMMEDIATELY;
+        ns_mark_pending(nc);
+        return -1;
+      }
     }
+#endif
 
-    if (copy_len > 0) {
-      retval = mg_write(conn, copy, copy_len);
+    // queue whatever the socket didn't take
+    for (i = 0; i <= iovcnt; i++) {
+      if (sent >= v[i].iov_len) {
+        sent -= v[i].iov_len;
+        continue;
+      }
+      iobuf_append(&nc->send_iobuf, (char *) v[i].iov_base + sent, v[i].iov_len - sent);
+      ns_mark_pending(nc);
+      sent = 0;
     }
-    free(copy);
 
     // If we send closing frame, schedule a connection to be closed after
     // data is drained to the client.
     if (opcode == 0x08) {
-        MG_CONN_2_CONN(conn)->ns_conn->flags |= NSF_FINISHED_SENDING_DATA;
+        nc->flags |= NSF_FINISHED_SENDING_DATA;
     }
 
-    return retval;
+    return hdr_len + data_len;
+}
+
+int mg_websocket_write(struct mg_connection* conn, int opcode,
+                       const char *data, size_t data_len) {
+    struct iovec iov;
+    iov.iov_base = (void *) data;
+    iov.iov_len = data_len;
+    return mg_websocket_writev(conn, opcode, &iov, 1);
 }
 
 static void send_websocket_handshake_if_requested(struct mg_connection *conn) {
@@ -2759,7 +2963,11 @@ static const char *suggest_connection_header(const struct mg_connection *conn) {
   return should_keep_alive(conn) ? "keep-alive" : "close";
 }
 
-static void construct_etag(char *buf, size_t buf_len, const file_stat_t *st) {
+static void construct_etag(char *buf, size_t buf_len, const struct mg_connection *mc, const file_stat_t *st) {
+  if (st == &mc->cache_info.st && mc->cache_info.etag_content[0] != '\0') {
+    mg_snprintf(buf, buf_len, "%s", mc->cache_info.etag_content);
+    return;
+  }
   mg_snprintf(buf, buf_len, "\"%lx.%" INT64_FMT "\"",
               (unsigned long) st->st_mtime, (int64_t) st->st_size);
 }
@@ -2770,7 +2978,7 @@ static int is_not_modified(struct connection *conn,
   struct mg_connection *mc = &conn->mg_conn;
   const char *inm = mg_get_header(mc, "If-None-Match");
   const char *ims = mg_get_header(mc, "If-Modified-Since");
-  construct_etag(mc->cache_info.etag_server, sizeof(mc->cache_info.etag_server), stp);
+  construct_etag(mc->cache_info.etag_server, sizeof(mc->cache_info.etag_server), mc, stp);
 
   mc->cache_info.if_none_match = (inm != NULL);
   web_printf_all("%-16s etag_match=%c", "MG_CACHE_INFO", mc->cache_info.if_none_match? 'T':'F');
@@ -2932,7 +3140,7 @@ void mg_send_standard_headers(struct mg_connection *mc, const char *path, file_s
   // http://www.w3.org/Protocols/rfc2616/rfc2616-sec3.html#sec3.3
   gmt_time_string(date, sizeof(date), &curtime);
   gmt_time_string(lm, sizeof(lm), &st->st_mtime);
-  construct_etag(etag, sizeof(etag), st);
+  construct_etag(etag, sizeof(etag), mc, st);
 
   n = mg_snprintf(headers, sizeof(headers),
                   "HTTP/1.1 %d %s\r\n"
@@ -4555,6 +4763,7 @@ static void close_local_endpoint(struct connection *conn) {
     case EP_CGI:
       if (conn->endpoint.cgi_conn != NULL) {
         conn->endpoint.cgi_conn->flags |= NSF_CLOSE_IMMEDIATELY;
+        ns_mark_pending(conn->endpoint.cgi_conn);
         conn->endpoint.cgi_conn->connection_data = NULL;
       }
       break;
@@ -4888,6 +5097,7 @@ static void mg_ev_handler(struct ns_connection *nc, enum ns_event ev, void *p) {
         conn->ns_conn->flags &= ~NSF_BUFFER_BUT_DONT_SEND;
         conn->ns_conn->flags |= conn->ns_conn->send_iobuf.len > 0 ?
           NSF_FINISHED_SENDING_DATA : NSF_CLOSE_IMMEDIATELY;
+        ns_mark_pending(conn->ns_conn);
         conn->endpoint.cgi_conn = NULL;
       } else if (conn != NULL) {
         DBG(("%p %d closing", conn, conn->endpoint_type));
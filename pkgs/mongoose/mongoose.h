@@ -25,6 +25,7 @@
 #include <stdio.h>      // required for FILE
 #include <stddef.h>     // required for size_t
 #include <sys/stat.h>   // required for struct stat
+#include <sys/uio.h>    // required for struct iovec
 
 #ifdef __cplusplus
 extern "C" {
@@ -63,6 +64,7 @@ struct mg_connection {
       bool etag_match;
       #define N_ETAG 64
       char etag_server[N_ETAG], etag_client[N_ETAG];
+      char etag_content[N_ETAG];  // if set, the etag for st instead of the mtime.size one
     bool if_mod_since;
       bool not_mod_since;
       time_t server_mtime, client_mtime;
@@ -109,6 +111,9 @@ void mg_printf_data(struct mg_connection *, const char *format, ...);
 
 int mg_websocket_write(struct mg_connection *, int opcode,
                        const char *data, size_t data_len);
+#define MG_WEBSOCKET_MAX_IOV 4
+int mg_websocket_writev(struct mg_connection *, int opcode,
+                        const struct iovec *iov, int iovcnt);
 
 // Deprecated in favor of mg_send_* interface
 int mg_write(struct mg_connection *, const void *buf, int len);
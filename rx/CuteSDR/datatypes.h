@@ -75,6 +75,7 @@ typedef struct
  #define MFFTW_PLAN_DFT_1D fftw_plan_dft_1d
  #define MFFTW_DESTROY_PLAN fftw_destroy_plan
  #define MFFTW_EXECUTE fftw_execute
+ #define MFFTW_EXECUTE_DFT fftw_execute_dft
 #else
  #define MSIN(x) sinf(x)
  #define MCOS(x) cosf(x)
@@ -97,6 +98,7 @@ typedef struct
  #define MFFTW_PLAN_DFT_1D fftwf_plan_dft_1d
  #define MFFTW_DESTROY_PLAN fftwf_destroy_plan
  #define MFFTW_EXECUTE fftwf_execute
+ #define MFFTW_EXECUTE_DFT fftwf_execute_dft
 #endif
 
 #define TYPESTEREO16 tStereo16
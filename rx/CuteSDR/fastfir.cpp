@@ -51,6 +51,9 @@
 
 CFastFIR m_PassbandFIR[MAX_RX_CHANS];
 
+MFFTW_PLAN CFastFIR::m_FFT_FwdPlan;
+MFFTW_PLAN CFastFIR::m_FFT_RevPlan;
+
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -110,9 +113,14 @@ CFastFIR::CFastFIR()
 	}
 #endif
 
-	m_FFT_CoefPlan = MFFTW_PLAN_DFT_1D(CONV_FFT_SIZE, (MFFTW_COMPLEX*) m_pFilterCoef, (MFFTW_COMPLEX*) m_pFilterCoef, FFTW_FORWARD, FFTW_MEASURE);
-	m_FFT_FwdPlan = MFFTW_PLAN_DFT_1D(CONV_FFT_SIZE, (MFFTW_COMPLEX*) m_pFFTBuf, (MFFTW_COMPLEX*) m_pFFTBuf, FFTW_FORWARD, FFTW_MEASURE);
-	m_FFT_RevPlan = MFFTW_PLAN_DFT_1D(CONV_FFT_SIZE, (MFFTW_COMPLEX*) m_pFFTBuf, (MFFTW_COMPLEX*) m_pFFTBuf, FFTW_BACKWARD, FFTW_MEASURE);
+	// plans are made once by the first instance and only executed after that
+	// (fftw execute is thread-safe, the planner is not)
+	if (m_FFT_FwdPlan == NULL) {
+		MFFTW_COMPLEX *buf = (MFFTW_COMPLEX*) MFFTW_MALLOC(sizeof(MFFTW_COMPLEX) * CONV_FFT_SIZE);
+		m_FFT_FwdPlan = MFFTW_PLAN_DFT_1D(CONV_FFT_SIZE, buf, buf, FFTW_FORWARD, FFTW_MEASURE);
+		m_FFT_RevPlan = MFFTW_PLAN_DFT_1D(CONV_FFT_SIZE, buf, buf, FFTW_BACKWARD, FFTW_MEASURE);
+		MFFTW_FREE(buf);
+	}
 	
 	m_FLoCut = -1.0;
 	m_FHiCut = 1.0;
@@ -192,7 +200,7 @@ int i;
 	}
 
 	//convert FIR coefficients to frequency domain by taking forward FFT
-	MFFTW_EXECUTE(m_FFT_CoefPlan);
+	MFFTW_EXECUTE_DFT(m_FFT_FwdPlan, (MFFTW_COMPLEX*) m_pFilterCoef, (MFFTW_COMPLEX*) m_pFilterCoef);
 
     #define CIC_COMPENSATION
 	#ifdef CIC_COMPENSATION
@@ -210,15 +218,13 @@ int i;
 //number of samples returned in general will not be equal to the number of
 //input samples due to FFT block size processing.
 //600ns/samp
+//receive_FFT_pre/post are latched by the caller and must be false when running on a work pool thread,
+//the extension FFT routines may only be called from the coroutine thread.
 ///////////////////////////////////////////////////////////////////////////////
-int CFastFIR::ProcessData(int rx_chan, int InLength, TYPECPX* InBuf, TYPECPX* OutBuf)
+int CFastFIR::ProcessData(int rx_chan, int InLength, TYPECPX* InBuf, TYPECPX* OutBuf, bool receive_FFT_pre, bool receive_FFT_post)
 {
 //print_max_min_c("FIRin", InBuf, InLength);
 
-ext_receive_FFT_samps_t receive_FFT = ext_users[rx_chan].receive_FFT;
-bool receive_FFT_pre = (receive_FFT != NULL && ext_users[rx_chan].filtering == PRE_FILTERED);
-bool receive_FFT_post = (receive_FFT != NULL && ext_users[rx_chan].filtering == POST_FILTERED);
-
 int i = 0;
 int j;
 int len = InLength;
@@ -240,7 +246,7 @@ int outpos = 0;
 		if(m_InBufInPos >= CONV_FFT_SIZE)
 		{	//perform FFT -> complexMultiply by FIR coefficients -> inverse FFT on filled FFT input buffer
 			//print_max_min_c("preFFT", m_pFFTBuf, CONV_FFT_SIZE);
-			MFFTW_EXECUTE(m_FFT_FwdPlan);
+			MFFTW_EXECUTE_DFT(m_FFT_FwdPlan, (MFFTW_COMPLEX*) m_pFFTBuf, (MFFTW_COMPLEX*) m_pFFTBuf);
 
 			if (receive_FFT_pre) {
                 //print_max_min_c("postFFT", m_pFFTBuf, CONV_FFT_SIZE);
@@ -249,9 +255,9 @@ int outpos = 0;
                                   reinterpret_cast<const fftwf_complex *>(m_pFFTBuf),
                                   m_CIC,
                                   reinterpret_cast<fftwf_complex *>(m_pFFTBuf_pre));
-                receive_FFT(rx_chan, 0, CONV_FFT_TO_OUTBUF_RATIO, CONV_FFT_SIZE, m_pFFTBuf_pre);
+                extint_receive_FFT_samps(rx_chan, EXT_STAGE_FFT_PRE, CONV_FFT_TO_OUTBUF_RATIO, CONV_FFT_SIZE, m_pFFTBuf_pre);
 #else
-                receive_FFT(rx_chan, 0, CONV_FFT_TO_OUTBUF_RATIO, CONV_FFT_SIZE, m_pFFTBuf);
+                extint_receive_FFT_samps(rx_chan, EXT_STAGE_FFT_PRE, CONV_FFT_TO_OUTBUF_RATIO, CONV_FFT_SIZE, m_pFFTBuf);
 #endif
             }
 
@@ -262,9 +268,9 @@ int outpos = 0;
                               reinterpret_cast<      fftwf_complex *>(m_pFFTBuf));
 
 			if (receive_FFT_post)
-				receive_FFT(rx_chan, 0, CONV_FFT_TO_OUTBUF_RATIO, CONV_FFT_SIZE, m_pFFTBuf);
+				extint_receive_FFT_samps(rx_chan, EXT_STAGE_FFT_POST, CONV_FFT_TO_OUTBUF_RATIO, CONV_FFT_SIZE, m_pFFTBuf);
 
-			MFFTW_EXECUTE(m_FFT_RevPlan);
+			MFFTW_EXECUTE_DFT(m_FFT_RevPlan, (MFFTW_COMPLEX*) m_pFFTBuf, (MFFTW_COMPLEX*) m_pFFTBuf);
 			for(j=(CONV_FIR_SIZE-1); j<CONV_FFT_SIZE; j++)
 			{	//copy FFT output into OutBuf minus CONV_FIR_SIZE-1 samples at beginning
 				OutBuf[outpos++] = m_pFFTBuf[j];
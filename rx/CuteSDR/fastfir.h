@@ -19,6 +19,10 @@
 #define CONV_FIR_SIZE (CONV_FFT_SIZE/2+1)	//must be <= FFT size. Make 1/2 +1 if want
 											//output to be in power of 2
 
+// the shared plans are made on fftw_malloc() memory so the FFT buffers need the same alignment
+// for the plans to use the SIMD codelets (32 covers AVX builds)
+#define FFT_ALIGNED __attribute__((aligned(32)))
+
 class CFastFIR  
 {
 public:
@@ -26,7 +30,7 @@ public:
 	virtual ~CFastFIR();
 
 	void SetupParameters( TYPEREAL FLoCut,TYPEREAL FHiCut,TYPEREAL Offset, TYPEREAL SampleRate);
-	int ProcessData(int rx_chan, int InLength, TYPECPX* InBuf, TYPECPX* OutBuf);
+	int ProcessData(int rx_chan, int InLength, TYPECPX* InBuf, TYPECPX* OutBuf, bool receive_FFT_pre, bool receive_FFT_post);
 
 	int FirPos() const { return m_InBufInPos - CONV_FIR_SIZE + 1; }
 private:
@@ -40,13 +44,15 @@ private:
 	int m_InBufInPos;
 	TYPEREAL m_pWindowTbl[CONV_FIR_SIZE];
 	TYPECPX m_pFFTOverlapBuf[CONV_FIR_SIZE];
-	TYPECPX m_pFilterCoef[CONV_FFT_SIZE];
-	TYPECPX m_pFFTBuf[CONV_FFT_SIZE];
+	TYPECPX m_pFilterCoef[CONV_FFT_SIZE] FFT_ALIGNED;
+	TYPECPX m_pFFTBuf[CONV_FFT_SIZE] FFT_ALIGNED;
 	TYPECPX m_pFFTBuf_pre[CONV_FFT_SIZE]; // pre-filtered FFT with CIC compensation
 	TYPEREAL m_CIC[CONV_FFT_SIZE]; // CIC compensation coefficients
-	MFFTW_PLAN m_FFT_CoefPlan;
-	MFFTW_PLAN m_FFT_FwdPlan;
-	MFFTW_PLAN m_FFT_RevPlan;
+
+	// All instances are the same size so they share one set of plans, run on each instance's
+	// buffers with the new-array execute (the coefficient FFT uses the forward plan).
+	static MFFTW_PLAN m_FFT_FwdPlan;
+	static MFFTW_PLAN m_FFT_RevPlan;
 };
 
 extern CFastFIR m_PassbandFIR[MAX_RX_CHANS];
@@ -84,6 +84,8 @@ typedef struct conn_st {
 	int dx_err_preg_ident, dx_err_preg_notes;
 	regex_t dx_preg_ident, dx_preg_notes;
 	int dx_filter_case, dx_filter_wild, dx_filter_grep;
+	u4_t *dx_filter_bm;     // per dx entry, two bits: filter evaluated, filter passed
+	int dx_filter_bm_len, dx_filter_bm_seq;
 	bool isWF_conn;
 
 	// set in STREAM_EXT, STREAM_SOUND
@@ -31,6 +31,7 @@ Boston, MA  02110-1301, USA.
 #include "debug.h"
 #include "shmem.h"
 #include "data_pump.h"
+#include "simd.h"
 
 #include <string.h>
 #include <stdio.h>
@@ -78,7 +79,6 @@ static u4_t last_run_us;
 
 static void snd_service()
 {
-	int j;
 	SPI_MISO *miso = &SPI_SHMEM->dpump_miso;
 	u4_t diff, moved=0;
 
@@ -139,11 +139,9 @@ static void snd_service()
         TYPECPX *i_samps[MAX_RX_CHANS];
         for (int ch=0; ch < rx_chans; ch++) {
             rx_dpump_t *rx = &rx_dpump[ch];
-            i_samps[ch] = rx->in_samps[rx->wr_pos];
+            i_samps[ch] = rx_channels[ch].data_enabled? rx->in_samps[spsc_wr_slot(&rx->in_ring)] : NULL;
         }
     
-        rx_iq_t *iqp = (rx_iq_t*) &rxd->iq_t;
-    
         #if 0
             // check 48-bit ticks counter timestamp
             static int debug_ticks;
@@ -157,46 +155,34 @@ static void snd_service()
             }
             debug_ticks++;
         #endif
-                
-        for (j=0; j < nrx_samps; j++) {
-    
-            for (int ch=0; ch < rx_chans; ch++) {
-                if (rx_channels[ch].data_enabled) {
-                    s4_t i, q;
-                    i = S24_8_16(iqp->i3, iqp->i);
-                    q = S24_8_16(iqp->q3, iqp->q);
-                    
-                    // NB: I/Q reversed to get correct sideband polarity; fixme: why?
-                    // [probably because mixer NCO polarity is wrong, i.e. cos/sin should really be cos/-sin]
-                    i_samps[ch]->re = q * rescale + DC_offset_I;
-                    i_samps[ch]->im = i * rescale + DC_offset_Q;
-                    i_samps[ch]++;
-                }
-                
-                iqp++;
-            }
-        }
+
+        // De-interleave and convert the whole block for all enabled channels in one pass
+        // (same result as S24_8_16() * rescale + DC_offset per sample, see tools/dpump_iq.cpp).
+        // NB: I/Q reversed to get correct sideband polarity; fixme: why?
+        // [probably because mixer NCO polarity is wrong, i.e. cos/sin should really be cos/-sin]
+        simd_iq24_unpack(nrx_samps, rx_chans, &rxd->iq_t, rescale, DC_offset_I, DC_offset_Q, (fftwf_complex **) i_samps);
     
         for (int ch=0; ch < rx_chans; ch++) {
             if (rx_channels[ch].data_enabled) {
                 rx_dpump_t *rx = &rx_dpump[ch];
 
-                rx->ticks[rx->wr_pos] = S16x4_S64(0, rxt->ticks[2], rxt->ticks[1], rxt->ticks[0]);
+                u4_t wr_pos = spsc_wr_slot(&rx->in_ring);
+                rx->ticks[wr_pos] = S16x4_S64(0, rxt->ticks[2], rxt->ticks[1], rxt->ticks[0]);
     
                 #ifdef SND_SEQ_CHECK
-                    rx->in_seq[rx->wr_pos] = snd_seq;
+                    rx->in_seq[wr_pos] = snd_seq;
                 #endif
                 
-                rx->wr_pos = (rx->wr_pos+1) & (N_DPBUF-1);
+                // full: c2s_sound() has fallen a whole ring behind, drop this block
+                if (!spsc_push(&rx->in_ring, N_DPBUF)) {
+                    dpump.in_overruns++;
+                    #ifdef DATA_PUMP_DEBUG
+                        real_printf("#%d ", ch); fflush(stdout);
+                    #endif
+                }
                 
-                diff = (rx->wr_pos >= rx->rd_pos)? rx->wr_pos - rx->rd_pos : N_DPBUF - rx->rd_pos + rx->wr_pos;
+                diff = spsc_count(&rx->in_ring, N_DPBUF);
                 dpump.in_hist[diff]++;
-
-                #ifdef DATA_PUMP_DEBUG
-                    if (rx->wr_pos == rx->rd_pos) {
-                        real_printf("#%d ", ch); fflush(stdout);
-                    }
-                #endif
             }
         }
         
@@ -293,6 +279,8 @@ static void data_pump(void *param)
 		evDP(EC_EVENT, EV_DPUMP, -1, "data_pump", evprintf("WAKEUP: SPI CTRL_SND_INTR %d",
 			GPIO_READ_BIT(SND_INTR)));
 
+        lat_hist_add(&dpump.intr_hist, TaskWakeLatency());
+        if (last_run_us) lat_hist_add(&dpump.gap_hist, timer_us() - last_run_us);
 		snd_service();
 		
 		for (int ch=0; ch < rx_chans; ch++) {
@@ -301,9 +289,7 @@ static void data_pump(void *param)
 			conn_t *c = rx->conn;
 			assert(c != NULL);
 			assert(c->type == STREAM_SOUND);
-			if (c->task) {
-				TaskWakeup(c->task, TWF_NONE, 0);
-			}
+			if (c->task) spsc_wake(&rx_dpump[ch].in_ring);
 		}
 	}
 }
@@ -24,6 +24,7 @@ Boston, MA  02110-1301, USA.
 #include "spi.h"
 #include "cuteSDR.h"
 #include "ima_adpcm.h"
+#include "spsc.h"
 
 #include <fftw3.h>
 
@@ -42,7 +43,7 @@ typedef struct {
 
 typedef struct {
 	struct {
-		u4_t wr_pos, rd_pos;
+		spsc_ring_t in_ring;    // snd_service() => c2s_sound()
 		// array size really nrx_samps but made pow2 FASTFIR_OUTBUF_SIZE for indexing efficiency
 		TYPECPX in_samps[N_DPBUF][FASTFIR_OUTBUF_SIZE];
 		u64_t ticks[N_DPBUF];
@@ -105,8 +106,11 @@ typedef struct {
     u4_t resets, hist[MAX_NRX_BUFS];
     bool force_reset;
     u4_t in_hist[N_DPBUF];
+    u4_t in_overruns;       // blocks dropped because a channel's in_ring was full
     int rx_adc_ovfl;
     int audio_dropped;
+    lat_hist_t intr_hist;   // interrupt seen to data pump task running
+    lat_hist_t gap_hist;    // between successive services, > nrx_bufs worth causes a reset
 } dpump_t;
 
 extern dpump_t dpump;
@@ -93,6 +93,61 @@ int bsearch_freqcomp(const void *key, const void *elem)
     return 0;   // key > last in array so lower is last (degenerate case)
 }
 
+static bool dx_filter_match(conn_t *conn, dx_t *dp)
+{
+    if (conn->dx_filter_grep) {
+        if (conn->dx_has_preg_ident) {
+            if (regexec(&conn->dx_preg_ident, dp->ident_s, 0, NULL, 0) == REG_NOMATCH) return false;
+        }
+        if (conn->dx_has_preg_notes) {
+            if (regexec(&conn->dx_preg_notes, dp->notes_s, 0, NULL, 0) == REG_NOMATCH) return false;
+        }
+        //printf("DX FILTER MATCHED-grep %s<%s> %s<%s>\n",
+        //    conn->dx_has_preg_ident? "*":"", dp->ident_s, conn->dx_has_preg_notes? "*":"", dp->notes_s);
+    } else
+    if (conn->dx_filter_wild) {
+        int fn_flags = conn->dx_filter_case? 0 : FNM_CASEFOLD;
+        if (fnmatch(conn->dx_filter_ident, dp->ident_s, fn_flags) != 0) return false;
+        if (conn->dx_filter_notes && conn->dx_filter_notes[0] != '\0' &&
+            fnmatch(conn->dx_filter_notes, dp->notes_s, fn_flags) != 0) return false;
+        //printf("DX FILTER MATCHED-wild <%s> <%s>\n", dp->ident_s, dp->notes_s);
+    } else {
+        if (conn->dx_filter_case) {
+            if (strstr(dp->ident_s, conn->dx_filter_ident) == NULL) return false;
+            if (conn->dx_filter_notes && strstr(dp->notes_s, conn->dx_filter_notes) == NULL) return false;
+        } else {
+            if (strcasestr(dp->ident_s, conn->dx_filter_ident) == NULL) return false;
+            if (conn->dx_filter_notes && strcasestr(dp->notes_s, conn->dx_filter_notes) == NULL) return false;
+        }
+        //printf("DX FILTER MATCHED-no-grep <%s> <%s>\n", dp->ident_s, dp->notes_s);
+    }
+    return true;
+}
+
+// Filter results are cached per connection as a pair of bitmaps over the dx list so each entry's
+// regexec/fnmatch/strcasestr is only run once while panning and zooming. Both bitmaps are cleared
+// when the filter is changed (dx_filter_bm_seq = -1) or the list is edited (dx.seq changes).
+static bool dx_filter_cached(conn_t *conn, dx_t *dp)
+{
+    int i = dp - dx.list;
+    int words = (dx.len + 31) / 32;
+    
+    if (conn->dx_filter_bm_seq != dx.seq || conn->dx_filter_bm_len != dx.len) {
+        free(conn->dx_filter_bm);
+        conn->dx_filter_bm = (u4_t *) calloc(words * 2, sizeof(u4_t));
+        conn->dx_filter_bm_len = dx.len;
+        conn->dx_filter_bm_seq = dx.seq;
+    }
+    
+    u4_t *done = conn->dx_filter_bm, *pass = done + words;
+    u4_t bit = 1U << (i & 31);
+    if (!(done[i >> 5] & bit)) {
+        if (dx_filter_match(conn, dp)) pass[i >> 5] |= bit;
+        done[i >> 5] |= bit;
+    }
+    return (pass[i >> 5] & bit)? true : false;
+}
+
 #endif
 
 void rx_common_init(conn_t *conn)
@@ -610,8 +665,7 @@ bool rx_common_cmd(const char *stream_name, conn_t *conn, char *cmd)
 		
 		float freq = 0;
 		int gid = -999;
-		int low_cut, high_cut, mkr_off, flags, new_len;
-		bool need_sort = false;
+		int low_cut, high_cut, mkr_off, flags;
 		flags = 0;
 
 		char *text_m, *notes_m, *params_m;
@@ -635,44 +689,34 @@ bool rx_common_cmd(const char *stream_name, conn_t *conn, char *cmd)
 		// dx.len == 0 only applies when adding first entry to empty list
 		if (gid != -1 && dx.len == 0) return true;
 		
+        //#define TMEAS(x) x
+        #define TMEAS(x)
+
 		bool err = false;
-		dx_t *dxp;
 		if (gid >= -1 && gid < dx.len) {
 			if (n == 2 && gid != -1 && freq == -1) {
-				// delete entry by forcing to top of list, then decreasing size by one before save
+				// delete entry
 				cprintf(conn, "DX_UPD %s delete entry #%d\n", conn->remote_ip, gid);
-				dxp = &dx.list[gid];
-				dxp->freq = 999999;
-				new_len = dx.len - 1;
-				need_sort = true;
+				err = !dx_update(gid, NULL);
 			} else
 			if (n != 2) {
+				dx_t e;
+				memset(&e, 0, sizeof(e));
+
 				if (gid == -1) {
-					// new entry: add to end of list (in hidden slot), then sort will insert it properly
+					// new entry: dx_update() inserts it at its sorted position
 					cprintf(conn, "DX_UPD %s adding new entry\n", conn->remote_ip);
-					assert(dx.hidden_used == false);		// FIXME need better serialization
-					dxp = &dx.list[dx.len];
-					dx.hidden_used = true;
-					dx.len++;
-					new_len = dx.len;
-				    need_sort = true;
 				} else {
 					// modify entry
 					cprintf(conn, "DX_UPD %s modify entry #%d\n", conn->remote_ip, gid);
-					dxp = &dx.list[gid];
-					new_len = dx.len;
-				    if (dxp->freq != freq) {
-                        need_sort = true;
-                    }
-                    else printf("DX_UPD modify but no freq change, so no sort required %f\n", freq);
-
+					e.tag = dx.list[gid].tag;
 				}
-				dxp->freq = freq;
-				dxp->low_cut = low_cut;
-				dxp->high_cut = high_cut;
-				dxp->offset = mkr_off;
-				dxp->flags = flags;
-		        dxp->timestamp = utc_time_since_2018() / 60;
+				e.freq = freq;
+				e.low_cut = low_cut;
+				e.high_cut = high_cut;
+				e.offset = mkr_off;
+				e.flags = flags;
+		        e.timestamp = utc_time_since_2018() / 60;
 				
 				// remove trailing 'x' transmitted with text, notes and params fields
 				text_m[strlen(text_m)-1] = '\0';
@@ -680,11 +724,18 @@ bool rx_common_cmd(const char *stream_name, conn_t *conn, char *cmd)
 				params_m[strlen(params_m)-1] = '\0';
 				
 				// can't use kiwi_strdup because free() must be used later on
-				free((void *) dxp->ident); dxp->ident = strdup(text_m);
-				free((void *) dxp->ident_s); dxp->ident_s = kiwi_str_decode_inplace(strdup(text_m));
-				free((void *) dxp->notes); dxp->notes = strdup(notes_m);
-				free((void *) dxp->notes_s); dxp->notes_s = kiwi_str_decode_inplace(strdup(notes_m));
-				free((void *) dxp->params); dxp->params = strdup(params_m);
+				e.ident = strdup(text_m);
+				e.ident_s = kiwi_str_decode_inplace(strdup(text_m));
+				e.notes = strdup(notes_m);
+				e.notes_s = kiwi_str_decode_inplace(strdup(notes_m));
+				e.params = strdup(params_m);
+
+				// Sorted position is updated in place and the edit appended to the dx journal
+				// rather than re-sorting the whole list and rewriting all of dx.json.
+				// The json string is regenerated from the dx struct only when GET_DX_JSON next asks for it.
+                TMEAS(u4_t start = timer_ms();)
+				err = !dx_update(gid, &e);
+                TMEAS(printf("DX_UPD done in %.3f msec\n", TIME_DIFF_MS(timer_ms(), start));)
 			} else {
 			    err = true;
 			}
@@ -692,40 +743,8 @@ bool rx_common_cmd(const char *stream_name, conn_t *conn, char *cmd)
 			printf("DX_UPD: gid %d <> dx.len %d ?\n", gid, dx.len);
 			err = true;
 		}
-		
-        //#define TMEAS(x) x
-        #define TMEAS(x)
 
 		if (!err) {
-            // NB: difference between dx.len and new_len
-            dx_prep_list(need_sort, dx.list, dx.len, new_len);
-            //printf("DX_UPD after qsort dx.len %d new_len %d top elem f=%.2f\n",
-            //	dx.len, new_len, dx.list[dx.len - DX_HIDDEN_SLOT].freq);
-                        
-            dx.len = new_len;
-            TMEAS(u4_t start = timer_ms(); printf("DX_UPD START\n");)
-            dx_save_as_json();		// FIXME need better serialization
-            TMEAS(u4_t split = timer_ms(); printf("DX_UPD struct -> json, file write in %.3f sec\n", TIME_DIFF_MS(split, start));)
-
-            #if 1
-                // NB: Don't need to do the time consuming json re-parse since there are no dxcfg_* write routines that
-                // incrementally alter the json struct. The DX_UPD code modifies the dx struct and then regenerates the entire json string
-                // and writes it to the file. In this way the dx struct is acting as a proxy for the json struct, except at server start-up
-                // when the json struct is walked to construct the initial dx struct.
-                // But do need to grow to include a new hidden slot if it was just used by an add.
-                //dx_reload();
-                if (dx.hidden_used) {
-	                dx.list = (dx_t *) kiwi_realloc("dx_list", dx.list, (dx.len + DX_HIDDEN_SLOT) * sizeof(dx_t));
-	                memset(&dx.list[dx.len], 0, sizeof(dx_t));
-	                dx.hidden_used = false;
-                }
-                
-	            dx.json_up_to_date = false;
-            #else
-                dx_reload();
-            #endif
-
-            TMEAS(u4_t now = timer_ms(); printf("DX_UPD DONE reloaded in %.3f/%.3f sec\n", TIME_DIFF_MS(now, split), TIME_DIFF_MS(now, start));)
             send_msg(conn, false, "MSG request_dx_update");	// get client to request updated dx list
         }
 
@@ -746,6 +765,7 @@ bool rx_common_cmd(const char *stream_name, conn_t *conn, char *cmd)
         free(filter_ident_m);
         free(filter_notes_m);
         conn->dx_err_preg_ident = conn->dx_err_preg_notes = 0;
+        conn->dx_filter_bm_seq = -1;    // invalidate cached filter results
         
         // compile regexp
         if (conn->dx_filter_grep) {
@@ -819,10 +839,9 @@ bool rx_common_cmd(const char *stream_name, conn_t *conn, char *cmd)
 		//printf("DX MKR key=%.2f bsearch=%.2f(%d/%d) min=%.2f max=%.2f\n",
 		//    dx_min.freq, dp->freq + ((float) dp->offset / 1000.0), dp->idx, dx.len, min, max);
 		
-		int dx_filter = 0, fn_flags = 0;
+		int dx_filter = 0;
         if (conn->dx_filter_ident || conn->dx_filter_notes) {
             dx_filter = 1;
-            fn_flags = conn->dx_filter_case? 0 : FNM_CASEFOLD;
             //printf("DX FILTERING on <%s> <%s> case=%d wild=%d grep=%d\n",
             //    conn->dx_filter_ident, conn->dx_filter_notes, conn->dx_filter_case, conn->dx_filter_wild, conn->dx_filter_grep);
             //show_conn("DX FILTER ", conn);
@@ -833,41 +852,28 @@ bool rx_common_cmd(const char *stream_name, conn_t *conn, char *cmd)
 
 			if (type == 4 && freq > max + DX_SEARCH_WINDOW) break;    // get extra one above for label stepping
 			
-			if (dx_filter) {
-			    if (conn->dx_filter_grep) {
-			        if (conn->dx_has_preg_ident) {
-                        if (regexec(&conn->dx_preg_ident, dp->ident_s, 0, NULL, 0) == REG_NOMATCH) continue;
-                    }
-			        if (conn->dx_has_preg_notes) {
-                        if (regexec(&conn->dx_preg_notes, dp->notes_s, 0, NULL, 0) == REG_NOMATCH) continue;
-                    }
-			        //printf("DX FILTER MATCHED-grep %s<%s> %s<%s>\n",
-			        //    conn->dx_has_preg_ident? "*":"", dp->ident_s, conn->dx_has_preg_notes? "*":"", dp->notes_s);
-			    } else
-			    if (conn->dx_filter_wild) {
-                    if (fnmatch(conn->dx_filter_ident, dp->ident_s, fn_flags) != 0) continue;
-                    if (conn->dx_filter_notes && conn->dx_filter_notes[0] != '\0' &&
-                        fnmatch(conn->dx_filter_notes, dp->notes_s, fn_flags) != 0) continue;
-			        //printf("DX FILTER MATCHED-wild <%s> <%s>\n", dp->ident_s, dp->notes_s);
-			    } else {
-                    if (conn->dx_filter_case) {
-                        if (strstr(dp->ident_s, conn->dx_filter_ident) == NULL) continue;
-                        if (conn->dx_filter_notes && strstr(dp->notes_s, conn->dx_filter_notes) == NULL) continue;
-                    } else {
-                        if (strcasestr(dp->ident_s, conn->dx_filter_ident) == NULL) continue;
-                        if (conn->dx_filter_notes && strcasestr(dp->notes_s, conn->dx_filter_notes) == NULL) continue;
-                    }
-			        //printf("DX FILTER MATCHED-no-grep <%s> <%s>\n", dp->ident_s, dp->notes_s);
-                }
-			}
-			
 			// reduce dx label clutter
+			// Labels closer than DX_SPACING_THRESHOLD_PX to the last one sent are never sent,
+			// so binary search forward to the first entry far enough away instead of stepping through them.
 			if (type == 4 && zoom <= DX_SPACING_ZOOM_THRESHOLD) {
 				int x = ((dp->freq - min) / bw) * width;
 				int diff = x - dx_lastx;
 				//printf("DX spacing %d %d %d %s\n", dx_lastx, x, diff, dp->ident);
-				if (!first && diff < DX_SPACING_THRESHOLD_PX) continue;
-				dx_lastx = x;
+				if (!first && diff < DX_SPACING_THRESHOLD_PX) {
+				    dx_t *lo = dp + 1, *hi = &dx.list[dx.len];
+				    while (lo < hi) {
+				        dx_t *mid = lo + (hi - lo) / 2;
+				        if ((int) (((mid->freq - min) / bw) * width) - dx_lastx < DX_SPACING_THRESHOLD_PX) lo = mid + 1; else hi = mid;
+				    }
+				    dp = lo - 1;    // loop increment makes it lo
+				    continue;
+				}
+			}
+			
+			if (dx_filter && !dx_filter_cached(conn, dp)) continue;
+			
+			if (type == 4 && zoom <= DX_SPACING_ZOOM_THRESHOLD) {
+				dx_lastx = ((dp->freq - min) / bw) * width;
 				first = false;
 			}
 			
@@ -894,7 +900,7 @@ bool rx_common_cmd(const char *stream_name, conn_t *conn, char *cmd)
 	
 	// send the whole database as json
 	if (strcmp(cmd, "SET GET_DX_JSON") == 0) {
-	    dxcfg_update_json();    // update (re-parse) json if necessary
+	    dx_json_update();    // regenerate json string from dx struct if edited since
 
         // NB: ident, notes and params are already stored URL encoded
         printf("GET_DX_JSON len=%d\n", strlen(cfg_dx.json));
@@ -273,6 +273,7 @@ void rx_loguser(conn_t *c, logtype_e type)
 	}
 	
 	if (type == LOG_ARRIVED || type == LOG_LEAVING) {
+		rx_server_ajax_invalidate();    // /status and /users content has changed
 		clprintf(c, "%8.2f kHz %3s z%-2d %s%s\"%s\"%s%s%s%s %s\n", (float) c->freqHz / kHz + freq_offset,
 			kiwi_enum2str(c->mode, mode_s, ARRAY_LEN(mode_s)), c->zoom,
 			c->ext? c->ext->name : "", c->ext? " ":"",
@@ -300,6 +301,7 @@ void rx_server_remove(conn_t *c)
 	free(c->pref);
 	free(c->dx_filter_ident);
 	free(c->dx_filter_notes);
+	free(c->dx_filter_bm);
     if (c->dx_has_preg_ident) { regfree(&c->dx_preg_ident); c->dx_has_preg_ident = false; }
     if (c->dx_has_preg_notes) { regfree(&c->dx_preg_notes); c->dx_has_preg_notes = false; }
     
@@ -310,6 +312,7 @@ void rx_server_remove(conn_t *c)
 	
 	int task = c->task;
 	conn_init(c);
+	rx_server_ajax_invalidate();
 	check_for_update(WAIT_UNTIL_NO_USERS, NULL);
 	//printf("### rx_server_remove %s\n", Task_ls(task));
 	TaskRemove(task);
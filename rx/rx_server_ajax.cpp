@@ -45,8 +45,82 @@ Boston, MA  02110-1301, USA.
 #include <stdlib.h>
 #include <sys/time.h>
 
+// Snapshot cache for the /status and /users replies which directory sites and proxies poll continuously.
+// A snapshot is reused until it is AJAX_CACHE_TTL_MS old or rx_server_ajax_invalidate() is called by one
+// of the events that change its content (user arriving/leaving, config save). /status also depends on
+// state that changes all over the place without an invalidate: the GPS fix count and the
+// down/update/backup/sdr.hu registration flags behind its status= and offline= fields.
+// These are recorded with the snapshot and it is stale as soon as any of them differ.
+// Both a raw and gzip'd copy are kept, each with a strong etag, so web_request() can answer
+// If-None-Match with a 304 without anything being regenerated.
+
+#define AJAX_CACHE_TTL_MS   10000
+#define AJAX_CACHE_GZIP_MIN 256     // not worth compressing below this
+
+typedef struct {
+    bool valid;
+    u4_t gen, built_ms;
+    int gps_fixes;
+    u4_t status_flags;
+    char *raw, *gz;         // gz NULL if not compressed
+    int raw_len, gz_len;
+    char etag[32], etag_gz[32];
+} ajax_cache_t;
+
+static ajax_cache_t ajax_cache_status, ajax_cache_users;
+static u4_t ajax_cache_gen;
+
+void rx_server_ajax_invalidate()
+{
+    ajax_cache_gen++;
+}
+
+static u4_t ajax_status_flags()
+{
+    bool sdr_hu_reg = (admcfg_bool("sdr_hu_register", NULL, CFG_OPTIONAL) == 1);
+    return (sdr_hu_reg? 1:0) | (down? 2:0) | (update_in_progress? 4:0) | (backup_in_progress? 8:0);
+}
+
+static bool ajax_cache_fresh(ajax_cache_t *ac, bool status_dep)
+{
+    if (status_dep && (ac->gps_fixes != gps.fixes || ac->status_flags != ajax_status_flags())) return false;
+    return (ac->valid && ac->gen == ajax_cache_gen && (timer_ms() - ac->built_ms) < AJAX_CACHE_TTL_MS);
+}
+
+static void ajax_cache_fill(ajax_cache_t *ac, const char *s, bool status_dep)
+{
+    free(ac->raw);
+    free(ac->gz);
+    ac->raw_len = strlen(s);
+    ac->raw = strdup(s);
+    ac->gz = (ac->raw_len >= AJAX_CACHE_GZIP_MIN)? web_gzip(ac->raw, ac->raw_len, &ac->gz_len) : NULL;
+    
+    // FNV-1a of the content, so the etag only changes when the content does
+    u4_t hash = 2166136261U;
+    for (int i = 0; i < ac->raw_len; i++)
+        hash = (hash ^ (u1_t) s[i]) * 16777619U;
+    snprintf(ac->etag, sizeof(ac->etag), "\"%08x.%x\"", hash, ac->raw_len);
+    snprintf(ac->etag_gz, sizeof(ac->etag_gz), "\"%08x.%x.gz\"", hash, ac->raw_len);
+
+    ac->gen = ajax_cache_gen;
+    ac->gps_fixes = gps.fixes;
+    ac->status_flags = status_dep? ajax_status_flags() : 0;
+    ac->built_ms = timer_ms();
+    ac->valid = true;
+}
+
+// NB: returned data belongs to the cache and is not free()'d by the caller
+static char *ajax_cache_reply(ajax_cache_t *ac, struct mg_connection *mc, ajax_cache_rsp_t *rsp)
+{
+    const char *ae = mg_get_header(mc, "Accept-Encoding");
+    rsp->is_gzip = (ac->gz != NULL && ae != NULL && strstr(ae, "gzip") != NULL);
+    rsp->etag = rsp->is_gzip? ac->etag_gz : ac->etag;
+    rsp->size = rsp->is_gzip? ac->gz_len : ac->raw_len;
+    return rsp->is_gzip? ac->gz : ac->raw;
+}
+
 // process non-websocket connections
-char *rx_server_ajax(struct mg_connection *mc)
+char *rx_server_ajax(struct mg_connection *mc, ajax_cache_rsp_t *rsp)
 {
 	int i, j, n;
 	char *sb, *sb2;
@@ -175,9 +249,13 @@ char *rx_server_ajax(struct mg_connection *mc)
 			printf("/users NON_LOCAL FETCH ATTEMPT from %s\n", remote_ip);
 			return (char *) -1;
 		}
-		sb = rx_users(true);
 		printf("/users REQUESTED from %s\n", remote_ip);
-		return sb;		// NB: return here because sb is already a kstr_t (don't want to do kstr_wrap() below)
+		if (!ajax_cache_fresh(&ajax_cache_users, false)) {
+		    sb = rx_users(true);
+		    ajax_cache_fill(&ajax_cache_users, kstr_sp(sb), false);
+		    kstr_free(sb);
+		}
+		return ajax_cache_reply(&ajax_cache_users, mc, rsp);
 		break;
 
 	// SECURITY:
@@ -196,6 +274,9 @@ char *rx_server_ajax(struct mg_connection *mc)
 		if (sdr_hu_debug)
 			printf("/status: replying to %s\n", remote_ip);
 		
+		if (ajax_cache_fresh(&ajax_cache_status, true))
+		    return ajax_cache_reply(&ajax_cache_status, mc, rsp);
+		
 		const char *s1, *s3, *s4, *s5, *s6, *s7;
 		
 		// if location hasn't been changed from the default try using ipinfo lat/log
@@ -343,7 +424,9 @@ char *rx_server_ajax(struct mg_connection *mc)
 		cfg_string_free(pwd_s);
 
 		//printf("STATUS REQUESTED from %s: <%s>\n", remote_ip, sb);
-		break;
+		ajax_cache_fill(&ajax_cache_status, sb, true);
+		free(sb);
+		return ajax_cache_reply(&ajax_cache_status, mc, rsp);
 	}
 
 	default:
@@ -49,6 +49,7 @@ Boston, MA  02110-1301, USA.
 #include "rx_sound.h"
 #include "rx_waterfall.h"
 #include "shmem.h"
+#include "work_pool.h"
 
 #ifdef DRM
  #include "DRM.h"
@@ -84,6 +85,147 @@ snd_t snd_inst[MAX_RX_CHANS];
 
 float g_genfreq, g_genampl, g_mixfreq;
 
+// FIXME: Why is SND_MAX_VAL less than CUTESDR_MAX_VAL again?
+// And does this explain the need for SMETER_CALIBRATION?
+// Can't remember how this evolved..
+#define SND_MAX_VAL ((float) ((1 << (CUTESDR_SCALE-2)) - 1))
+#define SND_MAX_PWR (SND_MAX_VAL * SND_MAX_VAL)
+
+// On multi-core cpus the per-channel DSP chain (noise blanker, passband FIR, AGC, demodulators,
+// de-emphasis and LMS filters) runs on a work pool thread while c2s_sound() sleeps.
+// The channels then spread over the cores instead of all sharing the coroutine thread.
+#ifdef MULTI_CORE
+    #define SND_DSP_POOL
+#endif
+
+typedef struct {
+    int rx_chan, mode, ns_in;
+    bool masked, noise_blanker, do_de_emp, do_lms;
+    bool receive_FFT_pre, receive_FFT_post;     // only ever set when the block runs on the coroutine thread
+    int lms_denoise, lms_autonotch;
+    conn_t *conn;
+    rx_dpump_t *rx;
+    TYPECPX *i_samps, *f_samps;
+    TYPEMONO16 *r_samps;
+    double *z1;
+
+    // results
+    int ns_out, fir_pos, sq_nc_open;
+
+    work_t work;
+} snd_dsp_t;
+
+static snd_dsp_t snd_dsp[MAX_RX_CHANS];
+
+// Everything from the data pump samples to the audio samples for one block.
+// May run on a work pool thread so must only touch this channel's DSP state (see work_pool.h)
+static void snd_dsp_block(void *param)
+{
+    snd_dsp_t *d = (snd_dsp_t *) param;
+    int j, rx_chan = d->rx_chan;
+    rx_dpump_t *rx = d->rx;
+    TYPECPX *f_samps = d->f_samps;
+    TYPEMONO16 *r_samps = d->r_samps;
+    bool masked = d->masked;
+    
+    if (d->noise_blanker) {
+        m_NoiseProc[rx_chan][NB_SND].ProcessBlanker(d->ns_in, d->i_samps, d->i_samps);
+    }
+
+    int ns_out = m_PassbandFIR[rx_chan].ProcessData(rx_chan, d->ns_in, d->i_samps, f_samps,
+        d->receive_FFT_pre, d->receive_FFT_post);
+    d->ns_out = ns_out;
+    d->fir_pos = m_PassbandFIR[rx_chan].FirPos();
+    d->sq_nc_open = 0;
+    if (ns_out == 0) return;
+    
+    // NB: AGC is out-of-place for all these modes so f_samps is still the FIR output afterwards
+    // (S-meter and receive_iq() in c2s_sound)
+    switch (d->mode) {
+    
+    case MODE_AM:
+    case MODE_AMN: {
+        // AM detector from CuteSDR
+        TYPECPX *a_samps = rx->agc_samples;
+        m_Agc[rx_chan].ProcessData(ns_out, f_samps, a_samps, masked);
+    
+        TYPEREAL *d_samps = rx->demod_samples;
+    
+        for (j=0; j<ns_out; j++) {
+            double pwr = a_samps->re*a_samps->re + a_samps->im*a_samps->im;
+            double mag = sqrt(pwr);
+            #define DC_ALPHA 0.99
+            double z0 = mag + (*d->z1 * DC_ALPHA);
+            *d_samps = z0 - *d->z1;
+            *d->z1 = z0;
+            d_samps++;
+            a_samps++;
+        }
+        
+        // clean up residual noise left by detector
+        // the non-FFT FIR has no pipeline delay issues
+        d_samps = rx->demod_samples;
+        m_AM_FIR[rx_chan].ProcessFilter(ns_out, d_samps, r_samps);
+        break;
+    }
+    
+    case MODE_NBFM: {
+        TYPEREAL *d_samps = rx->demod_samples;
+        TYPECPX *a_samps = rx->agc_samples;
+        m_Agc[rx_chan].ProcessData(ns_out, f_samps, a_samps, masked);
+        
+        // FM demod from CSDR: https://github.com/simonyiszk/csdr
+        // also see: http://www.embedded.com/design/configurable-systems/4212086/DSP-Tricks--Frequency-demodulation-algorithms-
+        #define fmdemod_quadri_K 0.340447550238101026565118445432744920253753662109375
+        float i = a_samps->re, q = a_samps->im;
+        float iL = d->conn->last_sample.re, qL = d->conn->last_sample.im;
+        *d_samps = SND_MAX_VAL * fmdemod_quadri_K * (i*(q-qL) - q*(i-iL)) / (i*i + q*q);
+        d->conn->last_sample = a_samps[ns_out-1];
+        a_samps++; d_samps++;
+        
+        for (j=1; j < ns_out; j++) {
+            i = a_samps->re, q = a_samps->im;
+            iL = a_samps[-1].re, qL = a_samps[-1].im;
+            *d_samps = SND_MAX_VAL * fmdemod_quadri_K * (i*(q-qL) - q*(i-iL)) / (i*i + q*q);
+            a_samps++; d_samps++;
+        }
+        
+        d_samps = rx->demod_samples;
+    
+        // use the noise squelch from CuteSDR
+        d->sq_nc_open = m_FmDemod[rx_chan].PerformNoiseSquelch(ns_out, d_samps, r_samps);
+        break;
+    }
+    
+    case MODE_IQ:
+    case MODE_DRM:
+        break;
+    
+    case MODE_USB:
+    case MODE_USN:
+    case MODE_LSB:
+    case MODE_LSN:
+    case MODE_CW:
+    case MODE_CWN:
+        m_Agc[rx_chan].ProcessData(ns_out, f_samps, r_samps, masked);
+        break;
+    
+    default:
+        panic("mode");
+    }
+    
+    if (d->do_de_emp) {    // AM and NBFM modes
+        m_de_emp_Biquad[rx_chan].ProcessFilter(ns_out, r_samps, r_samps);
+    }
+    
+    if (d->do_lms) {       // AM and sideband modes
+    
+        // noise processors
+        if (d->lms_denoise) m_LMS_denoise[rx_chan].ProcessFilter(ns_out, r_samps, r_samps);
+        if (d->lms_autonotch) m_LMS_autonotch[rx_chan].ProcessFilter(ns_out, r_samps, r_samps);
+    }
+}
+
 void c2s_sound_init()
 {
 	//evSnd(EC_DUMP, EV_SND, 10000, "rx task", "overrun");
@@ -92,6 +234,10 @@ void c2s_sound_init()
 		spi_set(CmdSetGen, 0, 0);
 		spi_set(CmdSetGenAttn, 0, 0);
 	}
+	
+	#ifdef SND_DSP_POOL
+	    work_pool_init(sysconf(_SC_NPROCESSORS_ONLN) - 1);
+	#endif
 }
 
 #define CMD_FREQ		0x01
@@ -120,6 +266,7 @@ void c2s_sound(void *param)
 	snd_t *snd = &snd_inst[rx_chan];
 	rx_dpump_t *rx = &rx_dpump[rx_chan];
     iq_buf_t *iq = &RX_SHMEM->iq_buf[rx_chan];
+    spsc_set_waiter(&rx->in_ring, TaskID());    // data pump wakes us via spsc_wake(), cleared in c2s_sound_shutdown()
 	
 	int j, k, n, len, slen;
 	//static u4_t ncnt[MAX_RX_CHANS];
@@ -346,15 +493,8 @@ void c2s_sound(void *param)
                     int pb_lo = f + locut;
                     int pb_hi = f + hicut;
                     //printf("SND f=%d lo=%.0f|%d hi=%.0f|%d ", f, locut, pb_lo, hicut, pb_hi);
-                    for (j=0; j < dx.masked_len; j++) {
-                        dx_t *dxp = &dx.list[dx.masked_idx[j]];
-                        if (!((pb_hi < dxp->masked_lo || pb_lo > dxp->masked_hi))) {
-                            masked = true;
-                            //printf("MASKED");
-                            break;
-                        }
-                    }
-                    //printf("\n");
+                    masked = dx_masked(pb_lo, pb_hi);
+                    //printf("%s\n", masked? "MASKED" : "");
                 }
 			
 			    free(mode_m);
@@ -687,10 +827,12 @@ void c2s_sound(void *param)
 		bool isNBFM = (mode == MODE_NBFM);
 		bool IQ_or_DRM = (mode == MODE_IQ || mode == MODE_DRM);
 
-		u1_t *bp_real_u1  = snd->out_pkt_real.u1;
-		s2_t *bp_real_s2  = snd->out_pkt_real.s2;
-		u1_t *bp_iq_u1    = snd->out_pkt_iq.u1;
-		s2_t *bp_iq_s2    = snd->out_pkt_iq.s2;
+		// samples are written directly into the nbuf payload, only the header is copied (app_to_web_pkt)
+		nbuf_pkt_t *pkt = nbuf_pkt_alloc(IQ_or_DRM? sizeof(snd->out_pkt_iq.u1) : sizeof(snd->out_pkt_real.u1));
+		u1_t *bp_real_u1  = (u1_t *) pkt->buf;
+		s2_t *bp_real_s2  = (s2_t *) pkt->buf;
+		u1_t *bp_iq_u1    = (u1_t *) pkt->buf;
+		s2_t *bp_iq_s2    = (s2_t *) pkt->buf;
 		u1_t *flags    = (IQ_or_DRM? &snd->out_pkt_iq.h.flags : &snd->out_pkt_real.h.flags);
 		u1_t *seq      = (IQ_or_DRM? snd->out_pkt_iq.h.seq    : snd->out_pkt_real.h.seq);
 		char *smeter   = (IQ_or_DRM? snd->out_pkt_iq.h.smeter : snd->out_pkt_real.h.smeter);
@@ -704,18 +846,16 @@ void c2s_sound(void *param)
 
 		u2_t bc = 0;
 
-		ext_receive_S_meter_t receive_S_meter   = ext_users[rx_chan].receive_S_meter;
-		ext_receive_iq_samps_t receive_iq       = isNBFM? NULL : ext_users[rx_chan].receive_iq;
-		tid_t receive_iq_tid                    = isNBFM? (tid_t) NULL : ext_users[rx_chan].receive_iq_tid;
-		ext_receive_real_samps_t receive_real   = ext_users[rx_chan].receive_real;
-		tid_t receive_real_tid                  = ext_users[rx_chan].receive_real_tid;
+		bool receive_S_meter = extint_subscribed(rx_chan, EXT_STAGE_S_METER);
+		bool receive_iq      = !isNBFM && extint_subscribed(rx_chan, EXT_STAGE_IQ);
+		bool receive_real    = extint_subscribed(rx_chan, EXT_STAGE_REAL);
 		
 		int ns_out;
 		int fir_pos;
 		TYPECPX *f_samps;
 
         do {
-			while (rx->wr_pos == rx->rd_pos) {
+			while (spsc_empty(&rx->in_ring)) {
 				evSnd(EC_EVENT, EV_SND, -1, "rx_snd", "sleeping");
 
                 //#define MEAS_SND_LOOP
@@ -745,10 +885,11 @@ void c2s_sound(void *param)
 			
         	TaskStat2(TSTAT_INCR|TSTAT_ZERO, 0, "aud");
 
-			TYPECPX *i_samps = rx->in_samps[rx->rd_pos];
+			u4_t rd_pos = spsc_rd_slot(&rx->in_ring);
+			TYPECPX *i_samps = rx->in_samps[rd_pos];
 
 			// check 48-bit ticks counter timestamp in audio IQ stream
-			const u64_t ticks   = rx->ticks[rx->rd_pos];
+			const u64_t ticks   = rx->ticks[rd_pos];
 			const u64_t dt      = time_diff48(ticks, clk.ticks);  // time difference to last GPS solution
 #if 0
 			static u64_t last_ticks[MAX_RX_CHANS] = {0};
@@ -771,19 +912,17 @@ void c2s_sound(void *param)
 			gps_tsp->gpssec = fmod(gps_week_sec + clk.gps_secs + dt/clk.adc_clock_base - gps_delay + gps_delay2, gps_week_sec);
 
 		    #ifdef SND_SEQ_CHECK
-		        if (rx->in_seq[rx->rd_pos] != snd->snd_seq_ck) {
+		        if (rx->in_seq[rd_pos] != snd->snd_seq_ck) {
 		            if (!snd->snd_seq_ck_init) {
 		                snd->snd_seq_ck_init = true;
 		            } else {
-		                real_printf("rx%d: got %d expecting %d\n", rx_chan, rx->in_seq[rx->rd_pos], snd->snd_seq_ck);
+		                real_printf("rx%d: got %d expecting %d\n", rx_chan, rx->in_seq[rd_pos], snd->snd_seq_ck);
 		            }
-		            snd->snd_seq_ck = rx->in_seq[rx->rd_pos];
+		            snd->snd_seq_ck = rx->in_seq[rd_pos];
 		        }
 		        snd->snd_seq_ck++;
 		    #endif
 		    
-			rx->rd_pos = (rx->rd_pos+1) & (N_DPBUF-1);
-			
 			f_samps = &iq->iq_samples[iq->iq_wr_pos][0];
 			const int ns_in = nrx_samps;
 			
@@ -801,12 +940,28 @@ void c2s_sound(void *param)
                 }
             }
 
-			if (noise_blanker) {
-                m_NoiseProc[rx_chan][NB_SND].ProcessBlanker(ns_in, i_samps, i_samps);
-            }
-
-			ns_out  = m_PassbandFIR[rx_chan].ProcessData(rx_chan, ns_in, i_samps, f_samps);
-			fir_pos = m_PassbandFIR[rx_chan].FirPos();
+            TYPEMONO16 *r_samps = IQ_or_DRM? NULL : &rx->real_samples[rx->real_wr_pos][0];
+            
+            snd_dsp_t *d = &snd_dsp[rx_chan];
+            d->rx_chan = rx_chan; d->mode = mode; d->ns_in = ns_in;
+            d->masked = masked; d->noise_blanker = noise_blanker;
+            d->do_de_emp = do_de_emp; d->do_lms = do_lms;
+            d->lms_denoise = lms_denoise; d->lms_autonotch = lms_autonotch;
+            d->conn = conn; d->rx = rx; d->z1 = &z1;
+            d->i_samps = i_samps; d->f_samps = f_samps; d->r_samps = r_samps;
+
+            // The FIR delivers the FFT stages from inside, so extensions using them keep the DSP on this thread.
+            // The state is latched here: a subscription made while a pool job runs only takes effect next block.
+            d->receive_FFT_pre = extint_subscribed(rx_chan, EXT_STAGE_FFT_PRE);
+            d->receive_FFT_post = extint_subscribed(rx_chan, EXT_STAGE_FFT_POST);
+            if (d->receive_FFT_pre || d->receive_FFT_post)
+                snd_dsp_block(d);
+            else
+                work_run(&d->work, snd_dsp_block, d, "snd dsp");
+
+			spsc_pop(&rx->in_ring, N_DPBUF);     // done with i_samps, slot can be refilled
+			ns_out = d->ns_out;
+			fir_pos = d->fir_pos;
             // [this diagram was back when the audio buffer was 1/2 its current size and NRX_SAMPS = 84]
             //
 			// FIR has a pipeline delay:
@@ -855,13 +1010,10 @@ void c2s_sound(void *param)
             snd->out_pkt_iq.h.dummy = 0;
             gps_tsp->last_gpssec = gps_tsp->gpssec;
     
-            // Forward IQ samples if requested.
+            // Forward IQ samples to all subscribers if requested.
             // Remember that receive_iq() is used to pushback test data in some cases, e.g. DRM
-            if (receive_iq != NULL)
-                receive_iq(rx_chan, 0, ns_out, f_samps);
-            
-            if (receive_iq_tid != (tid_t) NULL)
-                TaskWakeup(receive_iq_tid, TWF_CHECK_WAKING, TO_VOID_PARAM(rx_chan));
+            if (receive_iq)
+                extint_receive_iq_samps(rx_chan, ns_out, f_samps);
     
             // delay updating iq_wr_pos until after AGC applied below
             
@@ -869,11 +1021,6 @@ void c2s_sound(void *param)
             for (j=0; j<ns_out; j++) {
     
                 // S-meter from CuteSDR
-                // FIXME: Why is SND_MAX_VAL less than CUTESDR_MAX_VAL again?
-                // And does this explain the need for SMETER_CALIBRATION?
-                // Can't remember how this evolved..
-                #define SND_MAX_VAL ((float) ((1 << (CUTESDR_SCALE-2)) - 1))
-                #define SND_MAX_PWR (SND_MAX_VAL * SND_MAX_VAL)
                 float re = (float) f_sa->re, im = (float) f_sa->im;
                 float pwr = re*re + im*im;
                 float pwr_dB = 10.0 * log10f((pwr / SND_MAX_PWR) + 1e-30);
@@ -882,105 +1029,17 @@ void c2s_sound(void *param)
             
                 // forward S-meter samples if requested
                 // S-meter value in audio packet is sent less often than if we send it from here
-                if (receive_S_meter != NULL && (j == 0 || j == ns_out/2))
-                    receive_S_meter(rx_chan, sMeterAvg_dB + S_meter_cal);
+                if (receive_S_meter && (j == 0 || j == ns_out/2))
+                    extint_receive_S_meter(rx_chan, sMeterAvg_dB + S_meter_cal);
             }
             
-            TYPEMONO16 *r_samps;
-            
             if (!IQ_or_DRM) {
-                r_samps = &rx->real_samples[rx->real_wr_pos][0];
                 rx->real_seqnum[rx->real_wr_pos] = rx->real_seq;
                 rx->real_seq++;
             }
             
-            switch (mode) {
-            
-            case MODE_AM:
-            case MODE_AMN: {
-                // AM detector from CuteSDR
-                TYPECPX *a_samps = rx->agc_samples;
-                m_Agc[rx_chan].ProcessData(ns_out, f_samps, a_samps, masked);
-    
-                TYPEREAL *d_samps = rx->demod_samples;
-    
-                for (j=0; j<ns_out; j++) {
-                    double pwr = a_samps->re*a_samps->re + a_samps->im*a_samps->im;
-                    double mag = sqrt(pwr);
-                    #define DC_ALPHA 0.99
-                    double z0 = mag + (z1 * DC_ALPHA);
-                    *d_samps = z0-z1;
-                    z1 = z0;
-                    d_samps++;
-                    a_samps++;
-                }
-                
-                // clean up residual noise left by detector
-                // the non-FFT FIR has no pipeline delay issues
-                d_samps = rx->demod_samples;
-                m_AM_FIR[rx_chan].ProcessFilter(ns_out, d_samps, r_samps);
-                break;
-            }
-            
-            case MODE_NBFM: {
-                TYPEREAL *d_samps = rx->demod_samples;
-                TYPECPX *a_samps = rx->agc_samples;
-                m_Agc[rx_chan].ProcessData(ns_out, f_samps, a_samps, masked);
-                int sq_nc_open;
-                
-                // FM demod from CSDR: https://github.com/simonyiszk/csdr
-                // also see: http://www.embedded.com/design/configurable-systems/4212086/DSP-Tricks--Frequency-demodulation-algorithms-
-                #define fmdemod_quadri_K 0.340447550238101026565118445432744920253753662109375
-                float i = a_samps->re, q = a_samps->im;
-                float iL = conn->last_sample.re, qL = conn->last_sample.im;
-                *d_samps = SND_MAX_VAL * fmdemod_quadri_K * (i*(q-qL) - q*(i-iL)) / (i*i + q*q);
-                conn->last_sample = a_samps[ns_out-1];
-                a_samps++; d_samps++;
-                
-                for (j=1; j < ns_out; j++) {
-                    i = a_samps->re, q = a_samps->im;
-                    iL = a_samps[-1].re, qL = a_samps[-1].im;
-                    *d_samps = SND_MAX_VAL * fmdemod_quadri_K * (i*(q-qL) - q*(i-iL)) / (i*i + q*q);
-                    a_samps++; d_samps++;
-                }
-                
-                d_samps = rx->demod_samples;
-    
-                // use the noise squelch from CuteSDR
-                sq_nc_open = m_FmDemod[rx_chan].PerformNoiseSquelch(ns_out, d_samps, r_samps);
-                
-                if (sq_nc_open != 0) {
-                    send_msg(conn, SM_NO_DEBUG, "MSG squelch=%d", (sq_nc_open == 1)? 1:0);
-                }
-                break;
-            }
-            
-            case MODE_IQ:
-            case MODE_DRM:
-                break;
-            
-            case MODE_USB:
-            case MODE_USN:
-            case MODE_LSB:
-            case MODE_LSN:
-            case MODE_CW:
-            case MODE_CWN:
-                m_Agc[rx_chan].ProcessData(ns_out, f_samps, r_samps, masked);
-                break;
-    
-            default:
-                panic("mode");
-            }
-    
-            if (do_de_emp) {    // AM and NBFM modes
-                m_de_emp_Biquad[rx_chan].ProcessFilter(ns_out, r_samps, r_samps);
-            }
-    
-            if (do_lms) {       // AM and sideband modes
-    
-                // noise processors
-                if (lms_denoise) m_LMS_denoise[rx_chan].ProcessFilter(ns_out, r_samps, r_samps);
-                if (lms_autonotch) m_LMS_autonotch[rx_chan].ProcessFilter(ns_out, r_samps, r_samps);
+            if (d->sq_nc_open != 0) {
+                send_msg(conn, SM_NO_DEBUG, "MSG squelch=%d", (d->sq_nc_open == 1)? 1:0);
             }
             
             
@@ -1029,12 +1088,9 @@ void c2s_sound(void *param)
                 iq->iq_wr_pos = (iq->iq_wr_pos+1) & (N_DPBUF-1);
                 rx->real_wr_pos = (rx->real_wr_pos+1) & (N_DPBUF-1);
     
-                // forward real samples if requested
-                if (receive_real != NULL)
-                    receive_real(rx_chan, 0, ns_out, r_samps);
-                
-                if (receive_real_tid != (tid_t) NULL)
-                    TaskWakeup(receive_real_tid, TWF_CHECK_WAKING, TO_VOID_PARAM(rx_chan));
+                // forward real samples to all subscribers if requested
+                if (receive_real)
+                    extint_receive_real_samps(rx_chan, ns_out, r_samps);
     
                 if (compression) {
                     encode_ima_adpcm_i16_e8(r_samps, bp_real_u1, ns_out, &rx->adpcm_snd);
@@ -1184,14 +1240,13 @@ void c2s_sound(void *param)
                 snd->out_pkt_iq.h.gpssec = 0;
                 snd->out_pkt_iq.h.gpsnsec = 0;
             }
-            const int bytes = sizeof(snd->out_pkt_iq.h) + bc;
-            app_to_web(conn, (char*) &snd->out_pkt_iq, bytes);
+            app_to_web_pkt(conn, (char*) &snd->out_pkt_iq.h, sizeof(snd->out_pkt_iq.h), pkt, 0, bc);
             aud_bytes = sizeof(snd->out_pkt_iq.h.smeter) + bc;
         } else {
-            const int bytes = sizeof(snd->out_pkt_real.h) + bc;
-            app_to_web(conn, (char*) &snd->out_pkt_real, bytes);
+            app_to_web_pkt(conn, (char*) &snd->out_pkt_real.h, sizeof(snd->out_pkt_real.h), pkt, 0, bc);
             aud_bytes = sizeof(snd->out_pkt_real.h.smeter) + bc;
         }
+        nbuf_pkt_unref(pkt);
         audio_bytes[rx_chan] += aud_bytes;
         audio_bytes[rx_chans] += aud_bytes;     // [rx_chans] is the sum of all audio channels
 
@@ -1275,6 +1330,8 @@ void c2s_sound_shutdown(void *param)
 {
     conn_t *c = (conn_t*)(param);
     //cprintf(c, "rx%d c2s_sound_shutdown mc=0x%x\n", c->rx_channel, c->mc);
+    if (c && c->rx_channel >= 0 && c->rx_channel < MAX_RX_CHANS && c->task)
+        spsc_clear_waiter(&rx_dpump[c->rx_channel].in_ring, c->task);
     if (c && c->mc) {
         rx_server_websocket(WS_MODE_CLOSE, c->mc);
     }
@@ -221,7 +221,6 @@ void update_vars_from_config()
     cfg_default_int("tdoa_nchans", -1, &update_cfg);
     cfg_default_bool("no_wf", false, &update_cfg);
     cfg_default_bool("test_webserver_prio", false, &update_cfg);
-    cfg_default_bool("test_deadline_update", false, &update_cfg);
     cfg_default_bool("disable_recent_changes", false, &update_cfg);
     cfg_default_int("init.cw_offset", 500, &update_cfg);
     cfg_default_int("S_meter_OV_counts", 10, &update_cfg);
@@ -538,6 +537,7 @@ void webserver_collect_print_stats(int print)
 		
 		nusers++;
 	}
+	if (nusers != current_nusers) rx_server_ajax_invalidate();
 	current_nusers = nusers;
 
 	// construct cpu stats response
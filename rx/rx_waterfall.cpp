@@ -39,6 +39,7 @@ Boston, MA  02110-1301, USA.
 #include "non_block.h"
 #include "rx_waterfall.h"
 #include "shmem.h"
+#include "simd.h"
 
 #include <string.h>
 #include <stdio.h>
@@ -57,6 +58,11 @@ Boston, MA  02110-1301, USA.
 //#define SHOW_MAX_MIN_PWR
 //#define SHOW_MAX_MIN_DB
 
+// the debug code needs the intermediate values the simd kernels don't produce
+#if defined(SHOW_MAX_MIN_PWR) || defined(SHOW_MAX_MIN_DB)
+    #define WF_SCALAR
+#endif
+
 #define MAX_FFT_USED	MAX(WF_C_NFFT / WF_USING_HALF_FFT, WF_WIDTH)
 
 #define	MAX_START(z)	((WF_WIDTH << MAX_ZOOM) - (WF_WIDTH << (MAX_ZOOM - z)))
@@ -89,6 +95,20 @@ struct iq_t {
 
 #define	SO_OUT_HDR	((int) (sizeof(wf_pkt_t) - sizeof(out->un)))
 #define	SO_OUT_NOM	((int) (SO_OUT_HDR + sizeof(out->un.buf)))
+
+#ifdef WF_SHARE
+    // Last frame computed by each channel. Kept in this process (not WF_SHMEM) because
+    // the nbuf payload is referenced directly by the websocket output queues.
+    static nbuf_pkt_t *wf_share_pkt[MAX_WF_CHANS];
+
+    // drop the channel's shared frame so other channels stop using it and its payload is freed
+    static void wf_share_release(int rx_chan)
+    {
+        memset(&WF_SHMEM->wf_share[rx_chan], 0, sizeof(wf_share_t));
+        if (wf_share_pkt[rx_chan]) nbuf_pkt_unref(wf_share_pkt[rx_chan]);
+        wf_share_pkt[rx_chan] = NULL;
+    }
+#endif
 		
 void c2s_waterfall_init()
 {
@@ -216,6 +236,10 @@ void c2s_waterfall(void *param)
     wf->mark = timer_ms();
     wf->prev_start = wf->prev_zoom = -1;
     wf->snd = &snd_inst[rx_chan];
+    
+    #ifdef WF_SHARE
+        if (wf->isWF) wf_share_release(rx_chan);
+    #endif
 
     wf->check_overlapped_sampling = true;
     int n_chunks = WF_SHMEM->n_chunks;
@@ -532,6 +556,9 @@ void c2s_waterfall(void *param)
 
 		if (conn->stop_data) {
 			//clprintf(conn, "W/F stop_data rx_server_remove()\n");
+			#ifdef WF_SHARE
+			    if (wf->isWF) wf_share_release(rx_chan);
+			#endif
 			rx_enable(rx_chan, RX_CHAN_FREE);
 			rx_server_remove(conn);
 			panic("shouldn't return");
@@ -557,6 +584,9 @@ void c2s_waterfall(void *param)
 				rx_enable(rx_chan, RX_CHAN_FREE);		// there is no SND, so free rx_chan[] now
 			}
 			
+			#ifdef WF_SHARE
+			    if (wf->isWF) wf_share_release(rx_chan);
+			#endif
 			//clprintf(conn, "W/F rx_server_remove()\n");
 			rx_server_remove(conn);
 			panic("shouldn't return");
@@ -683,17 +713,13 @@ void c2s_waterfall(void *param)
 			//fft_scale = (zoom? 2.0 : 5.0) / (maxmag * maxmag);
 			
 			// apply masked frequencies
-			if (dx.masked_len != 0 && !(conn->other != NULL && conn->other->tlimit_exempt_by_pwd)) {
+			wf->masked = (dx.masked_len != 0 && !(conn->other != NULL && conn->other->tlimit_exempt_by_pwd));
+			wf->masked_seq = masked_seq;
+			if (wf->masked) {
                 for (i=0; i < wf->plot_width_clamped; i++) {
                     float scale = fft_scale;
                     int f = roundf((wf->start + (i << (MAX_ZOOM - zoom))) * HZperStart);
-                    for (j=0; j < dx.masked_len; j++) {
-                        dx_t *dxp = &dx.list[dx.masked_idx[j]];
-                        if (f >= dxp->masked_lo && f <= dxp->masked_hi) {
-                            scale = 0;
-                            break;
-                        }
-                    }
+                    if (dx_masked(f, f)) scale = 0;
                     wf->fft_scale[i] = scale;
                 }
 			} else {
@@ -717,6 +743,109 @@ void c2s_waterfall(void *param)
 	}
 }
 
+#ifdef WF_SHARE
+
+static void wf_share_key(wf_inst_t *wf, wf_share_key_t *key)
+{
+    memset(key, 0, sizeof(wf_share_key_t));     // so memcmp() works
+    key->zoom = wf->zoom;
+    key->start = wf->start;
+    key->speed = wf->speed;
+    key->noise_blanker = wf->noise_blanker;
+    key->noise_threshold = wf->noise_threshold;
+    key->nb_click = wf->nb_click;
+    key->masked = wf->masked;
+    key->masked_seq = wf->masked_seq;
+    key->compression = wf->compression;
+}
+
+// Look for a frame with the same key computed by another channel within the last frame interval.
+// If another channel is in the middle of computing one wait for it rather than duplicating the work.
+// Returns the frame to be sent by reference, or NULL.
+static nbuf_pkt_t *wf_share_get(wf_inst_t *wf, wf_share_key_t *key, int desired)
+{
+    int ch, waited = 0, wait_max = wf->samp_wait_ms + desired;
+    
+    while (true) {
+        bool busy = false;
+        
+        for (ch = 0; ch < wf_chans; ch++) {
+            if (ch == wf->rx_chan) continue;
+            wf_share_t *sh = &WF_SHMEM->wf_share[ch];
+            if (!sh->valid || memcmp(&sh->key, key, sizeof(wf_share_key_t)) != 0) continue;
+            if (sh->busy) {
+                busy = true;
+                continue;
+            }
+            if ((int) (timer_ms() - sh->time_ms) >= desired || wf_share_pkt[ch] == NULL) continue;
+            
+            wf->out_bytes = sh->out_bytes;
+            return wf_share_pkt[ch];
+        }
+        
+        if (!busy || waited >= wait_max) return NULL;
+        #define WF_SHARE_POLL_MS 5
+        WFSleepReasonMsec("wait shared", WF_SHARE_POLL_MS);
+        waited += WF_SHARE_POLL_MS;
+    }
+}
+
+#endif
+
+// Frame header start/zoom as this connection expects them, advancing its own pipe flush countdown.
+static void wf_frame_hdr(wf_inst_t *wf, wf_pkt_t *out)
+{
+	if (wf->flush_wf_pipe) {
+		out->x_bin_server = (wf->prev_start == -1)? wf->start : wf->prev_start;
+		out->flags_x_zoom_server = (wf->prev_zoom == -1)? wf->zoom : wf->prev_zoom;
+		wf->flush_wf_pipe--;
+		if (wf->flush_wf_pipe == 0) {
+			//jksd
+			printf("PIPE start P%d/C%d zoom P%d/C%d\n", wf->prev_start, wf->start, wf->prev_zoom, wf->zoom);
+			wf->prev_start = wf->start;
+			wf->prev_zoom = wf->zoom;
+		}
+	} else {
+		out->x_bin_server = wf->start;
+		out->flags_x_zoom_server = wf->zoom;
+	}
+	
+	if (wf->compression)
+		out->flags_x_zoom_server |= WF_FLAGS_COMPRESSION;
+}
+
+// The frame data is sent by reference, only the header is per-connection (seq syncs to our own audio).
+// A frame shared from another channel also gets its header rewritten from our own wf_inst_t.
+static void wf_send_frame(wf_inst_t *wf, int rx_chan, nbuf_pkt_t *pkt, u4_t seq, bool shared)
+{
+    wf_pkt_t *out, hdr;
+    memcpy(&hdr, pkt->buf, SO_OUT_HDR);
+    if (shared) wf_frame_hdr(wf, &hdr);
+    hdr.seq = seq;
+    app_to_web_pkt(wf->conn, (char*) &hdr, SO_OUT_HDR, pkt, SO_OUT_HDR, wf->out_bytes);
+    waterfall_bytes[rx_chan] += wf->out_bytes;
+    waterfall_bytes[rx_chans] += wf->out_bytes; // [rx_chans] is the sum of all waterfalls
+    waterfall_frames[rx_chan]++;
+    waterfall_frames[rx_chans]++;       // [rx_chans] is the sum of all waterfalls
+}
+
+static void wf_wait_frame(wf_inst_t *wf, int desired)
+{
+    int actual = timer_ms() - wf->mark;
+    int delay = desired - actual;
+    //printf("%d %d %d\n", delay, actual, desired);
+    
+    // full sampling faster than needed by frame rate
+    if (desired > actual) {
+        evWF(EC_EVENT, EV_WF, -1, "WF", "TaskSleep wait FPS");
+        WFSleepReasonMsec("wait frame", delay);
+        evWF(EC_EVENT, EV_WF, -1, "WF", "TaskSleep wait FPS done");
+    } else {
+        WFNextTask("loop");
+    }
+    wf->mark = timer_ms();
+}
+
 void sample_wf(int rx_chan)
 {
 	wf_inst_t *wf = &WF_SHMEM->wf_inst[rx_chan];
@@ -740,6 +869,23 @@ void sample_wf(int rx_chan)
     assert(wf_fps[wf->speed] != 0);
     int desired = 1000 / wf_fps[wf->speed];
 
+    #ifdef WF_SHARE
+        wf_share_key_t key;
+        wf_share_key(wf, &key);
+        
+        nbuf_pkt_t *shared = wf_share_get(wf, &key, desired);
+        if (shared) {
+            wf_send_frame(wf, rx_chan, shared, wf->snd_seq, true);
+            wf_wait_frame(wf, desired);
+            return;
+        }
+        
+        // let other channels with the same key know a frame is on the way
+        wf_share_t *sh = &WF_SHMEM->wf_share[rx_chan];
+        sh->key = key;
+        sh->busy = sh->valid = true;
+    #endif
+
     // desired frame rate greater than what full sampling can deliver, so start overlapped sampling
     if (wf->check_overlapped_sampling) {
         wf->check_overlapped_sampling = false;
@@ -865,12 +1011,22 @@ void sample_wf(int rx_chan)
             #endif
         #endif
         
+        // the only copy of the frame: out of WF_SHMEM into the nbuf payload
         wf_pkt_t *out = &wf->out;
-        app_to_web(wf->conn, (char*) out, SO_OUT_HDR + wf->out_bytes);
-        waterfall_bytes[rx_chan] += wf->out_bytes;
-        waterfall_bytes[rx_chans] += wf->out_bytes; // [rx_chans] is the sum of all waterfalls
-        waterfall_frames[rx_chan]++;
-        waterfall_frames[rx_chans]++;       // [rx_chans] is the sum of all waterfalls
+        nbuf_pkt_t *pkt = nbuf_pkt_alloc(SO_OUT_HDR + wf->out_bytes);
+        memcpy(pkt->buf, out, SO_OUT_HDR + wf->out_bytes);
+
+        #ifdef WF_SHARE
+            if (wf_share_pkt[rx_chan]) nbuf_pkt_unref(wf_share_pkt[rx_chan]);
+            nbuf_pkt_ref(pkt);
+            wf_share_pkt[rx_chan] = pkt;
+            sh->out_bytes = wf->out_bytes;
+            sh->time_ms = timer_ms();
+            sh->busy = false;
+        #endif
+
+        wf_send_frame(wf, rx_chan, pkt, out->seq, false);
+        nbuf_pkt_unref(pkt);
         evWF(EC_EVENT, EV_WF, -1, "WF", "compute_frame: done");
     
         #if 0
@@ -882,19 +1038,7 @@ void sample_wf(int rx_chan)
         #endif
     //}
 
-    int actual = timer_ms() - wf->mark;
-    int delay = desired - actual;
-    //printf("%d %d %d\n", delay, actual, desired);
-    
-    // full sampling faster than needed by frame rate
-    if (desired > actual) {
-        evWF(EC_EVENT, EV_WF, -1, "WF", "TaskSleep wait FPS");
-        WFSleepReasonMsec("wait frame", delay);
-        evWF(EC_EVENT, EV_WF, -1, "WF", "TaskSleep wait FPS done");
-    } else {
-        WFNextTask("loop");
-    }
-    wf->mark = timer_ms();
+    wf_wait_frame(wf, desired);
 }
 
 void compute_frame(int rx_chan)
@@ -932,6 +1076,29 @@ void compute_frame(int rx_chan)
 
 	// zero-out the DC component in bin zero/one (around -90 dBFS)
 	// otherwise when scrolling w/f it will move but then not continue at the new location
+#ifndef WF_SCALAR
+	fft->hw_fft[0][I] = fft->hw_fft[0][Q] = 0;
+	fft->hw_fft[1][I] = fft->hw_fft[1][Q] = 0;
+
+	if (wf->fft_used >= wf->plot_width) {
+		// >= FFT than plot
+		float pwr_out_peak[WF_WIDTH];
+		int limit = simd_mag2_peak_map(wf->fft_used_limit, fft->hw_fft, wf->fft2wf_map, pwr_out_peak, WF_WIDTH);
+		if (limit < wf->fft_used_limit) {
+			wf->fft_used_limit = limit;		// we now know what the limit is
+			wf->new_map = FALSE;
+		}
+		simd_dB_u8(WF_WIDTH, pwr_out_peak, wf->fft_scale, wf->fft_offset, bp);
+	} else {
+		// < FFT than plot
+		float pwr_out[WF_WIDTH];
+		wf->new_map = FALSE;
+		simd_mag2_cf(wf->fft_used_limit, fft->hw_fft, pwr);
+		for (i=0; i<wf->plot_width_clamped; i++)
+			pwr_out[i] = pwr[wf->wf2fft_map[i]];
+		simd_dB_u8(wf->plot_width_clamped, pwr_out, wf->fft_scale, wf->fft_offset, bp);
+	}
+#else
 	pwr[0] = 0;
 	pwr[1] = 0;
 	
@@ -1111,21 +1278,9 @@ if (i == 516) printf("\n");
 			*bp++ = (u1_t) (int) dB;
 		}
 	}
+#endif
 	
-	if (wf->flush_wf_pipe) {
-		out->x_bin_server = (wf->prev_start == -1)? wf->start : wf->prev_start;
-		out->flags_x_zoom_server = (wf->prev_zoom == -1)? wf->zoom : wf->prev_zoom;
-		wf->flush_wf_pipe--;
-		if (wf->flush_wf_pipe == 0) {
-			//jksd
-			printf("PIPE start P%d/C%d zoom P%d/C%d\n", wf->prev_start, wf->start, wf->prev_zoom, wf->zoom);
-			wf->prev_start = wf->start;
-			wf->prev_zoom = wf->zoom;
-		}
-	} else {
-		out->x_bin_server = wf->start;
-		out->flags_x_zoom_server = wf->zoom;
-	}
+	wf_frame_hdr(wf, out);
 	
 	evWF(EC_EVENT, EV_WF, -1, "WF", "compute_frame: fill out buf");
 
@@ -1136,7 +1291,6 @@ if (i == 516) printf("\n");
 		memset(&adpcm_wf, 0, sizeof(ima_adpcm_state_t));
 		encode_ima_adpcm_u8_e8(out->un.buf, out->un.buf, ADPCM_PAD + WF_WIDTH, &adpcm_wf);
 		wf->out_bytes = (ADPCM_PAD + WF_WIDTH) * sizeof(u1_t) / 2;
-		out->flags_x_zoom_server |= WF_FLAGS_COMPRESSION;
 	} else {
 		wf->out_bytes = WF_WIDTH * sizeof(u1_t);
 	}
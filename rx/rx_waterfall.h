@@ -107,6 +107,26 @@ struct wf_inst_t {
 	int out_bytes;
 	bool check_overlapped_sampling, overlapped_sampling;
 	int samp_wait_ms, chunk_wait_us;
+	bool masked;
+	int masked_seq;
+};
+
+// Shared frame cache: waterfalls parked on the same zoom/start (very common at z0 on a busy Kiwi)
+// would otherwise each sample and FFT an identical spectrum.
+#define WF_SHARE
+
+// everything that makes two channels' computed frames identical
+struct wf_share_key_t {
+	int zoom, start, speed;
+	int noise_blanker, noise_threshold, nb_click;
+	int masked, masked_seq, compression;
+};
+
+struct wf_share_t {
+	bool valid, busy;
+	wf_share_key_t key;
+	u4_t time_ms;
+	int out_bytes;      // frame itself is wf_share_pkt[] in rx_waterfall.cpp
 };
 
 struct wf_shmem_t {
@@ -114,6 +134,7 @@ struct wf_shmem_t {
     fft_t fft_inst[MAX_WF_CHANS];           // NB: MAX_WF_CHANS not MAX_RX_CHANS
     float window_function[WF_C_NSAMPS];
     int n_chunks;
+    wf_share_t wf_share[MAX_WF_CHANS];      // indexed by the rx_chan that computed the frame
 };     
 
 #ifdef MULTI_CORE
@@ -182,6 +182,7 @@ struct TASK {
 
 	TASK *interrupted_task;
 	s64_t deadline;
+	int heap_idx;           // position in task_deadline_heap[], -1 if no deadline
 	u4_t *wakeup_test;
 	u4_t run, cmds;
 	#define N_REASON 64
@@ -207,6 +208,13 @@ struct TASK {
 	u4_t spi_retry;
 	int stack_hiwat;
 	void *user_param;
+
+	// always-on accounting for TaskSchedStats()
+	u64_t ready_us;             // when made runnable (or the deadline slept until), 0 if not waiting to run
+	bool deadline_wake;
+	u4_t wake_latency, deadline_misses;
+	u64_t cpu_usec;
+	lat_hist_t wake_hist, quanta_hist, late_hist;
 };
 
 static bool task_package_init;
@@ -221,6 +229,16 @@ static u4_t previous_prio_inversion;
 
 static int itask_tid;
 static u64_t itask_last_tstart;
+static u64_t task_stats_start_us, task_stats_idle_us;
+
+// Per-priority bitmaps of runnable (!stopped) tasks indexed by task id, a bitmap of tasks sleeping
+// on a wakeup_test and a min-heap of tasks sleeping with a deadline.
+// NextTask() uses these instead of walking every task on every scheduling pass.
+#define TASK_MASK_WORDS ((MAX_TASKS + 31) / 32)
+static u4_t task_runnable_mask[NUM_PRIORITY][TASK_MASK_WORDS];
+static u4_t task_wakeup_test_mask[TASK_MASK_WORDS];
+static TASK *task_deadline_heap[MAX_TASKS];
+static int task_deadline_n;
 
 
 // NB: These use static buffers. The intent is that these are called as args in other printfs (short lifetime).
@@ -302,15 +320,115 @@ void runnable(TaskQ_t *tq, int chg)
     #define runnable(tq, chg)
 #endif
 
+#define TASK_MASK_SET(m, id)    (m)[(id) >> 5] |= 1U << ((id) & 31)
+#define TASK_MASK_CLR(m, id)    (m)[(id) >> 5] &= ~(1U << ((id) & 31))
+
+// only tasks currently on a TaskQ appear in the runnable bitmap
+static void task_stopped(TASK *t, bool stopped)
+{
+    if (t->stopped && !stopped) t->ready_us = timer_us64();
+    t->stopped = stopped;
+    if (stopped || t->tll.prev == NULL)
+        TASK_MASK_CLR(task_runnable_mask[t->priority], t->id);
+    else
+        TASK_MASK_SET(task_runnable_mask[t->priority], t->id);
+}
+
+static int task_mask_count(u4_t *mask)
+{
+    int i, n = 0;
+    for (i = 0; i < TASK_MASK_WORDS; i++) n += __builtin_popcount(mask[i]);
+    return n;
+}
+
+// lowest set bit at or after id "first", wrapping around, -1 if none
+static int task_mask_next(u4_t *mask, int first)
+{
+    if (first >= MAX_TASKS) first = 0;
+    int i, w = first >> 5;
+    u4_t m = mask[w] & (~0U << (first & 31));
+
+    for (i = 0; i <= TASK_MASK_WORDS; i++) {
+        if (m) return (w << 5) + ffs(m) - 1;
+        w = (w + 1) % TASK_MASK_WORDS;
+        m = mask[w];
+    }
+    return -1;
+}
+
+static void task_deadline_sift(int i)
+{
+    TASK *t = task_deadline_heap[i];
+
+    while (i > 0) {
+        int parent = (i-1) / 2;
+        TASK *pt = task_deadline_heap[parent];
+        if (pt->deadline <= t->deadline) break;
+        task_deadline_heap[i] = pt;
+        pt->heap_idx = i;
+        i = parent;
+    }
+
+    while (1) {
+        int child = 2*i + 1;
+        if (child >= task_deadline_n) break;
+        if (child+1 < task_deadline_n && task_deadline_heap[child+1]->deadline < task_deadline_heap[child]->deadline)
+            child++;
+        TASK *ct = task_deadline_heap[child];
+        if (ct->deadline >= t->deadline) break;
+        task_deadline_heap[i] = ct;
+        ct->heap_idx = i;
+        i = child;
+    }
+
+    task_deadline_heap[i] = t;
+    t->heap_idx = i;
+}
+
+static void task_deadline_set(TASK *t, s64_t deadline)
+{
+    t->deadline = deadline;
+    if (t->heap_idx < 0) {
+        assert(task_deadline_n < MAX_TASKS);
+        t->heap_idx = task_deadline_n++;
+        task_deadline_heap[t->heap_idx] = t;
+    }
+    task_deadline_sift(t->heap_idx);
+}
+
+static void task_deadline_clear(TASK *t)
+{
+    t->deadline = 0;
+    int i = t->heap_idx;
+    if (i < 0) return;
+    t->heap_idx = -1;
+
+    TASK *last = task_deadline_heap[--task_deadline_n];
+    if (last != t) {
+        task_deadline_heap[i] = last;
+        last->heap_idx = i;
+        task_deadline_sift(i);
+    }
+}
+
+static void task_wakeup_test_set(TASK *t, u4_t *wakeup_test)
+{
+    t->wakeup_test = wakeup_test;
+    if (wakeup_test != NULL)
+        TASK_MASK_SET(task_wakeup_test_mask, t->id);
+    else
+        TASK_MASK_CLR(task_wakeup_test_mask, t->id);
+}
+
 #define RUNNABLE_YES(tp) \
-    (tp)->stopped = FALSE; \
+    task_stopped((tp), FALSE); \
     run[(tp)->id].r = 1; \
     runnable((tp)->tq, 1); \
     (tp)->sleeping = FALSE; \
     (tp)->wakeup = TRUE;
 
 #define RUNNABLE_NO(tp, chg) \
-    (tp)->stopped = TRUE; \
+    task_stopped((tp), TRUE); \
     run[(tp)->id].r = 0; \
     runnable((tp)->tq, chg); \
     (tp)->sleeping = TRUE; \
@@ -329,6 +447,7 @@ static void TenQ(TASK *t, int priority)
 	tq->count++;
 
 	if (!t->stopped) runnable(tq, 1);
+	task_stopped(t, t->stopped);
 
 	t->tq = tq;
 }
@@ -351,6 +470,7 @@ static void TdeQ(TASK *t)
 	}
 
 	if (!t->stopped) runnable(tq, -1);
+	TASK_MASK_CLR(task_runnable_mask[t->priority], t->id);
 	tq->count--;
 }
 
@@ -516,6 +636,80 @@ void TaskDump(u4_t flags)
 	}
 }
 
+void lat_hist_add(lat_hist_t *h, u4_t usec)
+{
+    int b;
+    if (usec < 2) {
+        b = usec;
+    } else {
+        int msb = 31 - __builtin_clz(usec);
+        b = 2*msb + ((usec >> (msb-1)) & 1);
+        b = MIN(b, LAT_HIST_N-1);
+    }
+    h->b[b]++;
+    h->n++;
+    h->sum += usec;
+    if (usec > h->max) h->max = usec;
+}
+
+char *lat_hist_json(char *ks, lat_hist_t *h)
+{
+    int nb;
+    for (nb = LAT_HIST_N; nb > 0 && h->b[nb-1] == 0; nb--)
+        ;
+    ks = kstr_asprintf(ks, "{\"n\":%u,\"a\":%u,\"x\":%u,", h->n, h->n? (u4_t) (h->sum / h->n) : 0, h->max);
+    return kstr_cat(ks, kstr_list_int("\"b\":[", "%u", "]}", (int *) h->b, nb));
+}
+
+// A deadline wakeup running later than this counts as a miss.
+#define TASK_LATE_USEC  2000
+
+u4_t TaskWakeLatency()
+{
+    return cur_task? cur_task->wake_latency : 0;
+}
+
+// Cumulative since the last reset so a poller can difference successive replies.
+// "el" and "id" are elapsed and idle usec, per task "c" is cpu usec, "w" the wakeup (runnable to running) latency,
+// "q" run quanta and "l" lateness of deadline wakeups with "m" of those later than TASK_LATE_USEC.
+char *TaskSchedStats(char *ks, bool reset)
+{
+    int i;
+    TASK *t;
+    u64_t now = timer_us64();
+    
+    ks = kstr_asprintf(ks, "\"el\":%llu,\"id\":%llu,\"t\":[", now - task_stats_start_us, task_stats_idle_us);
+    
+    bool first = true;
+	for (i=0; i <= max_task; i++) {
+		t = Tasks + i;
+		if (!t->valid) continue;
+		ks = kstr_asprintf(ks, "%s{\"i\":%d,\"n\":\"%s\",\"p\":%d,\"c\":%llu,\"m\":%u,\"w\":", first? "":",",
+		    i, t->name? t->name : "?", t->priority, t->cpu_usec, t->deadline_misses);
+		ks = lat_hist_json(ks, &t->wake_hist);
+		ks = kstr_cat(ks, ",\"q\":");
+		ks = lat_hist_json(ks, &t->quanta_hist);
+		ks = kstr_cat(ks, ",\"l\":");
+		ks = lat_hist_json(ks, &t->late_hist);
+		ks = kstr_cat(ks, "}");
+		first = false;
+		
+		if (reset) {
+		    t->cpu_usec = 0;
+		    t->deadline_misses = 0;
+		    memset(&t->wake_hist, 0, sizeof(t->wake_hist));
+		    memset(&t->quanta_hist, 0, sizeof(t->quanta_hist));
+		    memset(&t->late_hist, 0, sizeof(t->late_hist));
+		}
+	}
+	
+	if (reset) {
+	    task_stats_start_us = now;
+	    task_stats_idle_us = 0;
+	}
+	return kstr_cat(ks, "]");
+}
+
 static int _TaskStat(TASK *t, u4_t s1_func, int s1_val, const char *s1_units, u4_t s2_func, int s2_val, const char *s2_units)
 {
 	int r=0;
@@ -574,6 +768,7 @@ static void task_init(TASK *t, int id, funcP_t funcP, void *param, const char *n
 	t->minrun_start_us = timer_us64();
 	t->valid = TRUE;
 	t->tll.t = t;
+	t->heap_idx = -1;
 	
     #ifdef LOCK_CHECK_HANG
         t->lock_marker = ' ';
@@ -800,21 +995,85 @@ void TaskInit()
 	collect_needed = TRUE;
 	TaskCollect();
 	
+	task_stats_start_us = timer_us64();
 	task_package_init = TRUE;
 }
 
-// init requiring cfg to be setup
-bool test_deadline_update;
+//#define TASK_SCHED_BENCH
+#ifdef TASK_SCHED_BENCH
 
-void TaskInitCfg()
+// Scheduler benchmark: sleeper tasks on a spread of intervals measure wake-up jitter
+// (actual minus requested wake time) while yielder tasks loop on NextTask() so the
+// context switch rate can be seen. Results printed every TASK_BENCH_REPORT_SEC.
+
+#define TASK_BENCH_YIELDERS     2
+#define TASK_BENCH_REPORT_SEC   10
+
+static const int task_bench_usec[] = { 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000 };
+#define TASK_BENCH_SLEEPERS     ARRAY_LEN(task_bench_usec)
+
+static struct {
+    u4_t n, min, max;
+    u64_t sum;
+} task_bench_jitter;
+
+static void task_bench_sleeper(void *param)
 {
-    bool err;
-    test_deadline_update = cfg_bool("test_deadline_update", &err, CFG_OPTIONAL);
-    printf("test_deadline_update=%d err=%d\n", test_deadline_update, err);
-    if (err) test_deadline_update = false;
+    int usec = task_bench_usec[FROM_VOID_PARAM(param)];
+    
+    while (1) {
+        u64_t wake_us = timer_us64() + usec;
+        TaskSleepReasonUsec("bench", usec);
+        u4_t jitter = timer_us64() - wake_us;
+        
+        if (task_bench_jitter.n == 0 || jitter < task_bench_jitter.min) task_bench_jitter.min = jitter;
+        if (jitter > task_bench_jitter.max) task_bench_jitter.max = jitter;
+        task_bench_jitter.sum += jitter;
+        task_bench_jitter.n++;
+    }
+}
 
+static void task_bench_yielder(void *param)
+{
+    while (1) {
+        NextTask("bench");
+    }
+}
+
+static void task_bench_report(void *param)
+{
+    int i;
+    u4_t runs, last_runs = 0;
+    
+    while (1) {
+        TaskSleepSec(TASK_BENCH_REPORT_SEC);
+        
+        for (i = 0, runs = 0; i <= max_task; i++) runs += Tasks[i].run;
+        u4_t n = task_bench_jitter.n;
+        printf("TASK_SCHED_BENCH: %d switches/sec, wakeup jitter min/avg/max %d/%d/%d usec (%d wakeups, %d tasks)\n",
+            (runs - last_runs) / TASK_BENCH_REPORT_SEC, task_bench_jitter.min, n? (u4_t) (task_bench_jitter.sum / n) : 0,
+            task_bench_jitter.max, n, max_task + 1);
+        last_runs = runs;
+        memset(&task_bench_jitter, 0, sizeof(task_bench_jitter));
+    }
+}
+
+#endif
+
+// init requiring cfg to be setup
+void TaskInitCfg()
+{
 	#define TASK_INTR_USEC_EARLY 1000
 	task_snd_intr_usec = snd_intr_usec - TASK_INTR_USEC_EARLY;
+
+	#ifdef TASK_SCHED_BENCH
+	    int i;
+	    for (i = 0; i < TASK_BENCH_SLEEPERS; i++)
+	        CreateTask(task_bench_sleeper, TO_VOID_PARAM(i), EXT_PRIORITY);
+	    for (i = 0; i < TASK_BENCH_YIELDERS; i++)
+	        CreateTask(task_bench_yielder, 0, MAIN_PRIORITY);
+	    CreateTask(task_bench_report, 0, MAIN_PRIORITY);
+	#endif
 }
 
 void TaskCheckStacks(bool report)
@@ -908,7 +1167,9 @@ void TaskRemove(int id)
 {
     TASK *t = Tasks + id;
     TdeQ(t);
-    t->stopped = TRUE;
+    task_stopped(t, TRUE);
+    task_deadline_clear(t);
+    task_wakeup_test_set(t, NULL);
 	run[t->id].r = 0;
     t->valid = FALSE;
     run[t->id].v = 0;
@@ -1000,6 +1261,7 @@ bool TaskIsChild()
 	
     quanta = enter_us - ct->tstart_us;
     ct->usec += quanta;
+    ct->cpu_usec += quanta;
     
     #if defined(LOCK_CHECK_HANG) && defined(EV_MEAS_LOCK)
         if (expecting_spi_lock_next_task && ct->minrun == 0) {
@@ -1020,6 +1282,7 @@ bool TaskIsChild()
         i = MIN(i, N_HIST-1);
         ct->hist[i]++;
         task_all_hist[i]++;
+        lat_hist_add(&ct->quanta_hist, quanta);
     }
     
     our_pid = getpid();
@@ -1075,36 +1338,35 @@ bool TaskIsChild()
     // mark ourselves as "last run" on our task queue if we're still valid
 	assert(ct->tq == &TaskQ[ct->priority]);
 	ct->tq->last_run = ct->valid? &ct->tll : NULL;
+	
+	// a task yielding while still runnable is waiting to run again from now
+	if (ct->valid && !ct->stopped && ct->ready_us == 0) ct->ready_us = enter_us;
 
     do {
         now_us = timer_us64();
 
-        if (test_deadline_update == false) {
-            // update scheduling deadlines
-            TASK *tp = Tasks;
-            for (i=0; i <= max_task; i++, tp++) {
-                if (!tp->valid) continue;
-                bool wake = false;
-                
-                if (tp->deadline > 0) {
-                    if (tp->deadline < now_us) {
-                        evNT(EC_EVENT, EV_NEXTTASK, -1, "NextTask", evprintf("deadline expired %s, Qrunnable %d", task_s(tp), tp->tq->runnable));
-                        tp->deadline = 0;
-                        wake = true;
-                    }
-                } else
-                if (tp->wakeup_test != NULL) {
-                    if (*tp->wakeup_test != 0) {
-                        evNT(EC_EVENT, EV_NEXTTASK, -1, "NextTask", evprintf("wakeup_test completed %s, Qrunnable %d", task_s(tp), tp->tq->runnable));
-                        tp->wakeup_test = NULL;
-                        wake = true;
-                    }
-                }
-                
-                if (wake) {
-                    RUNNABLE_YES(tp);
-                    tp->wake_param = TO_VOID_PARAM(tp->last_run_time);      // return how long task ran last time
-                }
+        // update scheduling deadlines: only the expired heap entries and the wakeup_test sleepers are visited
+        while (task_deadline_n && task_deadline_heap[0]->deadline < now_us) {
+            TASK *tp = task_deadline_heap[0];
+            evNT(EC_EVENT, EV_NEXTTASK, -1, "NextTask", evprintf("deadline expired %s, Qrunnable %d", task_s(tp), tp->tq->runnable));
+            s64_t deadline = tp->deadline;
+            task_deadline_clear(tp);
+            RUNNABLE_YES(tp);
+            tp->ready_us = deadline;    // lateness is measured from when it asked to be woken
+            tp->deadline_wake = true;
+            tp->wake_param = TO_VOID_PARAM(tp->last_run_time);      // return how long task ran last time
+        }
+
+        for (i = 0; i < TASK_MASK_WORDS; i++) {
+            u4_t m = task_wakeup_test_mask[i];
+            while (m) {
+                TASK *tp = Tasks + (i << 5) + ffs(m) - 1;
+                m &= m - 1;
+                if (tp->deadline > 0 || *tp->wakeup_test == 0) continue;
+                evNT(EC_EVENT, EV_NEXTTASK, -1, "NextTask", evprintf("wakeup_test completed %s, Qrunnable %d", task_s(tp), tp->tq->runnable));
+                task_wakeup_test_set(tp, NULL);
+                RUNNABLE_YES(tp);
+                tp->wake_param = TO_VOID_PARAM(tp->last_run_time);      // return how long task ran last time
             }
         }
 
@@ -1132,76 +1394,30 @@ bool TaskIsChild()
 		for (p = HIGHEST_PRIORITY; p >= LOWEST_PRIORITY; p--) {
 			head = &TaskQ[p];
 			assert(p == head->p);
+			u4_t *mask = task_runnable_mask[p];
 			
-			#ifdef USE_RUNNABLE
-				int t_runnable = head->runnable;
-				//evNT(EC_EVENT, EV_NEXTTASK, -1, "NextTask", evprintf("looking P%d, count %d, runnable %d",
-				//	p, head->count, t_runnable));
-				if (!(t_runnable >= 0 && t_runnable <= head->count && t_runnable <= MAX_TASKS))
-					assert(t_runnable >= 0 && t_runnable <= head->count && t_runnable <= MAX_TASKS);
-			#else
-				int t_runnable = 0;
-				TaskLL_t *tll;
-				
-                #ifdef LOCK_TEST_HANG
-                    if (lock_test_hang && p == DATAPUMP_PRIORITY) {
-                        printf("LOCK_TEST_HANG ignoring DATAPUMP_PRIORITY\n");
-                        continue;
-                    }
-                #endif
-                
-                #ifdef LOCK_CHECK_HANG
-                    if (lock_panic && head->last_run) lprintf("P%d: last_run %s\n", p, task_s(head->last_run->t));
-                #endif
-					
-				// count the number runnable
-				for (tll = head->tll.next; tll; tll = tll->next) {
-					assert(tll);
-					TASK *tp = tll->t;
-					assert(tp);
-					assert(tp && tp->valid);    // tp check to keep static analyzer quiet
-					
-                    #ifdef LOCK_CHECK_HANG
-				        if (lock_panic) lprintf("P%d: %s %s\n", p, task_s(tp), tp->stopped? "STOP":"RUN");
-                    #endif
-					
-                    if (test_deadline_update == true) {
-                        bool wake = false;
-                        
-                        if (tp->deadline > 0) {
-                            if (tp->deadline < now_us) {
-                                evNT(EC_EVENT, EV_NEXTTASK, -1, "NextTask", evprintf("deadline expired %s, Qrunnable %d", task_s(tp), tp->tq->runnable));
-                                tp->deadline = 0;
-                                wake = true;
-                            }
-                        } else
-                        if (tp->wakeup_test != NULL) {
-                            if (*tp->wakeup_test != 0) {
-                                evNT(EC_EVENT, EV_NEXTTASK, -1, "NextTask", evprintf("wakeup_test completed %s, Qrunnable %d", task_s(tp), tp->tq->runnable));
-                                tp->wakeup_test = NULL;
-                                wake = true;
-                            }
-                        }
-                        
-                        if (wake) {
-                            RUNNABLE_YES(tp);
-                            tp->wake_param = TO_VOID_PARAM(tp->last_run_time);      // return how long task ran last time
-                        }
-                    }
-                    
-					if (!tp->stopped)
-						t_runnable++;
-					
-					#ifdef LOCK_CHECK_HANG
-                        if (lock_panic && tp == busy_helper_task)
-                            lprintf("P%d: busy_helper_task stopped %d lock.wait %d\n", p, tp->stopped, tp->lock.wait);
-                    #endif
-				}
+            #ifdef LOCK_TEST_HANG
+                if (lock_test_hang && p == DATAPUMP_PRIORITY) {
+                    printf("LOCK_TEST_HANG ignoring DATAPUMP_PRIORITY\n");
+                    continue;
+                }
+            #endif
+            
+			int t_runnable = task_mask_count(mask);
 
-                #ifdef LOCK_CHECK_HANG
-				    if (lock_panic) lprintf("P%d: === runnable %d\n", p, t_runnable);
-				#endif
-			#endif
+            #ifdef LOCK_CHECK_HANG
+                if (lock_panic) {
+                    if (head->last_run) lprintf("P%d: last_run %s\n", p, task_s(head->last_run->t));
+                    TaskLL_t *tll;
+                    for (tll = head->tll.next; tll; tll = tll->next) {
+                        TASK *tp = tll->t;
+                        lprintf("P%d: %s %s\n", p, task_s(tp), tp->stopped? "STOP":"RUN");
+                        if (tp == busy_helper_task)
+                            lprintf("P%d: busy_helper_task stopped %d lock.wait %d\n", p, tp->stopped, tp->lock.wait);
+                    }
+                    lprintf("P%d: === runnable %d\n", p, t_runnable);
+                }
+            #endif
 
             //if (p == 2 && t_runnable) real_printf("P2-%d ", t_runnable); fflush(stdout);
 
@@ -1214,19 +1430,15 @@ bool TaskIsChild()
 			
 			t = NULL;
 			if (t_runnable) {
-				// at this point the p/head queue should have at least one runnable task
-				TaskLL_t *wrap = (head->last_run && head->last_run->next)? head->last_run->next : head->tll.next;
-	            assert(wrap->t->priority == p);
-	            
-	            // start with the one after the last run (round robin) or, failing that, the first one in the queue
-				TaskLL_t *tll = wrap;
+	            // Round robin in task id order starting with the one after the last run on this queue.
+	            // Only runnable tasks are visited.
+				int id = task_mask_next(mask, head->last_run? head->last_run->t->id + 1 : 0);
 				
-				int looping = 0;
-				do {
-					assert(tll);
-					t = tll->t;
-					assert(t);
-					assert(t && t->valid);      // t check to keep static analyzer quiet
+				int looping;
+				for (looping = 0; looping < t_runnable; looping++) {
+					assert(id >= 0);
+					t = Tasks + id;
+					assert(t->valid && !t->stopped && t->priority == p);
 					
 					#ifdef LOCK_CHECK_HANG
 					    if (lock_panic) t->lock_marker = '#';
@@ -1238,7 +1450,7 @@ bool TaskIsChild()
 						;   // NB: do not remove
 					} else
 
-					if (!t->stopped && t->long_run) {
+					if (t->long_run) {
 						u4_t last_time_run = now_us - itask_last_tstart;
 						if (!itask || !itask_run || (itask_run && last_time_run < 4000)) {
 							evNT(EC_EVENT, EV_NEXTTASK, -1, "NextTask", evprintf("OKAY for LONG RUN %s, interrupt last ran @%.6f, %d us ago",
@@ -1267,28 +1479,19 @@ bool TaskIsChild()
                             #endif
                         }
 					} else {
-						if (!t->stopped) {
-						    #ifdef LOCK_CHECK_HANG
-                                if (lock_panic)
-                                    t->lock_marker = '*';
-                                else
-                                    break;
-                            #else
+                        #ifdef LOCK_CHECK_HANG
+                            if (lock_panic)
+                                t->lock_marker = '*';
+                            else
                                 break;
-                            #endif
-						}
+                        #else
+                            break;
+                        #endif
 					}
 					
 					t = NULL;
-					tll = tll->next;
-					if (tll == NULL) tll = head->tll.next;
-					
-					if (++looping == 100)
-					    break;
-				} while (tll != wrap);
-				
-				if (looping == 100)
-				    panic("NextTask looping");
+					id = task_mask_next(mask, id + 1);
+				}
 				
 				if (t) {
 					assert(t->valid);
@@ -1347,6 +1550,7 @@ bool TaskIsChild()
     now_us = timer_us64();
     u4_t just_idle_us = now_us - enter_us;
     idle_us += just_idle_us;
+    task_stats_idle_us += just_idle_us;
 	if (t->minrun) t->minrun_start_us = now_us;
 	
     #ifdef EV_MEAS_NEXTTASK
@@ -1362,6 +1566,17 @@ bool TaskIsChild()
 	
 	t->tstart_us = now_us;
 	if (t->flags & CTF_POLL_INTR) itask_last_tstart = now_us;
+	
+	if (t->ready_us) {
+	    t->wake_latency = (now_us > t->ready_us)? now_us - t->ready_us : 0;
+	    lat_hist_add(&t->wake_hist, t->wake_latency);
+	    if (t->deadline_wake) {
+	        lat_hist_add(&t->late_hist, t->wake_latency);
+	        if (t->wake_latency > TASK_LATE_USEC) t->deadline_misses++;
+	        t->deadline_wake = false;
+	    }
+	    t->ready_us = 0;
+	}
 
 	ct->last_last_run_time = ct->last_run_time;
 	ct->last_run_time = quanta;
@@ -1411,14 +1626,14 @@ static void taskSleepSetup(TASK *t, const char *reason, int usec, u4_t *wakeup_t
 	// usec > 0 is microseconds time in future (added to current time)
 	
 	if (usec > 0) {
-    	t->deadline = timer_us64() + usec;
-        t->wakeup_test = NULL;
+    	task_deadline_set(t, timer_us64() + usec);
+        task_wakeup_test_set(t, NULL);
     	sprintf(t->reason, "(%.3f msec) ", (float) usec/1000.0);
 		evNT(EC_EVENT, EV_NEXTTASK, -1, "TaskSleep", evprintf("sleeping usec %d %s Qrunnable %d", usec, task_ls(t), t->tq->runnable));
 	} else {
 	    assert(usec == 0);
-        t->wakeup_test = wakeup_test;
-		t->deadline = 0;
+        task_wakeup_test_set(t, wakeup_test);
+		task_deadline_clear(t);
 		if (wakeup_test != NULL) {
             sprintf(t->reason, "(test %p) ", wakeup_test);
             evNT(EC_EVENT, EV_NEXTTASK, -1, "TaskSleep", evprintf("sleeping test %p %s Qrunnable %d", wakeup_test, task_ls(t), t->tq->runnable));
@@ -1453,8 +1668,8 @@ void *_TaskSleep(const char *reason, int usec, u4_t *wakeup_test)
     
 	evNT(EC_EVENT, EV_NEXTTASK, -1, "TaskSleep", evprintf("woke %s Qrunnable %d", task_ls(t), t->tq->runnable));
 
-    t->deadline = 0;
-    t->stopped = FALSE;
+    task_deadline_clear(t);
+    task_stopped(t, FALSE);
 	run[t->id].r = 1;
     t->sleeping = FALSE;
 	t->wakeup = FALSE;
@@ -1497,7 +1712,7 @@ void TaskWakeup(int id, u4_t flags, void *wake_param)
         return;		// don't interrupt a task sleeping on a time interval
     }
 
-    t->deadline = 0;	// cancel any outstanding deadline
+    task_deadline_clear(t);	// cancel any outstanding deadline
 
 	if (!t->sleeping) {
 		assert(!t->stopped || (t->stopped && t->lock.wait));
@@ -1846,7 +2061,7 @@ void lock_enter(lock_t *lock)
         #endif
 
 		ct->lock.wait = lock;
-		ct->stopped = TRUE;
+		task_stopped(ct, TRUE);
 		run[ct->id].r = 0;
 		runnable(ct->tq, -1);
 		
@@ -1984,7 +2199,7 @@ void lock_leave(lock_t *lock)
         if (tp->lock.waiting) {
     #endif
             tp->lock.waiting = false;
-            tp->stopped = FALSE;
+            task_stopped(tp, FALSE);
             
             // The lock _owner_ can subsequently sleep after acquiring the lock.
             // But a _waiter_ should never be sleeping.
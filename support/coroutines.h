@@ -146,6 +146,22 @@ u4_t TaskID();
 void *TaskGetUserParam();
 void TaskSetUserParam(void *param);
 
+// Always-on latency histograms (usec). Buckets are log2 with two sub-buckets per octave:
+// bucket b < 2 holds usec == b, otherwise [(2 + (b&1)) << (b/2 - 1), (3 + (b&1)) << (b/2 - 1)).
+// Only updated from the task scheduler's process so no locking is needed.
+#define LAT_HIST_N  48
+typedef struct {
+    u4_t n, max;
+    u64_t sum;
+    u4_t b[LAT_HIST_N];
+} lat_hist_t;
+
+void lat_hist_add(lat_hist_t *h, u4_t usec);
+char *lat_hist_json(char *ks, lat_hist_t *h);   // kstr_t, appends {"n":,"a":,"x":,"b":[]} to ks
+
+u4_t TaskWakeLatency();                 // usec from runnable to running for the current task's last wakeup
+char *TaskSchedStats(char *ks, bool reset);     // kstr_t, appends JSON of per-task cpu and latency histograms
+
 // don't collide with PRINTF_FLAGS
 #define	TDUMP_PRINTF    0x00ff
 #define	TDUMP_REG       0x0000
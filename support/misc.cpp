@@ -56,68 +56,163 @@ Boston, MA  02110-1301, USA.
  #define kmprintf(x)
 #endif
 
-#define NMT 1024
-struct mtrace_t {
-	int i;
+// Every block has a km_hdr_t in front of it so kiwi_free() finds its accounting in O(1).
+// Small blocks come from per-size-class free lists carved out of slabs, larger ones from malloc().
+// Live blocks are kept on a doubly-linked list for leak reporting and are counted per "from" tag.
+// None of this is locked: only call from the coroutine (main) thread, never from work pool threads
+// (see work_pool.h). That includes kiwi_malloc_stats() and kiwi_malloc_dump().
+
+#define KM_MAGIC        0x6b6d616c      // "kmal"
+#define KM_MAGIC_FREE   0x6b6d6672      // "kmfr"
+
+#define KM_CLASS_MIN    5               // 32 bytes (including header)
+#define KM_CLASS_MAX    12              // 4k bytes
+#define KM_NCLASS       (KM_CLASS_MAX - KM_CLASS_MIN + 1)
+#define KM_SLAB_SIZE    (64*1024)
+
+struct km_hdr_t {
+	u4_t magic;
+	s2_t cls;           // -1 if malloc()'d directly
+	u2_t tag;           // km_tag[] index
+	u4_t size;          // as requested
+	km_hdr_t *prev, *next;
+} __attribute__((aligned(16)));     // keeps caller's pointer malloc() aligned
+
+#define KM_NTAG         256
+#define KM_NHASH        512             // power of 2, > KM_NTAG
+#define KM_TAG_OTHER    0               // used when km_tag[] is full
+
+struct km_tag_t {
 	const char *from;
-	char *ptr;
-	int size;
-} mtrace[NMT];
+	int count, bytes, hiwat;
+};
 
-static int nmt;
+static km_tag_t km_tag[KM_NTAG] = { { "(other)" } };
+static int km_ntag = 1;
+static u2_t km_hash[KM_NHASH];          // km_tag[] index + 1, 0 = empty
 
-static int mt_enter(const char *from, void *ptr, int size)
+static km_hdr_t *km_free_list[KM_NCLASS];
+static km_hdr_t km_live;                // list head
+static int nmt, km_bytes, km_slab_bytes;
+
+static u2_t km_tag_lookup(const char *from)
 {
+	u4_t h = 2166136261U;       // FNV-1a
+	const char *cp;
+	for (cp = from; *cp; cp++) h = (h ^ (u1_t) *cp) * 16777619U;
+	
 	int i;
-	mtrace_t *mt;
+	for (i = h & (KM_NHASH-1); km_hash[i]; i = (i+1) & (KM_NHASH-1)) {
+		km_tag_t *t = &km_tag[km_hash[i] - 1];
+		if (t->from == from || strcmp(t->from, from) == 0) return km_hash[i] - 1;
+	}
 	
+	if (km_ntag == KM_NTAG) return KM_TAG_OTHER;
+	km_tag[km_ntag].from = from;
+	km_hash[i] = ++km_ntag;
+	return km_ntag - 1;
+}
+
+static int km_class(int tsize)
+{
 	#ifdef USE_VALGRIND
-	    return 0;
+		return -1;      // so valgrind sees every block individually
 	#endif
 	
-	for (i=0; i<NMT; i++) {
-		mt = &mtrace[i];
-		if (mt->ptr == ptr) {
-			kmprintf(("  mt_enter \"%s\" #%d (\"%s\") %d %p\n", from, i, mt->from, size, ptr));
-			panic("mt_enter dup");
-		}
-		if (mt->ptr == NULL) {
-			mt->i = i;
-			mt->from = from;
-			mt->ptr = (char*) ptr;
-			mt->size = size;
-			break;
-		}
-	}
+	if (tsize > (1 << KM_CLASS_MAX)) return -1;
+	int cls = 32 - __builtin_clz(tsize - 1) - KM_CLASS_MIN;
+	return (cls < 0)? 0 : cls;
+}
+
+static void km_slab_refill(int cls)
+{
+	int i, bsize = 1 << (cls + KM_CLASS_MIN);
+	char *slab = (char *) malloc(KM_SLAB_SIZE);
+	if (slab == NULL) panic("km_slab_refill malloc");
+	km_slab_bytes += KM_SLAB_SIZE;
 	
-	if (i == NMT) panic("mt_enter overflow");
+	for (i = KM_SLAB_SIZE - bsize; i >= 0; i -= bsize) {
+		km_hdr_t *h = (km_hdr_t *) (slab + i);
+		h->magic = KM_MAGIC_FREE;
+		h->next = km_free_list[cls];
+		km_free_list[cls] = h;
+	}
+}
+
+static void km_enter(const char *from, km_hdr_t *h, int size)
+{
+	h->magic = KM_MAGIC;
+	h->size = size;
+	h->tag = km_tag_lookup(from);
+
+	km_tag_t *t = &km_tag[h->tag];
+	t->count++;
+	t->bytes += size;
+	if (t->bytes > t->hiwat) t->hiwat = t->bytes;
+	km_bytes += size;
 	nmt++;
-	return i+1;
+
+	// no lingering references that would defeat valgrind leak detection
+	#ifndef USE_VALGRIND
+		if (km_live.next == NULL) km_live.next = km_live.prev = &km_live;
+		h->next = km_live.next;
+		h->prev = &km_live;
+		km_live.next->prev = h;
+		km_live.next = h;
+	#endif
 }
 
-static void mt_remove(const char *from, void *ptr)
+static km_hdr_t *km_remove(const char *from, void *ptr)
 {
-	int i;
-	mtrace_t *mt;
+	km_hdr_t *h = ((km_hdr_t *) ptr) - 1;
 	
-	#ifdef USE_VALGRIND
-	    return;
+	if (h->magic != KM_MAGIC) {
+		printf("km_remove \"%s\" %p magic 0x%x\n", from, ptr, h->magic);
+		panic((h->magic == KM_MAGIC_FREE)? "km_remove double free" : "km_remove not kiwi_malloc()'d");
+	}
+	h->magic = KM_MAGIC_FREE;
+	
+	km_tag_t *t = &km_tag[h->tag];
+	t->count--;
+	t->bytes -= h->size;
+	km_bytes -= h->size;
+	nmt--;
+
+	#ifndef USE_VALGRIND
+		h->prev->next = h->next;
+		h->next->prev = h->prev;
 	#endif
+	return h;
+}
+
+static void *km_alloc(const char *from, size_t size)
+{
+	int tsize = sizeof(km_hdr_t) + size;
+	int cls = km_class(tsize);
+	km_hdr_t *h;
 	
-	for (i=0; i<NMT; i++) {
-		mt = &mtrace[i];
-		if (mt->ptr == (char*) ptr) {
-			mt->ptr = NULL;
-			break;
-		}
+	if (cls < 0) {
+		h = (km_hdr_t *) malloc(tsize);
+		if (h == NULL) panic("kiwi_malloc");
+	} else {
+		if (km_free_list[cls] == NULL) km_slab_refill(cls);
+		h = km_free_list[cls];
+		km_free_list[cls] = h->next;
 	}
 	
-	kmprintf(("  mt_remove \"%s\" #%d %p\n", from, i+1, ptr));
-	if (i == NMT) {
-		printf("mt_remove \"%s\"\n", from);
-		panic("mt_remove not found");
+	h->cls = cls;
+	km_enter(from, h, size);
+	return h + 1;
+}
+
+static void km_release(km_hdr_t *h)
+{
+	if (h->cls < 0) {
+		free(h);
+	} else {
+		h->next = km_free_list[h->cls];
+		km_free_list[h->cls] = h;
 	}
-	nmt--;
 }
 
 #define	MALLOC_MAX	PHOTO_UPLOAD_MAX_SIZE
@@ -126,14 +221,9 @@ void *kiwi_malloc(const char *from, size_t size)
 {
 	//if (size > MALLOC_MAX) panic("malloc > MALLOC_MAX");
 	kmprintf(("kiwi_malloc-1 \"%s\" %d\n", from, size));
-	void *ptr = malloc(size);
+	void *ptr = km_alloc(from, size);
 	memset(ptr, 0, size);
-    #ifdef MALLOC_DEBUG_PRF
-        int i = mt_enter(from, ptr, size);
-    #else
-        mt_enter(from, ptr, size);
-    #endif
-	kmprintf(("kiwi_malloc-2 \"%s\" #%d %d %p\n", from, i, size, ptr));
+	kmprintf(("kiwi_malloc-2 \"%s\" %d %p\n", from, size, ptr));
 	return ptr;
 }
 
@@ -141,14 +231,23 @@ void *kiwi_realloc(const char *from, void *ptr, size_t size)
 {
 	//if (size > MALLOC_MAX) panic("malloc > MALLOC_MAX");
 	kmprintf(("kiwi_realloc-1 \"%s\" %d %p\n", from, size, ptr));
-	mt_remove(from, ptr);
-	ptr = realloc(ptr, size);
-    #ifdef MALLOC_DEBUG_PRF
-        int i = mt_enter(from, ptr, size);
-    #else
-        mt_enter(from, ptr, size);
-    #endif
-	kmprintf(("kiwi_realloc-2 \"%s\" #%d %d %p\n", from, i, size, ptr));
+	if (ptr == NULL) return kiwi_malloc(from, size);
+	km_hdr_t *h = km_remove(from, ptr);
+	int tsize = sizeof(km_hdr_t) + size;
+	
+	if (h->cls < 0 && km_class(tsize) < 0) {
+		h = (km_hdr_t *) realloc(h, tsize);
+		if (h == NULL) panic("kiwi_realloc");
+		km_enter(from, h, size);
+		ptr = h + 1;
+	} else {
+		void *nptr = km_alloc(from, size);
+		memcpy(nptr, ptr, MIN(size, h->size));
+		km_release(h);
+		ptr = nptr;
+	}
+	
+	kmprintf(("kiwi_realloc-2 \"%s\" %d %p\n", from, size, ptr));
 	return ptr;
 }
 
@@ -156,13 +255,9 @@ char *kiwi_strdup(const char *from, const char *s)
 {
 	int sl = strlen(s)+1;
 	if (sl == 0 || sl > 1024) panic("strdup size");
-	char *ptr = strdup(s);
-    #ifdef MALLOC_DEBUG_PRF
-        int i = mt_enter(from, (void*) ptr, sl);
-    #else
-        mt_enter(from, (void*) ptr, sl);
-    #endif
-	kmprintf(("kiwi_strdup \"%s\" #%d %d %p %p\n", from, i, sl, s, ptr));
+	char *ptr = (char *) km_alloc(from, sl);
+	memcpy(ptr, s, sl);
+	kmprintf(("kiwi_strdup \"%s\" %d %p %p\n", from, sl, s, ptr));
 	return ptr;
 }
 
@@ -170,8 +265,7 @@ void kiwi_free(const char *from, void *ptr)
 {
 	kmprintf(("kiwi_free \"%s\" %p\n", from, ptr));
 	if (ptr == NULL) return;
-	mt_remove(from, ptr);
-	free(ptr);
+	km_release(km_remove(from, ptr));
 }
 
 int kiwi_malloc_stat()
@@ -179,6 +273,43 @@ int kiwi_malloc_stat()
 	return nmt;
 }
 
+// live per-tag statistics for the admin status page
+kstr_t *kiwi_malloc_stats()
+{
+	int i;
+	bool first = true;
+	kstr_t *sb = kstr_asprintf(NULL, "{\"n\":%d,\"b\":%d,\"s\":%d,\"t\":[", nmt, km_bytes, km_slab_bytes);
+	
+	for (i = 0; i < km_ntag; i++) {
+		km_tag_t *t = &km_tag[i];
+		if (t->hiwat == 0) continue;
+		sb = kstr_asprintf(sb, "%s{\"f\":\"%s\",\"c\":%d,\"b\":%d,\"h\":%d}",
+			first? "":",", t->from, t->count, t->bytes, t->hiwat);
+		first = false;
+	}
+	
+	return kstr_cat(sb, "]}");
+}
+
+// leak report: blocks still live, most recently allocated first
+void kiwi_malloc_dump(int max)
+{
+	km_hdr_t *h;
+	int i;
+	
+	lprintf("kiwi_malloc: %d blocks, %d bytes live, %d bytes of slabs\n", nmt, km_bytes, km_slab_bytes);
+	for (i = 0; i < km_ntag; i++) {
+		km_tag_t *t = &km_tag[i];
+		if (t->count) lprintf("kiwi_malloc: %5d %8d (max %8d) \"%s\"\n", t->count, t->bytes, t->hiwat, t->from);
+	}
+	
+	#ifndef USE_VALGRIND
+		if (km_live.next == NULL) return;
+		for (h = km_live.next, i = 0; h != &km_live && i < max; h = h->next, i++)
+			lprintf("kiwi_malloc: #%d %p %d \"%s\"\n", i, h + 1, h->size, km_tag[h->tag].from);
+	#endif
+}
+
 #endif
 
 void kiwi_str_redup(char **ptr, const char *from, const char *s)
@@ -186,14 +317,11 @@ void kiwi_str_redup(char **ptr, const char *from, const char *s)
 	int sl = strlen(s)+1;
 	if (sl == 0 || sl > 1024) panic("strdup size");
 	if (*ptr) kiwi_free(from, (void*) *ptr);
-	*ptr = strdup(s);
 #ifdef MALLOC_DEBUG
-    #ifdef MALLOC_DEBUG_PRF
-        int i = mt_enter(from, (void*) *ptr, sl);
-    #else
-        mt_enter(from, (void*) *ptr, sl);
-    #endif
-	kmprintf(("kiwi_str_redup \"%s\" #%d %d %p %p\n", from, i, sl, s, *ptr));
+	*ptr = kiwi_strdup(from, s);
+	kmprintf(("kiwi_str_redup \"%s\" %d %p %p\n", from, sl, s, *ptr));
+#else
+	*ptr = strdup(s);
 #endif
 }
 
@@ -22,10 +22,12 @@ Boston, MA  02110-1301, USA.
 #include "types.h"
 #include "kiwi.h"
 #include "printf.h"
+#include "str.h"
 
 #include <sys/file.h>
 #include <stdarg.h>
 
+// kiwi_malloc() et al are coroutine (main) thread only, see misc.cpp
 #define MALLOC_DEBUG
 #ifdef MALLOC_DEBUG
 	void *kiwi_malloc(const char *from, size_t size);
@@ -34,6 +36,8 @@ Boston, MA  02110-1301, USA.
 	char *kiwi_strdup(const char *from, const char *s);
 	void kiwi_str_redup(char **ptr, const char *from, const char *s);
 	int kiwi_malloc_stat();
+	kstr_t *kiwi_malloc_stats();
+	void kiwi_malloc_dump(int max);
 #else
 	#define kiwi_malloc(from, size) malloc(size)
 	#define kiwi_realloc(from, ptr, size) realloc(ptr, size)
@@ -41,6 +45,8 @@ Boston, MA  02110-1301, USA.
 	#define kiwi_strdup(from, s) strdup(s)
 	void kiwi_str_redup(char **ptr, const char *from, const char *s);
 	#define kiwi_malloc_stat() 0
+	#define kiwi_malloc_stats() NULL
+	#define kiwi_malloc_dump(max)
 #endif
 
 u2_t ctrl_get();
@@ -1,9 +1,16 @@
 // -*- C++ -*-
 
 #include <complex>
+#include <string.h>
+#include <math.h>
 
 #ifdef __ARM_NEON
 #include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
 #endif
 
 #include "simd.h"
@@ -138,3 +145,273 @@ void simd_bit2float(int len, const int8_t* cv, float* fv)
         *fv++ = float(2*(*cv>0) - 1);
     }
 }
+
+// p = |a|^2
+void simd_mag2_cf(int len, const fftwf_complex* a, float* p)
+{
+    const float* pa = (const float*) a;
+
+    int counter=0;
+#ifdef __ARM_NEON
+    float32x4x2_t u;
+    float32x4_t w;
+    for (counter=0; counter<len/4; ++counter) {
+        __builtin_prefetch(pa+16);
+        u = vld2q_f32((const float32_t*)pa); // [r, i]
+        w = vmulq_f32(u.val[0], u.val[0]);   // w  = r*r
+        w = vmlaq_f32(w, u.val[1], u.val[1]);// w += i*i
+        vst1q_f32(p, w);
+        pa+=8, p+=4;
+    }
+    counter *= 4;
+#elif defined(__SSE2__)
+    __m128 u0, u1, r, i;
+    for (counter=0; counter<len/4; ++counter) {
+        u0 = _mm_loadu_ps(pa);               // [r0 i0 r1 i1]
+        u1 = _mm_loadu_ps(pa+4);             // [r2 i2 r3 i3]
+        r = _mm_shuffle_ps(u0, u1, _MM_SHUFFLE(2,0,2,0));
+        i = _mm_shuffle_ps(u0, u1, _MM_SHUFFLE(3,1,3,1));
+        _mm_storeu_ps(p, _mm_add_ps(_mm_mul_ps(r, r), _mm_mul_ps(i, i)));
+        pa+=8, p+=4;
+    }
+    counter *= 4;
+#endif
+    for (; counter<len; ++counter, pa+=2)
+        *p++ = pa[0]*pa[0] + pa[1]*pa[1];
+}
+
+// peak[j] = max(|a[i]|^2) for all i where map[i] == j
+// map[] must be monotonic. Stops at the first i where map[i] >= npeak and returns that i (or len).
+int simd_mag2_peak_map(int len, const fftwf_complex* a, const uint16_t* map, float* peak, int npeak)
+{
+    #define MAG2_BLK 256
+    float pwr[MAG2_BLK];
+    int i, j, n;
+
+    memset(peak, 0, sizeof(float) * npeak);
+
+    for (i=0; i<len; i+=MAG2_BLK) {
+        n = (len-i < MAG2_BLK)? len-i : MAG2_BLK;
+        simd_mag2_cf(n, a+i, pwr);
+
+        // runs of bins mapping to the same pixel are short (typically 1-4) so the reduction is scalar
+        for (j=0; j<n; j++) {
+            int bin = map[i+j];
+            if (bin >= npeak) return i+j;
+            if (pwr[j] > peak[bin]) peak[bin] = pwr[j];
+        }
+    }
+    return len;
+}
+
+// Fast log2 for positive normal floats: exponent plus a cubic in the mantissa [1,2)
+// fitted at the Chebyshev nodes. Max error is 0.0025 dB after scaling to 10*log10(),
+// which is far below the 1 dB resolution of the waterfall pixel.
+#define LOG2_C0     0.000825462823f
+#define LOG2_C1     1.41565319f
+#define LOG2_C2     -0.568704053f
+#define LOG2_C3     0.152700285f
+#define DB_PER_LOG2 3.01029996f     // 10*log10(2)
+
+// b = (u8) (clamp(10*log10(p*scale + 1e-30) + offset, -200, 0) - 1)
+// i.e. 0..-200 dB maps to 255..55, same as the scalar loop in compute_frame()
+void simd_dB_u8(int len, const float* p, const float* scale, float offset, uint8_t* b)
+{
+    int counter=0;
+#ifdef __ARM_NEON
+    const float32x4_t tiny = vdupq_n_f32(1e-30f);
+    const float32x4_t vofs = vdupq_n_f32(offset - 1.0f);    // includes the "dB--"
+    const float32x4_t vmax = vdupq_n_f32(-1.0f);
+    const float32x4_t vmin = vdupq_n_f32(-201.0f);
+    const uint32x4_t mant_mask = vdupq_n_u32(0x007fffff);
+    const uint32x4_t one_bits  = vdupq_n_u32(0x3f800000);
+    const int32x4_t  bias      = vdupq_n_s32(127);
+    float32x4_t x, t, poly, dB;
+    uint32x4_t bits;
+    int32x4_t e;
+    uint16x4_t h[2];
+    for (counter=0; counter<len/8; ++counter) {
+        for (int k=0; k<2; k++) {
+            x = vmlaq_f32(tiny, vld1q_f32(p), vld1q_f32(scale));
+            bits = vreinterpretq_u32_f32(x);
+            e = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), bias);
+            t = vsubq_f32(vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, mant_mask), one_bits)), vdupq_n_f32(1.0f));
+            poly = vmlaq_f32(vdupq_n_f32(LOG2_C2), t, vdupq_n_f32(LOG2_C3));
+            poly = vmlaq_f32(vdupq_n_f32(LOG2_C1), t, poly);
+            poly = vmlaq_f32(vdupq_n_f32(LOG2_C0), t, poly);
+            poly = vaddq_f32(poly, vcvtq_f32_s32(e));
+            dB = vmlaq_f32(vofs, poly, vdupq_n_f32(DB_PER_LOG2));
+            dB = vminq_f32(vmaxq_f32(dB, vmin), vmax);
+            // truncate toward zero like (int), then bias positive so the saturating narrow
+            // produces the same bits as the (u1_t) wrap of the negative value
+            e = vaddq_s32(vcvtq_s32_f32(dB), vdupq_n_s32(256));
+            h[k] = vqmovun_s32(e);
+            p+=4, scale+=4;
+        }
+        vst1_u8(b, vqmovn_u16(vcombine_u16(h[0], h[1])));
+        b+=8;
+    }
+    counter *= 8;
+#elif defined(__SSE2__)
+    const __m128 tiny = _mm_set1_ps(1e-30f);
+    const __m128 vofs = _mm_set1_ps(offset - 1.0f);         // includes the "dB--"
+    const __m128 vmax = _mm_set1_ps(-1.0f);
+    const __m128 vmin = _mm_set1_ps(-201.0f);
+    const __m128i mant_mask = _mm_set1_epi32(0x007fffff);
+    const __m128i one_bits  = _mm_set1_epi32(0x3f800000);
+    const __m128i bias      = _mm_set1_epi32(127);
+    __m128 x, t, poly, dB;
+    __m128i bits, e, w[2];
+    for (counter=0; counter<len/8; ++counter) {
+        for (int k=0; k<2; k++) {
+            x = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(p), _mm_loadu_ps(scale)), tiny);
+            bits = _mm_castps_si128(x);
+            e = _mm_sub_epi32(_mm_srli_epi32(bits, 23), bias);
+            t = _mm_sub_ps(_mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, mant_mask), one_bits)), _mm_set1_ps(1.0f));
+            poly = _mm_add_ps(_mm_set1_ps(LOG2_C2), _mm_mul_ps(t, _mm_set1_ps(LOG2_C3)));
+            poly = _mm_add_ps(_mm_set1_ps(LOG2_C1), _mm_mul_ps(t, poly));
+            poly = _mm_add_ps(_mm_set1_ps(LOG2_C0), _mm_mul_ps(t, poly));
+            poly = _mm_add_ps(poly, _mm_cvtepi32_ps(e));
+            dB = _mm_add_ps(vofs, _mm_mul_ps(poly, _mm_set1_ps(DB_PER_LOG2)));
+            dB = _mm_min_ps(_mm_max_ps(dB, vmin), vmax);
+            // truncate toward zero like (int), then bias positive so the saturating pack
+            // produces the same bits as the (u1_t) wrap of the negative value
+            w[k] = _mm_add_epi32(_mm_cvttps_epi32(dB), _mm_set1_epi32(256));
+            p+=4, scale+=4;
+        }
+        __m128i h = _mm_packs_epi32(w[0], w[1]);
+        _mm_storel_epi64((__m128i*) b, _mm_packus_epi16(h, h));
+        b+=8;
+    }
+    counter *= 8;
+#endif
+    for (; counter<len; ++counter) {
+        float x = *p++ * *scale++ + 1e-30f;
+        union { float f; uint32_t u; } bits = { x };
+        int e = (int) (bits.u >> 23) - 127;
+        bits.u = (bits.u & 0x007fffff) | 0x3f800000;
+        float t = bits.f - 1.0f;
+        float dB = (e + LOG2_C0 + t*(LOG2_C1 + t*(LOG2_C2 + t*LOG2_C3))) * DB_PER_LOG2 + offset;
+        if (dB > 0) dB = 0;
+        if (dB < -200.0f) dB = -200.0f;
+        dB--;
+        *b++ = (uint8_t) (int) dB;
+    }
+}
+
+// c = swap(iq24) * scale + off for n packed frames {u16 i, u16 q, u8 q3, u8 i3}
+static void iq24_cf(int n, const uint8_t* p, float scale, float off_re, float off_im, float* c)
+{
+    int counter=0;
+    // The 24-bit values are assembled in the top of an int32 (value << 8) which converts to float exactly.
+    // Multiplying by scale/256 then gives the same result as value*scale.
+    const float scale256 = scale / 256.0f;
+#ifdef __ARM_NEON
+    const float32x4_t vs = vdupq_n_f32(scale256);
+    const float32x4_t vre = vdupq_n_f32(off_re);
+    const float32x4_t vim = vdupq_n_f32(off_im);
+    const uint32x4_t i3_mask = vdupq_n_u32(0xff00);
+    uint16x8x3_t u;     // [i, q, q3|i3<<8]
+    uint32x4_t h;
+    float32x4x2_t w;
+    for (counter=0; counter<n/8; ++counter) {
+        __builtin_prefetch(p+96);
+        u = vld3q_u16((const uint16_t*) p);
+        for (int k=0; k<2; k++) {
+            uint16x4_t ii = k? vget_high_u16(u.val[0]) : vget_low_u16(u.val[0]);
+            uint16x4_t qq = k? vget_high_u16(u.val[1]) : vget_low_u16(u.val[1]);
+            h = vmovl_u16(k? vget_high_u16(u.val[2]) : vget_low_u16(u.val[2]));
+            int32x4_t q32 = vreinterpretq_s32_u32(vorrq_u32(vshlq_n_u32(h, 24), vshll_n_u16(qq, 8)));
+            int32x4_t i32 = vreinterpretq_s32_u32(vorrq_u32(vshlq_n_u32(vandq_u32(h, i3_mask), 16), vshll_n_u16(ii, 8)));
+            // separate mul and add (no fma) to match the scalar rounding
+            w.val[0] = vaddq_f32(vmulq_f32(vcvtq_f32_s32(q32), vs), vre);
+            w.val[1] = vaddq_f32(vmulq_f32(vcvtq_f32_s32(i32), vs), vim);
+            vst2q_f32(c, w);
+            c+=8;
+        }
+        p+=48;
+    }
+    counter *= 8;
+#elif defined(__SSSE3__)
+    // 4 frames (24 bytes) per loop from two overlapping 16 byte loads: A = frames 0,1 B = frames 2,3
+    const __m128 vs = _mm_set1_ps(scale256);
+    const __m128 vre = _mm_set1_ps(off_re);
+    const __m128 vim = _mm_set1_ps(off_im);
+    #define Z -1
+    const __m128i q_a = _mm_setr_epi8(Z,2,3,4, Z,8,9,10, Z,Z,Z,Z, Z,Z,Z,Z);
+    const __m128i q_b = _mm_setr_epi8(Z,Z,Z,Z, Z,Z,Z,Z, Z,6,7,8, Z,12,13,14);
+    const __m128i i_a = _mm_setr_epi8(Z,0,1,5, Z,6,7,11, Z,Z,Z,Z, Z,Z,Z,Z);
+    const __m128i i_b = _mm_setr_epi8(Z,Z,Z,Z, Z,Z,Z,Z, Z,4,5,9, Z,10,11,15);
+    #undef Z
+    __m128i a, b;
+    __m128 q, i;
+    for (counter=0; counter<n/4; ++counter) {
+        a = _mm_loadu_si128((const __m128i*) p);
+        b = _mm_loadu_si128((const __m128i*) (p+8));
+        q = _mm_cvtepi32_ps(_mm_or_si128(_mm_shuffle_epi8(a, q_a), _mm_shuffle_epi8(b, q_b)));
+        i = _mm_cvtepi32_ps(_mm_or_si128(_mm_shuffle_epi8(a, i_a), _mm_shuffle_epi8(b, i_b)));
+        q = _mm_add_ps(_mm_mul_ps(q, vs), vre);
+        i = _mm_add_ps(_mm_mul_ps(i, vs), vim);
+        _mm_storeu_ps(c,   _mm_unpacklo_ps(q, i));
+        _mm_storeu_ps(c+4, _mm_unpackhi_ps(q, i));
+        p+=24, c+=8;
+    }
+    counter *= 4;
+#endif
+    for (; counter<n; ++counter, p+=6) {
+        int32_t i = (int32_t) (((uint32_t) p[5] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[0] << 8));
+        int32_t q = (int32_t) (((uint32_t) p[4] << 24) | ((uint32_t) p[3] << 16) | ((uint32_t) p[2] << 8));
+        *c++ = (float) q * scale256 + off_re;
+        *c++ = (float) i * scale256 + off_im;
+    }
+}
+
+// De-interleave nsamps samples of nch channels of packed 24-bit IQ frames (channel-minor order)
+// to per-channel complex float: out[ch][j].re = q*scale + off_re, .im = i*scale + off_im
+// Channels with out[ch] == NULL are skipped.
+void simd_iq24_unpack(int nsamps, int nch, const void* iq, float scale, float off_re, float off_im, fftwf_complex** out)
+{
+    const uint8_t* p = (const uint8_t*) iq;
+    int j, ch;
+#if defined(__ARM_NEON) || defined(__SSSE3__)
+    // convert blocks of all channels into a temp buffer that stays in L1, then scatter
+    #define IQ24_BLK 256
+    float conv[IQ24_BLK * 2];
+    int spb = IQ24_BLK / nch;       // samples per block
+    int k, n;
+
+    for (j=0; j<nsamps; j+=spb) {
+        n = (nsamps-j < spb)? nsamps-j : spb;
+        iq24_cf(n * nch, p, scale, off_re, off_im, conv);
+        p += n * nch * 6;
+
+        for (ch=0; ch<nch; ch++) {
+            if (out[ch] == NULL) continue;
+            const uint64_t* src = (const uint64_t*) conv + ch;
+            uint64_t* dst = (uint64_t*) (out[ch] + j);
+            for (k=0; k<n; k++, src+=nch)
+                *dst++ = *src;
+        }
+    }
+#else
+    // no vector unpack: a second pass would only add cost
+    for (j=0; j<nsamps; j++) {
+        for (ch=0; ch<nch; ch++, p+=6) {
+            if (out[ch] != NULL)
+                iq24_cf(1, p, scale, off_re, off_im, out[ch][j]);
+        }
+    }
+#endif
+}
+
+// reference version of simd_dB_u8() using log10f()
+void simd_dB_u8_ref(int len, const float* p, const float* scale, float offset, uint8_t* b)
+{
+    for (int i=0; i<len; i++) {
+        float dB = 10.0f * log10f(p[i] * scale[i] + (float) 1e-30) + offset;
+        if (dB > 0) dB = 0;
+        if (dB < -200.0f) dB = -200.0f;
+        dB--;
+        *b++ = (uint8_t) (int) dB;
+    }
+}
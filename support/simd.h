@@ -24,4 +24,29 @@ extern void simd_multiply_cfc(int len,
 // fv = float(2*(cv>0)-1)
 extern void simd_bit2float(int len, const int8_t* cv, float* fv);
 
+// p = |a|^2
+extern void simd_mag2_cf(int len, const fftwf_complex* a, float* p);
+
+// peak[map[i]] = max(|a[i]|^2), map monotonic, returns first i with map[i] >= npeak (or len)
+extern int simd_mag2_peak_map(int len,
+                              const fftwf_complex* a,
+                              const uint16_t* map,
+                              float* peak,
+                              int npeak);
+
+// b = (uint8_t) (clamp(10*log10(p*scale + 1e-30) + offset, -200, 0) - 1)
+extern void simd_dB_u8(int len, const float* p, const float* scale, float offset, uint8_t* b);
+// same using log10f() (reference)
+extern void simd_dB_u8_ref(int len, const float* p, const float* scale, float offset, uint8_t* b);
+
+// out[ch][j] = swap(iq24[j*nch + ch]) * scale + {off_re, off_im}, packed 24-bit IQ frames
+// {u16 i, u16 q, u8 q3, u8 i3} as sent by the data pump, out[ch] == NULL skips that channel
+extern void simd_iq24_unpack(int nsamps,
+                             int nch,
+                             const void* iq,
+                             float scale,
+                             float off_re,
+                             float off_im,
+                             fftwf_complex** out);
+
 #endif // SUPPORT_SIMD_H
@@ -0,0 +1,101 @@
+/*
+--------------------------------------------------------------------------------
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Library General Public
+License as published by the Free Software Foundation; either
+version 2 of the License, or (at your option) any later version.
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Library General Public License for more details.
+You should have received a copy of the GNU Library General Public
+License along with this library; if not, write to the
+Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+Boston, MA  02110-1301, USA.
+--------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include "types.h"
+#include "coroutines.h"
+
+// Single-producer/single-consumer ring of indices into a caller-owned array of n (power of 2) slots.
+//
+// The producer fills slot spsc_wr_slot() in place then publishes it with spsc_push().
+// The consumer reads slot spsc_rd_slot() then hands it back with spsc_pop().
+// wr_pos is only written by the producer and rd_pos only by the consumer, with release stores
+// and acquire loads, so the slot contents are visible before the index that covers them
+// even when producer and consumer are on different OS threads.
+//
+// One slot is always left empty. When the ring is full spsc_push() drops the block just written
+// (the slot is reused next time) and counts an overrun rather than wrapping onto the reader.
+
+typedef struct {
+	u4_t wr_pos, rd_pos;
+	u4_t overruns;
+	tid_t waiter;           // consumer task to TaskWakeup() from spsc_wake(), 0 if none
+} spsc_ring_t;
+
+// producer
+
+static inline u4_t spsc_wr_slot(spsc_ring_t *r)
+{
+	return r->wr_pos;
+}
+
+static inline bool spsc_push(spsc_ring_t *r, u4_t n)
+{
+	u4_t next = (r->wr_pos + 1) & (n-1);
+	if (next == __atomic_load_n(&r->rd_pos, __ATOMIC_ACQUIRE)) {
+		r->overruns++;
+		return false;
+	}
+	__atomic_store_n(&r->wr_pos, next, __ATOMIC_RELEASE);
+	return true;
+}
+
+// wakeup hook for a consumer task sleeping on spsc_empty()
+static inline void spsc_wake(spsc_ring_t *r)
+{
+	tid_t waiter = __atomic_load_n(&r->waiter, __ATOMIC_ACQUIRE);
+	if (waiter) TaskWakeup(waiter, TWF_NONE, 0);
+}
+
+// consumer
+
+// The consumer task registers itself for spsc_wake() and must unregister before it exits,
+// else the producer would wake a task id that may since have been reused.
+// Only clears the waiter if it is still the given task.
+static inline void spsc_set_waiter(spsc_ring_t *r, tid_t tid)
+{
+	__atomic_store_n(&r->waiter, tid, __ATOMIC_RELEASE);
+}
+
+static inline void spsc_clear_waiter(spsc_ring_t *r, tid_t tid)
+{
+	__atomic_compare_exchange_n(&r->waiter, &tid, 0, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+
+static inline bool spsc_empty(spsc_ring_t *r)
+{
+	return __atomic_load_n(&r->wr_pos, __ATOMIC_ACQUIRE) == r->rd_pos;
+}
+
+static inline u4_t spsc_rd_slot(spsc_ring_t *r)
+{
+	return r->rd_pos;
+}
+
+static inline void spsc_pop(spsc_ring_t *r, u4_t n)
+{
+	__atomic_store_n(&r->rd_pos, (r->rd_pos + 1) & (n-1), __ATOMIC_RELEASE);
+}
+
+// number of published slots, from either side
+static inline u4_t spsc_count(spsc_ring_t *r, u4_t n)
+{
+	u4_t wr = __atomic_load_n(&r->wr_pos, __ATOMIC_ACQUIRE);
+	u4_t rd = __atomic_load_n(&r->rd_pos, __ATOMIC_ACQUIRE);
+	return (wr - rd) & (n-1);
+}
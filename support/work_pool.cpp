@@ -0,0 +1,117 @@
+/*
+--------------------------------------------------------------------------------
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Library General Public
+License as published by the Free Software Foundation; either
+version 2 of the License, or (at your option) any later version.
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Library General Public License for more details.
+You should have received a copy of the GNU Library General Public
+License along with this library; if not, write to the
+Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+Boston, MA  02110-1301, USA.
+--------------------------------------------------------------------------------
+*/
+
+#include "types.h"
+#include "kiwi.h"
+#include "misc.h"
+#include "coroutines.h"
+#include "work_pool.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <sched.h>
+#include <unistd.h>
+
+static struct {
+    int nthreads;
+    pthread_t tid[WORK_POOL_MAX];
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    work_t *head, *tail;
+} pool;
+
+static void *work_thread(void *param)
+{
+    #ifdef MULTI_CORE
+        // keep off cpu 0 which runs the coroutine thread
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (int cpu = 1; cpu < CPU_SETSIZE && cpu < sysconf(_SC_NPROCESSORS_ONLN); cpu++)
+            CPU_SET(cpu, &cpu_set);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
+    #endif
+
+    while (1) {
+        pthread_mutex_lock(&pool.lock);
+        while (pool.head == NULL)
+            pthread_cond_wait(&pool.cond, &pool.lock);
+        work_t *w = pool.head;
+        pool.head = w->next;
+        if (pool.head == NULL) pool.tail = NULL;
+        pthread_mutex_unlock(&pool.lock);
+
+        w->func(w->param);
+        
+        // results written by func() are visible to the task before it sees done
+        __atomic_store_n(&w->done, 1, __ATOMIC_RELEASE);
+    }
+    
+    return NULL;
+}
+
+void work_pool_init(int nthreads)
+{
+    if (pool.nthreads || nthreads <= 0) return;
+    if (nthreads > WORK_POOL_MAX) nthreads = WORK_POOL_MAX;
+    
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.cond, NULL);
+    
+    // signals must continue to be delivered to the coroutine thread only
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+
+    for (int i = 0; i < nthreads; i++) {
+        if (pthread_create(&pool.tid[i], NULL, work_thread, NULL) != 0) {
+            lprintf("work_pool_init: pthread_create failed, %d threads\n", i);
+            break;
+        }
+        pool.nthreads++;
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    lprintf("work_pool_init: %d threads\n", pool.nthreads);
+}
+
+int work_pool_threads()
+{
+    return pool.nthreads;
+}
+
+void work_run(work_t *w, funcP_t func, void *param, const char *reason)
+{
+    if (pool.nthreads == 0) {
+        func(param);
+        return;
+    }
+    
+    w->func = func;
+    w->param = param;
+    w->done = 0;
+    w->next = NULL;
+    
+    pthread_mutex_lock(&pool.lock);
+    if (pool.tail) pool.tail->next = w; else pool.head = w;
+    pool.tail = w;
+    pthread_cond_signal(&pool.cond);
+    pthread_mutex_unlock(&pool.lock);
+    
+    // NB: while needed because we could have been woken up for the wrong reason e.g. CTF_BUSY_HELPER
+    while (__atomic_load_n(&w->done, __ATOMIC_ACQUIRE) == 0)
+        TaskSleepWakeupTest(reason, &w->done);
+}
@@ -0,0 +1,40 @@
+/*
+--------------------------------------------------------------------------------
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Library General Public
+License as published by the Free Software Foundation; either
+version 2 of the License, or (at your option) any later version.
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Library General Public License for more details.
+You should have received a copy of the GNU Library General Public
+License along with this library; if not, write to the
+Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+Boston, MA  02110-1301, USA.
+--------------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include "types.h"
+
+// Pool of OS threads that run jobs for tasks. work_run() queues the job and puts the calling task
+// to sleep until a pool thread has finished it, so other tasks keep running on the coroutine thread
+// in the meantime. With no pool threads the job is run inline.
+//
+// A job runs concurrently with the task scheduler and must only touch state owned by the caller:
+// no NextTask()/TaskWakeup(), kiwi_malloc(), lprintf() or extension callbacks.
+
+#define WORK_POOL_MAX 4
+
+typedef struct work_st {
+    funcP_t func;
+    void *param;
+    u4_t done;
+    struct work_st *next;
+} work_t;
+
+void work_pool_init(int nthreads);
+int work_pool_threads();
+void work_run(work_t *w, funcP_t func, void *param, const char *reason);
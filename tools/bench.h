@@ -0,0 +1,52 @@
+// Timing and test signal helpers shared by the kernel check/benchmark tools in this directory
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+static inline double usec()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// unit variance gaussian noise from random(), so a run repeats after the same srandom()
+static inline double gauss()
+{
+    double u1 = (random() + 1.0) / (RAND_MAX + 2.0), u2 = (double) random() / RAND_MAX;
+    return sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+// Synthetic coded frames: frame n of nframes gets an Eb/No swept linearly over lo_dB .. hi_dB,
+// so the decoders see plenty of near ties. sigma is the noise for +/-1 symbols of a code of that rate.
+static inline double ebn0_sigma(int n, int nframes, double lo_dB, double hi_dB, double rate)
+{
+    double ebn0 = lo_dB + (hi_dB - lo_dB) * n / nframes;
+    return sqrt(1 / (2 * rate * pow(10, ebn0/10)));
+}
+
+// a +/-1 symbol (coded bit 0 = +1) plus noise
+static inline double noisy_symbol(int coded_bit, double sigma)
+{
+    return (coded_bit? -1 : 1) + sigma * gauss();
+}
+
+// Times nloop calls each of the reference and the optimized code (passed the loop index) and prints
+// "<ref> x usec/<unit>, <opt> y usec/<unit>, speedup z".
+template <typename REF, typename OPT>
+static void time_vs_ref(int nloop, const char *unit, const char *ref_name, REF ref, const char *opt_name, OPT opt)
+{
+    int n;
+    double t0 = usec();
+    for (n = 0; n < nloop; n++) ref(n);
+    double t1 = usec();
+    for (n = 0; n < nloop; n++) opt(n);
+    double t2 = usec();
+
+    double us_ref = (t1-t0)/nloop, us_opt = (t2-t1)/nloop;
+    printf("%s %.2f usec/%s, %s %.2f usec/%s, speedup %.2fx\n", ref_name, us_ref, unit, opt_name, us_opt, unit, us_ref/us_opt);
+}
@@ -0,0 +1,109 @@
+// Checks and times simd_iq24_unpack() used by snd_service() against the original scalar
+// S24_8_16() loop over a data pump block of packed 24-bit IQ frames.
+//
+// With no argument a synthetic block is used. Otherwise the file is read as a raw
+// rx_data_t iq_t[] capture (nrx_samps * rx_chans frames of 6 bytes, no SND_SEQ_CHECK header).
+// The results must be bit-exact.
+
+#include "types.h"
+#include "simd.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NRX_SAMPS   170         // typical for 8 channel configuration
+#define RX_CHANS    8
+#define NLOOP       20000
+
+typedef struct {
+    u2_t i, q;
+    u1_t q3, i3;
+} __attribute__((packed)) rx_iq_t;
+
+typedef struct {
+    float re, im;
+} cpx_t;
+
+static rx_iq_t iq[NRX_SAMPS * RX_CHANS];
+static cpx_t ref[RX_CHANS][NRX_SAMPS], out[RX_CHANS][NRX_SAMPS];
+static bool enabled[RX_CHANS] = { true, true, false, true, true, true, false, true };
+
+static const float rescale = 1.0f / (1 << 15);  // MPOW(2, -RXOUT_SCALE + CUTESDR_SCALE)
+static const float DC_offset_I = 1.1e-5f, DC_offset_Q = -3.3e-6f;
+
+// the scalar loop as it was in snd_service()
+static void scalar_block(int nrx_samps, int rx_chans)
+{
+    cpx_t *i_samps[RX_CHANS];
+    rx_iq_t *iqp = iq;
+    for (int ch=0; ch < rx_chans; ch++) i_samps[ch] = ref[ch];
+
+    for (int j=0; j < nrx_samps; j++) {
+        for (int ch=0; ch < rx_chans; ch++) {
+            if (enabled[ch]) {
+                s4_t i, q;
+                i = S24_8_16(iqp->i3, iqp->i);
+                q = S24_8_16(iqp->q3, iqp->q);
+                i_samps[ch]->re = q * rescale + DC_offset_I;
+                i_samps[ch]->im = i * rescale + DC_offset_Q;
+                i_samps[ch]++;
+            }
+            iqp++;
+        }
+    }
+}
+
+static void simd_block(int nrx_samps, int rx_chans)
+{
+    fftwf_complex *i_samps[RX_CHANS];
+    for (int ch=0; ch < rx_chans; ch++) i_samps[ch] = enabled[ch]? (fftwf_complex *) out[ch] : NULL;
+    simd_iq24_unpack(nrx_samps, rx_chans, iq, rescale, DC_offset_I, DC_offset_Q, i_samps);
+}
+
+int main(int argc, char *argv[])
+{
+    int i, n, ch;
+    int nrx_samps = NRX_SAMPS, rx_chans = RX_CHANS;
+
+    if (argc > 1) {
+        FILE *fp = fopen(argv[1], "r");
+        if (fp == NULL) { perror(argv[1]); return -1; }
+        n = fread(iq, sizeof(rx_iq_t), NRX_SAMPS * RX_CHANS, fp);
+        fclose(fp);
+        nrx_samps = n / RX_CHANS;
+        printf("%s: %d frames\n", argv[1], n);
+    } else {
+        // full-scale 24-bit values including the sign boundaries
+        srandom(1);
+        for (i=0; i < NRX_SAMPS * RX_CHANS; i++) {
+            u4_t vi = random(), vq = random();
+            if (i < 4) vi = vq = (i & 1)? 0x800000 : 0x7fffff;
+            iq[i].i = vi; iq[i].i3 = vi >> 16;
+            iq[i].q = vq; iq[i].q3 = vq >> 16;
+        }
+    }
+
+    scalar_block(nrx_samps, rx_chans);
+    memset(out, 0, sizeof(out));
+    simd_block(nrx_samps, rx_chans);
+
+    int fails = 0;
+    for (ch=0; ch < rx_chans; ch++) {
+        if (!enabled[ch]) continue;
+        for (i=0; i < nrx_samps; i++) {
+            if (memcmp(&out[ch][i], &ref[ch][i], sizeof(cpx_t)) == 0) continue;
+            if (fails++ < 10)
+                printf("FAIL: ch%d samp %d simd %.9g,%.9g ref %.9g,%.9g\n", ch, i,
+                    out[ch][i].re, out[ch][i].im, ref[ch][i].re, ref[ch][i].im);
+        }
+    }
+    printf("%d channels x %d samples, %d mismatches\n", rx_chans, nrx_samps, fails);
+    if (fails) return -1;
+
+    time_vs_ref(NLOOP, "block",
+        "scalar", [&](int n) { scalar_block(nrx_samps, rx_chans); },
+        "simd", [&](int n) { simd_block(nrx_samps, rx_chans); });
+    return 0;
+}
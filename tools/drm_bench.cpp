@@ -0,0 +1,276 @@
+// Offline DRM decode benchmark: runs a recorded 12 kHz IQ file through CDRMReceiver exactly as DRM_loop() does
+// (same drm_argv settings, "direct" input from the RX_SHMEM iq_buf, "kiwi" audio output) but without the
+// browser, the extension and the real-time pacing.
+//
+// drm_bench [-q] file
+//   file is a .au file (e.g. the samples/drm.test2.be12 file used by the extension test mode), a .wav file as
+//   written by the IQ recorder, or raw s16 IQ, big-endian if the extension starts with "be" otherwise little-endian.
+//   Must be at the Kiwi 12k snd_rate.
+//   -q only prints the summary lines.
+//
+// Reports the time split between the drm_next_task() marks, each charged with the time since the previous mark
+// (one per receiver module, plus those in the MLC decoder and around the FDK-AAC fill/decode calls), the
+// MEASURE_TIME() counters nested inside those modules (MLC Viterbi, channel estimation time interpolation,
+// CTimeSyncTrack), the decoded audio and the real-time factor (signal duration / decode time) which is roughly
+// the number of DRM channels a cpu core can sustain.
+//
+// Returns non-zero if no audio was decoded.
+
+#include "types.h"
+#include "DRM.h"
+#include "DRM_main.h"
+#include "data_pump.h"
+
+#include "GlobalDefinitions.h"
+#include "DRMReceiver.h"
+#include "util/Settings.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+// what the DRM code needs from the rest of the server
+int snd_rate = SND_RATE_4CH;
+static drm_shmem_t bench_drm_shmem;
+drm_shmem_t *drm_shmem_p = &bench_drm_shmem;
+static rx_shmem_t bench_rx_shmem;
+rx_shmem_t *rx_shmem_p = &bench_rx_shmem;
+
+static double t_epoch;
+u4_t timer_us() { return (u4_t) (usec() - t_epoch); }
+u4_t timer_sec() { return timer_us() / 1000000; }
+
+static void *user_param;
+void *TaskGetUserParam() { return user_param; }
+void TaskSetUserParam(void *param) { user_param = param; }
+
+void kiwi_exit(int err) { exit(err); }
+void lprintf(const char *fmt, ...) { va_list ap; va_start(ap, fmt); vprintf(fmt, ap); va_end(ap); }
+void _panic(const char *str, bool coreFile, const char *file, int line) { printf("PANIC: %s (%s:%d)\n", str, file, line); abort(); }
+int ext_send_msg(int rx_chan, bool debug, const char *msg, ...) { return 0; }
+
+void DebugError(const char *pchErDescr, const char *pchPar1Descr,
+    const double dPar1, const char *pchPar2Descr, const double dPar2)
+{
+    printf("DebugError: %s ### %s: %e ### %s: %e\n", pchErDescr, pchPar1Descr, dPar1, pchPar2Descr, dPar2);
+    kiwi_exit(1);
+}
+
+
+// IQ file input
+// Stands in for the data pump: whenever CAudioFileIn::Read() finds the iq_buf empty and yields,
+// the next FASTFIR_OUTBUF_SIZE samples are copied from the file. Zeros are sent once the file is exhausted.
+
+static FILE *iq_fp;
+static bool iq_big_endian, iq_eof;
+static u4_t iq_samps;
+static double t_file;       // time spent reading the file, excluded from the profile
+
+static void iq_open(const char *fn)
+{
+    if ((iq_fp = fopen(fn, "r")) == NULL) {
+        printf("can't open %s\n", fn);
+        exit(-1);
+    }
+
+    const char *ext = strrchr(fn, '.');
+    ext = ext? ext+1 : "";
+    iq_big_endian = (strncasecmp(ext, "be", 2) == 0);
+
+    u1_t hdr[12], chunk[8];
+    if (fread(hdr, sizeof(hdr), 1, iq_fp) != 1) {
+        printf("%s: too short\n", fn);
+        exit(-1);
+    }
+
+    if (memcmp(hdr, ".snd", 4) == 0) {
+        // .au header: big-endian data offset, the test files have no trailing annotation
+        iq_big_endian = true;
+        fseek(iq_fp, (hdr[4] << 24) | (hdr[5] << 16) | (hdr[6] << 8) | hdr[7], SEEK_SET);
+    } else
+    if (memcmp(hdr, "RIFF", 4) == 0 && memcmp(hdr+8, "WAVE", 4) == 0) {
+        iq_big_endian = false;
+        while (fread(chunk, sizeof(chunk), 1, iq_fp) == 1 && memcmp(chunk, "data", 4) != 0) {
+            u4_t len = chunk[4] | (chunk[5] << 8) | (chunk[6] << 16) | (chunk[7] << 24);
+            fseek(iq_fp, (len + 1) & ~1, SEEK_CUR);
+        }
+    } else {
+        rewind(iq_fp);
+    }
+}
+
+static void iq_refill()
+{
+    drm_t *drm = &DRM_SHMEM->drm[(int) FROM_VOID_PARAM(TaskGetUserParam())];
+    iq_buf_t *iq = &RX_SHMEM->iq_buf[drm->rx_chan];
+    if ((u4_t) drm->iq_rd_pos != iq->iq_wr_pos) return;
+
+    double t0 = usec();
+    static s2_t s2[FASTFIR_OUTBUF_SIZE * NIQ];
+    int n = iq_eof? 0 : fread(s2, sizeof(s2_t) * NIQ, FASTFIR_OUTBUF_SIZE, iq_fp);
+    if (n < FASTFIR_OUTBUF_SIZE) iq_eof = true;
+    iq_samps += n;
+
+    TYPECPX *samps = iq->iq_samples[iq->iq_wr_pos];
+    for (int i = 0; i < FASTFIR_OUTBUF_SIZE; i++, samps++) {
+        if (i >= n) {
+            samps->re = samps->im = 0;
+            continue;
+        }
+        u2_t re = (u2_t) s2[i*2], im = (u2_t) s2[i*2+1];
+        if (iq_big_endian) { re = FLIP16(re); im = FLIP16(im); }
+        samps->re = (TYPEREAL) (s4_t) (s2_t) re;
+        samps->im = (TYPEREAL) (s4_t) (s2_t) im;
+    }
+    iq->iq_wr_pos = (iq->iq_wr_pos + 1) & (N_DPBUF-1);
+    t_file += usec() - t0;
+}
+
+// DRM_YIELD_LOWER_PRIO() in CAudioFileIn::Read() and the CPacer sleeps end up here: never wait
+void *_TaskSleep(const char *reason, int us, u4_t *wakeup_test) { iq_refill(); return NULL; }
+void _NextTask(const char *s, u4_t param, u_int64_t pc) { iq_refill(); }
+
+
+// profile
+// drm_next_task() is called after every receiver module (see CDRMReceiver::DemodulateDRM() etc.)
+// so the time since the previous call is charged to the module named by id.
+
+#define N_PROF 32
+static struct prof_t {
+    const char *id;
+    double usec;
+    u4_t calls;
+} prof[N_PROF];
+static int n_prof;
+static double t_mark, t_file_mark;
+
+void drm_next_task(const char *id)
+{
+    double now = usec();
+    int i;
+
+    for (i = 0; i < n_prof && strcmp(prof[i].id, id) != 0; i++)
+        ;
+    if (i == n_prof) {
+        if (n_prof == N_PROF) return;
+        prof[n_prof++].id = id;
+    }
+    prof[i].usec += (now - t_mark) - (t_file - t_file_mark);
+    prof[i].calls++;
+    t_mark = now;
+    t_file_mark = t_file;
+}
+
+static int prof_cmp(const void *a, const void *b)
+{
+    double d = ((prof_t *) b)->usec - ((prof_t *) a)->usec;
+    return (d > 0)? 1 : ((d < 0)? -1 : 0);
+}
+
+int main(int argc, char *argv[])
+{
+    int ch;
+    bool quiet = false;
+
+    while ((ch = getopt(argc, argv, "q")) != -1) {
+        switch (ch) {
+            case 'q': quiet = true; break;
+            default: argc = 0; break;
+        }
+    }
+    if (optind != argc-1) {
+        printf("usage: drm_bench [-q] file.au|file.wav|file.be12|file.iq\n");
+        return -1;
+    }
+    iq_open(argv[optind]);
+    t_epoch = usec();
+
+    // as DRM_main() and DRM_loop() for rx_chan 0
+    int rx_chan = 0;
+    drm_t *drm = &DRM_SHMEM->drm[rx_chan];
+    drm->init = true;
+    DRM_CHECK(drm->magic1 = 0xcafe; drm->magic2 = 0xbabe;)
+    drm->rx_chan = rx_chan;
+    drm->run = 1;
+    TaskSetUserParam(TO_VOID_PARAM(rx_chan));
+    drm_buf_t *drm_buf = &DRM_SHMEM->drm_buf[rx_chan];
+
+    u4_t out_blocks = 0;
+    double t_decode = 0;
+
+    try {
+        CSettings Settings;
+        Settings.Load(ARRAY_LEN(drm_argv), (char **) drm_argv);
+        Settings.Put("Receiver", "samplerateaud", snd_rate);
+
+        CDRMReceiver DRMReceiver(&Settings);
+        DRMReceiver.LoadSettings();
+        DRMReceiver.InitReceiverMode();
+        DRMReceiver.SetInStartMode();
+
+        u4_t out_wr_pos = drm_buf->out_wr_pos;
+        double t0 = usec(), t_file0 = t_file;
+        t_mark = t0;
+        t_file_mark = t_file;
+
+        while (!iq_eof) {
+            DRMReceiver.updatePosition();
+            DRMReceiver.process();
+            drm_next_task("process");   // RSCI/split/audio output after the last module mark
+
+            // drain the audio output as the sound task would
+            out_blocks += (drm_buf->out_wr_pos - out_wr_pos) & (N_DRM_OBUF-1);
+            drm_buf->out_rd_pos = out_wr_pos = drm_buf->out_wr_pos;
+        }
+
+        t_decode = usec() - t0 - (t_file - t_file0);
+        DRMReceiver.CloseSoundInterfaces();
+    }
+    catch (CGenErr GenErr)
+    {
+        printf("%s\n", GenErr.strError.c_str());
+        return -1;
+    }
+    catch (string strError)
+    {
+        printf("%s\n", strError.c_str());
+        return -1;
+    }
+
+    double signal_sec = (double) iq_samps / snd_rate;
+    double audio_sec = (double) out_blocks * drm_buf->out_samps / snd_rate;
+    double t_total = 0;
+    for (int i = 0; i < n_prof; i++) t_total += prof[i].usec;
+
+    if (!quiet) {
+        qsort(prof, n_prof, sizeof(prof_t), prof_cmp);
+        printf("%-32s %10s %6s %10s %10s\n", "module", "msec", "%", "calls", "usec/call");
+        for (int i = 0; i < n_prof; i++) {
+            prof_t *p = &prof[i];
+            printf("%-32s %10.1f %6.1f %10d %10.1f\n", p->id, p->usec/1e3, p->usec * 100 / t_total,
+                p->calls, p->usec / p->calls);
+        }
+
+        // MEASURE_TIME() counters, already included in the module times above
+        static const struct { int acc; const char *name; } nested[] = {
+            { 3, "MLC Viterbi" },
+            { 6, "CTimeWiener/CTimeLinear" },
+            { 7, "CTimeSyncTrack" }
+        };
+        printf("of which:\n");
+        for (int i = 0; i < ARRAY_LEN(nested); i++) {
+            u4_t us = drm->MeasureTime[nested[i].acc];
+            printf("  %-30s %10.1f %6.1f\n", nested[i].name, us/1e3, us * 100 / t_total);
+        }
+    }
+
+    printf("signal %.1f sec, audio %.1f sec, decode %.1f sec (file read %.1f msec not included)\n",
+        signal_sec, audio_sec, t_decode/1e6, t_file/1e3);
+    printf("real-time factor %.1fx, %.1f%% of a core per DRM channel\n",
+        signal_sec * 1e6 / t_decode, t_decode / (signal_sec * 1e6) * 100);
+
+    return (out_blocks == 0)? -1 : 0;
+}
@@ -0,0 +1,354 @@
+// Checks the NEON/SSE2 trellis update of the DRM (dream) Viterbi decoder against a scalar model
+// of the same 8-bit saturating trellis for bit-exact path metrics and decisions, compares the
+// decoded bits with those of the floating point trellis (the VITERBI_NO_SIMD path of Decode(),
+// copied here) and then times both.
+//
+// With no argument frames are encoded with the DRM mother code (K=7, 4 outputs), punctured with
+// the patterns used by the MLC and noise added over a range of Eb/No. Otherwise the argument is
+// a file of recorded metric vectors, see VITERBI_RECORD in dream/MLC/ViterbiDecoder.cpp
+
+#include "MLC/ViterbiDecoder.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define NBITS       1000
+#define NSTEPS      (NBITS + MC_CONSTRAINT_LENGTH - 1)
+#define NFRAMES     500
+#define NLOOP       200
+
+#if defined(USE_NEON)
+    #define TrellisUpdateSIMD TrellisUpdateNEON
+    #define SIMD_NAME "neon"
+#elif defined(USE_SSE2)
+    #define TrellisUpdateSIMD TrellisUpdateSSE2
+    #define SIMD_NAME "sse2"
+#endif
+
+#ifdef SIMD_NAME
+
+typedef unsigned char u1_t;
+
+struct frame_t {
+    int nsteps, ndist;
+    int *punc;
+    CDistance *dist;
+    _BINARY *bits;      // NULL for recorded frames
+};
+
+static frame_t frames[NFRAMES];
+
+// (cur, next, prev0, prev1, met0, met1) as the forward BUTTERFLY() calls in ViterbiDecoder.cpp
+static const int bfly[MC_NUM_STATES/2][6] = {
+    { 0,  1,  0, 32,  0, 15}, { 2,  3,  1, 33,  6,  9}, { 4,  5,  2, 34, 11,  4}, { 6,  7,  3, 35, 13,  2},
+    { 8,  9,  4, 36, 11,  4}, {10, 11,  5, 37, 13,  2}, {12, 13,  6, 38,  0, 15}, {14, 15,  7, 39,  6,  9},
+    {16, 17,  8, 40,  4, 11}, {18, 19,  9, 41,  2, 13}, {20, 21, 10, 42, 15,  0}, {22, 23, 11, 43,  9,  6},
+    {24, 25, 12, 44, 15,  0}, {26, 27, 13, 45,  9,  6}, {28, 29, 14, 46,  4, 11}, {30, 31, 15, 47,  2, 13},
+    {32, 33, 16, 48,  9,  6}, {34, 35, 17, 49, 15,  0}, {36, 37, 18, 50,  2, 13}, {38, 39, 19, 51,  4, 11},
+    {40, 41, 20, 52,  2, 13}, {42, 43, 21, 53,  4, 11}, {44, 45, 22, 54,  9,  6}, {46, 47, 23, 55, 15,  0},
+    {48, 49, 24, 56, 13,  2}, {50, 51, 25, 57, 11,  4}, {52, 53, 26, 58,  6,  9}, {54, 55, 27, 59,  0, 15},
+    {56, 57, 28, 60,  6,  9}, {58, 59, 29, 61,  0, 15}, {60, 61, 30, 62, 13,  2}, {62, 63, 31, 63, 11,  4},
+};
+
+// gives the test access to the protected trellis state and kernel
+class CViterbiTest : public CViterbiDecoder
+{
+public:
+    void InitFrame(const frame_t *f)
+    {
+        iNumOutBitsWithMemory = f->nsteps;
+        iNumOutBits = f->nsteps - (MC_CONSTRAINT_LENGTH - 1);
+        if (veciTablePuncPat.Size() != f->nsteps) {
+            veciTablePuncPat.Init(f->nsteps);
+            matdecDecisions.Init(f->nsteps, MC_NUM_STATES);
+        }
+        for (int i = 0; i < f->nsteps; i++)
+            veciTablePuncPat[i] = f->punc[i];
+    }
+
+    void Trellis(u1_t *dec, u1_t *cur, const u1_t *old, const u1_t *met1, const u1_t *met2)
+    {
+        TrellisUpdateSIMD(dec, cur, old, met1, met2);
+    }
+};
+
+// metric set for one step as Decode() computes it, returns the number of distances used
+static int metric_set(int punc, const CDistance *d, _REAL *met)
+{
+    _REAL a00 = 0, a10 = 0, a01 = 0, a11 = 0;
+
+    if (punc == PP_TYPE_0001) {
+        met[0] = met[2] = met[4] = met[6] = d[0].rTow0;
+        met[9] = met[11] = met[13] = met[15] = d[0].rTow1;
+        return 1;
+    }
+
+    a00 = d[1].rTow0 + d[0].rTow0; a10 = d[1].rTow1 + d[0].rTow0;
+    a01 = d[1].rTow0 + d[0].rTow1; a11 = d[1].rTow1 + d[0].rTow1;
+
+    if (punc == PP_TYPE_0101) {
+        met[0] = met[2] = a00; met[4] = met[6] = a10; met[9] = met[11] = a01; met[13] = met[15] = a11;
+        return 2;
+    }
+    if (punc == PP_TYPE_0011) {
+        met[0] = met[4] = a00; met[2] = met[6] = a10; met[9] = met[13] = a01; met[11] = met[15] = a11;
+        return 2;
+    }
+    if (punc == PP_TYPE_0111) {
+        met[0] = d[2].rTow0 + a00; met[2] = d[2].rTow0 + a10; met[4] = d[2].rTow1 + a00; met[6] = d[2].rTow1 + a10;
+        met[9] = d[2].rTow0 + a01; met[11] = d[2].rTow0 + a11; met[13] = d[2].rTow1 + a01; met[15] = d[2].rTow1 + a11;
+        return 3;
+    }
+
+    _REAL b00 = d[3].rTow0 + d[2].rTow0, b10 = d[3].rTow1 + d[2].rTow0;
+    _REAL b01 = d[3].rTow0 + d[2].rTow1, b11 = d[3].rTow1 + d[2].rTow1;
+    met[0] = b00 + a00; met[2] = b00 + a10; met[4] = b01 + a00; met[6] = b01 + a10;
+    met[9] = b10 + a01; met[11] = b10 + a11; met[13] = b11 + a01; met[15] = b11 + a11;
+    return 4;
+}
+
+// the floating point decoder (Decode() without USE_SIMD)
+static void decode_float(const frame_t *f, _BINARY *out, u1_t (*dec)[MC_NUM_STATES])
+{
+    _REAL m1[MC_NUM_STATES], m2[MC_NUM_STATES], met[MC_NUM_OUTPUT_COMBINATIONS];
+    _REAL *old = m1, *cur = m2;
+    int i, j, n = 0;
+
+    old[0] = 0;
+    for (i = 1; i < MC_NUM_STATES; i++) old[i] = 1e10;
+
+    for (i = 0; i < f->nsteps; i++) {
+        n += metric_set(f->punc[i], &f->dist[n], met);
+        for (j = 0; j < MC_NUM_STATES/2; j++) {
+            const int *b = bfly[j];
+            _REAL p0 = old[b[2]] + met[b[4]], p1 = old[b[3]] + met[b[5]];
+            if (p0 < p1) { cur[b[0]] = p0; dec[i][b[0]] = 0; } else { cur[b[0]] = p1; dec[i][b[0]] = 1; }
+            p0 = old[b[2]] + met[b[5]]; p1 = old[b[3]] + met[b[4]];
+            if (p0 < p1) { cur[b[1]] = p0; dec[i][b[1]] = 0; } else { cur[b[1]] = p1; dec[i][b[1]] = 1; }
+        }
+        _REAL *t = cur; cur = old; old = t;
+    }
+
+    int state = 0, nbits = f->nsteps - (MC_CONSTRAINT_LENGTH - 1);
+    for (i = 0; i < nbits; i++) {
+        int bit = dec[f->nsteps - i - 1][state] & 1;
+        state = (state >> 1) | (bit << 5);
+        out[nbits - i - 1] = bit;
+    }
+}
+
+// scalar model of TrellisUpdateSSE2/NEON
+static void trellis_model(u1_t *dec, u1_t *cur, const u1_t *old, const u1_t *met1, const u1_t *met2)
+{
+    #define ADDS(a, b) (((a) + (b) > 255)? 255 : (a) + (b))
+    for (int j = 0; j < MC_NUM_STATES/2; j++) {
+        int a = ADDS(old[j], met1[j]), b = ADDS(old[j+32], met2[j]);
+        int c = ADDS(old[j], met2[j]), e = ADDS(old[j+32], met1[j]);
+        cur[2*j] = (b <= a)? b : a;
+        dec[2*j] = (b <= a)? 0xff : 0;
+        cur[2*j+1] = (e <= c)? e : c;
+        dec[2*j+1] = (e <= c)? 0xff : 0;
+    }
+    #undef ADDS
+
+    if (cur[0] <= 150) return;
+    int min = 255;
+    for (int i = 0; i < MC_NUM_STATES; i++) if (cur[i] < min) min = cur[i];
+    for (int i = 0; i < MC_NUM_STATES; i++) cur[i] -= min;
+}
+
+// steps the kernel and the model over a frame from the same 8-bit metrics, each from its own output
+static int compare_trellis(CViterbiTest &vd, const frame_t *f, int frame)
+{
+    u1_t mk[2][MC_NUM_STATES], mm[2][MC_NUM_STATES], dk[MC_NUM_STATES], dm[MC_NUM_STATES];
+    u1_t met1[MC_NUM_STATES/2], met2[MC_NUM_STATES/2];
+    _REAL met[MC_NUM_OUTPUT_COMBINATIONS], avg = 0;
+    int i, j, n = 0;
+
+    for (i = 0; i < f->ndist; i++) avg += f->dist[i].rTow0 + f->dist[i].rTow1;
+    const _REAL amp = avg / (2 * f->ndist) / 10;
+
+    mk[0][0] = mm[0][0] = 0;
+    for (i = 1; i < MC_NUM_STATES; i++) mk[0][i] = mm[0][i] = MC_METRIC_INIT_VALUE;
+
+    for (i = 0; i < f->nsteps; i++) {
+        n += metric_set(f->punc[i], &f->dist[n], met);
+        for (j = 0; j < MC_NUM_STATES/2; j++) {
+            const int *b = bfly[j];
+            _REAL m0 = met[b[4]] / amp, m1 = met[b[5]] / amp;
+            met1[b[2]] = (m0 < 255)? (u1_t) m0 : 255;
+            met2[b[2]] = (m1 < 255)? (u1_t) m1 : 255;
+        }
+
+        int o = i & 1;
+        vd.Trellis(dk, mk[o^1], mk[o], met1, met2);
+        trellis_model(dm, mm[o^1], mm[o], met1, met2);
+        if (memcmp(mk[o^1], mm[o^1], MC_NUM_STATES) != 0 || memcmp(dk, dm, MC_NUM_STATES) != 0) {
+            printf("FAIL: frame %d step %d %s differ\n", frame, i,
+                memcmp(dk, dm, MC_NUM_STATES)? "decisions" : "path metrics");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static _BINARY parity(int x)
+{
+    x ^= x >> 4; x ^= x >> 2; x ^= x >> 1;
+    return x & 1;
+}
+
+// random data, zero tail, one puncturing pattern per frame, distances of a +/-1 symbol plus noise
+static void encode_frame(frame_t *f, int pattern, double sigma)
+{
+    static const int nused[] = { 0, 4, 3, 2, 1, 2 };    // by PP_TYPE
+    static const int used[][4] = { {}, {0, 1, 2, 3}, {0, 1, 2}, {0, 1}, {0}, {0, 2} };
+    int i, j, n = 0, sr = 0;
+
+    f->nsteps = NSTEPS;
+    f->punc = new int[NSTEPS];
+    f->dist = new CDistance[4 * NSTEPS];
+    f->bits = new _BINARY[NSTEPS];
+
+    for (i = 0; i < NSTEPS; i++) {
+        int bit = (i < NBITS)? (random() & 1) : 0;
+        f->bits[i] = bit;
+        sr = ((sr << 1) | bit) & 0x7f;
+        f->punc[i] = pattern;
+        for (j = 0; j < nused[pattern]; j++) {
+            int c = parity(sr & byGeneratorMatrix[used[pattern][j]]);
+            double y = noisy_symbol(c, sigma);
+            f->dist[n].rTow0 = (y - 1) * (y - 1);
+            f->dist[n].rTow1 = (y + 1) * (y + 1);
+            n++;
+        }
+    }
+    f->ndist = n;
+}
+
+static int read_frames(const char *fn)
+{
+    int n = 0;
+    FILE *fp = fopen(fn, "r");
+    if (fp == NULL) {
+        printf("can't open %s\n", fn);
+        return -1;
+    }
+    while (n < NFRAMES) {
+        frame_t *f = &frames[n];
+        if (fread(&f->nsteps, sizeof(int), 1, fp) != 1 || fread(&f->ndist, sizeof(int), 1, fp) != 1) break;
+        f->punc = new int[f->nsteps];
+        f->dist = new CDistance[f->ndist];
+        f->bits = NULL;
+        if (fread(f->punc, sizeof(int), f->nsteps, fp) != (size_t) f->nsteps) break;
+        int i;
+        for (i = 0; i < f->ndist; i++) {
+            float d[2];
+            if (fread(d, sizeof(float), 2, fp) != 2) break;
+            f->dist[i].rTow0 = d[0];
+            f->dist[i].rTow1 = d[1];
+        }
+        if (i != f->ndist) break;
+        n++;
+    }
+    fclose(fp);
+    return n;
+}
+
+int main(int argc, char *argv[])
+{
+    int i, n, nframes = 0, fails = 0, diff_frames = 0, diff_bits = 0;
+    int err_float = 0, err_simd = 0, ok_float = 0, ok_simd = 0;
+    static const int patterns[] = { PP_TYPE_1111, PP_TYPE_0111, PP_TYPE_0011, PP_TYPE_0101, PP_TYPE_0001 };
+    static u1_t dec[NSTEPS * 8][MC_NUM_STATES];
+    CViterbiTest vd;
+
+    srandom(1);
+
+    if (argc > 1) {
+        nframes = read_frames(argv[1]);
+        if (nframes < 0) return -1;
+        printf("%d recorded frames from %s\n", nframes, argv[1]);
+    } else {
+        // each pattern over Eb/No from -1 to +7 dB
+        for (nframes = 0; nframes < NFRAMES; nframes++) {
+            int pattern = patterns[nframes % 5];
+            double rate = (pattern == PP_TYPE_1111)? 0.25 : (pattern == PP_TYPE_0111)? 1.0/3 :
+                (pattern == PP_TYPE_0001)? 1 : 0.5;
+            encode_frame(&frames[nframes], pattern, ebn0_sigma(nframes, NFRAMES, -1, 7, rate));
+        }
+    }
+
+    for (i = 0; i < nframes; i++) {
+        frame_t *f = &frames[i];
+        if (f->nsteps > NSTEPS * 8) {
+            printf("frame %d: %d steps too long\n", i, f->nsteps);
+            return -1;
+        }
+        if (compare_trellis(vd, f, i) < 0) fails++;
+
+        // the complete decoders, SIMD and float
+        int nbits = f->nsteps - (MC_CONSTRAINT_LENGTH - 1), diffs = 0, ef = 0, es = 0;
+        CVector<CDistance> dist(f->ndist);
+        CVector<_DECISION> out(nbits);
+        _BINARY out_float[NSTEPS * 8];
+        for (n = 0; n < f->ndist; n++) dist[n] = f->dist[n];
+        vd.InitFrame(f);
+        vd.Decode(dist, out);
+        decode_float(f, out_float, dec);
+
+        for (n = 0; n < nbits; n++) {
+            if (out[n] != out_float[n]) diffs++;
+            if (f->bits && out[n] != f->bits[n]) es++;
+            if (f->bits && out_float[n] != f->bits[n]) ef++;
+        }
+        err_float += ef; err_simd += es;
+        if (ef == 0) ok_float++;
+        if (es == 0) ok_simd++;
+        if (diffs) diff_frames++;
+        diff_bits += diffs;
+    }
+
+    printf("%s trellis vs scalar model: %d/%d frames differ\n", SIMD_NAME, fails, nframes);
+    printf("%s decoder vs float decoder: %d/%d frames, %d bits differ (8-bit metric quantization)\n",
+        SIMD_NAME, diff_frames, nframes, diff_bits);
+    if (argc <= 1)
+        printf("vs transmitted: float %d bit errors, %d frames error free; %s %d bit errors, %d frames error free\n",
+            err_float, ok_float, SIMD_NAME, err_simd, ok_simd);
+    if (fails || nframes == 0) return -1;
+
+    // timing over complete frames, the input copy is needed because Decode() scales it in place
+    _BINARY out_float[NSTEPS * 8];
+    CVector<CDistance> dist, dist_in;
+    CVector<_DECISION> out;
+    time_vs_ref(NLOOP, "frame",
+        "float", [&](int n) {
+            decode_float(&frames[n % nframes], out_float, dec);
+        },
+        SIMD_NAME, [&](int n) {
+            frame_t *f = &frames[n % nframes];
+            if (dist.Size() != f->ndist) {
+                dist.Init(f->ndist);
+                dist_in.Init(f->ndist);
+                out.Init(f->nsteps - (MC_CONSTRAINT_LENGTH - 1));
+            }
+            memcpy(&dist_in[0], f->dist, f->ndist * sizeof(CDistance));
+            dist = dist_in;
+            vd.InitFrame(f);
+            vd.Decode(dist, out);
+        });
+    return 0;
+}
+
+#else
+
+int main(int argc, char *argv[])
+{
+    printf("no NEON or SSE2 in this build, nothing to compare\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,382 @@
+// Replays recorded GPS data offline, for benchmarking and regression testing the acquisition and
+// position solver code on the build machine.
+//
+// gps_replay -s file [-n rounds] [-e min_detected] [-b]
+//   Front-end bit stream (as read by GenSamples() in search.cpp, e.g. SiGe_Bands-L1.fs.16368.if.4092.rs81p.dat)
+//   is run through Sample() and then Correlate() for every sat each round, as SearchTask() does.
+//   Reports per PRN the round and the cumulative sample+correlation time at first detection,
+//   and the correlator throughput. -b also compares the full and pruned correlators (CorrelateBench).
+//
+// gps_replay -p file [-r lat lon alt] [-m max_m] [-c]
+//   Solver input logged by solve.cpp (GPS_SOLVE_LOG) is run through the all sats / not Galileo / only Galileo
+//   position solvers as SolveTask() does with plot_E1B on. Reports usec per epoch and the fix accuracy
+//   relative to the reference position, or the spread about the mean position if none is given.
+//   -c solves the subsets from scratch instead of from the all sats linearization.
+//
+// Returns non-zero if fewer than min_detected sats are found or the 95% horizontal error exceeds max_m.
+
+#include "types.h"
+
+// include the acquisition code so its static sample and correlation functions can be driven directly
+#define GPS_SAMPLES_FROM_FILE
+#define GPS_SAMPLES_FN replay_fn
+static const char *replay_fn;
+#include "search.cpp"
+
+#include "PosSolver.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/stat.h>
+#include <stdarg.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <array>
+
+// what search.cpp needs from the rest of the server
+gps_t gps;
+int gps_debug, is_locked;
+bool gps_e1b_only, update_in_progress, backup_in_progress, sd_copy_in_progress;
+clk_t clk;
+cfg_t cfg_adm;
+static shmem_t replay_shmem;
+shmem_t *shmem = &replay_shmem;
+#ifdef SPI_SHMEM_DISABLE
+    static spi_shmem_t replay_spi_shmem;
+    spi_shmem_t *spi_shmem_p = &replay_spi_shmem;
+#endif
+
+void spi_set(SPI_CMD cmd, uint16_t wparam, uint32_t lparam) {}
+void spi_get(SPI_CMD cmd, SPI_MISO *rx, int bytes, uint16_t wparam, uint32_t lparam) {}
+void *_TaskSleep(const char *reason, int usec, u4_t *wakeup_test) { return NULL; }
+void _NextTask(const char *s, u4_t param, u_int64_t pc) {}
+int _CreateTask(funcP_t entry, const char *name, void *param, int priority, u4_t flags, int f_arg) { return 0; }
+u4_t TaskID() { return 0; }
+void TaskSleepID(int id, int usec) {}
+void TaskWakeup(int id, u4_t flags, void *wake_param) {}
+u4_t timer_us() { return (u4_t) usec(); }
+void kiwi_exit(int err) { exit(err); }
+void lprintf(const char *fmt, ...) { va_list ap; va_start(ap, fmt); vprintf(fmt, ap); va_end(ap); }
+void _panic(const char *str, bool coreFile, const char *file, int line) { printf("PANIC: %s\n", str); abort(); }
+int _cfg_bool(cfg_t *cfg, const char *name, bool *error, u4_t flags) { return 0; }
+int rx_count_server_conns(conn_count_e type, conn_t *our_conn) { return 0; }
+void GPSstat_init() {}
+void GPSstat(STAT st, double d, int i, int j, int k, int l, double d2) {}
+int ChanFree(unsigned claimed) { return -1; }
+int ChanReset(int sat, int codegen_init, unsigned claimed, bool e1b_download) { return -1; }
+unsigned ChanOtherCode(bool isE1B) { return 0; }
+void ChanSearchPrep() {}
+void ChanE1BDownload() {}
+void ChanStart(int ch, int sat, int t_sample, int lo_shift, int ca_shift, int snr) {}
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// acquisition
+
+struct detect_t {
+    int round;
+    double secs;
+    float snr;
+    int dop_hz, ca_shift;
+};
+
+static int replay_search(const char *fn, int max_rounds, int min_detected)
+{
+    struct stat st;
+    if (stat(fn, &st) < 0) {
+        printf("can't open %s\n", fn);
+        return -1;
+    }
+    replay_fn = fn;
+
+    // Sample() reads whole packets until it has NSAMPLES bits
+    const int packet = GPS_SAMPS * 2;
+    const int bytes_per_round = ((NSAMPLES + packet*8 - 1) / (packet*8)) * packet;
+    int rounds = st.st_size / bytes_per_round;
+    if (max_rounds && rounds > max_rounds) rounds = max_rounds;
+    if (rounds == 0) {
+        printf("%s shorter than one %d byte sample\n", fn, bytes_per_round);
+        return -1;
+    }
+
+    gps.acq_Navstar = gps.acq_QZSS = gps.acq_Galileo = true;
+    double t0 = usec();
+    SearchInit();
+    printf("SearchInit (code FFTs) %.3f sec, %d rounds of %d samples from %s\n", (usec() - t0)/1e6, rounds, NSAMPLES, fn);
+
+    static detect_t det[MAX_SATS];
+    int n_sats, n_corr = 0, n_det = 0;
+    double secs = 0, secs_sample = 0, secs_corr = 0;
+    for (n_sats = 0; Sats[n_sats].prn != -1; n_sats++)
+        det[n_sats].round = -1;
+
+    for (int r = 0; r < rounds; r++) {
+        double t = usec();
+        Sample();
+        double dt = (usec() - t)/1e6;
+        secs += dt;
+        secs_sample += dt;
+
+        for (int sat = 0; sat < n_sats; sat++) {
+            if (!search_enabled(&Sats[sat])) continue;
+            if (test_mode) CorrelateBench(sat, fwd_buf);
+            int lo_shift, ca_shift;
+            t = usec();
+            float snr = Correlate(sat, fwd_buf, &lo_shift, &ca_shift);
+            dt = (usec() - t)/1e6;
+            secs += dt;
+            secs_corr += dt;
+            n_corr++;
+
+            if (snr >= search_min_sig(sat) && det[sat].round < 0) {
+                detect_t *d = &det[sat];
+                d->round = r;
+                d->secs = secs;
+                d->snr = snr;
+                d->dop_hz = lo_shift * BIN_SIZE;
+                d->ca_shift = ca_shift * DECIM;
+                n_det++;
+            }
+        }
+    }
+
+    printf("\nPRN   round  detect(sec)  snr     dop(Hz)  ca_shift\n");
+    for (int sat = 0; sat < n_sats; sat++) {
+        detect_t *d = &det[sat];
+        if (d->round < 0) continue;
+        printf("%-5s %5d  %11.3f  %5.1f  %8d  %8d\n", PRN(sat), d->round, d->secs, d->snr, d->dop_hz, d->ca_shift);
+    }
+
+    int n_dop = 2*(5000/BIN_SIZE) + 1;
+    printf("\n%d/%d sats detected\n", n_det, n_sats);
+    printf("Sample %.3f msec/round, Correlate %.3f msec/PRN (%.1f usec/doppler bin), %.1f PRN/sec\n",
+        secs_sample/rounds * 1e3, secs_corr/n_corr * 1e3, secs_corr/n_corr/n_dop * 1e6, n_corr/secs_corr);
+
+    if (n_det < min_detected) {
+        printf("FAIL: %d sats detected, expected at least %d\n", n_det, min_detected);
+        return -1;
+    }
+    return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// position solution
+
+typedef PosSolver::vec_type vec_type;
+typedef PosSolver::mat_type mat_type;
+typedef PosSolver::ivec_type ivec_type;
+
+// as solve.cpp
+#define UERE 6.0
+
+#define NSOLVERS 3
+static const char *solver_name[NSOLVERS] = { "all", "not Galileo", "only Galileo" };
+
+struct epoch_t {
+    u64_t ticks;
+    std::vector<std::string> prn;
+    std::vector<double> sv[4], weight;
+};
+
+struct fix_t {
+    double lat, lon, alt;
+};
+
+static ivec_type subset(epoch_t const& e, bool galileo)
+{
+    int n = 0;
+    ivec_type idx(e.prn.size());
+    for (int i = 0; i < (int) e.prn.size(); i++)
+        if ((e.prn[i][0] == 'E') == galileo) idx[n++] = i;
+    return n? idx.subarray(0, n-1).copy() : ivec_type();
+}
+
+static mat_type sv_of(epoch_t const& e, ivec_type const& idx)
+{
+    mat_type sv(4, idx.dim());
+    for (int i = 0; i < idx.dim(); i++)
+        for (int j = 0; j < 4; j++)
+            sv[j][i] = e.sv[j][idx[i]];
+    return sv;
+}
+
+static vec_type weight_of(epoch_t const& e, ivec_type const& idx)
+{
+    vec_type w(idx.dim());
+    for (int i = 0; i < idx.dim(); i++)
+        w[i] = e.weight[idx[i]];
+    return w;
+}
+
+static int load_solve_log(const char *fn, std::vector<epoch_t> &epochs)
+{
+    FILE *fp = fopen(fn, "r");
+    if (fp == NULL) {
+        printf("can't open %s\n", fn);
+        return -1;
+    }
+
+    char line[256], prn[16];
+    epoch_t e;
+    bool in_epoch = false;
+    while (fgets(line, sizeof(line), fp)) {
+        char *s = strstr(line, "GNSS_");
+        if (s == NULL) continue;
+        unsigned long long ticks;
+        double x, y, z, t, w;
+        if (sscanf(s, "GNSS_start %llu", &ticks) == 1) {
+            e = epoch_t();
+            e.ticks = ticks;
+            in_epoch = true;
+        } else
+        if (in_epoch && sscanf(s, "GNSS_sat %15s %lf %lf %lf %lf %lf", prn, &x, &y, &z, &t, &w) == 6) {
+            e.prn.push_back(prn);
+            e.sv[0].push_back(x);
+            e.sv[1].push_back(y);
+            e.sv[2].push_back(z);
+            e.sv[3].push_back(C*t);   // [s] -> [m]
+            e.weight.push_back(w);
+        } else
+        if (in_epoch && strncmp(s, "GNSS_end", 8) == 0) {
+            if (e.prn.size()) epochs.push_back(e);
+            in_epoch = false;
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+static double percentile(std::vector<double> v, double p)
+{
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[std::min((int) v.size()-1, (int) (p * v.size()))];
+}
+
+static int replay_solve(const char *fn, bool have_ref, fix_t ref, double max_m, bool cold)
+{
+    std::vector<epoch_t> epochs;
+    if (load_solve_log(fn, epochs) < 0) return -1;
+    if (epochs.empty()) {
+        printf("no GNSS_start/GNSS_sat/GNSS_end epochs in %s\n", fn);
+        return -1;
+    }
+
+    std::array<PosSolver::sptr, NSOLVERS> solvers = {
+        PosSolver::make(UERE, ADC_CLOCK_TYP),
+        PosSolver::make(UERE, ADC_CLOCK_TYP),
+        PosSolver::make(UERE, ADC_CLOCK_TYP)
+    };
+
+    std::vector<fix_t> fixes[NSOLVERS];
+    std::vector<double> us_epoch;
+    int nsv_sum = 0;
+
+    for (epoch_t const& e : epochs) {
+        int nsv = e.prn.size();
+        nsv_sum += nsv;
+        ivec_type all(nsv);
+        for (int i = 0; i < nsv; i++) all[i] = i;
+        ivec_type idx[NSOLVERS] = { all, subset(e, false), subset(e, true) };
+
+        double t0 = usec();
+        solvers[0]->solve(sv_of(e, all), weight_of(e, all), e.ticks);
+        for (int s = 1; s < NSOLVERS; s++) {
+            if (cold)
+                solvers[s]->solve(sv_of(e, idx[s]), weight_of(e, idx[s]), e.ticks);
+            else
+                solvers[s]->solve(sv_of(e, idx[s]), weight_of(e, idx[s]), e.ticks, *solvers[0], idx[s]);
+        }
+        us_epoch.push_back(usec() - t0);
+
+        for (int s = 0; s < NSOLVERS; s++) {
+            if (!solvers[s]->ekf_valid() && !solvers[s]->spp_valid()) continue;
+            PosSolver::LonLatAlt const& llh = solvers[s]->llh();
+            fix_t f = { llh.lat(), llh.lon(), llh.alt() };
+            fixes[s].push_back(f);
+        }
+    }
+
+    printf("%d epochs, %.1f sats/epoch, subsets %s\n", (int) epochs.size(), (float) nsv_sum / epochs.size(),
+        cold? "solved from scratch" : "share the all sats linearization");
+    double us_sum = 0;
+    for (double us : us_epoch) us_sum += us;
+    printf("solver %.1f usec/epoch (median %.1f, 95%% %.1f, max %.1f)\n", us_sum / us_epoch.size(),
+        percentile(us_epoch, 0.5), percentile(us_epoch, 0.95), percentile(us_epoch, 1));
+
+    if (!have_ref) {
+        if (fixes[0].empty()) {
+            printf("FAIL: no position fixes\n");
+            return -1;
+        }
+        ref.lat = ref.lon = ref.alt = 0;
+        for (fix_t const& f : fixes[0]) {
+            ref.lat += f.lat; ref.lon += f.lon; ref.alt += f.alt;
+        }
+        ref.lat /= fixes[0].size(); ref.lon /= fixes[0].size(); ref.alt /= fixes[0].size();
+    }
+    printf("%s %.6f %.6f %.1f\n", have_ref? "reference" : "mean position", ref.lat, ref.lon, ref.alt);
+
+    int rv = 0;
+    const double m_per_deg = 6371e3 * M_PI/180;
+    printf("\nsolver        fixes  horiz 50%%  95%% (m)  vert rms (m)\n");
+    for (int s = 0; s < NSOLVERS; s++) {
+        std::vector<double> h, v;
+        for (fix_t const& f : fixes[s]) {
+            double dn = (f.lat - ref.lat) * m_per_deg;
+            double de = (f.lon - ref.lon) * m_per_deg * cos(ref.lat * M_PI/180);
+            h.push_back(sqrt(dn*dn + de*de));
+            v.push_back((f.alt - ref.alt) * (f.alt - ref.alt));
+        }
+        double v_ms = 0;
+        for (double d2 : v) v_ms += d2;
+        double h95 = percentile(h, 0.95);
+        printf("%-12s  %5d  %8.1f  %7.1f  %12.1f\n", solver_name[s], (int) fixes[s].size(),
+            percentile(h, 0.5), h95, v.size()? sqrt(v_ms / v.size()) : 0);
+        if (s == 0 && max_m && h95 > max_m) {
+            printf("FAIL: 95%% horizontal error %.1f m over %.1f m\n", h95, max_m);
+            rv = -1;
+        }
+    }
+    return rv;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char *argv[])
+{
+    const char *samples_fn = NULL, *solve_fn = NULL;
+    int rounds = 0, min_detected = 0;
+    bool have_ref = false, cold = false;
+    fix_t ref = { 0, 0, 0 };
+    double max_m = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i+1 < argc) samples_fn = argv[++i]; else
+        if (strcmp(argv[i], "-p") == 0 && i+1 < argc) solve_fn = argv[++i]; else
+        if (strcmp(argv[i], "-n") == 0 && i+1 < argc) rounds = atoi(argv[++i]); else
+        if (strcmp(argv[i], "-e") == 0 && i+1 < argc) min_detected = atoi(argv[++i]); else
+        if (strcmp(argv[i], "-m") == 0 && i+1 < argc) max_m = atof(argv[++i]); else
+        if (strcmp(argv[i], "-b") == 0) test_mode = 1; else
+        if (strcmp(argv[i], "-c") == 0) cold = true; else
+        if (strcmp(argv[i], "-r") == 0 && i+3 < argc) {
+            ref.lat = atof(argv[++i]);
+            ref.lon = atof(argv[++i]);
+            ref.alt = atof(argv[++i]);
+            have_ref = true;
+        } else {
+            printf("usage: gps_replay -s samples_file [-n rounds] [-e min_detected] [-b]\n");
+            printf("       gps_replay -p solve_log [-r lat lon alt] [-m max_m] [-c]\n");
+            return -1;
+        }
+    }
+
+    int rv = 0;
+    if (samples_fn && replay_search(samples_fn, rounds, min_detected) < 0) rv = -1;
+    if (solve_fn && replay_solve(solve_fn, have_ref, ref, max_m, cold) < 0) rv = -1;
+    if (!samples_fn && !solve_fn) printf("nothing to do, see -s and -p\n");
+    return rv;
+}
@@ -0,0 +1,141 @@
+// Compares the sliding DFT SSTV FM demodulator (SSTV_FM_SDFT) with the 1024 point FFT one
+// for each of the adaptive Hann window lengths, then times both.
+//
+// sstv_fm_bench [-m mode] [-s seconds]
+//   A phase continuous FM signal stepping between random video luminance tones every 2048 samples is
+//   generated at the Kiwi 12k rate and noise added over a range of SNRs (3 kHz bandwidth).
+//   Freq is estimated every fm_sample_interval samples of the mode (default Martin 1) as sstv_video_get()
+//   does. Reports the rms luminance error of each against the transmitted tone (only for windows entirely
+//   within one step, so it is the estimator error and not the smoothing over pixels), the rms difference
+//   between the two and the cpu time per video sample.
+
+#include "types.h"
+#include "sstv.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+#ifndef SSTV_FM_SDFT
+    #error SSTV_FM_SDFT not defined in sstv.h
+#endif
+
+// what the SSTV code needs from the rest of the server
+sstv_t sstv;
+void lprintf(const char *fmt, ...) { va_list ap; va_start(ap, fmt); vprintf(fmt, ap); va_end(ap); }
+void _panic(const char *str, bool coreFile, const char *file, int line) { printf("PANIC: %s (%s:%d)\n", str, file, line); abort(); }
+
+#define AMPL 8192.0
+#define STEP 2048
+#define LUM(f) ((f) - 1500) / 3.1372549
+
+static sstv_chan_t chan;
+
+int main(int argc, char *argv[])
+{
+    int i, ch, mode = M1;
+    double secs = 5;
+    const int HannLens[7] = { 48, 64, 96, 128, 256, 512, 1024 };
+    const int SNRs[] = { 30, 10, 3, -5, -10 };
+    static SSTV_REAL Hann[1024];
+
+    while ((ch = getopt(argc, argv, "m:s:")) != -1) {
+        switch (ch) {
+            case 'm': mode = atoi(optarg); break;
+            case 's': secs = atof(optarg); break;
+            default: printf("usage: sstv_fm_bench [-m mode] [-s seconds]\n"); return -1;
+        }
+    }
+
+    sstv.nom_rate = SSTV_TEST_FILE_RATE;
+    ModeSpec_t *m = &ModeSpec[mode];
+    double spp = sstv.nom_rate * m->LineTime / m->ImgWidth;
+    int fm_sample_interval = (int) (spp * 3/4);
+    int len = secs * sstv.nom_rate, margin = 1024;
+    printf("%s: %.1f samples/pixel, fm_sample_interval=%d, %d samples\n", m->ShortName, spp, fm_sample_interval, len);
+
+    sstv_chan_t *e = &chan;
+    e->fft.in1k = SSTV_FFTW_ALLOC_REAL(1024);
+    e->fft.out1k = SSTV_FFTW_ALLOC_COMPLEX(1024);
+    e->fft.Plan1024 = SSTV_FFTW_PLAN_DFT_R2C_1D(1024, e->fft.in1k, e->fft.out1k, FFTW_ESTIMATE);
+    s2_t *samps = (s2_t *) malloc((len + 2*margin) * sizeof(s2_t));
+    float *lum = (float *) malloc((len + 2*margin) * sizeof(float));
+    e->pcm.Buffer = samps;
+
+    // random luminance steps
+    srandom(1);
+    double phase, f = 1500;
+    for (i = 0; i < len + 2*margin; i++) {
+        if ((i % STEP) == 0)
+            f = 1500 + (random() % 256) * 3.1372549;
+        lum[i] = LUM(f);
+    }
+
+    printf("win  SNR dB   FFT lum err   SDFT lum err   FFT-SDFT diff   FFT usec/samp   SDFT usec/samp   speedup\n");
+    double t_fft_all = 0, t_sdft_all = 0;
+
+    for (int w = 0; w < ARRAY_LEN(HannLens); w++) {
+        int WinLength = HannLens[w];
+        for (i = 0; i < WinLength; i++)
+            Hann[i] = 0.5 * (1 - SSTV_MCOS( (2 * M_PI * i) / (WinLength - 1)) );
+
+        for (int s = 0; s < ARRAY_LEN(SNRs); s++) {
+            double sigma = AMPL / pow(10, SNRs[s] / 20.0);
+            srandom(2);
+            phase = 0;
+            for (i = 0; i < len + 2*margin; i++) {
+                double v = AMPL * cos(phase) + sigma * gauss();
+                samps[i] = (v > 32767)? 32767 : ((v < -32768)? -32768 : v);
+                phase += 2 * M_PI * (1500 + lum[i] * 3.1372549) / sstv.nom_rate;
+            }
+
+            int n = 0;
+            double err_fft = 0, err_sdft = 0, diff = 0, t_fft = 0, t_sdft = 0, t0;
+
+            for (int SampleNum = 0; SampleNum < len; SampleNum++) {
+                e->pcm.WindowPtr = margin + SampleNum;
+                bool fm_sample = (SampleNum % fm_sample_interval == 0);
+
+                SSTV_REAL Freq_fft = 0, Freq_sdft = 0;
+                if (fm_sample) {
+                    t0 = usec();
+                    Freq_fft = sstv_fm_fft_freq(e, Hann, WinLength);
+                    t_fft += usec() - t0;
+                }
+
+                t0 = usec();
+                if (SampleNum == 0)
+                    sstv_fm_sdft_init(e, WinLength);
+                else
+                    sstv_fm_sdft_update(e);
+                if (fm_sample)
+                    Freq_sdft = sstv_fm_sdft_freq(e);
+                t_sdft += usec() - t0;
+
+                int wp = e->pcm.WindowPtr;
+                if (fm_sample && (wp - WinLength/2) / STEP == (wp + WinLength/2 - 1) / STEP) {
+                    double ref = lum[wp];
+                    double l_fft = clip(LUM(Freq_fft)), l_sdft = clip(LUM(Freq_sdft));
+                    err_fft += (l_fft - ref) * (l_fft - ref);
+                    err_sdft += (l_sdft - ref) * (l_sdft - ref);
+                    diff += (l_fft - l_sdft) * (l_fft - l_sdft);
+                    n++;
+                }
+            }
+
+            t_fft_all += t_fft;
+            t_sdft_all += t_sdft;
+            printf("%4d %7d %13.1f %14.1f %15.1f %15.3f %16.3f %8.1fx\n", WinLength, SNRs[s],
+                sqrt(err_fft/n), sqrt(err_sdft/n), sqrt(diff/n), t_fft/len, t_sdft/len, t_fft/t_sdft);
+        }
+    }
+
+    printf("all windows: FFT %.3f usec/samp, SDFT %.3f usec/samp, speedup %.1fx\n",
+        t_fft_all / (len * ARRAY_LEN(HannLens) * ARRAY_LEN(SNRs)),
+        t_sdft_all / (len * ARRAY_LEN(HannLens) * ARRAY_LEN(SNRs)), t_fft_all / t_sdft_all);
+    return 0;
+}
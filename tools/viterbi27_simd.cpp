@@ -0,0 +1,134 @@
+// Checks the NEON/SSE2 viterbi27 update against the portable one for bit-exact path metrics,
+// decisions and decoded data, then times both.
+//
+// With no argument E1B sized frames (120 bits, Galileo polynomials as in channel.cpp) are encoded
+// and noise added over a range of Eb/No. Otherwise the argument is a file of recorded soft symbols
+// (unsigned char pairs, 0 = strong one .. 255 = strong zero) decoded E1B_NBIT pairs at a time.
+
+#include "types.h"
+
+// include the decoder so the private state (struct v27) can be compared
+#include "viterbi27_port.cpp"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define E1B_NBIT    120
+#define NFRAMES     20000
+#define NLOOP       20000
+
+#if defined(__ARM_NEON)
+    #define update_viterbi27_blk_simd update_viterbi27_blk_neon
+    #define SIMD_NAME "neon"
+#elif defined(__SSE2__)
+    #define update_viterbi27_blk_simd update_viterbi27_blk_sse2
+    #define SIMD_NAME "sse2"
+#endif
+
+// E1B style frame: random data with a zero tail, hard symbols 0/255 plus noise
+static void encode_frame(u1_t *syms, int polys[2], double sigma)
+{
+    int i, sr = 0;
+
+    for (i = 0; i < E1B_NBIT; i++) {
+        int bit = (i < E1B_NBIT-6)? (random() & 1) : 0;
+        sr = (sr << 1) | bit;
+        for (int j = 0; j < 2; j++) {
+            double s = 127.5 * (1 + noisy_symbol(parity(sr & polys[j]), sigma));
+            syms[2*i+j] = (s < 0)? 0 : ((s > 255)? 255 : s);
+        }
+    }
+}
+
+static int compare(u1_t *syms, int frame)
+{
+    struct v27 *vp = (struct v27 *) create_viterbi27_port(E1B_NBIT);
+    struct v27 *vs = (struct v27 *) create_viterbi27_port(E1B_NBIT);
+    u1_t dp[E1B_NBIT/8], ds[E1B_NBIT/8];
+    int rv = 0;
+
+    init_viterbi27_port(vp, 0);
+    init_viterbi27_port(vs, 0);
+    update_viterbi27_blk_port(vp, syms, E1B_NBIT);
+    update_viterbi27_blk_simd(vs, syms, E1B_NBIT);
+
+    if (memcmp(vp->old_metrics, vs->old_metrics, sizeof(metric_t)) != 0) {
+        printf("FAIL: frame %d path metrics differ\n", frame);
+        rv = -1;
+    }
+    for (int i = 0; i < E1B_NBIT; i++) {
+        if (vp->decisions[i].w[0] != vs->decisions[i].w[0] || vp->decisions[i].w[1] != vs->decisions[i].w[1]) {
+            printf("FAIL: frame %d decisions differ at bit %d\n", frame, i);
+            rv = -1;
+            break;
+        }
+    }
+    chainback_viterbi27_port(vp, dp, E1B_NBIT-6, 0);
+    chainback_viterbi27_port(vs, ds, E1B_NBIT-6, 0);
+    if (memcmp(dp, ds, (E1B_NBIT-6)/8) != 0) {
+        printf("FAIL: frame %d decoded data differs\n", frame);
+        rv = -1;
+    }
+
+    delete_viterbi27_port(vp);
+    delete_viterbi27_port(vs);
+    return rv;
+}
+
+int main(int argc, char *argv[])
+{
+    int i, frames = 0, fails = 0;
+    int polys[2] = { 0x4f, 0x6d };      // k=7; Galileo E1B
+    static u1_t syms[NFRAMES][2*E1B_NBIT];
+
+    #ifndef SIMD_NAME
+        printf("no NEON or SSE2 in this build, nothing to compare\n");
+        return 0;
+    #else
+
+    set_viterbi27_polynomial_port(polys);
+    srandom(1);
+
+    if (argc > 1) {
+        FILE *fp = fopen(argv[1], "r");
+        if (fp == NULL) {
+            printf("can't open %s\n", argv[1]);
+            return -1;
+        }
+        while (frames < NFRAMES && fread(syms[frames], 2*E1B_NBIT, 1, fp) == 1)
+            frames++;
+        fclose(fp);
+        printf("%d recorded frames from %s\n", frames, argv[1]);
+    } else {
+        // Eb/No from -3 to +9 dB
+        for (frames = 0; frames < NFRAMES; frames++)
+            encode_frame(syms[frames], polys, ebn0_sigma(frames, NFRAMES, -3, 9, 0.5));
+        // and the degenerate all-erasure frame
+        memset(syms[0], 127, sizeof(syms[0]));
+    }
+
+    for (i = 0; i < frames; i++)
+        if (compare(syms[i], i) < 0) fails++;
+    printf("%s vs port: %d/%d frames differ\n", SIMD_NAME, fails, frames);
+    if (fails || frames == 0) return -1;
+
+    void *vp = create_viterbi27_port(E1B_NBIT);
+    u1_t data[E1B_NBIT/8];
+    time_vs_ref(NLOOP, "frame",
+        "port", [&](int n) {
+            init_viterbi27_port(vp, 0);
+            update_viterbi27_blk_port(vp, syms[n % frames], E1B_NBIT);
+            chainback_viterbi27_port(vp, data, E1B_NBIT-6, 0);
+        },
+        SIMD_NAME, [&](int n) {
+            init_viterbi27_port(vp, 0);
+            update_viterbi27_blk_simd(vp, syms[n % frames], E1B_NBIT);
+            chainback_viterbi27_port(vp, data, E1B_NBIT-6, 0);
+        });
+    delete_viterbi27_port(vp);
+    return 0;
+    #endif
+}
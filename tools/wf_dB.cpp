@@ -0,0 +1,117 @@
+// Checks and times the simd waterfall kernels used by compute_frame() against the
+// original scalar loops (|X|^2, peak-hold bin reduction, log10f dB and 8-bit pack).
+//
+// A pixel value may differ by one count from the log10f() version only where the exact
+// dB value is within the 0.1 dB tolerance of a truncation boundary.
+
+#include "types.h"
+#include "simd.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define WF_WIDTH    1024
+#define NFFT        4096        // fft_used at z0
+#define PLOT_WIDTH  1137        // typical for 66.666 MHz ADC clock and 30 MHz ui_srate
+#define NLOOP       2000
+#define TOL_DB      0.1
+
+static fftwf_complex fft[NFFT];
+static u2_t fft2wf_map[NFFT];
+static float fft_scale[WF_WIDTH];
+
+// the scalar loops as they were in compute_frame()
+static int scalar_frame(int fft_used, float fft_offset, u1_t *bp)
+{
+    int i, bin, _bin = -1, limit = fft_used;
+    float pwr[NFFT], pwr_out_peak[WF_WIDTH];
+
+    pwr[0] = pwr[1] = 0;
+    for (i=2; i < fft_used; i++) {
+        float re = fft[i][0], im = fft[i][1];
+        pwr[i] = re*re + im*im;
+    }
+
+    memset(pwr_out_peak, 0, sizeof(pwr_out_peak));
+    for (i=0; i < fft_used; i++) {
+        float p = pwr[i];
+        bin = fft2wf_map[i];
+        if (bin >= WF_WIDTH) {
+            limit = i;
+            break;
+        }
+        if (bin == _bin) {
+            if (p > pwr_out_peak[bin]) pwr_out_peak[bin] = p;
+        } else {
+            pwr_out_peak[bin] = p;
+            _bin = bin;
+        }
+    }
+
+    simd_dB_u8_ref(WF_WIDTH, pwr_out_peak, fft_scale, fft_offset, bp);
+    return limit;
+}
+
+static int simd_frame(int fft_used, float fft_offset, u1_t *bp)
+{
+    float pwr_out_peak[WF_WIDTH];
+
+    fft[0][0] = fft[0][1] = fft[1][0] = fft[1][1] = 0;
+    int limit = simd_mag2_peak_map(fft_used, fft, fft2wf_map, pwr_out_peak, WF_WIDTH);
+    simd_dB_u8(WF_WIDTH, pwr_out_peak, fft_scale, fft_offset, bp);
+    return limit;
+}
+
+int main(int argc, char *argv[])
+{
+    int i;
+    u1_t ref[WF_WIDTH], out[WF_WIDTH];
+    float maxmag = NFFT/2;
+    float fft_offset = -0.8;
+
+    // log-uniform magnitudes spanning the full 0..-200 dB display range and beyond
+    srandom(1);
+    for (i=0; i < NFFT; i++) {
+        float mag = maxmag * powf(10, -12.0 * random() / RAND_MAX);
+        float ph = 2.0 * M_PI * random() / RAND_MAX;
+        fft[i][0] = mag * cosf(ph);
+        fft[i][1] = mag * sinf(ph);
+    }
+    for (i=0; i < NFFT; i++)
+        fft2wf_map[i] = PLOT_WIDTH * i/NFFT;
+    for (i=0; i < WF_WIDTH; i++)
+        fft_scale[i] = (i >= 500 && i < 510)? 0 : 5.0 / (maxmag * maxmag);     // some masked pixels
+
+    int ref_limit = scalar_frame(NFFT, fft_offset, ref);
+    int limit = simd_frame(NFFT, fft_offset, out);
+    if (limit != ref_limit) {
+        printf("FAIL: fft_used_limit %d, expected %d\n", limit, ref_limit);
+        return -1;
+    }
+
+    // recompute the exact pre-truncation values to judge any mismatches
+    float peak[WF_WIDTH];
+    simd_mag2_peak_map(NFFT, fft, fft2wf_map, peak, WF_WIDTH);
+    int diffs = 0, fails = 0;
+    for (i=0; i < WF_WIDTH; i++) {
+        if (out[i] == ref[i]) continue;
+        diffs++;
+        float dB = 10.0 * log10f(peak[i] * fft_scale[i] + (float) 1e-30) + fft_offset - 1;
+        float edge = fabsf(dB - roundf(dB));
+        if (abs(out[i] - ref[i]) > 1 || edge > TOL_DB) {
+            printf("FAIL: pixel %d simd %d ref %d (%.3f dB)\n", i, out[i], ref[i], dB);
+            fails++;
+        }
+    }
+    printf("%d/%d pixels differ by one count at a truncation boundary, %d outside %.1f dB\n",
+        diffs, WF_WIDTH, fails, TOL_DB);
+    if (fails) return -1;
+
+    time_vs_ref(NLOOP, "frame",
+        "scalar", [&](int n) { scalar_frame(NFFT, fft_offset, ref); },
+        "simd", [&](int n) { simd_frame(NFFT, fft_offset, out); });
+    return 0;
+}
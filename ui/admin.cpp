@@ -322,6 +322,47 @@ void c2s_admin(void *param)
 			if (i == 0) {
 			    dpump.force_reset = true;
 			    dpump.resets = 0;
+			    memset(&dpump.intr_hist, 0, sizeof(dpump.intr_hist));
+			    memset(&dpump.gap_hist, 0, sizeof(dpump.gap_hist));
+				continue;
+			}
+#endif
+
+            // scheduler and data pump latency histograms, polled by the admin page
+            int sched_reset;
+			i = sscanf(cmd, "SET sched_stats reset=%d", &sched_reset);
+			if (i == 1) {
+			    sb = kstr_cat(NULL, "{");
+#ifndef CFG_GPS_ONLY
+			    sb = kstr_asprintf(sb, "\"dp\":{\"r\":%d,\"o\":%d,\"i\":", dpump.resets, dpump.in_overruns);
+			    sb = lat_hist_json(sb, &dpump.intr_hist);
+			    sb = kstr_cat(sb, ",\"g\":");
+			    sb = lat_hist_json(sb, &dpump.gap_hist);
+			    sb = kstr_cat(sb, "},");
+			    if (sched_reset) {
+                    memset(&dpump.intr_hist, 0, sizeof(dpump.intr_hist));
+                    memset(&dpump.gap_hist, 0, sizeof(dpump.gap_hist));
+			    }
+#endif
+			    sb = TaskSchedStats(sb, sched_reset);
+			    sb = kstr_cat(sb, "}");
+				send_msg_encoded(conn, "ADM", "sched_stats", "%s", kstr_sp(sb));
+				kstr_free(sb);
+				continue;
+			}
+
+#ifdef MALLOC_DEBUG
+			i = strcmp(cmd, "SET malloc_stats");
+			if (i == 0) {
+				sb = kiwi_malloc_stats();
+				send_msg_encoded(conn, "ADM", "malloc_stats", "%s", kstr_sp(sb));
+				kstr_free(sb);
+				continue;
+			}
+
+			i = strcmp(cmd, "SET malloc_dump");
+			if (i == 0) {
+				kiwi_malloc_dump(64);
 				continue;
 			}
 #endif
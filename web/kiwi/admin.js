@@ -28,6 +28,13 @@ function status_html()
                w3_div('id-status-dp-hist'),
                w3_div('id-status-in-hist')
             )
+         ) +
+         w3_div('w3-container w3-section',
+            w3_inline('',
+               w3_div('', 'Server memory (kiwi_malloc):'),
+               w3_button('w3-padding-smaller w3-aqua|margin-left:10px', 'Dump to log', 'status_malloc_dump_cb')
+            ),
+            w3_div('id-status-malloc w3-container')
          )
       ) : '';
    
@@ -52,6 +59,49 @@ function status_dpump_hist_reset_cb(id, idx)
 	ext_send('SET dpump_hist_reset');
 }
 
+function status_malloc_dump_cb(id, idx)
+{
+	ext_send('SET malloc_dump');
+}
+
+var status_malloc_interval;
+
+// only poll the malloc stats while the status tab is showing
+function status_focus(id)
+{
+   if (!admin_sdr_mode) return;
+	kiwi_clearInterval(status_malloc_interval);
+	ext_send('SET malloc_stats');
+	status_malloc_interval = setInterval(function() { ext_send('SET malloc_stats'); }, 5000);
+}
+
+function status_blur(id)
+{
+	kiwi_clearInterval(status_malloc_interval);
+}
+
+// live per-tag allocation stats, largest first
+function status_malloc_stats(p)
+{
+   var el = w3_el('id-status-malloc');
+   if (!el) return;
+   var o;
+   try {
+      o = JSON.parse(decodeURIComponent(p));
+   } catch(ex) {
+      console.log('status_malloc_stats: JSON parse fail');
+      return;
+   }
+   
+   o.t.sort(function(a, b) { return b.b - a.b; });
+   var s = o.n.toUnits() +' blocks, '+ (o.b/1024).toFixed(0) +' kB live, '+ (o.s/1024).toFixed(0) +' kB slabs<br>';
+   for (var i = 0; i < o.t.length && i < 16; i++) {
+      var t = o.t[i];
+      s += (i? ', ':'') + t.f +' '+ t.c.toUnits() +'/'+ (t.b/1024).toFixed(1) +'k (max '+ (t.h/1024).toFixed(1) +'k)';
+   }
+   el.innerHTML = s;
+}
+
 function status_user_kick_cb(id, idx)
 {
    console.log('status_user_kick_cb='+ idx);
@@ -2787,6 +2837,10 @@ function admin_recv(data)
 				public_update(param[1]);
 				break;
 
+			case "malloc_stats":
+				status_malloc_stats(param[1]);
+				break;
+
 			case "auto_nat":
 				var p = +param[1];
 				var el = w3_el('id-net-auto-nat-msg');
@@ -1,4 +1,4 @@
 
 
 /* web/kiwi/admin.min.js */
-var admin={BBAI:!1,reg_status:{}};function status_html(){var e=admin_sdr_mode?"<hr>"+w3_div("id-msg-errors w3-container")+w3_div("w3-container w3-section",w3_inline("",w3_div("","Realtime response histograms:"),w3_button("w3-padding-smaller w3-aqua|margin-left:10px","Reset","status_dpump_hist_reset_cb")),w3_div("w3-container",w3_div("id-status-dp-hist"),w3_div("id-status-in-hist"))):"";return w3_div("id-status w3-hide","<hr>"+w3_div("id-problems w3-container")+w3_div("id-msg-config w3-container")+w3_div("id-msg-gps w3-container")+"<hr>"+w3_div("id-msg-stats-cpu w3-container")+w3_div("id-msg-stats-xfer w3-container")+e+"<hr>"+w3_div("id-debugdiv w3-container"))}function status_dpump_hist_reset_cb(e,t){ext_send("SET dpump_hist_reset")}function status_user_kick_cb(e,t){console.log("status_user_kick_cb="+t),ext_send("SET user_kick="+t)}var mode_icon_snd12=w3_icon("w3-text-blue","fa-volume-up",28)+"&nbsp;",mode_icon_snd20=w3_icon("w3-text-red","fa-volume-up",28)+"&nbsp;",mode_icon_fft=w3_icon("w3-text-green","fa-bar-chart",28)+"&nbsp;",mode_icon_wf=w3_icon("w3-text-amber","fa-area-chart",28)+"&nbsp;";function mode_html(){var e=px(235),t=px(113),n=0;return w3_div("id-mode w3-hide","<hr>",w3_div("w3-container",w3_div("w3-flex w3-margin-B-8",w3_div("w3-text-teal|width:"+t," "),w3_div("w3-text-teal w3-center w3-bold|width:"+e,"select FPGA mode"),w3_div("id-fw-hdr w3-flex w3-margin-left")),w3_div("",w3_div("w3-left",w3_div("w3-flex w3-halign-center w3-margin-B-5",'<img src="gfx/kiwi.73x73.jpg" width="73" height="73" />'),w3_div("w3-flex w3-halign-center w3-margin-B-5",'<img src="gfx/cowbelly.73x73.jpg" width="73" height="73" />'),w3_div("w3-flex",'<img src="gfx/kiwi.derp.113x73.jpg" width="113" height="73" />'),admin.BBAI?w3_div("w3-flex",'<img src="gfx/kiwi.derp.113x73.jpg" width="113" height="73" />'):""),w3_sidenav("id-fw-nav|width:"+e+";border-collapse:collapse",w3_nav(admin_colors[n++]+" w3-border w3-padding-xxlarge w3-restart","Kiwi classic",kiwi.RX4_WF4,"firmware_sel_cb",adm.firmware_sel==kiwi.RX4_WF4),w3_nav(admin_colors[n++]+" w3-border w3-padding-xxlarge w3-restart","More receivers",kiwi.RX8_WF2,"firmware_sel_cb",adm.firmware_sel==kiwi.RX8_WF2),w3_nav(admin_colors[n++]+" w3-border w3-padding-xxlarge w3-restart","More bandwidth",kiwi.RX3_WF3,"firmware_sel_cb",adm.firmware_sel==kiwi.RX3_WF3),admin.BBAI?w3_nav(admin_colors[n++]+" w3-border w3-padding-xxlarge w3-restart","BBAI rx14_wf0",kiwi.RX14_WF0,"firmware_sel_cb",adm.firmware_sel==kiwi.RX14_WF0):""),w3_div("w3-margin-left w3-left",w3_div("id-fw-44 w3-flex w3-padding-TB-7"),w3_div("id-fw-82 w3-flex w3-padding-TB-7"),w3_div("id-fw-22 w3-flex w3-padding-TB-7"))),w3_div("w3-clear"," "),w3_div("w3-margin-T-16","<hr>"),w3_col_percent("w3-section/ w3-hspace-16",w3_div("w3-text-black",w3_text("w3-bold w3-margin-B-8 w3-text-teal","Trade-offs: receiver channels, audio bandwidth and waterfalls"),w3_div("w3-flex w3-valign-center",w3_div("|width:40px",mode_icon_snd12),w3_div("","Audio output, 12 kHz max bandwidth")),w3_div("w3-flex w3-valign-center",w3_div("|width:40px",mode_icon_snd20),w3_div("","Audio output, 20 kHz max bandwidth")),w3_div("w3-flex w3-margin-B-8 w3-valign-center",w3_div("|width:40px",mode_icon_wf),w3_div("","Tuneable waterfall/spectrum, 30 MHz bandwidth, 14-level zoom")),w3_div("w3-flex w3-margin-B-8 w3-valign-center",w3_div("|width:40px",mode_icon_fft),w3_div("","Audio FFT display, 12 kHz max bandwidth ")),"The original Kiwi FPGA with its 4 tuneable audio/waterfall receiver channels and 12 GPS channels was completely full. But it is now possible to load a different FPGA configuration where 2 of the waterfalls have been traded for adding more audio-only receiver channels. "),48,w3_div("w3-text-black"," "),4,w3_div("w3-text-black","Having more receiver channels per Kiwi is especially important with the recently added features that are channel intensive. Namely the TDoA service, WSPR autorun and external connection via the kiwirecorder program for using other software such as WSJT-X and Dream (DRM). When these kinds of connections are made channels rx2 - rx7 will be used first leaving rx0 and rx1 available for normal browser connections where it is desirable to view the waterfall. However rx0 and rx1 will be used last if necessary. The configurable TDoA channel limit still applies.<br><br>To compensate for lack of the waterfall/spectrum on the new channels an audio-bandwidth FFT is presented instead. This requires no additional FPGA resources."),48),w3_div("w3-margin-T-16","<hr>"),w3_col_percent("w3-section/ w3-hspace-16",w3_div("w3-text-black",'And now a third option "More bandwidth". The audio bandwidth is increased from 12 to 20 kHz. This supports wide passbands for hi-fidelity listening of AM BCB and SW stations. And also wide IQ bandwidths for external applications processing large parts of the spectrum. '),48,w3_div("w3-text-black"," "),4,w3_div("w3-text-black","In exchange the number of channels drops from four to three. It may have to drop to two in the future depending on how stable operation is with three channels."),48),w3_div("w3-margin-T-16","<hr>")))}function mode_focus(){var e,t;console.log("mode_focus");var n=px(90);for(t="",e=0;e<8;e++)t+=w3_div("w3-margin-left w3-bold w3-center|width:"+n,"rx"+e);w3_innerHTML("id-fw-hdr",t);var a=w3_div("w3-margin-left w3-border w3-border-light-blue w3-center|width:"+n,mode_icon_snd12,"<br>",mode_icon_wf),i=w3_div("w3-margin-left w3-border w3-border-light-blue w3-center|width:"+n,mode_icon_snd20,"<br>",mode_icon_wf),_=w3_div("w3-margin-left w3-border w3-border-light-blue w3-center|width:"+n,mode_icon_snd12,"<br>",mode_icon_fft);for(t="",e=0;e<4;e++)t+=a;for(w3_innerHTML("id-fw-44",t),t="",e=0;e<2;e++)t+=a;for(e=2;e<8;e++)t+=_;for(w3_innerHTML("id-fw-82",t),t="",e=0;e<3;e++)t+=i;w3_innerHTML("id-fw-22",t)}function firmware_sel_cb_focus(e){var t=+e;console.log("firmware_sel_cb_focus path="+e),ext_set_cfg_param("adm.firmware_sel",t,!0)}function control_html(){var e="<hr>"+w3_half("w3-valign","",w3_div("",w3_div("",w3_button("w3-aqua w3-margin","KiwiSDR server restart","control_restart_cb"),w3_button("w3-blue w3-margin","Beagle reboot","control_reboot_cb"),w3_button("w3-red w3-margin","Beagle power off","control_power_off_cb")),w3_div("id-confirm w3-valign w3-hide",w3_button("w3-green w3-margin","Confirm","control_confirm_cb"),w3_button("w3-yellow w3-margin","Cancel","control_confirm_cancel_cb"))),w3_div("w3-container w3-center","<b>Daily restart?</b> "+w3_switch("","Yes","No","adm.daily_restart",adm.daily_restart,"admin_radio_YN_cb"),w3_div("w3-text-black","Set if you're having problems with the server<br>after it has run for a period of time.<br>Restart occurs at the same time as updates (0200-0600 UTC)<br> and will wait until there are no connections."))),t="<hr>"+w3_third("","w3-container w3-valign",w3_divs("w3-center w3-tspace-8",w3_div("","<b>Enable user connections?</b>"),w3_switch("","Yes","No","adm.server_enabled",adm.server_enabled,"server_enabled_cb")),w3_divs("w3-center w3-tspace-8",w3_div("","<b>Close all active user connections</b>"),w3_button("w3-red","Kick","control_user_kick_cb")),w3_divs("w3-restart/w3-center w3-tspace-8",w3_div("","<b>Disable waterfalls/spectrum?</b>"),w3_switch("","Yes","No","cfg.no_wf",cfg.no_wf,"admin_radio_YN_cb"),w3_text("w3-text-black w3-center",'Set "yes" to save Internet bandwidth by preventing <br>the waterfall and spectrum from being displayed.')))+w3_div("w3-container w3-margin-top",w3_input_get("","Reason if disabled","reason_disabled","reason_disabled_cb","","will be shown to users attempting to connect"))+w3_divs("w3-margin-top/w3-container","<label><b>Reason HTML preview</b></label>",w3_div("id-reason-disabled-preview w3-text-black w3-background-pale-aqua","")),n="<hr>"+w3_third("w3-margin-bottom w3-text-teal","w3-container",w3_div("",w3_input_get("","Inactivity time limit (min, 0 = no limit)","inactivity_timeout_mins","admin_int_cb"),w3_div("w3-text-black","Connections from the local network are exempt.")),w3_div("",w3_input_get("","24hr per-IP addr time limit (min, 0 = no limit)","ip_limit_mins","admin_int_cb"),w3_div("w3-text-black","Connections from the local network are exempt.")),w3_div("",w3_input_get("","Time limit exemption password","adm.tlimit_exempt_pwd","w3_string_set_cfg_cb"),w3_div("w3-text-black","Password users can give to override time limits.")));return w3_div("id-control w3-text-teal w3-hide",e+(admin_sdr_mode?t+n:""))}function control_focus(){w3_el("id-reason-disabled-preview").innerHTML=admin_preview_status_box(cfg.reason_disabled)}function server_enabled_cb(e,t,n){var a=0==(t=+t);n||ext_send("SET server_enabled="+(a?1:0)),admin_bool_cb(e,a,n)}function control_user_kick_cb(e,t){ext_send("SET user_kick=-1")}function reason_disabled_cb(e,t){w3_string_set_cfg_cb(e,t),w3_el("id-reason-disabled-preview").innerHTML=admin_preview_status_box(cfg.reason_disabled)}var pending_restart=!1,pending_reboot=!1,pending_power_off=!1;function control_restart_cb(){pending_restart=!0,w3_show_block("id-confirm")}function control_reboot_cb(){pending_reboot=!0,w3_show_block("id-confirm")}function control_power_off_cb(){pending_power_off=!0,w3_show_block("id-confirm")}function control_confirm_cb(){pending_restart?admin_restart_now_cb():pending_reboot?admin_reboot_now_cb():pending_power_off&&(ext_send("SET power_off"),admin_wait_then_reload(0,"Powering off Beagle"))}function control_confirm_cancel_cb(){w3_hide("id-confirm")}var connect={focus:0,timeout:null},connect_dom_sel={NAM:0,DUC:1,PUB:2,SIP:3,REV:4},duc_update_i={0:"5 min",1:"10 min",2:"15 min",3:"30 min",4:"60 min"},duc_update_v={0:5,1:10,2:15,3:30,4:60};function connect_html(){"kiwisdr.example.com"==ext_get_cfg_param("server_url")&&ext_set_cfg_param("cfg.server_url","",!0),"kiwisdr.example.com"==ext_get_cfg_param("sdr_hu_dom_name")&&ext_set_cfg_param("cfg.sdr_hu_dom_name","",!0);var e=0,t=w3_div("w3-valign",'<header class="w3-container w3-yellow"><h5>If you are not able to make an incoming connection from the Internet to your Kiwi because of problems <br> with your router or Internet Service Provider (ISP) then please consider using the KiwiSDR <a href="http://proxy.kiwisdr.com" target="_blank">reverse proxy service</a>.</h5></header>')+"<hr>"+w3_div("id-warn-ip w3-valign w3-margin-B-8 w3-hide",'<header class="w3-container w3-yellow"><h5>Warning: Using an IP address in the Kiwi connect name will work, but if you switch to using a domain name later on<br>this will cause duplicate entries on <a href="https://sdr.hu/?top=kiwi" target="_blank">sdr.hu</a> See <a href="http://kiwisdr.com/quickstart#id-sdr_hu-dup" target="_blank">kiwisdr.com/quickstart</a> for more information.</h5></header>')+w3_divs("w3-container/w3-tspace-8",w3_label("w3-bold","What domain name or IP address will people use to connect to your KiwiSDR?<br>If you are listing on sdr.hu this information will be part of your entry.<br>Click one of the five options below and enter any additional information:<br><br>"),w3_sidenav("id-admin-nav-dom w3-margin-R-16 w3-restart",w3_nav(admin_colors[e++]+" w3-border","Domain Name","connect_dom_nam","connect_dom_nam",cfg.sdr_hu_dom_sel==connect_dom_sel.NAM),w3_nav(admin_colors[e++]+" w3-border","DUC Domain","connect_dom_duc","connect_dom_duc",cfg.sdr_hu_dom_sel==connect_dom_sel.DUC),w3_nav(admin_colors[e++]+" w3-border","Reverse Proxy","connect_dom_rev","connect_dom_rev",cfg.sdr_hu_dom_sel==connect_dom_sel.REV),w3_nav(admin_colors[e++]+" w3-border","Public IP","connect_dom_pub","connect_dom_pub",cfg.sdr_hu_dom_sel==connect_dom_sel.PUB),w3_nav(admin_colors[e++]+" w3-border","Specified IP","connect_dom_sip","connect_dom_sip",cfg.sdr_hu_dom_sel==connect_dom_sel.SIP)),w3_divs("w3-padding-L-16/w3-padding-T-1",w3_div("w3-show-inline-block|width:70%;",w3_input_get("","","sdr_hu_dom_name","connect_dom_name_cb","","Enter domain name that you will point to Kiwi public IP address, e.g. kiwisdr.my_domain.com (don't include port number)")),w3_div("id-connect-duc-dom w3-padding-TB-8"),w3_div("id-connect-rev-dom w3-padding-TB-8"),w3_div("id-connect-pub-ip w3-padding-TB-8"),w3_div("w3-show-inline-block|width:70%;",w3_input_get("","","sdr_hu_dom_ip","connect_dom_ip_cb","","Enter known public IP address of the Kiwi (don't include port number)"))),w3_div("w3-margin-T-16",w3_label("id-connect-url-text-label w3-show-inline-block w3-margin-R-16 w3-text-teal")+w3_div("id-connect-url w3-show-inline-block w3-text-black w3-background-pale-aqua"))),n="<hr>"+w3_div("w3-container w3-text-teal|width:80%",w3_input_get("","Next Kiwi URL redirect","adm.url_redirect","connect_url_redirect_cb"),w3_div("w3-text-black",'Use this setting to get multiple Kiwis to respond to a single URL.<br>When all the channels of this Kiwi are busy further connection attempts will be redirected to the above URL.<br>Example: Your Kiwi is known as "mykiwi.com:8073". Configure another Kiwi to use port 8074 and be known as "mykiwi.com:8074".<br>On the port 8073 Kiwi set the above field to "http://mykiwi.com:8074".<br>On the port 8074 Kiwi leave the above field blank.<br>Configure the port 8074 Kiwi as normal (i.e. router port open, dynamic DNS, proxy etc.)')),a="<hr>"+w3_divs("/w3-tspace-8",w3_div("w3-container w3-valign",'<header class="w3-container w3-yellow"><h6>Please read these instructions before use: <a href="http://kiwisdr.com/quickstart/index.html#id-net-duc" target="_blank">dynamic DNS update client (DUC)</a></h6></header>'),w3_col_percent("w3-text-teal/w3-container",w3_div("w3-text-teal w3-bold","Dynamic DNS update client (DUC) configuration"),50,w3_div("w3-text-teal w3-bold w3-center w3-light-grey","Account at noip.com"),50),w3_col_percent("w3-text-teal/w3-container",w3_div(),50,w3_input_get("","Username or email","adm.duc_user","w3_string_set_cfg_cb","","required"),25,w3_input_get("","Password","adm.duc_pass","w3_string_set_cfg_cb","","required"),25),w3_col_percent("w3-text-teal/w3-container",w3_div("w3-center","<b>Enable DUC at startup?</b><br>"+w3_switch("w3-margin-T-8","Yes","No","adm.duc_enable",adm.duc_enable,"connect_DUC_enabled_cb")),20,w3_div("w3-center",w3_select("","Update","","adm.duc_update",adm.duc_update,duc_update_i,"admin_select_cb")),10,w3_div("w3-center w3-tspace-8",w3_button("w3-aqua","Click to (re)start DUC","connect_DUC_start_cb"),w3_div("w3-text-black","After changing username or password click to test changes.")),20,w3_input_get("","Host","adm.duc_host","connect_DUC_host_cb","","required"),50),w3_div("w3-container",w3_label("w3-show-inline-block w3-margin-R-16 w3-text-teal","Status:")+w3_div("id-net-duc-status w3-show-inline-block w3-text-black w3-background-pale-aqua",""))),i="<hr>"+w3_divs("/w3-tspace-8",w3_div("w3-container w3-valign",'<header class="w3-container w3-yellow"><h6>Please read these instructions before use: <a href="http://proxy.kiwisdr.com" target="_blank">reverse proxy service</a></h6></header>'),w3_col_percent("w3-text-teal/w3-container",w3_div("w3-text-teal w3-bold","Reverse proxy configuration"),50,w3_div("w3-text-teal w3-bold w3-center w3-light-grey","Proxy information for kiwisdr.com"),50),w3_col_percent("w3-text-teal/w3-container",w3_div(),50,w3_input_get("","User key (see instructions)","adm.rev_user","w3_string_set_cfg_cb","","required"),50),w3_col_percent("w3-text-teal/w3-container",w3_div("w3-center w3-tspace-8",w3_button("w3-aqua","Click to (re)register","connect_rev_register_cb"),w3_div("w3-text-black","After changing user key or<br>host name click to register proxy.")),50,w3_div("",w3_div("w3-show-inline-block|width:60%;",w3_input_get("","Host name (your choice, see instructions)","adm.rev_host","connect_rev_host_cb","","required"))+w3_div("id-connect-rev-url w3-show-inline-block",".proxy.kiwisdr.com")),50),w3_div("w3-container",w3_label("w3-show-inline-block w3-margin-R-16 w3-text-teal","Status:")+w3_div("id-connect-rev-status w3-show-inline-block w3-text-black w3-background-pale-aqua","")))+"<hr>";return w3_div("id-connect w3-text-teal w3-hide",t+n+a+i)}function connect_focus(){connect.focus=1,connect_update_url(),ext_send("SET DUC_status_query"),cfg.sdr_hu_dom_sel==connect_dom_sel.REV&&ext_send("SET rev_status_query")}function connect_blur(){connect.focus=0}var connect_rev_server=-1;function connect_update_url(){var e,t;t=(e=adm.duc_host&&""!=adm.duc_host)?"w3-background-pale-aqua":"w3-override-yellow",w3_el("id-connect-duc-dom").innerHTML="Use domain name from DUC configuration below: "+w3_div("w3-show-inline-block w3-text-black "+t,e?adm.duc_host:"(none currently set)");var n=".proxy"+(-1==connect_rev_server?"":connect_rev_server)+".kiwisdr.com";t=(e=adm.rev_host&&""!=adm.rev_host)?"w3-background-pale-aqua":"w3-override-yellow",w3_el("id-connect-rev-dom").innerHTML="Use domain name from reverse proxy configuration below: "+w3_div("w3-show-inline-block w3-text-black "+t,e?adm.rev_host+n:"(none currently set)"),w3_el("id-connect-rev-url").innerHTML=n,t=(e=config_net.pub_ip)?"w3-background-pale-aqua":"w3-override-yellow",w3_el("id-connect-pub-ip").innerHTML="Public IP address detected by Kiwi: "+w3_div("w3-show-inline-block w3-text-black "+t,e?config_net.pub_ip:"(no public IP address detected)");var a=decodeURIComponent(cfg.server_url),i=a;cfg.sdr_hu_dom_sel!=connect_dom_sel.REV?(i+=":"+adm.port_ext,w3_set_label("Based on above selection, and external port from Network tab, the URL to connect to your Kiwi is:","connect-url-text")):(i+=":8073",8073!=adm.port_ext&&(i+=" (proxy always uses port 8073 even though your external port is "+adm.port_ext+")"),w3_set_label("Based on the above selection the URL to connect to your Kiwi is:","connect-url-text")),e=""!=a,w3_color("id-connect-url",null,e?"hsl(180, 100%, 95%)":"#ffeb3b"),w3_el("id-connect-url").innerHTML=e?"http://"+i:"(incomplete information)"}function connect_dom_nam_focus(){console.log("connect_dom_nam_focus server_url="+cfg.sdr_hu_dom_name),ext_set_cfg_param("cfg.server_url",cfg.sdr_hu_dom_name,!0),ext_set_cfg_param("cfg.sdr_hu_dom_sel",connect_dom_sel.NAM,!0),connect_update_url(),w3_hide("id-warn-ip")}function connect_dom_duc_focus(){console.log("connect_dom_duc_focus server_url="+adm.duc_host),ext_set_cfg_param("cfg.server_url",adm.duc_host,!0),ext_set_cfg_param("cfg.sdr_hu_dom_sel",connect_dom_sel.DUC,!0),connect_update_url(),w3_hide("id-warn-ip")}function connect_dom_rev_focus(){var e=-1==connect_rev_server?"":connect_rev_server,t=""==adm.rev_host?"":adm.rev_host+".proxy"+e+".kiwisdr.com";console.log("connect_dom_rev_focus server_url="+t),ext_set_cfg_param("cfg.server_url",t,!0),ext_set_cfg_param("cfg.sdr_hu_dom_sel",connect_dom_sel.REV,!0),connect_update_url(),w3_hide("id-warn-ip")}function connect_dom_pub_focus(){console.log("connect_dom_pub_focus server_url="+config_net.pub_ip),ext_set_cfg_param("cfg.server_url",config_net.pub_ip,!0),ext_set_cfg_param("cfg.sdr_hu_dom_sel",connect_dom_sel.PUB,!0),connect_update_url()}function connect_dom_sip_focus(){console.log("connect_dom_sip_focus server_url="+cfg.sdr_hu_dom_ip),ext_set_cfg_param("cfg.server_url",cfg.sdr_hu_dom_ip,!0),ext_set_cfg_param("cfg.sdr_hu_dom_sel",connect_dom_sel.SIP,!0),connect_update_url()}function connect_dom_name_cb(e,t,n){connect_remove_port(e,t,n),cfg.sdr_hu_dom_sel==connect_dom_sel.NAM&&connect_dom_nam_focus()}function connect_dom_ip_cb(e,t,n){connect_remove_port(e,t,n),cfg.sdr_hu_dom_sel==connect_dom_sel.SIP&&connect_dom_sip_focus()}function connect_remove_port(e,t,n){var a=t.length,i=1,_=2,o=3,r=0;t=t.replace("http://","");for(var s=a-1;s>=0;s--){var l=t.charAt(s);if(l>="0"&&l<="9")r=i;else{if(":"==l){r==i&&(r=o);break}if(r=_,"]"==l)break}}r==o&&(t=t.substr(0,s)),w3_string_set_cfg_cb(e,t,n),admin_set_decoded_value(e)}function connect_url_redirect_cb(e,t,n){""==t||t.startsWith("http://")||(t="http://"+t),w3_string_set_cfg_cb(e,t,n),w3_set_value("id-"+e,t)}function connect_DUC_enabled_cb(e,t,n){admin_bool_cb(e,0==(t=+t),n)}function connect_DUC_start_cb(e,t){var n="-u "+sq(decodeURIComponent(adm.duc_user))+" -p "+sq(decodeURIComponent(adm.duc_pass))+" -H "+sq(decodeURIComponent(adm.duc_host))+" -U "+duc_update_v[adm.duc_update];console.log("start DUC: "+n),w3_innerHTML("id-net-duc-status",""),ext_send("SET DUC_start args="+encodeURIComponent(n))}function connect_DUC_host_cb(e,t,n){w3_string_set_cfg_cb(e,t,n),cfg.sdr_hu_dom_sel==connect_dom_sel.DUC?connect_dom_duc_focus():connect_update_url()}function connect_DUC_status_cb(e){var t;switch(e=+e,console.log("DUC_status="+e),e){case 0:t="DUC started successfully";break;case 100:t="Incorrect username or password";break;case 101:t="No hosts defined on your account at noip.com; please correct and retry";break;case 102:t="Please specify a host";break;case 103:t="Host given isn't defined on your account at noip.com; please correct and retry";break;case 300:t="DUC start failed";break;case 301:t="DUC enabled and running";break;default:t="DUC internal error: "+e}w3_el("id-net-duc-status").innerHTML=t}function connect_rev_register_cb(e,t){if(""==adm.rev_user||""==adm.rev_host)return connect_rev_status_cb(100);kiwi_clearTimeout(connect.timeout),w3_el("id-connect-rev-status").innerHTML="";var n="user="+adm.rev_user+" host="+adm.rev_host;console.log("start rev: "+n),ext_send("SET rev_register "+n)}function connect_rev_host_cb(e,t,n){w3_string_set_cfg_cb(e,t,n),cfg.sdr_hu_dom_sel==connect_dom_sel.REV?connect_dom_rev_focus():connect_update_url()}function connect_rev_status_cb(e){if(connect.focus){var t;switch(e=+e,console.log("rev_status="+e),e>=0&&e<=99&&cfg.sdr_hu_dom_sel==connect_dom_sel.REV&&connect_dom_rev_focus(),e){case 0:t="Existing account, registration successful";break;case 1:t="New account, registration successful";break;case 2:t="Updating host name, registration successful";break;case 100:t="User key or host name field blank";break;case 101:t="User key invalid. Did you email your user/API key to support@kiwisdr.com as per the instructions?";break;case 102:t="Host name already in use; please choose another and retry";break;case 103:t="Invalid characters in user key or host name field (use a-z, 0-9, -, _)";break;case 200:t="Reverse proxy enabled and running";break;case 201:t="Reverse proxy enabled and pending";break;case 900:t="Problem contacting proxy.kiwisdr.com; please check Internet connection";break;default:t="Reverse proxy internal error: "+e}w3_el("id-connect-rev-status").innerHTML=t,201==e&&(connect.timeout=setTimeout(function(){ext_send("SET rev_status_query")},5e3))}}function update_html(){return w3_div("id-update w3-hide","<hr>"+w3_div("id-msg-update w3-container")+"<hr>"+w3_div("w3-margin-bottom",w3_half("w3-container","w3-text-teal",w3_div("","<b>Automatically check for software updates?</b> "+w3_switch("","Yes","No","adm.update_check",adm.update_check,"admin_radio_YN_cb")),w3_div("","<b>Automatically install software updates?</b> "+w3_switch("","Yes","No","adm.update_install",adm.update_install,"admin_radio_YN_cb"))),w3_half("w3-container","w3-text-teal",w3_div("",w3_select("w3-label-inline","After update","","adm.update_restart",adm.update_restart,update_restart_u,"admin_select_cb")),""))+"<hr>"+w3_half("w3-container","w3-text-teal",w3_div("w3-valign","<b>Check for software update </b> "+w3_button("w3-aqua w3-margin","Check now","update_check_now_cb")),w3_div("w3-valign","<b>Force software build </b> "+w3_button("w3-aqua w3-margin","Build now","update_build_now_cb")))+"<hr>"+w3_half("w3-margin-bottom w3-text-teal w3-restart","w3-container",w3_divs("w3-tspace-8",w3_div("","<b>Disable recent changes?</b>"),w3_switch("","Yes","No","disable_recent_changes",cfg.disable_recent_changes,"admin_radio_YN_cb"),w3_text("w3-text-black","Currently:<br><ul><li>The Firefox audio hang workaround.</li></ul>")),"")+"<hr>"+w3_div("w3-container","TODO: alt github name")+"<hr>")}var update_restart_u={0:"restart server",1:"reboot Beagle"};function update_check_now_cb(e,t){ext_send("SET force_check=1 force_build=0"),w3_el("msg-update").innerHTML=w3_icon("","fa-refresh fa-spin",20)}function update_build_now_cb(e,t){ext_send("SET force_check=1 force_build=1"),0==adm.update_restart?w3_show_block("id-build-restart"):w3_show_block("id-build-reboot")}function backup_html(){return w3_div("id-backup w3-hide","<hr>",w3_div("w3-section w3-text-teal w3-bold","Backup complete contents of KiwiSDR by writing Beagle filesystem onto a user provided micro-SD card"),w3_div("w3-container w3-text w3-red","WARNING: after SD card is written immediately remove from Beagle.<br>Otherwise on next reboot Beagle will be re-flashed from SD card."),"<hr>",w3_third("w3-container","w3-valign",w3_button("w3-aqua w3-margin","Click to write micro-SD card","backup_sd_write"),w3_div("",w3_div("id-progress-container w3-progress-container w3-round-large w3-gray w3-show-inline-block",w3_div("id-progress w3-progressbar w3-round-large w3-light-green w3-width-zero",w3_div("id-progress-text w3-container"))),w3_div("w3-margin-T-8",w3_div("id-progress-time w3-show-inline-block")+w3_div("id-progress-icon w3-show-inline-block w3-margin-left"))),w3_div("id-sd-status class-sd-status")),"<hr>",w3_div("id-output-msg w3-container w3-text-output w3-scroll-down w3-small w3-margin-B-16"))}function backup_focus(){w3_el("id-progress-container").style.width=px(300),w3_el("id-output-msg").style.height=px(300)}var sd_progress,backup_sd_interval,sd_progress_max=240,backup_refresh_icon=w3_icon("","fa-refresh fa-spin",20);function backup_sd_write(e,t){w3_el("id-sd-status").innerHTML="writing the micro-SD card...",w3_el("id-progress-text").innerHTML=w3_el("id-progress").style.width="0%",sd_progress=-1,backup_sd_progress(),backup_sd_interval=setInterval(backup_sd_progress,1e3),w3_el("id-progress-icon").innerHTML=backup_refresh_icon,ext_send("SET microSD_write")}function backup_sd_progress(){var e=(++sd_progress/sd_progress_max*100).toFixed(0);e<=95&&(w3_el("id-progress-text").innerHTML=w3_el("id-progress").style.width=e+"%");var t=(sd_progress%60).toFixed(0).leadingZeros(2),n=Math.floor(sd_progress/60).toFixed(0);w3_el("id-progress-time").innerHTML=n+":"+t}function backup_sd_write_done(e){var t=w3_el("id-sd-status"),n=e?"FAILED error "+e.toString():"WORKED";1==e&&(n+="<br>No SD card inserted?"),15==e&&(n+="<br>rsync I/O error"),t.innerHTML=n,t.style.color=e?"red":"lime",e||(w3_el("id-progress-text").innerHTML=w3_el("id-progress").style.width="100%"),kiwi_clearInterval(backup_sd_interval),w3_el("id-progress-icon").innerHTML=""}var network={auto_nat_color:null,ip_blacklist_input_prev:null},ethernet_speed_i={0:"100 Mbps",1:"10 Mbps"};function network_html(){var e=ext_get_cfg_param("adm.ip_address.commit_use_static");console.log("commit_use_static="+e),null==e&&(e=!1),ext_set_cfg_param("adm.ip_address.use_static",e,EXT_SAVE),w3_switch_set_value("adm.ip_address.use_static",e?w3_SWITCH_NO_IDX:w3_SWITCH_YES_IDX);var t=w3_div("id-net-auto-nat-msg w3-valign w3-hide")+w3_div("id-net-need-update w3-valign w3-margin-T-8 w3-hide",w3_button("w3-yellow","Are you sure? Click to update interface DHCP/static IP configuration","network_dhcp_static_update_cb"))+"<hr>"+w3_div("id-net-reboot",w3_col_percent("w3-container w3-margin-bottom w3-text-teal/w3-hspace-16",w3_div("w3-restart",w3_input_get("","Internal port","adm.port","admin_int_cb")),10,w3_div("w3-restart",w3_input_get("","External port","adm.port_ext","admin_int_cb")),10,w3_divs("w3-center/w3-restart","<b>Auto add NAT rule<br>on firewall / router?</b><br>",w3_switch("w3-margin-T-8","Yes","No","adm.auto_add_nat",adm.auto_add_nat,"admin_radio_YN_cb")),20,w3_div("w3-center","<b>IP address<br>(only static IPv4 for now)</b><br> "+w3_switch_get_param("w3-margin-T-8","DHCP","Static","adm.ip_address.use_static",0,!1,"network_use_static_cb")),20,w3_divs("w3-center/",w3_select("","Ethernet interface speed","","ethernet_speed",cfg.ethernet_speed,ethernet_speed_i,"network_ethernet_speed"),w3_div("w3-text-black","Select 10 Mbps to reduce Ethernet spurs. <br> Try changing while looking at waterfall.")),30),w3_div("id-net-static w3-hide",w3_div("",w3_third("w3-margin-B-8 w3-text-teal","w3-container",w3_input_get("","IP address (n.n.n.n where n = 0..255)","adm.ip_address.ip","network_ip_address_cb",""),w3_input_get("","Netmask (n.n.n.n where n = 0..255)","adm.ip_address.netmask","network_netmask_cb",""),w3_input_get("","Gateway (n.n.n.n where n = 0..255)","adm.ip_address.gateway","network_gw_address_cb","")),w3_third("w3-margin-B-8 w3-text-teal","w3-container",w3_div("id-network-check-ip w3-green"),w3_div("id-network-check-nm w3-green"),w3_div("id-network-check-gw w3-green")),w3_third("w3-valign w3-margin-bottom w3-text-teal","w3-container",w3_input_get("","DNS-1 (n.n.n.n where n = 0..255)","adm.ip_address.dns1","w3_string_set_cfg_cb",""),w3_input_get("","DNS-2 (n.n.n.n where n = 0..255)","adm.ip_address.dns2","w3_string_set_cfg_cb",""),w3_div("",w3_label("","<br>")+w3_button("w3-show-inline w3-aqua","Use Google public DNS","net_google_dns_cb")))),w3_text("w3-margin-left w3-text-black","If DNS fields are blank the DNS servers specified by your router's DHCP will be used."))),n="<hr>"+w3_div("id-net-config w3-container")+"<hr>"+w3_half("w3-container","",w3_div("",w3_div("",w3_label("w3-show-inline w3-bold w3-text-teal","Check if your external router port is open:")+w3_button("w3-show-inline w3-aqua|margin-left:10px","Check port open","net_port_open_cb")),'Does kiwisdr.com successfully connect to your Kiwi using these URLs?<br>If both respond "NO" then check the NAT port mapping on your router.<br>If first responds "NO" and second "YES" then domain name of the first<br>isn\'t resolving to the ip address of the second. Check DNS.',w3_div("",w3_label("id-net-check-port-dom-q w3-show-inline-block w3-margin-LR-16 w3-text-teal")+w3_div("id-net-check-port-dom-s w3-show-inline-block w3-text-black w3-background-pale-aqua")),w3_div("",w3_label("id-net-check-port-ip-q w3-show-inline-block w3-margin-LR-16 w3-text-teal")+w3_div("id-net-check-port-ip-s w3-show-inline-block w3-text-black w3-background-pale-aqua"))),w3_div("w3-center",w3_label("w3-bold w3-text-teal","Register this Kiwi on my.kiwisdr.com<br>on each reboot?<br>"),w3_switch("w3-margin-T-8 w3-margin-B-8","Yes","No","adm.my_kiwi",adm.my_kiwi,"admin_radio_YN_cb"),w3_text("w3-block w3-center w3-text-black",'Registering on <a href="http://my.kiwisdr.com" target="_blank">my.kiwisdr.com</a> allows the local ip address of Kiwis <br>to be easily discovered. Set to "no" if you don\'t want your Kiwi <br>sending information to kiwisdr.com. Defaults to "yes".'))),a="<hr>"+w3_div("w3-container w3-text-teal",w3_textarea_get_param("w3-input-any-change|width:100%",w3_inline("",w3_label("w3-show-inline-block w3-bold w3-text-teal","IP address blacklist"),w3_text("w3-text-black|margin-left: 32px",'IP addresses/ranges listed here are blocked from accessing your<br>Kiwi (via Linux iptables). 47.88.219.24/24 is a currently active bot.<br>Use CIDR notation for ranges, e.g. CIDR "ip/24" equivalent to netmask "255.255.255.0"'),w3_div("w3-center|margin-left: 32px","<b>Prevent multiple connections from<br>the same IP address?</b><br>",w3_switch("w3-margin-T-8 w3-margin-B-8","Yes","No","adm.no_dup_ip",adm.no_dup_ip,"admin_radio_YN_cb"))),"adm.ip_blacklist",3,100,"network_ip_blacklist_cb",""),w3_label("w3-show-inline-block w3-margin-R-16 w3-margin-T-8 w3-text-teal","Status:")+w3_div("id-ip-blacklist-status w3-show-inline-block w3-text-black w3-background-pale-aqua",""))+"<hr>"+w3_div("w3-container","TODO: throttle #chan MB/dy GB/mo, hostname")+"<hr>";return setTimeout(function(){network_use_static_cb("adm.ip_address.use_static",ext_get_cfg_param("adm.ip_address.use_static",!1),!0)},500),w3_div("id-network w3-hide",t+n+a)}function network_ip_blacklist_cb(e,t){var n=t.match(/([^,;\s]+)/gm);null==n&&(n=[]);var a="";n.forEach(function(e){a+=e+" "}),a!=network.ip_blacklist_input_prev&&(network.ip_blacklist_input_prev=a,ext_send("SET network_ip_blacklist_clear"),w3_innerHTML("id-ip-blacklist-status","updated"),w3_set_value(e,a),w3_string_set_cfg_cb(e,a),n.forEach(function(e){ext_send("SET network_ip_blacklist="+encodeURIComponent(e))}),ext_send("SET network_ip_blacklist_enable"))}function network_ip_blacklist_status(e,t){console.log("network_ip_blacklist_status status="+e+" ip="+t),0!=e&&w3_innerHTML("id-ip-blacklist-status","ip address error: "+dq(t))}function network_ethernet_speed(e,t,n){t=+t,console.log("network_ethernet_speed path="+e+" idx="+t+" first="+n),n||admin_select_cb(e,t,n)}function network_port_open_init(){var e=cfg.sdr_hu_dom_sel==connect_dom_sel.REV?8073:adm.port_ext;w3_el("id-net-check-port-dom-q").innerHTML=""!=cfg.server_url?"http://"+cfg.server_url+":"+e+" :":'(incomplete information -- on "connect" tab please use a valid setting in menu) :',w3_el("id-net-check-port-ip-q").innerHTML="http://"+config_net.pvt_ip+":"+adm.port_ext+" :",w3_el("id-net-check-port-dom-s").innerHTML="",w3_el("id-net-check-port-ip-s").innerHTML=""}function network_focus(){setTimeout(network_port_open_init,2e3),setInterval(network_auto_nat_status_poll,1e3)}function network_blur(){kiwi_clearInterval(network_auto_nat_status_poll)}function network_auto_nat_status_poll(){ext_send("SET auto_nat_status_poll")}function network_check_port_status_cb(e){if(console.log("network_check_port_status_cb status="+e.toHex()),e<0)w3_el("id-net-check-port-dom-s").innerHTML="Error checking port status",w3_el("id-net-check-port-ip-s").innerHTML="Error checking port status";else{var t=240&e,n=15&e;w3_el("id-net-check-port-dom-s").innerHTML=t?"NO":"YES",w3_el("id-net-check-port-ip-s").innerHTML=n?"NO":"YES"}}function net_port_open_cb(){w3_el("id-net-check-port-dom-s").innerHTML=w3_icon("","fa-refresh fa-spin",20),w3_el("id-net-check-port-ip-s").innerHTML=w3_icon("","fa-refresh fa-spin",20),ext_send("SET check_port_open")}function network_dhcp_static_update_cb(e,t){var n=adm.ip_address.use_static;n?(ext_send("SET static_ip="+kiwi_ip_str(network_ip)+" static_nm="+kiwi_ip_str(network_nm)+" static_gw="+kiwi_ip_str(network_gw)),ext_send("SET dns dns1=x"+encodeURIComponent(adm.ip_address.dns1)+" dns2=x"+encodeURIComponent(adm.ip_address.dns2))):ext_send("SET use_DHCP"),ext_set_cfg_param("adm.ip_address.commit_use_static",n,EXT_SAVE),w3_hide("id-net-need-update"),w3_reboot_cb()}function network_use_static_cb(e,t,n){var a=0==(t=+t);a?w3_hide("id-net-static"):w3_show_block("id-net-static"),n?(network_ip_address_cb("adm.ip_address.ip",adm.ip_address.ip,!0),network_netmask_cb("adm.ip_address.netmask",adm.ip_address.netmask,!0),network_gw_address_cb("adm.ip_address.gateway",adm.ip_address.gateway,!0)):a?w3_show_block("id-net-need-update"):network_show_update(!1),admin_bool_cb(e,a?0:1,n)}function network_ip_nm_check(e,t){var n,a,i,_,o=new RegExp("^([0-9]*).([0-9]*).([0-9]*).([0-9]*)$").exec(e);return null!=o&&(n=(n=parseInt(o[1]))>255?Math.NaN:n,a=(a=parseInt(o[2]))>255?Math.NaN:a,i=(i=parseInt(o[3]))>255?Math.NaN:i,_=(_=parseInt(o[4]))>255?Math.NaN:_),null==o||isNaN(n)||isNaN(a)||isNaN(i)||isNaN(_)?t.ok=!1:(t.ok=!0,t.a=n,t.b=a,t.c=i,t.d=_),t.ok}function network_show_update(e){!e&&network_ip.ok&&network_nm.ok&&network_gw.ok?w3_show_block("id-net-need-update"):w3_hide("id-net-need-update")}function network_show_check(e,t,n,a,i,_,o){if(""!=a){var r=w3_el(e),s=network_ip_nm_check(a,i),l=!0;1==s&&null!=o&&(l=o(a,i)),0==s||0==l?(r.innerHTML="bad "+t+" entered",w3_remove(r,"w3-green"),w3_add(r,"w3-red")):(r.innerHTML=t+" okay, check: "+i.a+"."+i.b+"."+i.c+"."+i.d,w3_remove(r,"w3-red"),w3_add(r,"w3-green"),w3_string_set_cfg_cb(n,a,_)),network_show_update(_)}}function network_ip_address_cb(e,t,n){network_show_check("network-check-ip","IP address",e,t,network_ip,n)}function network_netmask_cb(e,t,n){network_nm.nm=-1,network_show_check("network-check-nm","netmask",e,t,network_nm,n,function(e,t){var n=kiwi_inet4_d2h(e);t.nm=0;for(var a=0;a<32;a++)if(n&1<<a)for(t.nm=32-a;a<32;a++)if(0==(n&1<<a))return t.nm=-1,t.ok=!1,!1;return t.ok=!0,!0}),-1!=network_nm.nm&&(w3_el("network-check-nm").innerHTML+=" (/"+network_nm.nm+")")}function network_gw_address_cb(e,t,n){network_show_check("network-check-gw","gateway",e,t,network_gw,n)}function net_google_dns_cb(e,t){w3_string_set_cfg_cb("adm.ip_address.dns1","8.8.8.8"),w3_set_value("adm.ip_address.dns1","8.8.8.8"),w3_string_set_cfg_cb("adm.ip_address.dns2","8.8.4.4"),w3_set_value("adm.ip_address.dns2","8.8.4.4")}network_ip={ok:!1,a:null,b:null,c:null,d:null},network_nm={ok:!1,a:null,b:null,c:null,d:null},network_gw={ok:!1,a:null,b:null,c:null,d:null};var gps_interval,gps_azel_interval,pin={green:w3_div("cl-leaflet-marker cl-legend-marker|background-color:lime"),red:w3_div("cl-leaflet-marker cl-legend-marker|background-color:red"),yellow:w3_div("cl-leaflet-marker cl-legend-marker|background-color:yellow")},_gps={leaflet:!0,gps_map_loaded:!1,pkgs_maps_js:["pkgs_maps/pkgs_maps.js","pkgs_maps/pkgs_maps.css"],gmap_js:["http://maps.googleapis.com/maps/api/js?key="],RSSI:0,AZEL:1,POS:2,MAP:3,IQ:4,IQ_data:null,iq_ch:0,map_init:0,map_needs_height:0,map_locate:0,map_mkr:[],legend_sep:w3_inline("",pin.green,"Navstar/QZSS only",pin.yellow,"Galileo only",pin.red,"all sats"),legend_all:w3_inline("",pin.green,"all sats (Navstar/QZSS/Galileo)")},E1B_offset_i={0:"-1",1:"-3/4",2:"-1/2",3:"-1/4",4:"0",5:"+1/4",6:"+1/2",7:"+3/4",8:"+1"};function gps_html(){return w3_div("id-gps w3-hide|line-height:1.5",w3_inline("w3-valign w3-halign-space-between w3-margin-T-16/",w3_div("w3-valign w3-text-teal",w3_text("w3-text-teal w3-bold w3-small","Acquire"),w3_div("w3-flex-col w3-valign-start w3-margin-L-4",w3_checkbox("w3-label-inline w3-label-not-bold w3-small/w3-small","Navstar","adm.acq_Navstar",adm.acq_Navstar,"gps_acq_cb"),w3_inline("",w3_checkbox("w3-label-inline w3-label-not-bold w3-small/w3-small","QZSS","adm.acq_QZSS",adm.acq_QZSS,"gps_acq_cb"),w3_checkbox("w3-label-inline w3-label-not-bold w3-small w3-margin-left/w3-small/","Priority","adm.QZSS_prio",adm.QZSS_prio,"gps_acq_cb")),w3_checkbox("w3-label-inline w3-label-not-bold w3-small/w3-small","Galileo","adm.acq_Galileo",adm.acq_Galileo,"gps_acq_cb"))),w3_div("w3-valign w3-text-teal",w3_checkbox("w3-label-inline w3-small/w3-small","Acquire<br>if Kiwi<br>busy? [n]","adm.always_acq_gps",adm.always_acq_gps,"w3_bool_set_cfg_cb")),w3_div("w3-valign w3-text-teal",w3_checkbox("w3-label-inline w3-small/w3-small","Include<br>alerted sats in<br>solutions? [n]","adm.include_alert_gps",adm.include_alert_gps,"w3_bool_set_cfg_cb")),w3_div("w3-valign w3-text-teal",w3_checkbox("w3-label-inline w3-small/w3-small","Include<br>Galileo in<br>solutions? [y]","adm.include_E1B",adm.include_E1B,"w3_bool_set_cfg_cb")),w3_div("w3-valign w3-text-teal",w3_checkbox("w3-label-inline w3-small/w3-small","Use<br>Kalman<br>filter? [y]","adm.use_kalman_position_solver",adm.use_kalman_position_solver,"w3_bool_set_cfg_cb")),w3_div("w3-valign w3-hcenter w3-text-teal",w3_div("w3-margin-right","<b>Select<br>Graph</b>")+w3_radio_button("w3-margin-R-4","RSSI","adm.rssi_azel_iq",adm.rssi_azel_iq==_gps.RSSI,"gps_graph_cb"),w3_radio_button("w3-margin-R-4","Az/El","adm.rssi_azel_iq",adm.rssi_azel_iq==_gps.AZEL,"gps_graph_cb"),w3_radio_button("w3-margin-R-4","Pos","adm.rssi_azel_iq",adm.rssi_azel_iq==_gps.POS,"gps_graph_cb"),w3_radio_button("w3-margin-R-4","Map","adm.rssi_azel_iq",adm.rssi_azel_iq==_gps.MAP,"gps_graph_cb"),w3_radio_button("","IQ","adm.rssi_azel_iq",adm.rssi_azel_iq==_gps.IQ,"gps_graph_cb")),w3_divs("w3-hcenter w3-text-teal/w3-center",w3_div("id-gps-pos-scale w3-center w3-hide w3-small","<b>Scale</b> ",w3_select("w3-margin-L-5|color:red","","","_gps.pos_scale",9,"1:20","gps_pos_scale_cb")),w3_div("id-gps-iq-ch w3-center w3-hide w3-small","<b>Chan</b> ",w3_select("w3-margin-L-5|color:red","","","_gps.iq_ch",0,"1:12","gps_iq_ch_cb"))))+w3_div("w3-valign",w3_div("id-gps-loading-maps w3-container w3-section w3-card-8 w3-round-xlarge w3-pale-blue|width:100%","loading maps..."),w3_div("id-gps-channels w3-container w3-section w3-card-8 w3-round-xlarge w3-pale-blue|width:100%",w3_table("id-gps-ch w3-table-6-8 w3-striped")),w3_div("id-gps-azel-container w3-hide",w3_div("w3-hcenter w3-relative",'<img id="id-gps-azel-graph" src="gfx/gpsEarth.png" width="400" height="400" style="position:absolute; top:-2px" />','<canvas id="id-gps-azel-canvas" width="400" height="400" style="position:absolute"></canvas>')),w3_div("id-gps-map-container",w3_div('||id="id-gps-map"',""),w3_div("id-gps-map-legend w3-small w3-margin-left","")))+w3_div("w3-container w3-section w3-card-8 w3-round-xlarge w3-pale-blue",w3_table("id-gps-info w3-table-6-8")))}function gps_acq_cb(e,t,n){n||(console.log("gps_acq_cb path="+e+" val="+t),w3_bool_set_cfg_cb(e,t))}function gps_graph_cb(e,t){admin_int_cb(e,t=+t),ext_send("SET gps_IQ_data_ch="+(t==_gps.IQ?_gps.iq_ch:0)),w3_show_hide("id-gps-pos-scale",t==_gps.POS),w3_show_hide("id-gps-iq-ch",t==_gps.IQ);var n=w3_el("id-gps-channels");t==_gps.AZEL||t==_gps.MAP?(n.style.width="65%",w3_el("id-gps-azel-container").style.width="35%",w3_el("id-gps-map-container").style.width="35%",_gps.map_needs_height=1):n.style.width="100%",w3_show_hide("id-gps-azel-container",t==_gps.AZEL),w3_show_hide("id-gps-map-container",t==_gps.MAP),gps_update_admin_cb(),t==_gps.AZEL&&ext_send("SET gps_az_el_history")}function gps_E1B_offset_cb(e,t,n){-1==(t=+t)&&(t=4)}function gps_pos_scale_cb(e,t,n){(-1==(t=+t)||n)&&(t=9),_gps.pos_scale=t+1}function gps_iq_ch_cb(e,t,n){(-1==(t=+t)||n)&&(t=0),_gps.iq_ch=t+1,ext_send("SET gps_IQ_data_ch="+_gps.iq_ch),_gps.IQ_data=null}function gps_gain_cb(e,t,n){(-1==(t=+t)||n)&&(t=0),_gps.gain=t+1,ext_send("SET gps_gain="+_gps.gain)}var gps_has_lat_lon,gps_nsamp,gps_nsats,gps_now,gps_prn,gps_az_el_history_running=!1;function gps_schedule_azel(){0==gps_az_el_history_running&&(gps_az_el_history_running=!0,ext_send("SET gps_az_el_history"),gps_azel_interval=setInterval(function(){ext_send("SET gps_az_el_history")},6e4))}function gps_focus(e){_gps.gps_map_loaded?gps_focus2(e):(kiwi_load_js(_gps.leaflet?_gps.pkgs_maps_js:_gps.gmap_js,"gps_focus2"),_gps.gps_map_loaded=!0)}function gps_focus2(e){w3_hide("id-gps-loading-maps"),gps_schedule_azel(),ext_send("SET gps_update"),gps_interval=setInterval(function(){ext_send("SET gps_update")},1e3),gps_graph_cb("adm.rssi_azel_iq",adm.rssi_azel_iq)}function gps_blur(e){kiwi_clearInterval(gps_interval),kiwi_clearInterval(gps_azel_interval),gps_az_el_history_running=!1,ext_send("SET gps_IQ_data_ch=0")}var gps_az=null,gps_el=null,gps_qzs3_az=0,gps_qzs3_el=0,gps_shadow_map=null;function gps_az_el_history_cb(e){gps_nsats=e.n_sats,gps_nsamp=e.n_samp,gps_now=e.now,gps_prn=new Array(gps_nsats),(gps_az=new Array(gps_nsamp*gps_nsats)).fill(0),(gps_el=new Array(gps_nsamp*gps_nsats)).fill(0);for(var t=e.sat_seen.length,n=0;n<t;n++){var a=e.sat_seen[n];gps_prn[a]=e.prn_seen[n]}for(var i=0;i<gps_nsamp;i++)for(n=0;n<t;n++){var _=i*t+n,o=e.az[_],r=e.el[_],s=(a=e.sat_seen[n],i*gps_nsats+a);gps_az[s]=o,gps_el[s]=r}gps_qzs3_az=e.qzs3.az,gps_qzs3_el=e.qzs3.el,gps_shadow_map=e.shadow_map.slice(),gps_update_azel()}var gps_canvas,SUBFRAMES=5,max_rssi=1,refresh_icon=w3_icon("","fa-refresh",20),sub_colors=["w3-red","w3-green","w3-blue","w3-yellow","w3-orange"],gps_last_good_el=[],gps_rssi_azel_iq_s=["RSSI","Az/el","Position solution map","Map","LO PLL IQ"];function gps_update_admin_cb(){if(gps){var e;e=w3_table_row("",w3_table_heads("w3-right-align","chan","acq","&nbsp;PRN","SNR","eph age","hold","wdog"),w3_table_heads("w3-center","status","subframe"),w3_table_heads("w3-right-align","ov","az","el"),adm.rssi_azel_iq==_gps.RSSI?null:w3_table_heads("w3-right-align","RSSI"),adm.rssi_azel_iq==_gps.AZEL||adm.rssi_azel_iq==_gps.MAP?null:w3_table_heads("w3-center|width:35%",(adm.rssi_azel_iq==_gps.IQ&&_gps.iq_ch?"Channel "+_gps.iq_ch+" ":"")+gps_rssi_azel_iq_s[adm.rssi_azel_iq]));for(var t=0;t<gps.ch.length;t++)e+=w3_table_row("id-gps-ch-"+t,"");w3_el("id-gps-ch").innerHTML=e;var n=0==gps.stype?"w3-green":1==gps.stype?"w3-yellow":"w3-red";for(t=0;t<gps.ch.length;t++){var a=gps.ch[t];a.rssi>max_rssi&&(max_rssi=a.rssi);var i=0,_="";-1!=a.prn&&("N"!=a.prn_s&&(_=a.prn_s),i=a.prn);for(var o=n,r=a.alert?"A":1==a.ACF?"+":2==a.ACF?"-":"U",s=w3_table_cells("w3-right-align",t+1)+w3_table_cells("w3-center",t==gps.FFTch?refresh_icon:"")+w3_table_cells("w3-right-align",i?_+i:"",a.snr?a.snr:"")+w3_table_cells("w3-right-align"+(a.old?" w3-text-red w3-bold":""),a.age)+w3_table_cells("w3-right-align",a.hold?a.hold:"",a.rssi?a.wdog:"")+w3_table_cells("w3-center",'<span class="w3-tag '+(a.alert?1==a.alert?"w3-red":"w3-green":a.unlock?"w3-yellow":"w3-white")+'">'+r+'</span><span class="w3-tag '+(a.parity?"w3-yellow":"w3-white")+'">P</span><span class="w3-tag '+(a.soln?o:"w3-white")+'">S</span>'),l="",c=SUBFRAMES-1;c>=0;c--){l+='<span class="w3-tag '+(a.sub_renew&1<<c?"w3-grey":a.sub&1<<c?sub_colors[c]:"w3-white")+'">'+(c+1)+"</span>"}if(s+=w3_table_cells("w3-center",l),s+=w3_table_cells("w3-right-align",a.novfl?a.novfl:"",a.el?a.az:"",a.el?a.el:"",adm.rssi_azel_iq==_gps.RSSI?null:a.rssi?a.rssi:""),adm.rssi_azel_iq==_gps.RSSI){var d=(a.rssi/max_rssi*100).toFixed(0);s+=w3_table_cells("",w3_div("w3-progress-container w3-round-xlarge w3-white",w3_div("w3-progressbar w3-round-xlarge w3-light-green|width:"+d+"%",w3_div("w3-container w3-text-white",a.rssi))))}else adm.rssi_azel_iq==_gps.RSSI&&adm.rssi_azel_iq==_gps.AZEL&&adm.rssi_azel_iq==_gps.MAP||0==t&&(s+=w3_table_cells("|vertical-align:top;position:relative;|rowspan="+gps.ch.length,w3_div("w3-hcenter",'<canvas id="id-gps-canvas" width="400" height="400" style="position:absolute; z-index:2"></canvas>')));w3_el("id-gps-ch-"+t).innerHTML=s}if(e=w3_table_row("",w3_table_heads("","acq","track","good","fixes","f/min","run","TTFF","UTC offset","ADC clock","lat","lon","alt","map"))+w3_table_row("",w3_table_cells("",gps.acq?"yes":"paused",gps.track?gps.track:"",gps.good?gps.good:"",gps.fixes?gps.fixes.toUnits():"",gps.fixes_min,gps.run,gps.ttff?gps.ttff:"",gps.utc_offset?gps.utc_offset:"",gps.adc_clk.toFixed(6)+" ("+gps.adc_corr.toUnits()+")",gps.lat?gps.lat:"",gps.lat?gps.lon:"",gps.lat?gps.alt:"",gps.lat?gps.map:"")),w3_el("id-gps-info").innerHTML=e,null!=(gps_canvas=w3_el("id-gps-canvas"))){gps_canvas.ctx=gps_canvas.getContext("2d");var w=gps_canvas.ctx;if(adm.rssi_azel_iq!=_gps.RSSI){if(_gps.map_needs_height){var p=css_style_num(w3_el("id-gps-channels"),"height");p&&(w3_el("id-gps-azel-container").style.height=px(p-24),w3_el("id-gps-map").style.height=px(p-24),_gps.a=enc(gps.a),_gps.map_needs_height=0)}if(adm.rssi_azel_iq!=_gps.MAP)if(adm.rssi_azel_iq!=_gps.IQ){if(adm.rssi_azel_iq==_gps.POS){S=400;if(w.fillStyle="hsl(0, 0%, 90%)",w.fillRect(0,0,S,S),!_gps.POS_data)return;w.fillStyle="black";var g,m,u,h,b,f,v,k;T=S/2/(.001*_gps.pos_scale),I=_gps.POS_data.POS.length;w.globalAlpha=1,g=u=b=v=Number.MAX_VALUE,m=h=f=k=Number.MIN_VALUE;for(c=0;c<I&&(adm.plot_E1B||!(c>=I/2));c+=2){w.fillStyle=c<I/2?"DeepSkyBlue":"black";var x=_gps.POS_data.POS[c];if(0!=x){var y=_gps.POS_data.POS[c+1];x-=_gps.POS_data.ref_lat,y-=_gps.POS_data.ref_lon,((M=Math.round(y*T+S/2))<0||M>=S)&&(M=M<0?0:S-1,0),((q=Math.round(-x*T+S/2))<0||q>=S)&&(q=q<0?0:S-1,0);c<I/2?(w.fillRect(M-2,q-2,5,5),M+8>m?m=M+8:M-8<g&&(g=M-8),q+8>h?h=q+8:q-8<u&&(u=q-8)):(w.fillRect(M,q-2,1,5),w.fillRect(M-2,q,5,1),M+8>f?f=M+8:M-8<b&&(b=M-8),q+8>k?k=q+8:q-8<v&&(v=q-8))}}m>=S&&(m=S-1),g<0&&(g=0),h>=S&&(h=S-1),u<0&&(u=0),line_stroke(w,0,1,"DeepSkyBlue",g,u,m,u),line_stroke(w,0,1,"DeepSkyBlue",g,h,m,h),line_stroke(w,1,1,"DeepSkyBlue",g,u,g,h),line_stroke(w,1,1,"DeepSkyBlue",m,u,m,h),adm.plot_E1B&&(f>=S&&(f=S-1),b<0&&(b=0),k>=S&&(k=S-1),v<0&&(v=0),line_stroke(w,0,1,"black",b,v,f,v),line_stroke(w,0,1,"black",b,k,f,k),line_stroke(w,1,1,"black",b,v,b,k),line_stroke(w,1,1,"black",f,v,f,k));M=16,q=S-32;return w.font="15px Courier",w.fillStyle="DeepSkyBlue",w.fillRect(M-2,q-2-4,5,5),M+=12,w.fillStyle="black",w.fillText((adm.plot_E1B?" w/o Galileo span: ":"All sats span: ")+_gps.POS_data.y0span.toFixed(0).fieldWidth(4)+"m Ylat "+_gps.POS_data.x0span.toFixed(0).fieldWidth(4)+"m Xlon",M,q),void(adm.plot_E1B&&(M-=12,q+=18,w.fillStyle="black",w.fillRect(M,q-2-4,1,5),w.fillRect(M-2,q-4,5,1),M+=12,w.fillText("with Galileo span: "+_gps.POS_data.y1span.toFixed(0).fieldWidth(4)+"m Ylat "+_gps.POS_data.x1span.toFixed(0).fieldWidth(4)+"m Xlon",M,q)))}}else{var S=400;if(w.fillStyle="hsl(0, 0%, 90%)",w.fillRect(0,0,S,S),w.fillStyle="yellow",w.fillRect(S/2,0,1,S),w.fillRect(0,S/2,S,1),!_gps.IQ_data)return;w.fillStyle="black";for(var T=S/2/32768*8,I=_gps.IQ_data.IQ.length,c=0;c<I;c+=2){var M,q,R=_gps.IQ_data.IQ[c],P=_gps.IQ_data.IQ[c+1];if(0!=R||0!=P)((M=Math.round(R*T+S/2))<0||M>=S)&&(M=M<0?0:S-1),((q=Math.round(P*T+S/2))<0||q>=S)&&(q=q<0?0:S-1),w.fillRect(M,q,2,2)}}else{if(!_gps.map_init&&!_gps.map_needs_height){if(_gps.leaflet){var N=function(e){return L.mapboxGL({attribution:'<a href="https://www.maptiler.com/license/maps/" target="_blank">&copy; MapTiler</a> <a href="https://www.openstreetmap.org/copyright" target="_blank">&copy; OpenStreetMap contributors</a>',accessToken:"not-needed",style:"https://api.maptiler.com/maps/"+e+"/style.json"+_gps.a})};_gps.map=L.map("id-gps-map",{maxZoom:19,minZoom:1}).setView([0,0],1);var A=N("hybrid");A.addTo(_gps.map),L.control.layers({Satellite:A,Basic:N("basic"),Bright:N("bright"),Positron:N("positron"),Street:N("streets"),Topo:N("topo")},null).addTo(_gps.map)}else{var E=new google.maps.LatLng(0,0),z=w3_el("id-gps-map");_gps.map=new google.maps.Map(z,{zoom:1,center:E,navigationControl:!1,mapTypeControl:!1,streetViewControl:!1,mapTypeId:google.maps.MapTypeId.SATELLITE})}_gps.map_init=1}if(w3_innerHTML("id-gps-map-legend",adm.plot_E1B?_gps.legend_sep:_gps.legend_all),!_gps.MAP_data||!_gps.map_init)return;if(!_gps.map_locate){if(_gps.leaflet)_gps.map.setView([_gps.MAP_data.ref_lat,_gps.MAP_data.ref_lon],15,{duration:0,animate:!1});else{E=new google.maps.LatLng(_gps.MAP_data.ref_lat,_gps.MAP_data.ref_lon);_gps.map.panTo(E),_gps.map.setZoom(18)}_gps.map_locate=1}for(var C=_gps.MAP_data.MAP.length,D=0;D<C;D++){var U=_gps.MAP_data.MAP[D],H=0==U.nmap?_gps.leaflet?"lime":"green":1==U.nmap?"red":"yellow";if(_gps.leaflet){var B=L.divIcon({className:"fooLM",iconAnchor:[12,12],labelAnchor:[-6,0],popupAnchor:[0,-36],html:'<span class="cl-leaflet-marker" style="background-color:'+H+';"/>'});for((O=L.marker([U.lat,U.lon],{icon:B,opacity:1})).addTo(_gps.map),_gps.map_mkr.push(O);_gps.map_mkr.length>12;)_gps.map_mkr.shift().remove()}else{E=new google.maps.LatLng(U.lat,U.lon);var O=new google.maps.Marker({position:E,icon:"http://maps.google.com/mapfiles/ms/icons/"+H+"-dot.png",map:_gps.map});for(_gps.map_mkr.push(O);_gps.map_mkr.length>12;)_gps.map_mkr.shift().setMap(null)}}_gps.MAP_data=null}}}}}function gps_update_azel(){if(adm.rssi_azel_iq==_gps.AZEL&&null!=gps_el){var e=w3_el("id-gps-azel-canvas");if(null!=e){e.ctx=e.getContext("2d");var t=e.ctx,n=200;if(t.clearRect(0,0,400,400),adm.rssi_azel_iq==_gps.AZEL&&gps_shadow_map){t.fillStyle="cyan",t.globalAlpha=.1;for(var a=2*(k=4)+1,_=0;_<360;_++)for(var o=_*Math.PI/180,r=gps_shadow_map[_],s=0,l=1;s<32;s++,l<<=1)if(r&l){var c=(90-(h=s/31*90))/90*180,d=Math.round(c*Math.sin(o)),w=Math.round(c*Math.cos(o));t.fillRect(d+n-k-1,n-w-k-1,a+2,a+2)}t.globalAlpha=1}if(t.strokeStyle="black",t.miterLimit=2,t.lineJoin="circle",t.font="13px Verdana",gps_qzs3_el>0){o=gps_qzs3_az*Math.PI/180,c=(90-gps_qzs3_el)/90*180,d=Math.round(c*Math.sin(o));d+=n,w=n-(w=Math.round(c*Math.cos(o))),t.lineWidth=1,t.beginPath(),t.arc(d,w,10,0,2*Math.PI),t.stroke(),d=12,w=30,t.lineWidth=1,t.beginPath(),t.arc(d,w,10,0,2*Math.PI),t.stroke();t.fillStyle="black",t.lineWidth=1,t.fillText("QZS-3",d+16,w+4)}t.fillStyle="black";for(var p=0;p<gps_nsats;p++)gps_last_good_el[p]=-1;for(var g=gps_nsamp-10;g>=-1;g--)for(p=0;p<gps_nsats;p++){var m=-1==g?gps_last_good_el[p]:g;if(-1!=g||-1!=m){var u=gps_now-m;u<0&&(u+=gps_nsamp),i=u*gps_nsats+p;var h;_=gps_az[i];if(0!=(h=gps_el[i])){gps_last_good_el[p]=g;o=_*Math.PI/180,c=(90-h)/90*180,d=Math.round(c*Math.sin(o)),w=Math.round(c*Math.cos(o));if(-1==g){var b=gps_prn[p],f=t.measureText(b).width,v=_<=180?-f-8:8;t.fillStyle=m>1?"pink":"yellow",t.lineWidth=3,t.strokeText(b,d+v+n,n-w+5),t.lineWidth=1,t.fillText(b,d+v+n,n-w+5);var k;a=2*(k=3)+1;t.fillStyle="black",t.fillRect(d+n-k-1,n-w-k-1,a+2,a+2),t.fillStyle=m>1?"red":"yellow",t.fillRect(d+n-k,n-w-k,a,a)}else t.fillStyle="black",t.fillRect(d+n,n-w,2,2)}}}}}}var log_interval,log={},nlog=256;function log_html(){return w3_div("id-log w3-text-teal w3-hide","<hr>"+w3_div("w3-container",w3_div("",w3_label("w3-show-inline","KiwiSDR server log (scrollable list, first and last set of messages)")+w3_button("w3-aqua|margin-left:10px","Dump","log_dump_cb")+w3_button("w3-blue|margin-left:10px","Clear Histogram","log_clear_hist_cb")),w3_div("id-log-msg w3-margin-T-8 w3-text-output w3-small w3-text-black","")))}function log_setup(){for(var e=w3_el("id-log-msg"),t="<pre>",n=0;n<nlog;n++)n==nlog/2&&(t+='<code id="id-log-not-shown"></code>'),t+='<code id="id-log-'+n+'"></code>';t+="</pre>",e.innerHTML=t,ext_send("SET log_update=1")}function log_dump_cb(e,t){ext_send("SET log_dump")}function log_clear_hist_cb(e,t){ext_send("SET log_clear_hist")}function log_resize(){var e=w3_el("id-log-msg");if(e){var t=window.innerHeight-w3_el("id-admin-header-container").clientHeight-100;e.style.height=px(t)}}function log_focus(e){log_resize(),log_update(),log_interval=setInterval(log_update,3e3)}function log_blur(e){kiwi_clearInterval(log_interval)}function log_update(){ext_send("SET log_update=0")}var console_status_msg_p={scroll_only_at_bottom:!0,process_return_alone:!0,remove_returns:!0,ncol:160};function console_html(){return w3_div("id-console w3-section w3-text-teal w3-hide",w3_div("w3-container",w3_div("",w3_label("w3-show-inline","Beagle Debian console")+w3_button("w3-aqua|margin-left:10px","Connect","console_connect_cb")),w3_div("id-console-msg w3-margin-T-8 w3-text-output w3-scroll-down w3-small w3-text-black|background-color:#a8a8a8",'<pre><code id="id-console-msgs"></code></pre>'),w3_div("w3-margin-top",w3_input("","","console_input","","console_input_cb|console_ctrl_cb","enter shell command")),w3_text("w3-text-black w3-margin-top","Control characters (^C, ^D, ^\\) and empty lines may now be typed directly into shell command field.")))}function console_input_cb(e,t){ext_send("SET console_w2c="+encodeURIComponent(t+"\n")),w3_set_value(e,"")}function console_connect_cb(){ext_send("SET console_open")}function console_ctrl_cb(e){ext_send("SET console_ctrl="+e)}function console_setup(){}function console_resize(){var e=w3_el("id-console-msg");if(e){var t=window.innerHeight-w3_el("id-admin-header-container").clientHeight-200;e.style.height=px(t)}}function console_focus(e){console_resize()}function console_blur(e){}function security_html(){var e=ext_get_cfg_param("chan_no_pwd",0);e=Math.min(e,rx_chans-1);for(var t={0:"none"},n=1;n<rx_chans;n++)t[n]=n.toFixed(0);return w3_div("id-security w3-hide","<hr>"+w3_inline_percent("w3-container/w3-hspace-16 w3-text-teal",w3_div("",w3_div("","<b>User auto-login from local net<br>even if password set?</b><br>",w3_switch("w3-margin-T-8","Yes","No","adm.user_auto_login",adm.user_auto_login,"admin_radio_YN_cb"))),25,w3_div("w3-center",w3_select("","Number of channels<br>not requiring a password<br>even if password set","","chan_no_pwd",e,t,"admin_select_cb"),w3_div("w3-margin-T-8 w3-text-black","Set this and a password to create two sets of channels. Some that have open-access requiring no password and some that are password protected.")),25,w3_div("",w3_input("","User password","adm.user_password","","w3_string_set_cfg_cb","No password set: unrestricted Internet access to SDR")),50)+"<hr>"+w3_inline_percent("w3-container/w3-hspace-16 w3-text-teal",w3_div("",w3_div("","<b>Admin auto-login from local net<br>even if password set?</b><br>",w3_switch("w3-margin-T-8","Yes","No","adm.admin_auto_login",adm.admin_auto_login,"admin_radio_YN_cb"))),25,w3_div("w3-text-teal",""),25,w3_div("",w3_input("","Admin password","adm.admin_password","","w3_string_set_cfg_cb","No password set: no admin access from Internet allowed")),50)+"<hr>"+w3_inline_percent("w3-container/w3-hspace-16 w3-text-teal",w3_div("",w3_div("","<b>Allow GPS timestamp information <br> to be sent on the network?</b><br>",w3_switch("w3-margin-T-8","Yes","No","adm.GPS_tstamp",adm.GPS_tstamp,"admin_radio_YN_cb"))),25,w3_div("w3-text-black",'Set to "No" to prevent timestamp information from your GPS (assuming it is working) from being used by applications on the Internet such as the TDoA service. You would only do this if you had some concern about your publicly-listed Kiwi participating in these kinds of projects. '),33,w3_div("w3-text-black"),1,w3_div("w3-text-black","However we expect most Kiwi owners will want to participate and we encourage you to do so. Your precise GPS location is not revealed by the timestamp information. For more discussion please see the "+w3_link("w3-link-darker-color","http://valentfx.com/vanilla/discussion/1218/participation-of-kiwis-in-the-tdoa-process","Kiwi forums")+"."),33)+"<hr>")}function security_focus(e){admin_set_decoded_value("adm.user_password"),admin_set_decoded_value("adm.admin_password")}var admin_colors=["w3-hover-red","w3-hover-blue","w3-hover-purple","w3-hover-black","w3-hover-aqua","w3-hover-pink","w3-hover-yellow","w3-hover-khaki","w3-hover-green","w3-hover-orange","w3-hover-grey","w3-hover-lime","w3-hover-indigo","w3-hover-brown","w3-hover-teal","w3-hover-blue-grey"];function admin_main(){window.addEventListener("resize",admin_resize)}function admin_resize(){log_resize(),console_resize()}function kiwi_ws_open(e,t,n){return open_websocket(e,t,n,admin_msg,admin_recv)}function admin_draw(e){var t=w3_el("id-admin"),n=0,a="";e||(a+=w3_nav(admin_colors[n++],"GPS","gps","admin_nav")),a+=w3_nav(admin_colors[n++],"Status","status","admin_nav")+w3_nav(admin_colors[n++],"Mode","mode","admin_nav")+w3_nav(admin_colors[n++],"Control","control","admin_nav")+w3_nav(admin_colors[n++],"Connect","connect","admin_nav"),e&&(a+=w3_nav(admin_colors[n++],"Config","config","admin_nav")+w3_nav(admin_colors[n++],"Webpage","webpage","admin_nav")+w3_nav(admin_colors[n++],"Public","sdr_hu","admin_nav")+w3_nav(admin_colors[n++],"DX","dx","admin_nav")),a+=w3_nav(admin_colors[n++],"Update","update","admin_nav")+w3_nav(admin_colors[n++],"Backup","backup","admin_nav")+w3_nav(admin_colors[n++],"Network","network","admin_nav")+(e?w3_nav(admin_colors[n++],"GPS","gps","admin_nav"):"")+w3_nav(admin_colors[n++],"Log","log","admin_nav")+w3_nav(admin_colors[n++],"Console","console","admin_nav")+(e?w3_nav(admin_colors[n++],"Extensions","extensions","admin_nav"):"")+w3_nav(admin_colors[n++],"Security","security","admin_nav"),t.innerHTML=w3_div("id-admin-header-container",'<header class="w3-container w3-teal"><h5>Admin interface</h5></header>'+w3_navbar("w3-border w3-light-grey",a)+w3_divs("id-restart w3-hide/w3-valign",'<header class="w3-show-inline-block w3-container w3-red"><h5>Restart required for changes to take effect</h5></header>'+w3_div("w3-show-inline-block",w3_button("w3-green w3-margin","KiwiSDR server restart","admin_restart_now_cb"))+w3_div("w3-show-inline-block",w3_button("w3-yellow w3-margin","cancel","admin_restart_cancel_cb")))+w3_divs("id-reboot w3-hide/w3-valign",'<header class="w3-show-inline-block w3-container w3-red"><h5>Reboot required for changes to take effect</h5></header>'+w3_div("w3-show-inline-block",w3_button("w3-green w3-margin","Beagle reboot","admin_reboot_now_cb"))+w3_div("w3-show-inline-block",w3_button("w3-yellow w3-margin","cancel","admin_reboot_cancel_cb")))+w3_div("id-build-restart w3-valign w3-hide",'<header class="w3-container w3-blue"><h5>Server will restart after build</h5></header>')+w3_div("id-build-reboot w3-valign w3-hide",'<header class="w3-container w3-red"><h5>Beagle will reboot after build</h5></header>')),a=e?status_html():gps_html()+status_html(),a+=mode_html()+control_html()+connect_html(),e&&(a+=config_html()+webpage_html()+sdr_hu_html()+dx_html()),a+=update_html()+backup_html()+network_html()+(e?gps_html():"")+log_html()+console_html()+(e?extensions_html():"")+security_html(),t.innerHTML+=a,log_setup(),console_setup(),stats_init(),e?users_init(!0):gps_focus(),w3_show_block("id-admin");var i=e?"status":"gps";w3_click_nav(kiwi_toggle(toggle_e.FROM_COOKIE|toggle_e.SET,i,i,"last_admin_navbar"),"admin_nav"),setTimeout(function(){setInterval(status_periodic,5e3)},1e3)}function admin_nav_focus(e,t){w3_click_nav(e,e),writeCookie("last_admin_navbar",e)}function admin_nav_blur(e,t){w3_call(e+"_blur")}var gps=null;function admin_msg(e){switch(e[0]){case"gps_update_cb":try{var t=decodeURIComponent(e[1]);gps=JSON.parse(t),w3_call("gps_update_admin_cb")}catch(e){console.log("<"+t+">"),console.log("kiwi_msg() gps_update_cb: JSON parse fail")}break;case"gps_IQ_data_cb":try{var n=decodeURIComponent(e[1]);_gps.IQ_data=JSON.parse(n)}catch(e){console.log("<"+n+">"),console.log("kiwi_msg() gps_IQ_data_cb: JSON parse fail")}break;case"gps_POS_data_cb":try{var a=decodeURIComponent(e[1]);_gps.POS_data=JSON.parse(a)}catch(e){console.log("<"+a+">"),console.log("kiwi_msg() gps_POS_data_cb: JSON parse fail")}break;case"gps_MAP_data_cb":try{var i=decodeURIComponent(e[1]);_gps.MAP_data=JSON.parse(i)}catch(e){console.log("<"+i+">"),console.log("kiwi_msg() gps_MAP_data_cb: JSON parse fail")}break;case"gps_az_el_history_cb":var _;try{_=decodeURIComponent(e[1]),w3_call("gps_az_el_history_cb",JSON.parse(_))}catch(e){console.log("kiwi_msg() gps_az_el_history_cb: JSON parse fail"),console.log(_)}break;case"dx_json":console.log("dx_json len="+e[1].length),dx_json(JSON.parse(e[1]));break;default:return!1}return!0}var log_msg_idx,log_msg_not_shown=0,admin_sdr_mode=1;function admin_recv(e){for(var t=arrayBufferToString(e).substring(4).split(" "),n=0;n<t.length;n++){var a=t[n].split("=");switch(a[0]){case"gps_only_mode":admin_sdr_mode=+a[1]?0:1;break;case"BBAI":admin.BBAI=!0;break;case"init":rx_chans=rx_chan=+a[1],-1==rx_chans?w3_innerHTML("id-admin",'<header class="w3-container w3-red"><h5>Admin interface</h5></header><p>To use the new admin interface you must edit the configuration parameters from your current kiwi.config/kiwi.cfg into kiwi.config/kiwi.json<br>Use the file kiwi.config/kiwi.template.json as a guide.</p>'):(admin_draw(admin_sdr_mode),ext_send("SET extint_load_extension_configs"));break;case"ext_call":var i=decodeURIComponent(a[1]).split("="),_=i[0],o=i.length>1?i[1]:null;w3_call(_,o);break;case"public_update":public_update(a[1]);break;case"auto_nat":var r,s,l=+a[1],c=w3_el("id-net-auto-nat-msg");switch(l){case 0:break;case 1:r="succeeded",s="w3-green";break;case 2:r="no device found",s="w3-orange";break;case 3:r="rule already exists",s="w3-yellow";break;case 4:r="command failed",s="w3-red";break;case 5:r="pending",s="w3-yellow"}l&&c&&(c.innerHTML='<header class="w3-container"><h5>Automatic add of NAT rule on firewall / router: '+r+"</h5></header>",w3_remove_then_add(c,network.auto_nat_color,s),network.auto_nat_color=s,w3_show_block(c));break;case"log_msg_not_shown":if(log_msg_not_shown=parseInt(a[1]))(c=w3_el("id-log-not-shown")).innerHTML="---- "+log_msg_not_shown.toString()+" lines not shown ----\n";break;case"log_msg_idx":log_msg_idx=parseInt(a[1]);break;case"log_msg_save":if(!(c=w3_el("id-log-"+log_msg_idx)))break;var d=w3_el("id-log-msg"),w=kiwi_isScrolledDown(d),p=decodeURIComponent(a[1]).replace(/</g,"&lt;").replace(/>/g,"&gt;");c.innerHTML=p,w&&(d.scrollTop=d.scrollHeight);break;case"log_update":log_update(a[1]);break;case"microSD_done":backup_sd_write_done(parseFloat(a[1]));break;case"DUC_status":connect_DUC_status_cb(parseFloat(a[1]));break;case"rev_status":connect_rev_status_cb(parseFloat(a[1]));break;case"check_port_status":network_check_port_status_cb(parseInt(a[1]));break;case"console_c2w":console_status_msg_p.s=a[1],kiwi_output_msg("id-console-msgs","id-console-msg",console_status_msg_p);break;case"console_done":console.log("## console_done");break;case"config_clone_status":config_clone_status_cb(parseInt(a[1]));break;case"network_ip_blacklist_status":l=decodeURIComponent(a[1]).split(","),network_ip_blacklist_status(parseInt(l[0]),l[1]);break;default:console.log("ADMIN UNKNOWN: "+a[0]+"="+a[1])}}}function w3_restart_cb(){w3_show_block("id-restart")}function w3_reboot_cb(){w3_show_block("id-reboot")}var admin_reload_secs,admin_reload_rem,admin_pie_size=25;function admin_draw_pie(){w3_el("id-admin-reload-secs").innerHTML="Admin page reload in "+admin_reload_rem+" secs",admin_reload_rem>0?(admin_reload_rem--,kiwi_draw_pie("id-admin-pie",admin_pie_size,(admin_reload_secs-admin_reload_rem)/admin_reload_secs)):window.location.reload(!0)}function admin_wait_then_reload(e,t){var n=w3_el("id-admin"),a='<header class="w3-container w3-teal"><h5>Admin interface</h5></header>'+(e?w3_divs("w3-valign w3-margin-T-8/w3-container",w3_div("w3-show-inline-block",kiwi_pie("id-admin-pie",admin_pie_size,"#eeeeee","deepSkyBlue")),w3_div("w3-show-inline-block",w3_div("id-admin-reload-msg"),w3_div("id-admin-reload-secs"))):w3_divs("w3-valign w3-margin-T-8/w3-container",w3_div("id-admin-reload-msg")));n.innerHTML=a,t&&(w3_el("id-admin-reload-msg").innerHTML=t),e&&(admin_reload_rem=admin_reload_secs=e,setInterval(admin_draw_pie,1e3),admin_draw_pie())}function admin_restart_now_cb(){ext_send("SET restart"),admin_wait_then_reload(60,"Restarting KiwiSDR server")}function admin_restart_cancel_cb(){w3_hide("id-restart")}function admin_reboot_now_cb(){ext_send("SET reboot"),admin_wait_then_reload(90,"Rebooting Beagle")}function admin_reboot_cancel_cb(){w3_hide("id-reboot")}function admin_int_cb(e,t){t=parseInt(t),isNaN(t)?(t=ext_get_cfg_param(e),w3_set_value(e,t)):ext_set_cfg_param(e,t,!0)}function admin_float_cb(e,t){t=parseFloat(t),isNaN(t)?(t=ext_get_cfg_param(e),w3_set_value(e,t)):ext_set_cfg_param(e,t,!0)}function admin_bool_cb(e,t,n){ext_set_cfg_param(e,!!t,null==n||!n)}function admin_set_decoded_value(e){var t=ext_get_cfg_param(e);w3_set_decoded_value(e,t)}function admin_radio_YN_cb(e,t){admin_bool_cb(e,t?0:1)}function admin_select_cb(e,t,n){-1!=(t=+t)&&ext_set_cfg_param(e,t,!n)}function admin_preview_status_box(e){var t=decodeURIComponent(e);return t&&""!=t||(t="&nbsp;"),t}
\ No newline at end of file
+var admin={BBAI:!1,reg_status:{}};function status_html(){var e=admin_sdr_mode?"<hr>"+w3_div("id-msg-errors w3-container")+w3_div("w3-container w3-section",w3_inline("",w3_div("","Realtime response histograms:"),w3_button("w3-padding-smaller w3-aqua|margin-left:10px","Reset","status_dpump_hist_reset_cb")),w3_div("w3-container",w3_div("id-status-dp-hist"),w3_div("id-status-in-hist")))+w3_div("w3-container w3-section",w3_inline("",w3_div("","Server memory (kiwi_malloc):"),w3_button("w3-padding-smaller w3-aqua|margin-left:10px","Dump to log","status_malloc_dump_cb")),w3_div("id-status-malloc w3-container")):"";return w3_div("id-status w3-hide","<hr>"+w3_div("id-problems w3-container")+w3_div("id-msg-config w3-container")+w3_div("id-msg-gps w3-container")+"<hr>"+w3_div("id-msg-stats-cpu w3-container")+w3_div("id-msg-stats-xfer w3-container")+e+"<hr>"+w3_div("id-debugdiv w3-container"))}function status_dpump_hist_reset_cb(e,t){ext_send("SET dpump_hist_reset")}function status_malloc_dump_cb(e,t){ext_send("SET malloc_dump")}var status_malloc_interval;function status_focus(e){admin_sdr_mode&&(kiwi_clearInterval(status_malloc_interval),ext_send("SET malloc_stats"),status_malloc_interval=setInterval(function(){ext_send("SET malloc_stats")},5e3))}function status_blur(e){kiwi_clearInterval(status_malloc_interval)}function status_malloc_stats(e){var t,a=w3_el("id-status-malloc");if(a){try{t=JSON.parse(decodeURIComponent(e))}catch(e){return void console.log("status_malloc_stats: JSON parse fail")}t.t.sort(function(e,t){return t.b-e.b});for(var n=t.n.toUnits()+" blocks, "+(t.b/1024).toFixed(0)+" kB live, "+(t.s/1024).toFixed(0)+" kB slabs<br>",s=0;s<t.t.length&&s<16;s++){var i=t.t[s];n+=(s?", ":"")+i.f+" "+i.c.toUnits()+"/"+(i.b/1024).toFixed(1)+"k (max "+(i.h/1024).toFixed(1)+"k)"}a.innerHTML=n}}function status_user_kick_cb(e,t){console.log("status_user_kick_cb="+t),ext_send("SET user_kick="+t)}var mode_icon_snd12=w3_icon("w3-text-blue","fa-volume-up",28)+"&nbsp;",mode_icon_snd20=w3_icon("w3-text-red","fa-volume-up",28)+"&nbsp;",mode_icon_fft=w3_icon("w3-text-green","fa-bar-chart",28)+"&nbsp;",mode_icon_wf=w3_icon("w3-text-amber","fa-area-chart",28)+"&nbsp;";function mode_html(){var e=px(235),t=px(113),n=0;return w3_div("id-mode w3-hide","<hr>",w3_div("w3-container",w3_div("w3-flex w3-margin-B-8",w3_div("w3-text-teal|width:"+t," "),w3_div("w3-text-teal w3-center w3-bold|width:"+e,"select FPGA mode"),w3_div("id-fw-hdr w3-flex w3-margin-left")),w3_div("",w3_div("w3-left",w3_div("w3-flex w3-halign-center w3-margin-B-5",'<img src="gfx/kiwi.73x73.jpg" width="73" height="73" />'),w3_div("w3-flex w3-halign-center w3-margin-B-5",'<img src="gfx/cowbelly.73x73.jpg" width="73" height="73" />'),w3_div("w3-flex",'<img src="gfx/kiwi.derp.113x73.jpg" width="113" height="73" />'),admin.BBAI?w3_div("w3-flex",'<img src="gfx/kiwi.derp.113x73.jpg" width="113" height="73" />'):""),w3_sidenav("id-fw-nav|width:"+e+";border-collapse:collapse",w3_nav(admin_colors[n++]+" w3-border w3-padding-xxlarge w3-restart","Kiwi classic",kiwi.RX4_WF4,"firmware_sel_cb",adm.firmware_sel==kiwi.RX4_WF4),w3_nav(admin_colors[n++]+" w3-border w3-padding-xxlarge w3-restart","More receivers",kiwi.RX8_WF2,"firmware_sel_cb",adm.firmware_sel==kiwi.RX8_WF2),w3_nav(admin_colors[n++]+" w3-border w3-padding-xxlarge w3-restart","More bandwidth",kiwi.RX3_WF3,"firmware_sel_cb",adm.firmware_sel==kiwi.RX3_WF3),admin.BBAI?w3_nav(admin_colors[n++]+" w3-border w3-padding-xxlarge w3-restart","BBAI rx14_wf0",kiwi.RX14_WF0,"firmware_sel_cb",adm.firmware_sel==kiwi.RX14_WF0):""),w3_div("w3-margin-left w3-left",w3_div("id-fw-44 w3-flex w3-padding-TB-7"),w3_div("id-fw-82 w3-flex w3-padding-TB-7"),w3_div("id-fw-22 w3-flex w3-padding-TB-7"))),w3_div("w3-clear"," "),w3_div("w3-margin-T-16","<hr>"),w3_col_percent("w3-section/ w3-hspace-16",w3_div("w3-text-black",w3_text("w3-bold w3-margin-B-8 w3-text-teal","Trade-offs: receiver channels, audio bandwidth and waterfalls"),w3_div("w3-flex w3-valign-center",w3_div("|width:40px",mode_icon_snd12),w3_div("","Audio output, 12 kHz max bandwidth")),w3_div("w3-flex w3-valign-center",w3_div("|width:40px",mode_icon_snd20),w3_div("","Audio output, 20 kHz max bandwidth")),w3_div("w3-flex w3-margin-B-8 w3-valign-center",w3_div("|width:40px",mode_icon_wf),w3_div("","Tuneable waterfall/spectrum, 30 MHz bandwidth, 14-level zoom")),w3_div("w3-flex w3-margin-B-8 w3-valign-center",w3_div("|width:40px",mode_icon_fft),w3_div("","Audio FFT display, 12 kHz max bandwidth ")),"The original Kiwi FPGA with its 4 tuneable audio/waterfall receiver channels and 12 GPS channels was completely full. But it is now possible to load a different FPGA configuration where 2 of the waterfalls have been traded for adding more audio-only receiver channels. "),48,w3_div("w3-text-black"," "),4,w3_div("w3-text-black","Having more receiver channels per Kiwi is especially important with the recently added features that are channel intensive. Namely the TDoA service, WSPR autorun and external connection via the kiwirecorder program for using other software such as WSJT-X and Dream (DRM). When these kinds of connections are made channels rx2 - rx7 will be used first leaving rx0 and rx1 available for normal browser connections where it is desirable to view the waterfall. However rx0 and rx1 will be used last if necessary. The configurable TDoA channel limit still applies.<br><br>To compensate for lack of the waterfall/spectrum on the new channels an audio-bandwidth FFT is presented instead. This requires no additional FPGA resources."),48),w3_div("w3-margin-T-16","<hr>"),w3_col_percent("w3-section/ w3-hspace-16",w3_div("w3-text-black",'And now a third option "More bandwidth". The audio bandwidth is increased from 12 to 20 kHz. This supports wide passbands for hi-fidelity listening of AM BCB and SW stations. And also wide IQ bandwidths for external applications processing large parts of the spectrum. '),48,w3_div("w3-text-black"," "),4,w3_div("w3-text-black","In exchange the number of channels drops from four to three. It may have to drop to two in the future depending on how stable operation is with three channels."),48),w3_div("w3-margin-T-16","<hr>")))}function mode_focus(){var e,t;console.log("mode_focus");var n=px(90);for(t="",e=0;e<8;e++)t+=w3_div("w3-margin-left w3-bold w3-center|width:"+n,"rx"+e);w3_innerHTML("id-fw-hdr",t);var a=w3_div("w3-margin-left w3-border w3-border-light-blue w3-center|width:"+n,mode_icon_snd12,"<br>",mode_icon_wf),i=w3_div("w3-margin-left w3-border w3-border-light-blue w3-center|width:"+n,mode_icon_snd20,"<br>",mode_icon_wf),_=w3_div("w3-margin-left w3-border w3-border-light-blue w3-center|width:"+n,mode_icon_snd12,"<br>",mode_icon_fft);for(t="",e=0;e<4;e++)t+=a;for(w3_innerHTML("id-fw-44",t),t="",e=0;e<2;e++)t+=a;for(e=2;e<8;e++)t+=_;for(w3_innerHTML("id-fw-82",t),t="",e=0;e<3;e++)t+=i;w3_innerHTML("id-fw-22",t)}function firmware_sel_cb_focus(e){var t=+e;console.log("firmware_sel_cb_focus path="+e),ext_set_cfg_param("adm.firmware_sel",t,!0)}function control_html(){var e="<hr>"+w3_half("w3-valign","",w3_div("",w3_div("",w3_button("w3-aqua w3-margin","KiwiSDR server restart","control_restart_cb"),w3_button("w3-blue w3-margin","Beagle reboot","control_reboot_cb"),w3_button("w3-red w3-margin","Beagle power off","control_power_off_cb")),w3_div("id-confirm w3-valign w3-hide",w3_button("w3-green w3-margin","Confirm","control_confirm_cb"),w3_button("w3-yellow w3-margin","Cancel","control_confirm_cancel_cb"))),w3_div("w3-container w3-center","<b>Daily restart?</b> "+w3_switch("","Yes","No","adm.daily_restart",adm.daily_restart,"admin_radio_YN_cb"),w3_div("w3-text-black","Set if you're having problems with the server<br>after it has run for a period of time.<br>Restart occurs at the same time as updates (0200-0600 UTC)<br> and will wait until there are no connections."))),t="<hr>"+w3_third("","w3-container w3-valign",w3_divs("w3-center w3-tspace-8",w3_div("","<b>Enable user connections?</b>"),w3_switch("","Yes","No","adm.server_enabled",adm.server_enabled,"server_enabled_cb")),w3_divs("w3-center w3-tspace-8",w3_div("","<b>Close all active user connections</b>"),w3_button("w3-red","Kick","control_user_kick_cb")),w3_divs("w3-restart/w3-center w3-tspace-8",w3_div("","<b>Disable waterfalls/spectrum?</b>"),w3_switch("","Yes","No","cfg.no_wf",cfg.no_wf,"admin_radio_YN_cb"),w3_text("w3-text-black w3-center",'Set "yes" to save Internet bandwidth by preventing <br>the waterfall and spectrum from being displayed.')))+w3_div("w3-container w3-margin-top",w3_input_get("","Reason if disabled","reason_disabled","reason_disabled_cb","","will be shown to users attempting to connect"))+w3_divs("w3-margin-top/w3-container","<label><b>Reason HTML preview</b></label>",w3_div("id-reason-disabled-preview w3-text-black w3-background-pale-aqua","")),n="<hr>"+w3_third("w3-margin-bottom w3-text-teal","w3-container",w3_div("",w3_input_get("","Inactivity time limit (min, 0 = no limit)","inactivity_timeout_mins","admin_int_cb"),w3_div("w3-text-black","Connections from the local network are exempt.")),w3_div("",w3_input_get("","24hr per-IP addr time limit (min, 0 = no limit)","ip_limit_mins","admin_int_cb"),w3_div("w3-text-black","Connections from the local network are exempt.")),w3_div("",w3_input_get("","Time limit exemption password","adm.tlimit_exempt_pwd","w3_string_set_cfg_cb"),w3_div("w3-text-black","Password users can give to override time limits.")));return w3_div("id-control w3-text-teal w3-hide",e+(admin_sdr_mode?t+n:""))}function control_focus(){w3_el("id-reason-disabled-preview").innerHTML=admin_preview_status_box(cfg.reason_disabled)}function server_enabled_cb(e,t,n){var a=0==(t=+t);n||ext_send("SET server_enabled="+(a?1:0)),admin_bool_cb(e,a,n)}function control_user_kick_cb(e,t){ext_send("SET user_kick=-1")}function reason_disabled_cb(e,t){w3_string_set_cfg_cb(e,t),w3_el("id-reason-disabled-preview").innerHTML=admin_preview_status_box(cfg.reason_disabled)}var pending_restart=!1,pending_reboot=!1,pending_power_off=!1;function control_restart_cb(){pending_restart=!0,w3_show_block("id-confirm")}function control_reboot_cb(){pending_reboot=!0,w3_show_block("id-confirm")}function control_power_off_cb(){pending_power_off=!0,w3_show_block("id-confirm")}function control_confirm_cb(){pending_restart?admin_restart_now_cb():pending_reboot?admin_reboot_now_cb():pending_power_off&&(ext_send("SET power_off"),admin_wait_then_reload(0,"Powering off Beagle"))}function control_confirm_cancel_cb(){w3_hide("id-confirm")}var connect={focus:0,timeout:null},connect_dom_sel={NAM:0,DUC:1,PUB:2,SIP:3,REV:4},duc_update_i={0:"5 min",1:"10 min",2:"15 min",3:"30 min",4:"60 min"},duc_update_v={0:5,1:10,2:15,3:30,4:60};function connect_html(){"kiwisdr.example.com"==ext_get_cfg_param("server_url")&&ext_set_cfg_param("cfg.server_url","",!0),"kiwisdr.example.com"==ext_get_cfg_param("sdr_hu_dom_name")&&ext_set_cfg_param("cfg.sdr_hu_dom_name","",!0);var e=0,t=w3_div("w3-valign",'<header class="w3-container w3-yellow"><h5>If you are not able to make an incoming connection from the Internet to your Kiwi because of problems <br> with your router or Internet Service Provider (ISP) then please consider using the KiwiSDR <a href="http://proxy.kiwisdr.com" target="_blank">reverse proxy service</a>.</h5></header>')+"<hr>"+w3_div("id-warn-ip w3-valign w3-margin-B-8 w3-hide",'<header class="w3-container w3-yellow"><h5>Warning: Using an IP address in the Kiwi connect name will work, but if you switch to using a domain name later on<br>this will cause duplicate entries on <a href="https://sdr.hu/?top=kiwi" target="_blank">sdr.hu</a> See <a href="http://kiwisdr.com/quickstart#id-sdr_hu-dup" target="_blank">kiwisdr.com/quickstart</a> for more information.</h5></header>')+w3_divs("w3-container/w3-tspace-8",w3_label("w3-bold","What domain name or IP address will people use to connect to your KiwiSDR?<br>If you are listing on sdr.hu this information will be part of your entry.<br>Click one of the five options below and enter any additional information:<br><br>"),w3_sidenav("id-admin-nav-dom w3-margin-R-16 w3-restart",w3_nav(admin_colors[e++]+" w3-border","Domain Name","connect_dom_nam","connect_dom_nam",cfg.sdr_hu_dom_sel==connect_dom_sel.NAM),w3_nav(admin_colors[e++]+" w3-border","DUC Domain","connect_dom_duc","connect_dom_duc",cfg.sdr_hu_dom_sel==connect_dom_sel.DUC),w3_nav(admin_colors[e++]+" w3-border","Reverse Proxy","connect_dom_rev","connect_dom_rev",cfg.sdr_hu_dom_sel==connect_dom_sel.REV),w3_nav(admin_colors[e++]+" w3-border","Public IP","connect_dom_pub","connect_dom_pub",cfg.sdr_hu_dom_sel==connect_dom_sel.PUB),w3_nav(admin_colors[e++]+" w3-border","Specified IP","connect_dom_sip","connect_dom_sip",cfg.sdr_hu_dom_sel==connect_dom_sel.SIP)),w3_divs("w3-padding-L-16/w3-padding-T-1",w3_div("w3-show-inline-block|width:70%;",w3_input_get("","","sdr_hu_dom_name","connect_dom_name_cb","","Enter domain name that you will point to Kiwi public IP address, e.g. kiwisdr.my_domain.com (don't include port number)")),w3_div("id-connect-duc-dom w3-padding-TB-8"),w3_div("id-connect-rev-dom w3-padding-TB-8"),w3_div("id-connect-pub-ip w3-padding-TB-8"),w3_div("w3-show-inline-block|width:70%;",w3_input_get("","","sdr_hu_dom_ip","connect_dom_ip_cb","","Enter known public IP address of the Kiwi (don't include port number)"))),w3_div("w3-margin-T-16",w3_label("id-connect-url-text-label w3-show-inline-block w3-margin-R-16 w3-text-teal")+w3_div("id-connect-url w3-show-inline-block w3-text-black w3-background-pale-aqua"))),n="<hr>"+w3_div("w3-container w3-text-teal|width:80%",w3_input_get("","Next Kiwi URL redirect","adm.url_redirect","connect_url_redirect_cb"),w3_div("w3-text-black",'Use this setting to get multiple Kiwis to respond to a single URL.<br>When all the channels of this Kiwi are busy further connection attempts will be redirected to the above URL.<br>Example: Your Kiwi is known as "mykiwi.com:8073". Configure another Kiwi to use port 8074 and be known as "mykiwi.com:8074".<br>On the port 8073 Kiwi set the above field to "http://mykiwi.com:8074".<br>On the port 8074 Kiwi leave the above field blank.<br>Configure the port 8074 Kiwi as normal (i.e. router port open, dynamic DNS, proxy etc.)')),a="<hr>"+w3_divs("/w3-tspace-8",w3_div("w3-container w3-valign",'<header class="w3-container w3-yellow"><h6>Please read these instructions before use: <a href="http://kiwisdr.com/quickstart/index.html#id-net-duc" target="_blank">dynamic DNS update client (DUC)</a></h6></header>'),w3_col_percent("w3-text-teal/w3-container",w3_div("w3-text-teal w3-bold","Dynamic DNS update client (DUC) configuration"),50,w3_div("w3-text-teal w3-bold w3-center w3-light-grey","Account at noip.com"),50),w3_col_percent("w3-text-teal/w3-container",w3_div(),50,w3_input_get("","Username or email","adm.duc_user","w3_string_set_cfg_cb","","required"),25,w3_input_get("","Password","adm.duc_pass","w3_string_set_cfg_cb","","required"),25),w3_col_percent("w3-text-teal/w3-container",w3_div("w3-center","<b>Enable DUC at startup?</b><br>"+w3_switch("w3-margin-T-8","Yes","No","adm.duc_enable",adm.duc_enable,"connect_DUC_enabled_cb")),20,w3_div("w3-center",w3_select("","Update","","adm.duc_update",adm.duc_update,duc_update_i,"admin_select_cb")),10,w3_div("w3-center w3-tspace-8",w3_button("w3-aqua","Click to (re)start DUC","connect_DUC_start_cb"),w3_div("w3-text-black","After changing username or password click to test changes.")),20,w3_input_get("","Host","adm.duc_host","connect_DUC_host_cb","","required"),50),w3_div("w3-container",w3_label("w3-show-inline-block w3-margin-R-16 w3-text-teal","Status:")+w3_div("id-net-duc-status w3-show-inline-block w3-text-black w3-background-pale-aqua",""))),i="<hr>"+w3_divs("/w3-tspace-8",w3_div("w3-container w3-valign",'<header class="w3-container w3-yellow"><h6>Please read these instructions before use: <a href="http://proxy.kiwisdr.com" target="_blank">reverse proxy service</a></h6></header>'),w3_col_percent("w3-text-teal/w3-container",w3_div("w3-text-teal w3-bold","Reverse proxy configuration"),50,w3_div("w3-text-teal w3-bold w3-center w3-light-grey","Proxy information for kiwisdr.com"),50),w3_col_percent("w3-text-teal/w3-container",w3_div(),50,w3_input_get("","User key (see instructions)","adm.rev_user","w3_string_set_cfg_cb","","required"),50),w3_col_percent("w3-text-teal/w3-container",w3_div("w3-center w3-tspace-8",w3_button("w3-aqua","Click to (re)register","connect_rev_register_cb"),w3_div("w3-text-black","After changing user key or<br>host name click to register proxy.")),50,w3_div("",w3_div("w3-show-inline-block|width:60%;",w3_input_get("","Host name (your choice, see instructions)","adm.rev_host","connect_rev_host_cb","","required"))+w3_div("id-connect-rev-url w3-show-inline-block",".proxy.kiwisdr.com")),50),w3_div("w3-container",w3_label("w3-show-inline-block w3-margin-R-16 w3-text-teal","Status:")+w3_div("id-connect-rev-status w3-show-inline-block w3-text-black w3-background-pale-aqua","")))+"<hr>";return w3_div("id-connect w3-text-teal w3-hide",t+n+a+i)}function connect_focus(){connect.focus=1,connect_update_url(),ext_send("SET DUC_status_query"),cfg.sdr_hu_dom_sel==connect_dom_sel.REV&&ext_send("SET rev_status_query")}function connect_blur(){connect.focus=0}var connect_rev_server=-1;function connect_update_url(){var e,t;t=(e=adm.duc_host&&""!=adm.duc_host)?"w3-background-pale-aqua":"w3-override-yellow",w3_el("id-connect-duc-dom").innerHTML="Use domain name from DUC configuration below: "+w3_div("w3-show-inline-block w3-text-black "+t,e?adm.duc_host:"(none currently set)");var n=".proxy"+(-1==connect_rev_server?"":connect_rev_server)+".kiwisdr.com";t=(e=adm.rev_host&&""!=adm.rev_host)?"w3-background-pale-aqua":"w3-override-yellow",w3_el("id-connect-rev-dom").innerHTML="Use domain name from reverse proxy configuration below: "+w3_div("w3-show-inline-block w3-text-black "+t,e?adm.rev_host+n:"(none currently set)"),w3_el("id-connect-rev-url").innerHTML=n,t=(e=config_net.pub_ip)?"w3-background-pale-aqua":"w3-override-yellow",w3_el("id-connect-pub-ip").innerHTML="Public IP address detected by Kiwi: "+w3_div("w3-show-inline-block w3-text-black "+t,e?config_net.pub_ip:"(no public IP address detected)");var a=decodeURIComponent(cfg.server_url),i=a;cfg.sdr_hu_dom_sel!=connect_dom_sel.REV?(i+=":"+adm.port_ext,w3_set_label("Based on above selection, and external port from Network tab, the URL to connect to your Kiwi is:","connect-url-text")):(i+=":8073",8073!=adm.port_ext&&(i+=" (proxy always uses port 8073 even though your external port is "+adm.port_ext+")"),w3_set_label("Based on the above selection the URL to connect to your Kiwi is:","connect-url-text")),e=""!=a,w3_color("id-connect-url",null,e?"hsl(180, 100%, 95%)":"#ffeb3b"),w3_el("id-connect-url").innerHTML=e?"http://"+i:"(incomplete information)"}function connect_dom_nam_focus(){console.log("connect_dom_nam_focus server_url="+cfg.sdr_hu_dom_name),ext_set_cfg_param("cfg.server_url",cfg.sdr_hu_dom_name,!0),ext_set_cfg_param("cfg.sdr_hu_dom_sel",connect_dom_sel.NAM,!0),connect_update_url(),w3_hide("id-warn-ip")}function connect_dom_duc_focus(){console.log("connect_dom_duc_focus server_url="+adm.duc_host),ext_set_cfg_param("cfg.server_url",adm.duc_host,!0),ext_set_cfg_param("cfg.sdr_hu_dom_sel",connect_dom_sel.DUC,!0),connect_update_url(),w3_hide("id-warn-ip")}function connect_dom_rev_focus(){var e=-1==connect_rev_server?"":connect_rev_server,t=""==adm.rev_host?"":adm.rev_host+".proxy"+e+".kiwisdr.com";console.log("connect_dom_rev_focus server_url="+t),ext_set_cfg_param("cfg.server_url",t,!0),ext_set_cfg_param("cfg.sdr_hu_dom_sel",connect_dom_sel.REV,!0),connect_update_url(),w3_hide("id-warn-ip")}function connect_dom_pub_focus(){console.log("connect_dom_pub_focus server_url="+config_net.pub_ip),ext_set_cfg_param("cfg.server_url",config_net.pub_ip,!0),ext_set_cfg_param("cfg.sdr_hu_dom_sel",connect_dom_sel.PUB,!0),connect_update_url()}function connect_dom_sip_focus(){console.log("connect_dom_sip_focus server_url="+cfg.sdr_hu_dom_ip),ext_set_cfg_param("cfg.server_url",cfg.sdr_hu_dom_ip,!0),ext_set_cfg_param("cfg.sdr_hu_dom_sel",connect_dom_sel.SIP,!0),connect_update_url()}function connect_dom_name_cb(e,t,n){connect_remove_port(e,t,n),cfg.sdr_hu_dom_sel==connect_dom_sel.NAM&&connect_dom_nam_focus()}function connect_dom_ip_cb(e,t,n){connect_remove_port(e,t,n),cfg.sdr_hu_dom_sel==connect_dom_sel.SIP&&connect_dom_sip_focus()}function connect_remove_port(e,t,n){var a=t.length,i=1,_=2,o=3,r=0;t=t.replace("http://","");for(var s=a-1;s>=0;s--){var l=t.charAt(s);if(l>="0"&&l<="9")r=i;else{if(":"==l){r==i&&(r=o);break}if(r=_,"]"==l)break}}r==o&&(t=t.substr(0,s)),w3_string_set_cfg_cb(e,t,n),admin_set_decoded_value(e)}function connect_url_redirect_cb(e,t,n){""==t||t.startsWith("http://")||(t="http://"+t),w3_string_set_cfg_cb(e,t,n),w3_set_value("id-"+e,t)}function connect_DUC_enabled_cb(e,t,n){admin_bool_cb(e,0==(t=+t),n)}function connect_DUC_start_cb(e,t){var n="-u "+sq(decodeURIComponent(adm.duc_user))+" -p "+sq(decodeURIComponent(adm.duc_pass))+" -H "+sq(decodeURIComponent(adm.duc_host))+" -U "+duc_update_v[adm.duc_update];console.log("start DUC: "+n),w3_innerHTML("id-net-duc-status",""),ext_send("SET DUC_start args="+encodeURIComponent(n))}function connect_DUC_host_cb(e,t,n){w3_string_set_cfg_cb(e,t,n),cfg.sdr_hu_dom_sel==connect_dom_sel.DUC?connect_dom_duc_focus():connect_update_url()}function connect_DUC_status_cb(e){var t;switch(e=+e,console.log("DUC_status="+e),e){case 0:t="DUC started successfully";break;case 100:t="Incorrect username or password";break;case 101:t="No hosts defined on your account at noip.com; please correct and retry";break;case 102:t="Please specify a host";break;case 103:t="Host given isn't defined on your account at noip.com; please correct and retry";break;case 300:t="DUC start failed";break;case 301:t="DUC enabled and running";break;default:t="DUC internal error: "+e}w3_el("id-net-duc-status").innerHTML=t}function connect_rev_register_cb(e,t){if(""==adm.rev_user||""==adm.rev_host)return connect_rev_status_cb(100);kiwi_clearTimeout(connect.timeout),w3_el("id-connect-rev-status").innerHTML="";var n="user="+adm.rev_user+" host="+adm.rev_host;console.log("start rev: "+n),ext_send("SET rev_register "+n)}function connect_rev_host_cb(e,t,n){w3_string_set_cfg_cb(e,t,n),cfg.sdr_hu_dom_sel==connect_dom_sel.REV?connect_dom_rev_focus():connect_update_url()}function connect_rev_status_cb(e){if(connect.focus){var t;switch(e=+e,console.log("rev_status="+e),e>=0&&e<=99&&cfg.sdr_hu_dom_sel==connect_dom_sel.REV&&connect_dom_rev_focus(),e){case 0:t="Existing account, registration successful";break;case 1:t="New account, registration successful";break;case 2:t="Updating host name, registration successful";break;case 100:t="User key or host name field blank";break;case 101:t="User key invalid. Did you email your user/API key to support@kiwisdr.com as per the instructions?";break;case 102:t="Host name already in use; please choose another and retry";break;case 103:t="Invalid characters in user key or host name field (use a-z, 0-9, -, _)";break;case 200:t="Reverse proxy enabled and running";break;case 201:t="Reverse proxy enabled and pending";break;case 900:t="Problem contacting proxy.kiwisdr.com; please check Internet connection";break;default:t="Reverse proxy internal error: "+e}w3_el("id-connect-rev-status").innerHTML=t,201==e&&(connect.timeout=setTimeout(function(){ext_send("SET rev_status_query")},5e3))}}function update_html(){return w3_div("id-update w3-hide","<hr>"+w3_div("id-msg-update w3-container")+"<hr>"+w3_div("w3-margin-bottom",w3_half("w3-container","w3-text-teal",w3_div("","<b>Automatically check for software updates?</b> "+w3_switch("","Yes","No","adm.update_check",adm.update_check,"admin_radio_YN_cb")),w3_div("","<b>Automatically install software updates?</b> "+w3_switch("","Yes","No","adm.update_install",adm.update_install,"admin_radio_YN_cb"))),w3_half("w3-container","w3-text-teal",w3_div("",w3_select("w3-label-inline","After update","","adm.update_restart",adm.update_restart,update_restart_u,"admin_select_cb")),""))+"<hr>"+w3_half("w3-container","w3-text-teal",w3_div("w3-valign","<b>Check for software update </b> "+w3_button("w3-aqua w3-margin","Check now","update_check_now_cb")),w3_div("w3-valign","<b>Force software build </b> "+w3_button("w3-aqua w3-margin","Build now","update_build_now_cb")))+"<hr>"+w3_half("w3-margin-bottom w3-text-teal w3-restart","w3-container",w3_divs("w3-tspace-8",w3_div("","<b>Disable recent changes?</b>"),w3_switch("","Yes","No","disable_recent_changes",cfg.disable_recent_changes,"admin_radio_YN_cb"),w3_text("w3-text-black","Currently:<br><ul><li>The Firefox audio hang workaround.</li></ul>")),"")+"<hr>"+w3_div("w3-container","TODO: alt github name")+"<hr>")}var update_restart_u={0:"restart server",1:"reboot Beagle"};function update_check_now_cb(e,t){ext_send("SET force_check=1 force_build=0"),w3_el("msg-update").innerHTML=w3_icon("","fa-refresh fa-spin",20)}function update_build_now_cb(e,t){ext_send("SET force_check=1 force_build=1"),0==adm.update_restart?w3_show_block("id-build-restart"):w3_show_block("id-build-reboot")}function backup_html(){return w3_div("id-backup w3-hide","<hr>",w3_div("w3-section w3-text-teal w3-bold","Backup complete contents of KiwiSDR by writing Beagle filesystem onto a user provided micro-SD card"),w3_div("w3-container w3-text w3-red","WARNING: after SD card is written immediately remove from Beagle.<br>Otherwise on next reboot Beagle will be re-flashed from SD card."),"<hr>",w3_third("w3-container","w3-valign",w3_button("w3-aqua w3-margin","Click to write micro-SD card","backup_sd_write"),w3_div("",w3_div("id-progress-container w3-progress-container w3-round-large w3-gray w3-show-inline-block",w3_div("id-progress w3-progressbar w3-round-large w3-light-green w3-width-zero",w3_div("id-progress-text w3-container"))),w3_div("w3-margin-T-8",w3_div("id-progress-time w3-show-inline-block")+w3_div("id-progress-icon w3-show-inline-block w3-margin-left"))),w3_div("id-sd-status class-sd-status")),"<hr>",w3_div("id-output-msg w3-container w3-text-output w3-scroll-down w3-small w3-margin-B-16"))}function backup_focus(){w3_el("id-progress-container").style.width=px(300),w3_el("id-output-msg").style.height=px(300)}var sd_progress,backup_sd_interval,sd_progress_max=240,backup_refresh_icon=w3_icon("","fa-refresh fa-spin",20);function backup_sd_write(e,t){w3_el("id-sd-status").innerHTML="writing the micro-SD card...",w3_el("id-progress-text").innerHTML=w3_el("id-progress").style.width="0%",sd_progress=-1,backup_sd_progress(),backup_sd_interval=setInterval(backup_sd_progress,1e3),w3_el("id-progress-icon").innerHTML=backup_refresh_icon,ext_send("SET microSD_write")}function backup_sd_progress(){var e=(++sd_progress/sd_progress_max*100).toFixed(0);e<=95&&(w3_el("id-progress-text").innerHTML=w3_el("id-progress").style.width=e+"%");var t=(sd_progress%60).toFixed(0).leadingZeros(2),n=Math.floor(sd_progress/60).toFixed(0);w3_el("id-progress-time").innerHTML=n+":"+t}function backup_sd_write_done(e){var t=w3_el("id-sd-status"),n=e?"FAILED error "+e.toString():"WORKED";1==e&&(n+="<br>No SD card inserted?"),15==e&&(n+="<br>rsync I/O error"),t.innerHTML=n,t.style.color=e?"red":"lime",e||(w3_el("id-progress-text").innerHTML=w3_el("id-progress").style.width="100%"),kiwi_clearInterval(backup_sd_interval),w3_el("id-progress-icon").innerHTML=""}var network={auto_nat_color:null,ip_blacklist_input_prev:null},ethernet_speed_i={0:"100 Mbps",1:"10 Mbps"};function network_html(){var e=ext_get_cfg_param("adm.ip_address.commit_use_static");console.log("commit_use_static="+e),null==e&&(e=!1),ext_set_cfg_param("adm.ip_address.use_static",e,EXT_SAVE),w3_switch_set_value("adm.ip_address.use_static",e?w3_SWITCH_NO_IDX:w3_SWITCH_YES_IDX);var t=w3_div("id-net-auto-nat-msg w3-valign w3-hide")+w3_div("id-net-need-update w3-valign w3-margin-T-8 w3-hide",w3_button("w3-yellow","Are you sure? Click to update interface DHCP/static IP configuration","network_dhcp_static_update_cb"))+"<hr>"+w3_div("id-net-reboot",w3_col_percent("w3-container w3-margin-bottom w3-text-teal/w3-hspace-16",w3_div("w3-restart",w3_input_get("","Internal port","adm.port","admin_int_cb")),10,w3_div("w3-restart",w3_input_get("","External port","adm.port_ext","admin_int_cb")),10,w3_divs("w3-center/w3-restart","<b>Auto add NAT rule<br>on firewall / router?</b><br>",w3_switch("w3-margin-T-8","Yes","No","adm.auto_add_nat",adm.auto_add_nat,"admin_radio_YN_cb")),20,w3_div("w3-center","<b>IP address<br>(only static IPv4 for now)</b><br> "+w3_switch_get_param("w3-margin-T-8","DHCP","Static","adm.ip_address.use_static",0,!1,"network_use_static_cb")),20,w3_divs("w3-center/",w3_select("","Ethernet interface speed","","ethernet_speed",cfg.ethernet_speed,ethernet_speed_i,"network_ethernet_speed"),w3_div("w3-text-black","Select 10 Mbps to reduce Ethernet spurs. <br> Try changing while looking at waterfall.")),30),w3_div("id-net-static w3-hide",w3_div("",w3_third("w3-margin-B-8 w3-text-teal","w3-container",w3_input_get("","IP address (n.n.n.n where n = 0..255)","adm.ip_address.ip","network_ip_address_cb",""),w3_input_get("","Netmask (n.n.n.n where n = 0..255)","adm.ip_address.netmask","network_netmask_cb",""),w3_input_get("","Gateway (n.n.n.n where n = 0..255)","adm.ip_address.gateway","network_gw_address_cb","")),w3_third("w3-margin-B-8 w3-text-teal","w3-container",w3_div("id-network-check-ip w3-green"),w3_div("id-network-check-nm w3-green"),w3_div("id-network-check-gw w3-green")),w3_third("w3-valign w3-margin-bottom w3-text-teal","w3-container",w3_input_get("","DNS-1 (n.n.n.n where n = 0..255)","adm.ip_address.dns1","w3_string_set_cfg_cb",""),w3_input_get("","DNS-2 (n.n.n.n where n = 0..255)","adm.ip_address.dns2","w3_string_set_cfg_cb",""),w3_div("",w3_label("","<br>")+w3_button("w3-show-inline w3-aqua","Use Google public DNS","net_google_dns_cb")))),w3_text("w3-margin-left w3-text-black","If DNS fields are blank the DNS servers specified by your router's DHCP will be used."))),n="<hr>"+w3_div("id-net-config w3-container")+"<hr>"+w3_half("w3-container","",w3_div("",w3_div("",w3_label("w3-show-inline w3-bold w3-text-teal","Check if your external router port is open:")+w3_button("w3-show-inline w3-aqua|margin-left:10px","Check port open","net_port_open_cb")),'Does kiwisdr.com successfully connect to your Kiwi using these URLs?<br>If both respond "NO" then check the NAT port mapping on your router.<br>If first responds "NO" and second "YES" then domain name of the first<br>isn\'t resolving to the ip address of the second. Check DNS.',w3_div("",w3_label("id-net-check-port-dom-q w3-show-inline-block w3-margin-LR-16 w3-text-teal")+w3_div("id-net-check-port-dom-s w3-show-inline-block w3-text-black w3-background-pale-aqua")),w3_div("",w3_label("id-net-check-port-ip-q w3-show-inline-block w3-margin-LR-16 w3-text-teal")+w3_div("id-net-check-port-ip-s w3-show-inline-block w3-text-black w3-background-pale-aqua"))),w3_div("w3-center",w3_label("w3-bold w3-text-teal","Register this Kiwi on my.kiwisdr.com<br>on each reboot?<br>"),w3_switch("w3-margin-T-8 w3-margin-B-8","Yes","No","adm.my_kiwi",adm.my_kiwi,"admin_radio_YN_cb"),w3_text("w3-block w3-center w3-text-black",'Registering on <a href="http://my.kiwisdr.com" target="_blank">my.kiwisdr.com</a> allows the local ip address of Kiwis <br>to be easily discovered. Set to "no" if you don\'t want your Kiwi <br>sending information to kiwisdr.com. Defaults to "yes".'))),a="<hr>"+w3_div("w3-container w3-text-teal",w3_textarea_get_param("w3-input-any-change|width:100%",w3_inline("",w3_label("w3-show-inline-block w3-bold w3-text-teal","IP address blacklist"),w3_text("w3-text-black|margin-left: 32px",'IP addresses/ranges listed here are blocked from accessing your<br>Kiwi (via Linux iptables). 47.88.219.24/24 is a currently active bot.<br>Use CIDR notation for ranges, e.g. CIDR "ip/24" equivalent to netmask "255.255.255.0"'),w3_div("w3-center|margin-left: 32px","<b>Prevent multiple connections from<br>the same IP address?</b><br>",w3_switch("w3-margin-T-8 w3-margin-B-8","Yes","No","adm.no_dup_ip",adm.no_dup_ip,"admin_radio_YN_cb"))),"adm.ip_blacklist",3,100,"network_ip_blacklist_cb",""),w3_label("w3-show-inline-block w3-margin-R-16 w3-margin-T-8 w3-text-teal","Status:")+w3_div("id-ip-blacklist-status w3-show-inline-block w3-text-black w3-background-pale-aqua",""))+"<hr>"+w3_div("w3-container","TODO: throttle #chan MB/dy GB/mo, hostname")+"<hr>";return setTimeout(function(){network_use_static_cb("adm.ip_address.use_static",ext_get_cfg_param("adm.ip_address.use_static",!1),!0)},500),w3_div("id-network w3-hide",t+n+a)}function network_ip_blacklist_cb(e,t){var n=t.match(/([^,;\s]+)/gm);null==n&&(n=[]);var a="";n.forEach(function(e){a+=e+" "}),a!=network.ip_blacklist_input_prev&&(network.ip_blacklist_input_prev=a,ext_send("SET network_ip_blacklist_clear"),w3_innerHTML("id-ip-blacklist-status","updated"),w3_set_value(e,a),w3_string_set_cfg_cb(e,a),n.forEach(function(e){ext_send("SET network_ip_blacklist="+encodeURIComponent(e))}),ext_send("SET network_ip_blacklist_enable"))}function network_ip_blacklist_status(e,t){console.log("network_ip_blacklist_status status="+e+" ip="+t),0!=e&&w3_innerHTML("id-ip-blacklist-status","ip address error: "+dq(t))}function network_ethernet_speed(e,t,n){t=+t,console.log("network_ethernet_speed path="+e+" idx="+t+" first="+n),n||admin_select_cb(e,t,n)}function network_port_open_init(){var e=cfg.sdr_hu_dom_sel==connect_dom_sel.REV?8073:adm.port_ext;w3_el("id-net-check-port-dom-q").innerHTML=""!=cfg.server_url?"http://"+cfg.server_url+":"+e+" :":'(incomplete information -- on "connect" tab please use a valid setting in menu) :',w3_el("id-net-check-port-ip-q").innerHTML="http://"+config_net.pvt_ip+":"+adm.port_ext+" :",w3_el("id-net-check-port-dom-s").innerHTML="",w3_el("id-net-check-port-ip-s").innerHTML=""}function network_focus(){setTimeout(network_port_open_init,2e3),setInterval(network_auto_nat_status_poll,1e3)}function network_blur(){kiwi_clearInterval(network_auto_nat_status_poll)}function network_auto_nat_status_poll(){ext_send("SET auto_nat_status_poll")}function network_check_port_status_cb(e){if(console.log("network_check_port_status_cb status="+e.toHex()),e<0)w3_el("id-net-check-port-dom-s").innerHTML="Error checking port status",w3_el("id-net-check-port-ip-s").innerHTML="Error checking port status";else{var t=240&e,n=15&e;w3_el("id-net-check-port-dom-s").innerHTML=t?"NO":"YES",w3_el("id-net-check-port-ip-s").innerHTML=n?"NO":"YES"}}function net_port_open_cb(){w3_el("id-net-check-port-dom-s").innerHTML=w3_icon("","fa-refresh fa-spin",20),w3_el("id-net-check-port-ip-s").innerHTML=w3_icon("","fa-refresh fa-spin",20),ext_send("SET check_port_open")}function network_dhcp_static_update_cb(e,t){var n=adm.ip_address.use_static;n?(ext_send("SET static_ip="+kiwi_ip_str(network_ip)+" static_nm="+kiwi_ip_str(network_nm)+" static_gw="+kiwi_ip_str(network_gw)),ext_send("SET dns dns1=x"+encodeURIComponent(adm.ip_address.dns1)+" dns2=x"+encodeURIComponent(adm.ip_address.dns2))):ext_send("SET use_DHCP"),ext_set_cfg_param("adm.ip_address.commit_use_static",n,EXT_SAVE),w3_hide("id-net-need-update"),w3_reboot_cb()}function network_use_static_cb(e,t,n){var a=0==(t=+t);a?w3_hide("id-net-static"):w3_show_block("id-net-static"),n?(network_ip_address_cb("adm.ip_address.ip",adm.ip_address.ip,!0),network_netmask_cb("adm.ip_address.netmask",adm.ip_address.netmask,!0),network_gw_address_cb("adm.ip_address.gateway",adm.ip_address.gateway,!0)):a?w3_show_block("id-net-need-update"):network_show_update(!1),admin_bool_cb(e,a?0:1,n)}function network_ip_nm_check(e,t){var n,a,i,_,o=new RegExp("^([0-9]*).([0-9]*).([0-9]*).([0-9]*)$").exec(e);return null!=o&&(n=(n=parseInt(o[1]))>255?Math.NaN:n,a=(a=parseInt(o[2]))>255?Math.NaN:a,i=(i=parseInt(o[3]))>255?Math.NaN:i,_=(_=parseInt(o[4]))>255?Math.NaN:_),null==o||isNaN(n)||isNaN(a)||isNaN(i)||isNaN(_)?t.ok=!1:(t.ok=!0,t.a=n,t.b=a,t.c=i,t.d=_),t.ok}function network_show_update(e){!e&&network_ip.ok&&network_nm.ok&&network_gw.ok?w3_show_block("id-net-need-update"):w3_hide("id-net-need-update")}function network_show_check(e,t,n,a,i,_,o){if(""!=a){var r=w3_el(e),s=network_ip_nm_check(a,i),l=!0;1==s&&null!=o&&(l=o(a,i)),0==s||0==l?(r.innerHTML="bad "+t+" entered",w3_remove(r,"w3-green"),w3_add(r,"w3-red")):(r.innerHTML=t+" okay, check: "+i.a+"."+i.b+"."+i.c+"."+i.d,w3_remove(r,"w3-red"),w3_add(r,"w3-green"),w3_string_set_cfg_cb(n,a,_)),network_show_update(_)}}function network_ip_address_cb(e,t,n){network_show_check("network-check-ip","IP address",e,t,network_ip,n)}function network_netmask_cb(e,t,n){network_nm.nm=-1,network_show_check("network-check-nm","netmask",e,t,network_nm,n,function(e,t){var n=kiwi_inet4_d2h(e);t.nm=0;for(var a=0;a<32;a++)if(n&1<<a)for(t.nm=32-a;a<32;a++)if(0==(n&1<<a))return t.nm=-1,t.ok=!1,!1;return t.ok=!0,!0}),-1!=network_nm.nm&&(w3_el("network-check-nm").innerHTML+=" (/"+network_nm.nm+")")}function network_gw_address_cb(e,t,n){network_show_check("network-check-gw","gateway",e,t,network_gw,n)}function net_google_dns_cb(e,t){w3_string_set_cfg_cb("adm.ip_address.dns1","8.8.8.8"),w3_set_value("adm.ip_address.dns1","8.8.8.8"),w3_string_set_cfg_cb("adm.ip_address.dns2","8.8.4.4"),w3_set_value("adm.ip_address.dns2","8.8.4.4")}network_ip={ok:!1,a:null,b:null,c:null,d:null},network_nm={ok:!1,a:null,b:null,c:null,d:null},network_gw={ok:!1,a:null,b:null,c:null,d:null};var gps_interval,gps_azel_interval,pin={green:w3_div("cl-leaflet-marker cl-legend-marker|background-color:lime"),red:w3_div("cl-leaflet-marker cl-legend-marker|background-color:red"),yellow:w3_div("cl-leaflet-marker cl-legend-marker|background-color:yellow")},_gps={leaflet:!0,gps_map_loaded:!1,pkgs_maps_js:["pkgs_maps/pkgs_maps.js","pkgs_maps/pkgs_maps.css"],gmap_js:["http://maps.googleapis.com/maps/api/js?key="],RSSI:0,AZEL:1,POS:2,MAP:3,IQ:4,IQ_data:null,iq_ch:0,map_init:0,map_needs_height:0,map_locate:0,map_mkr:[],legend_sep:w3_inline("",pin.green,"Navstar/QZSS only",pin.yellow,"Galileo only",pin.red,"all sats"),legend_all:w3_inline("",pin.green,"all sats (Navstar/QZSS/Galileo)")},E1B_offset_i={0:"-1",1:"-3/4",2:"-1/2",3:"-1/4",4:"0",5:"+1/4",6:"+1/2",7:"+3/4",8:"+1"};function gps_html(){return w3_div("id-gps w3-hide|line-height:1.5",w3_inline("w3-valign w3-halign-space-between w3-margin-T-16/",w3_div("w3-valign w3-text-teal",w3_text("w3-text-teal w3-bold w3-small","Acquire"),w3_div("w3-flex-col w3-valign-start w3-margin-L-4",w3_checkbox("w3-label-inline w3-label-not-bold w3-small/w3-small","Navstar","adm.acq_Navstar",adm.acq_Navstar,"gps_acq_cb"),w3_inline("",w3_checkbox("w3-label-inline w3-label-not-bold w3-small/w3-small","QZSS","adm.acq_QZSS",adm.acq_QZSS,"gps_acq_cb"),w3_checkbox("w3-label-inline w3-label-not-bold w3-small w3-margin-left/w3-small/","Priority","adm.QZSS_prio",adm.QZSS_prio,"gps_acq_cb")),w3_checkbox("w3-label-inline w3-label-not-bold w3-small/w3-small","Galileo","adm.acq_Galileo",adm.acq_Galileo,"gps_acq_cb"))),w3_div("w3-valign w3-text-teal",w3_checkbox("w3-label-inline w3-small/w3-small","Acquire<br>if Kiwi<br>busy? [n]","adm.always_acq_gps",adm.always_acq_gps,"w3_bool_set_cfg_cb")),w3_div("w3-valign w3-text-teal",w3_checkbox("w3-label-inline w3-small/w3-small","Include<br>alerted sats in<br>solutions? [n]","adm.include_alert_gps",adm.include_alert_gps,"w3_bool_set_cfg_cb")),w3_div("w3-valign w3-text-teal",w3_checkbox("w3-label-inline w3-small/w3-small","Include<br>Galileo in<br>solutions? [y]","adm.include_E1B",adm.include_E1B,"w3_bool_set_cfg_cb")),w3_div("w3-valign w3-text-teal",w3_checkbox("w3-label-inline w3-small/w3-small","Use<br>Kalman<br>filter? [y]","adm.use_kalman_position_solver",adm.use_kalman_position_solver,"w3_bool_set_cfg_cb")),w3_div("w3-valign w3-hcenter w3-text-teal",w3_div("w3-margin-right","<b>Select<br>Graph</b>")+w3_radio_button("w3-margin-R-4","RSSI","adm.rssi_azel_iq",adm.rssi_azel_iq==_gps.RSSI,"gps_graph_cb"),w3_radio_button("w3-margin-R-4","Az/El","adm.rssi_azel_iq",adm.rssi_azel_iq==_gps.AZEL,"gps_graph_cb"),w3_radio_button("w3-margin-R-4","Pos","adm.rssi_azel_iq",adm.rssi_azel_iq==_gps.POS,"gps_graph_cb"),w3_radio_button("w3-margin-R-4","Map","adm.rssi_azel_iq",adm.rssi_azel_iq==_gps.MAP,"gps_graph_cb"),w3_radio_button("","IQ","adm.rssi_azel_iq",adm.rssi_azel_iq==_gps.IQ,"gps_graph_cb")),w3_divs("w3-hcenter w3-text-teal/w3-center",w3_div("id-gps-pos-scale w3-center w3-hide w3-small","<b>Scale</b> ",w3_select("w3-margin-L-5|color:red","","","_gps.pos_scale",9,"1:20","gps_pos_scale_cb")),w3_div("id-gps-iq-ch w3-center w3-hide w3-small","<b>Chan</b> ",w3_select("w3-margin-L-5|color:red","","","_gps.iq_ch",0,"1:12","gps_iq_ch_cb"))))+w3_div("w3-valign",w3_div("id-gps-loading-maps w3-container w3-section w3-card-8 w3-round-xlarge w3-pale-blue|width:100%","loading maps..."),w3_div("id-gps-channels w3-container w3-section w3-card-8 w3-round-xlarge w3-pale-blue|width:100%",w3_table("id-gps-ch w3-table-6-8 w3-striped")),w3_div("id-gps-azel-container w3-hide",w3_div("w3-hcenter w3-relative",'<img id="id-gps-azel-graph" src="gfx/gpsEarth.png" width="400" height="400" style="position:absolute; top:-2px" />','<canvas id="id-gps-azel-canvas" width="400" height="400" style="position:absolute"></canvas>')),w3_div("id-gps-map-container",w3_div('||id="id-gps-map"',""),w3_div("id-gps-map-legend w3-small w3-margin-left","")))+w3_div("w3-container w3-section w3-card-8 w3-round-xlarge w3-pale-blue",w3_table("id-gps-info w3-table-6-8")))}function gps_acq_cb(e,t,n){n||(console.log("gps_acq_cb path="+e+" val="+t),w3_bool_set_cfg_cb(e,t))}function gps_graph_cb(e,t){admin_int_cb(e,t=+t),ext_send("SET gps_IQ_data_ch="+(t==_gps.IQ?_gps.iq_ch:0)),w3_show_hide("id-gps-pos-scale",t==_gps.POS),w3_show_hide("id-gps-iq-ch",t==_gps.IQ);var n=w3_el("id-gps-channels");t==_gps.AZEL||t==_gps.MAP?(n.style.width="65%",w3_el("id-gps-azel-container").style.width="35%",w3_el("id-gps-map-container").style.width="35%",_gps.map_needs_height=1):n.style.width="100%",w3_show_hide("id-gps-azel-container",t==_gps.AZEL),w3_show_hide("id-gps-map-container",t==_gps.MAP),gps_update_admin_cb(),t==_gps.AZEL&&ext_send("SET gps_az_el_history")}function gps_E1B_offset_cb(e,t,n){-1==(t=+t)&&(t=4)}function gps_pos_scale_cb(e,t,n){(-1==(t=+t)||n)&&(t=9),_gps.pos_scale=t+1}function gps_iq_ch_cb(e,t,n){(-1==(t=+t)||n)&&(t=0),_gps.iq_ch=t+1,ext_send("SET gps_IQ_data_ch="+_gps.iq_ch),_gps.IQ_data=null}function gps_gain_cb(e,t,n){(-1==(t=+t)||n)&&(t=0),_gps.gain=t+1,ext_send("SET gps_gain="+_gps.gain)}var gps_has_lat_lon,gps_nsamp,gps_nsats,gps_now,gps_prn,gps_az_el_history_running=!1;function gps_schedule_azel(){0==gps_az_el_history_running&&(gps_az_el_history_running=!0,ext_send("SET gps_az_el_history"),gps_azel_interval=setInterval(function(){ext_send("SET gps_az_el_history")},6e4))}function gps_focus(e){_gps.gps_map_loaded?gps_focus2(e):(kiwi_load_js(_gps.leaflet?_gps.pkgs_maps_js:_gps.gmap_js,"gps_focus2"),_gps.gps_map_loaded=!0)}function gps_focus2(e){w3_hide("id-gps-loading-maps"),gps_schedule_azel(),ext_send("SET gps_update"),gps_interval=setInterval(function(){ext_send("SET gps_update")},1e3),gps_graph_cb("adm.rssi_azel_iq",adm.rssi_azel_iq)}function gps_blur(e){kiwi_clearInterval(gps_interval),kiwi_clearInterval(gps_azel_interval),gps_az_el_history_running=!1,ext_send("SET gps_IQ_data_ch=0")}var gps_az=null,gps_el=null,gps_qzs3_az=0,gps_qzs3_el=0,gps_shadow_map=null;function gps_az_el_history_cb(e){gps_nsats=e.n_sats,gps_nsamp=e.n_samp,gps_now=e.now,gps_prn=new Array(gps_nsats),(gps_az=new Array(gps_nsamp*gps_nsats)).fill(0),(gps_el=new Array(gps_nsamp*gps_nsats)).fill(0);for(var t=e.sat_seen.length,n=0;n<t;n++){var a=e.sat_seen[n];gps_prn[a]=e.prn_seen[n]}for(var i=0;i<gps_nsamp;i++)for(n=0;n<t;n++){var _=i*t+n,o=e.az[_],r=e.el[_],s=(a=e.sat_seen[n],i*gps_nsats+a);gps_az[s]=o,gps_el[s]=r}gps_qzs3_az=e.qzs3.az,gps_qzs3_el=e.qzs3.el,gps_shadow_map=e.shadow_map.slice(),gps_update_azel()}var gps_canvas,SUBFRAMES=5,max_rssi=1,refresh_icon=w3_icon("","fa-refresh",20),sub_colors=["w3-red","w3-green","w3-blue","w3-yellow","w3-orange"],gps_last_good_el=[],gps_rssi_azel_iq_s=["RSSI","Az/el","Position solution map","Map","LO PLL IQ"];function gps_update_admin_cb(){if(gps){var e;e=w3_table_row("",w3_table_heads("w3-right-align","chan","acq","&nbsp;PRN","SNR","eph age","hold","wdog"),w3_table_heads("w3-center","status","subframe"),w3_table_heads("w3-right-align","ov","az","el"),adm.rssi_azel_iq==_gps.RSSI?null:w3_table_heads("w3-right-align","RSSI"),adm.rssi_azel_iq==_gps.AZEL||adm.rssi_azel_iq==_gps.MAP?null:w3_table_heads("w3-center|width:35%",(adm.rssi_azel_iq==_gps.IQ&&_gps.iq_ch?"Channel "+_gps.iq_ch+" ":"")+gps_rssi_azel_iq_s[adm.rssi_azel_iq]));for(var t=0;t<gps.ch.length;t++)e+=w3_table_row("id-gps-ch-"+t,"");w3_el("id-gps-ch").innerHTML=e;var n=0==gps.stype?"w3-green":1==gps.stype?"w3-yellow":"w3-red";for(t=0;t<gps.ch.length;t++){var a=gps.ch[t];a.rssi>max_rssi&&(max_rssi=a.rssi);var i=0,_="";-1!=a.prn&&("N"!=a.prn_s&&(_=a.prn_s),i=a.prn);for(var o=n,r=a.alert?"A":1==a.ACF?"+":2==a.ACF?"-":"U",s=w3_table_cells("w3-right-align",t+1)+w3_table_cells("w3-center",t==gps.FFTch?refresh_icon:"")+w3_table_cells("w3-right-align",i?_+i:"",a.snr?a.snr:"")+w3_table_cells("w3-right-align"+(a.old?" w3-text-red w3-bold":""),a.age)+w3_table_cells("w3-right-align",a.hold?a.hold:"",a.rssi?a.wdog:"")+w3_table_cells("w3-center",'<span class="w3-tag '+(a.alert?1==a.alert?"w3-red":"w3-green":a.unlock?"w3-yellow":"w3-white")+'">'+r+'</span><span class="w3-tag '+(a.parity?"w3-yellow":"w3-white")+'">P</span><span class="w3-tag '+(a.soln?o:"w3-white")+'">S</span>'),l="",c=SUBFRAMES-1;c>=0;c--){l+='<span class="w3-tag '+(a.sub_renew&1<<c?"w3-grey":a.sub&1<<c?sub_colors[c]:"w3-white")+'">'+(c+1)+"</span>"}if(s+=w3_table_cells("w3-center",l),s+=w3_table_cells("w3-right-align",a.novfl?a.novfl:"",a.el?a.az:"",a.el?a.el:"",adm.rssi_azel_iq==_gps.RSSI?null:a.rssi?a.rssi:""),adm.rssi_azel_iq==_gps.RSSI){var d=(a.rssi/max_rssi*100).toFixed(0);s+=w3_table_cells("",w3_div("w3-progress-container w3-round-xlarge w3-white",w3_div("w3-progressbar w3-round-xlarge w3-light-green|width:"+d+"%",w3_div("w3-container w3-text-white",a.rssi))))}else adm.rssi_azel_iq==_gps.RSSI&&adm.rssi_azel_iq==_gps.AZEL&&adm.rssi_azel_iq==_gps.MAP||0==t&&(s+=w3_table_cells("|vertical-align:top;position:relative;|rowspan="+gps.ch.length,w3_div("w3-hcenter",'<canvas id="id-gps-canvas" width="400" height="400" style="position:absolute; z-index:2"></canvas>')));w3_el("id-gps-ch-"+t).innerHTML=s}if(e=w3_table_row("",w3_table_heads("","acq","track","good","fixes","f/min","run","TTFF","UTC offset","ADC clock","lat","lon","alt","map"))+w3_table_row("",w3_table_cells("",gps.acq?"yes":"paused",gps.track?gps.track:"",gps.good?gps.good:"",gps.fixes?gps.fixes.toUnits():"",gps.fixes_min,gps.run,gps.ttff?gps.ttff:"",gps.utc_offset?gps.utc_offset:"",gps.adc_clk.toFixed(6)+" ("+gps.adc_corr.toUnits()+")",gps.lat?gps.lat:"",gps.lat?gps.lon:"",gps.lat?gps.alt:"",gps.lat?gps.map:"")),w3_el("id-gps-info").innerHTML=e,null!=(gps_canvas=w3_el("id-gps-canvas"))){gps_canvas.ctx=gps_canvas.getContext("2d");var w=gps_canvas.ctx;if(adm.rssi_azel_iq!=_gps.RSSI){if(_gps.map_needs_height){var p=css_style_num(w3_el("id-gps-channels"),"height");p&&(w3_el("id-gps-azel-container").style.height=px(p-24),w3_el("id-gps-map").style.height=px(p-24),_gps.a=enc(gps.a),_gps.map_needs_height=0)}if(adm.rssi_azel_iq!=_gps.MAP)if(adm.rssi_azel_iq!=_gps.IQ){if(adm.rssi_azel_iq==_gps.POS){S=400;if(w.fillStyle="hsl(0, 0%, 90%)",w.fillRect(0,0,S,S),!_gps.POS_data)return;w.fillStyle="black";var g,m,u,h,b,f,v,k;T=S/2/(.001*_gps.pos_scale),I=_gps.POS_data.POS.length;w.globalAlpha=1,g=u=b=v=Number.MAX_VALUE,m=h=f=k=Number.MIN_VALUE;for(c=0;c<I&&(adm.plot_E1B||!(c>=I/2));c+=2){w.fillStyle=c<I/2?"DeepSkyBlue":"black";var x=_gps.POS_data.POS[c];if(0!=x){var y=_gps.POS_data.POS[c+1];x-=_gps.POS_data.ref_lat,y-=_gps.POS_data.ref_lon,((M=Math.round(y*T+S/2))<0||M>=S)&&(M=M<0?0:S-1,0),((q=Math.round(-x*T+S/2))<0||q>=S)&&(q=q<0?0:S-1,0);c<I/2?(w.fillRect(M-2,q-2,5,5),M+8>m?m=M+8:M-8<g&&(g=M-8),q+8>h?h=q+8:q-8<u&&(u=q-8)):(w.fillRect(M,q-2,1,5),w.fillRect(M-2,q,5,1),M+8>f?f=M+8:M-8<b&&(b=M-8),q+8>k?k=q+8:q-8<v&&(v=q-8))}}m>=S&&(m=S-1),g<0&&(g=0),h>=S&&(h=S-1),u<0&&(u=0),line_stroke(w,0,1,"DeepSkyBlue",g,u,m,u),line_stroke(w,0,1,"DeepSkyBlue",g,h,m,h),line_stroke(w,1,1,"DeepSkyBlue",g,u,g,h),line_stroke(w,1,1,"DeepSkyBlue",m,u,m,h),adm.plot_E1B&&(f>=S&&(f=S-1),b<0&&(b=0),k>=S&&(k=S-1),v<0&&(v=0),line_stroke(w,0,1,"black",b,v,f,v),line_stroke(w,0,1,"black",b,k,f,k),line_stroke(w,1,1,"black",b,v,b,k),line_stroke(w,1,1,"black",f,v,f,k));M=16,q=S-32;return w.font="15px Courier",w.fillStyle="DeepSkyBlue",w.fillRect(M-2,q-2-4,5,5),M+=12,w.fillStyle="black",w.fillText((adm.plot_E1B?" w/o Galileo span: ":"All sats span: ")+_gps.POS_data.y0span.toFixed(0).fieldWidth(4)+"m Ylat "+_gps.POS_data.x0span.toFixed(0).fieldWidth(4)+"m Xlon",M,q),void(adm.plot_E1B&&(M-=12,q+=18,w.fillStyle="black",w.fillRect(M,q-2-4,1,5),w.fillRect(M-2,q-4,5,1),M+=12,w.fillText("with Galileo span: "+_gps.POS_data.y1span.toFixed(0).fieldWidth(4)+"m Ylat "+_gps.POS_data.x1span.toFixed(0).fieldWidth(4)+"m Xlon",M,q)))}}else{var S=400;if(w.fillStyle="hsl(0, 0%, 90%)",w.fillRect(0,0,S,S),w.fillStyle="yellow",w.fillRect(S/2,0,1,S),w.fillRect(0,S/2,S,1),!_gps.IQ_data)return;w.fillStyle="black";for(var T=S/2/32768*8,I=_gps.IQ_data.IQ.length,c=0;c<I;c+=2){var M,q,R=_gps.IQ_data.IQ[c],P=_gps.IQ_data.IQ[c+1];if(0!=R||0!=P)((M=Math.round(R*T+S/2))<0||M>=S)&&(M=M<0?0:S-1),((q=Math.round(P*T+S/2))<0||q>=S)&&(q=q<0?0:S-1),w.fillRect(M,q,2,2)}}else{if(!_gps.map_init&&!_gps.map_needs_height){if(_gps.leaflet){var N=function(e){return L.mapboxGL({attribution:'<a href="https://www.maptiler.com/license/maps/" target="_blank">&copy; MapTiler</a> <a href="https://www.openstreetmap.org/copyright" target="_blank">&copy; OpenStreetMap contributors</a>',accessToken:"not-needed",style:"https://api.maptiler.com/maps/"+e+"/style.json"+_gps.a})};_gps.map=L.map("id-gps-map",{maxZoom:19,minZoom:1}).setView([0,0],1);var A=N("hybrid");A.addTo(_gps.map),L.control.layers({Satellite:A,Basic:N("basic"),Bright:N("bright"),Positron:N("positron"),Street:N("streets"),Topo:N("topo")},null).addTo(_gps.map)}else{var E=new google.maps.LatLng(0,0),z=w3_el("id-gps-map");_gps.map=new google.maps.Map(z,{zoom:1,center:E,navigationControl:!1,mapTypeControl:!1,streetViewControl:!1,mapTypeId:google.maps.MapTypeId.SATELLITE})}_gps.map_init=1}if(w3_innerHTML("id-gps-map-legend",adm.plot_E1B?_gps.legend_sep:_gps.legend_all),!_gps.MAP_data||!_gps.map_init)return;if(!_gps.map_locate){if(_gps.leaflet)_gps.map.setView([_gps.MAP_data.ref_lat,_gps.MAP_data.ref_lon],15,{duration:0,animate:!1});else{E=new google.maps.LatLng(_gps.MAP_data.ref_lat,_gps.MAP_data.ref_lon);_gps.map.panTo(E),_gps.map.setZoom(18)}_gps.map_locate=1}for(var C=_gps.MAP_data.MAP.length,D=0;D<C;D++){var U=_gps.MAP_data.MAP[D],H=0==U.nmap?_gps.leaflet?"lime":"green":1==U.nmap?"red":"yellow";if(_gps.leaflet){var B=L.divIcon({className:"fooLM",iconAnchor:[12,12],labelAnchor:[-6,0],popupAnchor:[0,-36],html:'<span class="cl-leaflet-marker" style="background-color:'+H+';"/>'});for((O=L.marker([U.lat,U.lon],{icon:B,opacity:1})).addTo(_gps.map),_gps.map_mkr.push(O);_gps.map_mkr.length>12;)_gps.map_mkr.shift().remove()}else{E=new google.maps.LatLng(U.lat,U.lon);var O=new google.maps.Marker({position:E,icon:"http://maps.google.com/mapfiles/ms/icons/"+H+"-dot.png",map:_gps.map});for(_gps.map_mkr.push(O);_gps.map_mkr.length>12;)_gps.map_mkr.shift().setMap(null)}}_gps.MAP_data=null}}}}}function gps_update_azel(){if(adm.rssi_azel_iq==_gps.AZEL&&null!=gps_el){var e=w3_el("id-gps-azel-canvas");if(null!=e){e.ctx=e.getContext("2d");var t=e.ctx,n=200;if(t.clearRect(0,0,400,400),adm.rssi_azel_iq==_gps.AZEL&&gps_shadow_map){t.fillStyle="cyan",t.globalAlpha=.1;for(var a=2*(k=4)+1,_=0;_<360;_++)for(var o=_*Math.PI/180,r=gps_shadow_map[_],s=0,l=1;s<32;s++,l<<=1)if(r&l){var c=(90-(h=s/31*90))/90*180,d=Math.round(c*Math.sin(o)),w=Math.round(c*Math.cos(o));t.fillRect(d+n-k-1,n-w-k-1,a+2,a+2)}t.globalAlpha=1}if(t.strokeStyle="black",t.miterLimit=2,t.lineJoin="circle",t.font="13px Verdana",gps_qzs3_el>0){o=gps_qzs3_az*Math.PI/180,c=(90-gps_qzs3_el)/90*180,d=Math.round(c*Math.sin(o));d+=n,w=n-(w=Math.round(c*Math.cos(o))),t.lineWidth=1,t.beginPath(),t.arc(d,w,10,0,2*Math.PI),t.stroke(),d=12,w=30,t.lineWidth=1,t.beginPath(),t.arc(d,w,10,0,2*Math.PI),t.stroke();t.fillStyle="black",t.lineWidth=1,t.fillText("QZS-3",d+16,w+4)}t.fillStyle="black";for(var p=0;p<gps_nsats;p++)gps_last_good_el[p]=-1;for(var g=gps_nsamp-10;g>=-1;g--)for(p=0;p<gps_nsats;p++){var m=-1==g?gps_last_good_el[p]:g;if(-1!=g||-1!=m){var u=gps_now-m;u<0&&(u+=gps_nsamp),i=u*gps_nsats+p;var h;_=gps_az[i];if(0!=(h=gps_el[i])){gps_last_good_el[p]=g;o=_*Math.PI/180,c=(90-h)/90*180,d=Math.round(c*Math.sin(o)),w=Math.round(c*Math.cos(o));if(-1==g){var b=gps_prn[p],f=t.measureText(b).width,v=_<=180?-f-8:8;t.fillStyle=m>1?"pink":"yellow",t.lineWidth=3,t.strokeText(b,d+v+n,n-w+5),t.lineWidth=1,t.fillText(b,d+v+n,n-w+5);var k;a=2*(k=3)+1;t.fillStyle="black",t.fillRect(d+n-k-1,n-w-k-1,a+2,a+2),t.fillStyle=m>1?"red":"yellow",t.fillRect(d+n-k,n-w-k,a,a)}else t.fillStyle="black",t.fillRect(d+n,n-w,2,2)}}}}}}var log_interval,log={},nlog=256;function log_html(){return w3_div("id-log w3-text-teal w3-hide","<hr>"+w3_div("w3-container",w3_div("",w3_label("w3-show-inline","KiwiSDR server log (scrollable list, first and last set of messages)")+w3_button("w3-aqua|margin-left:10px","Dump","log_dump_cb")+w3_button("w3-blue|margin-left:10px","Clear Histogram","log_clear_hist_cb")),w3_div("id-log-msg w3-margin-T-8 w3-text-output w3-small w3-text-black","")))}function log_setup(){for(var e=w3_el("id-log-msg"),t="<pre>",n=0;n<nlog;n++)n==nlog/2&&(t+='<code id="id-log-not-shown"></code>'),t+='<code id="id-log-'+n+'"></code>';t+="</pre>",e.innerHTML=t,ext_send("SET log_update=1")}function log_dump_cb(e,t){ext_send("SET log_dump")}function log_clear_hist_cb(e,t){ext_send("SET log_clear_hist")}function log_resize(){var e=w3_el("id-log-msg");if(e){var t=window.innerHeight-w3_el("id-admin-header-container").clientHeight-100;e.style.height=px(t)}}function log_focus(e){log_resize(),log_update(),log_interval=setInterval(log_update,3e3)}function log_blur(e){kiwi_clearInterval(log_interval)}function log_update(){ext_send("SET log_update=0")}var console_status_msg_p={scroll_only_at_bottom:!0,process_return_alone:!0,remove_returns:!0,ncol:160};function console_html(){return w3_div("id-console w3-section w3-text-teal w3-hide",w3_div("w3-container",w3_div("",w3_label("w3-show-inline","Beagle Debian console")+w3_button("w3-aqua|margin-left:10px","Connect","console_connect_cb")),w3_div("id-console-msg w3-margin-T-8 w3-text-output w3-scroll-down w3-small w3-text-black|background-color:#a8a8a8",'<pre><code id="id-console-msgs"></code></pre>'),w3_div("w3-margin-top",w3_input("","","console_input","","console_input_cb|console_ctrl_cb","enter shell command")),w3_text("w3-text-black w3-margin-top","Control characters (^C, ^D, ^\\) and empty lines may now be typed directly into shell command field.")))}function console_input_cb(e,t){ext_send("SET console_w2c="+encodeURIComponent(t+"\n")),w3_set_value(e,"")}function console_connect_cb(){ext_send("SET console_open")}function console_ctrl_cb(e){ext_send("SET console_ctrl="+e)}function console_setup(){}function console_resize(){var e=w3_el("id-console-msg");if(e){var t=window.innerHeight-w3_el("id-admin-header-container").clientHeight-200;e.style.height=px(t)}}function console_focus(e){console_resize()}function console_blur(e){}function security_html(){var e=ext_get_cfg_param("chan_no_pwd",0);e=Math.min(e,rx_chans-1);for(var t={0:"none"},n=1;n<rx_chans;n++)t[n]=n.toFixed(0);return w3_div("id-security w3-hide","<hr>"+w3_inline_percent("w3-container/w3-hspace-16 w3-text-teal",w3_div("",w3_div("","<b>User auto-login from local net<br>even if password set?</b><br>",w3_switch("w3-margin-T-8","Yes","No","adm.user_auto_login",adm.user_auto_login,"admin_radio_YN_cb"))),25,w3_div("w3-center",w3_select("","Number of channels<br>not requiring a password<br>even if password set","","chan_no_pwd",e,t,"admin_select_cb"),w3_div("w3-margin-T-8 w3-text-black","Set this and a password to create two sets of channels. Some that have open-access requiring no password and some that are password protected.")),25,w3_div("",w3_input("","User password","adm.user_password","","w3_string_set_cfg_cb","No password set: unrestricted Internet access to SDR")),50)+"<hr>"+w3_inline_percent("w3-container/w3-hspace-16 w3-text-teal",w3_div("",w3_div("","<b>Admin auto-login from local net<br>even if password set?</b><br>",w3_switch("w3-margin-T-8","Yes","No","adm.admin_auto_login",adm.admin_auto_login,"admin_radio_YN_cb"))),25,w3_div("w3-text-teal",""),25,w3_div("",w3_input("","Admin password","adm.admin_password","","w3_string_set_cfg_cb","No password set: no admin access from Internet allowed")),50)+"<hr>"+w3_inline_percent("w3-container/w3-hspace-16 w3-text-teal",w3_div("",w3_div("","<b>Allow GPS timestamp information <br> to be sent on the network?</b><br>",w3_switch("w3-margin-T-8","Yes","No","adm.GPS_tstamp",adm.GPS_tstamp,"admin_radio_YN_cb"))),25,w3_div("w3-text-black",'Set to "No" to prevent timestamp information from your GPS (assuming it is working) from being used by applications on the Internet such as the TDoA service. You would only do this if you had some concern about your publicly-listed Kiwi participating in these kinds of projects. '),33,w3_div("w3-text-black"),1,w3_div("w3-text-black","However we expect most Kiwi owners will want to participate and we encourage you to do so. Your precise GPS location is not revealed by the timestamp information. For more discussion please see the "+w3_link("w3-link-darker-color","http://valentfx.com/vanilla/discussion/1218/participation-of-kiwis-in-the-tdoa-process","Kiwi forums")+"."),33)+"<hr>")}function security_focus(e){admin_set_decoded_value("adm.user_password"),admin_set_decoded_value("adm.admin_password")}var admin_colors=["w3-hover-red","w3-hover-blue","w3-hover-purple","w3-hover-black","w3-hover-aqua","w3-hover-pink","w3-hover-yellow","w3-hover-khaki","w3-hover-green","w3-hover-orange","w3-hover-grey","w3-hover-lime","w3-hover-indigo","w3-hover-brown","w3-hover-teal","w3-hover-blue-grey"];function admin_main(){window.addEventListener("resize",admin_resize)}function admin_resize(){log_resize(),console_resize()}function kiwi_ws_open(e,t,n){return open_websocket(e,t,n,admin_msg,admin_recv)}function admin_draw(e){var t=w3_el("id-admin"),n=0,a="";e||(a+=w3_nav(admin_colors[n++],"GPS","gps","admin_nav")),a+=w3_nav(admin_colors[n++],"Status","status","admin_nav")+w3_nav(admin_colors[n++],"Mode","mode","admin_nav")+w3_nav(admin_colors[n++],"Control","control","admin_nav")+w3_nav(admin_colors[n++],"Connect","connect","admin_nav"),e&&(a+=w3_nav(admin_colors[n++],"Config","config","admin_nav")+w3_nav(admin_colors[n++],"Webpage","webpage","admin_nav")+w3_nav(admin_colors[n++],"Public","sdr_hu","admin_nav")+w3_nav(admin_colors[n++],"DX","dx","admin_nav")),a+=w3_nav(admin_colors[n++],"Update","update","admin_nav")+w3_nav(admin_colors[n++],"Backup","backup","admin_nav")+w3_nav(admin_colors[n++],"Network","network","admin_nav")+(e?w3_nav(admin_colors[n++],"GPS","gps","admin_nav"):"")+w3_nav(admin_colors[n++],"Log","log","admin_nav")+w3_nav(admin_colors[n++],"Console","console","admin_nav")+(e?w3_nav(admin_colors[n++],"Extensions","extensions","admin_nav"):"")+w3_nav(admin_colors[n++],"Security","security","admin_nav"),t.innerHTML=w3_div("id-admin-header-container",'<header class="w3-container w3-teal"><h5>Admin interface</h5></header>'+w3_navbar("w3-border w3-light-grey",a)+w3_divs("id-restart w3-hide/w3-valign",'<header class="w3-show-inline-block w3-container w3-red"><h5>Restart required for changes to take effect</h5></header>'+w3_div("w3-show-inline-block",w3_button("w3-green w3-margin","KiwiSDR server restart","admin_restart_now_cb"))+w3_div("w3-show-inline-block",w3_button("w3-yellow w3-margin","cancel","admin_restart_cancel_cb")))+w3_divs("id-reboot w3-hide/w3-valign",'<header class="w3-show-inline-block w3-container w3-red"><h5>Reboot required for changes to take effect</h5></header>'+w3_div("w3-show-inline-block",w3_button("w3-green w3-margin","Beagle reboot","admin_reboot_now_cb"))+w3_div("w3-show-inline-block",w3_button("w3-yellow w3-margin","cancel","admin_reboot_cancel_cb")))+w3_div("id-build-restart w3-valign w3-hide",'<header class="w3-container w3-blue"><h5>Server will restart after build</h5></header>')+w3_div("id-build-reboot w3-valign w3-hide",'<header class="w3-container w3-red"><h5>Beagle will reboot after build</h5></header>')),a=e?status_html():gps_html()+status_html(),a+=mode_html()+control_html()+connect_html(),e&&(a+=config_html()+webpage_html()+sdr_hu_html()+dx_html()),a+=update_html()+backup_html()+network_html()+(e?gps_html():"")+log_html()+console_html()+(e?extensions_html():"")+security_html(),t.innerHTML+=a,log_setup(),console_setup(),stats_init(),e?users_init(!0):gps_focus(),w3_show_block("id-admin");var i=e?"status":"gps";w3_click_nav(kiwi_toggle(toggle_e.FROM_COOKIE|toggle_e.SET,i,i,"last_admin_navbar"),"admin_nav"),setTimeout(function(){setInterval(status_periodic,5e3)},1e3)}function admin_nav_focus(e,t){w3_click_nav(e,e),writeCookie("last_admin_navbar",e)}function admin_nav_blur(e,t){w3_call(e+"_blur")}var gps=null;function admin_msg(e){switch(e[0]){case"gps_update_cb":try{var t=decodeURIComponent(e[1]);gps=JSON.parse(t),w3_call("gps_update_admin_cb")}catch(e){console.log("<"+t+">"),console.log("kiwi_msg() gps_update_cb: JSON parse fail")}break;case"gps_IQ_data_cb":try{var n=decodeURIComponent(e[1]);_gps.IQ_data=JSON.parse(n)}catch(e){console.log("<"+n+">"),console.log("kiwi_msg() gps_IQ_data_cb: JSON parse fail")}break;case"gps_POS_data_cb":try{var a=decodeURIComponent(e[1]);_gps.POS_data=JSON.parse(a)}catch(e){console.log("<"+a+">"),console.log("kiwi_msg() gps_POS_data_cb: JSON parse fail")}break;case"gps_MAP_data_cb":try{var i=decodeURIComponent(e[1]);_gps.MAP_data=JSON.parse(i)}catch(e){console.log("<"+i+">"),console.log("kiwi_msg() gps_MAP_data_cb: JSON parse fail")}break;case"gps_az_el_history_cb":var _;try{_=decodeURIComponent(e[1]),w3_call("gps_az_el_history_cb",JSON.parse(_))}catch(e){console.log("kiwi_msg() gps_az_el_history_cb: JSON parse fail"),console.log(_)}break;case"dx_json":console.log("dx_json len="+e[1].length),dx_json(JSON.parse(e[1]));break;default:return!1}return!0}var log_msg_idx,log_msg_not_shown=0,admin_sdr_mode=1;function admin_recv(e){for(var t=arrayBufferToString(e).substring(4).split(" "),n=0;n<t.length;n++){var a=t[n].split("=");switch(a[0]){case"gps_only_mode":admin_sdr_mode=+a[1]?0:1;break;case"BBAI":admin.BBAI=!0;break;case"init":rx_chans=rx_chan=+a[1],-1==rx_chans?w3_innerHTML("id-admin",'<header class="w3-container w3-red"><h5>Admin interface</h5></header><p>To use the new admin interface you must edit the configuration parameters from your current kiwi.config/kiwi.cfg into kiwi.config/kiwi.json<br>Use the file kiwi.config/kiwi.template.json as a guide.</p>'):(admin_draw(admin_sdr_mode),ext_send("SET extint_load_extension_configs"));break;case"ext_call":var i=decodeURIComponent(a[1]).split("="),_=i[0],o=i.length>1?i[1]:null;w3_call(_,o);break;case"public_update":public_update(a[1]);break;case"malloc_stats":status_malloc_stats(a[1]);break;case"auto_nat":var r,s,l=+a[1],c=w3_el("id-net-auto-nat-msg");switch(l){case 0:break;case 1:r="succeeded",s="w3-green";break;case 2:r="no device found",s="w3-orange";break;case 3:r="rule already exists",s="w3-yellow";break;case 4:r="command failed",s="w3-red";break;case 5:r="pending",s="w3-yellow"}l&&c&&(c.innerHTML='<header class="w3-container"><h5>Automatic add of NAT rule on firewall / router: '+r+"</h5></header>",w3_remove_then_add(c,network.auto_nat_color,s),network.auto_nat_color=s,w3_show_block(c));break;case"log_msg_not_shown":if(log_msg_not_shown=parseInt(a[1]))(c=w3_el("id-log-not-shown")).innerHTML="---- "+log_msg_not_shown.toString()+" lines not shown ----\n";break;case"log_msg_idx":log_msg_idx=parseInt(a[1]);break;case"log_msg_save":if(!(c=w3_el("id-log-"+log_msg_idx)))break;var d=w3_el("id-log-msg"),w=kiwi_isScrolledDown(d),p=decodeURIComponent(a[1]).replace(/</g,"&lt;").replace(/>/g,"&gt;");c.innerHTML=p,w&&(d.scrollTop=d.scrollHeight);break;case"log_update":log_update(a[1]);break;case"microSD_done":backup_sd_write_done(parseFloat(a[1]));break;case"DUC_status":connect_DUC_status_cb(parseFloat(a[1]));break;case"rev_status":connect_rev_status_cb(parseFloat(a[1]));break;case"check_port_status":network_check_port_status_cb(parseInt(a[1]));break;case"console_c2w":console_status_msg_p.s=a[1],kiwi_output_msg("id-console-msgs","id-console-msg",console_status_msg_p);break;case"console_done":console.log("## console_done");break;case"config_clone_status":config_clone_status_cb(parseInt(a[1]));break;case"network_ip_blacklist_status":l=decodeURIComponent(a[1]).split(","),network_ip_blacklist_status(parseInt(l[0]),l[1]);break;default:console.log("ADMIN UNKNOWN: "+a[0]+"="+a[1])}}}function w3_restart_cb(){w3_show_block("id-restart")}function w3_reboot_cb(){w3_show_block("id-reboot")}var admin_reload_secs,admin_reload_rem,admin_pie_size=25;function admin_draw_pie(){w3_el("id-admin-reload-secs").innerHTML="Admin page reload in "+admin_reload_rem+" secs",admin_reload_rem>0?(admin_reload_rem--,kiwi_draw_pie("id-admin-pie",admin_pie_size,(admin_reload_secs-admin_reload_rem)/admin_reload_secs)):window.location.reload(!0)}function admin_wait_then_reload(e,t){var n=w3_el("id-admin"),a='<header class="w3-container w3-teal"><h5>Admin interface</h5></header>'+(e?w3_divs("w3-valign w3-margin-T-8/w3-container",w3_div("w3-show-inline-block",kiwi_pie("id-admin-pie",admin_pie_size,"#eeeeee","deepSkyBlue")),w3_div("w3-show-inline-block",w3_div("id-admin-reload-msg"),w3_div("id-admin-reload-secs"))):w3_divs("w3-valign w3-margin-T-8/w3-container",w3_div("id-admin-reload-msg")));n.innerHTML=a,t&&(w3_el("id-admin-reload-msg").innerHTML=t),e&&(admin_reload_rem=admin_reload_secs=e,setInterval(admin_draw_pie,1e3),admin_draw_pie())}function admin_restart_now_cb(){ext_send("SET restart"),admin_wait_then_reload(60,"Restarting KiwiSDR server")}function admin_restart_cancel_cb(){w3_hide("id-restart")}function admin_reboot_now_cb(){ext_send("SET reboot"),admin_wait_then_reload(90,"Rebooting Beagle")}function admin_reboot_cancel_cb(){w3_hide("id-reboot")}function admin_int_cb(e,t){t=parseInt(t),isNaN(t)?(t=ext_get_cfg_param(e),w3_set_value(e,t)):ext_set_cfg_param(e,t,!0)}function admin_float_cb(e,t){t=parseFloat(t),isNaN(t)?(t=ext_get_cfg_param(e),w3_set_value(e,t)):ext_set_cfg_param(e,t,!0)}function admin_bool_cb(e,t,n){ext_set_cfg_param(e,!!t,null==n||!n)}function admin_set_decoded_value(e){var t=ext_get_cfg_param(e);w3_set_decoded_value(e,t)}function admin_radio_YN_cb(e,t){admin_bool_cb(e,t?0:1)}function admin_select_cb(e,t,n){-1!=(t=+t)&&ext_set_cfg_param(e,t,!n)}function admin_preview_status_box(e){var t=decodeURIComponent(e);return t&&""!=t||(t="&nbsp;"),t}
\ No newline at end of file
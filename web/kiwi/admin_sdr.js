@@ -198,11 +198,6 @@ function config_html()
             w3_switch('', 'Yes', 'No', 'test_webserver_prio', cfg.test_webserver_prio, 'admin_radio_YN_cb'),
 				w3_text('w3-text-black w3-center', 'Set \'no\' for standard behavior.')
 			),
-			w3_divs('w3-center w3-tspace-8',
-				w3_div('', '<b>New deadline update scheme?</b>'),
-            w3_switch('', 'Yes', 'No', 'test_deadline_update', cfg.test_deadline_update, 'admin_radio_YN_cb'),
-				w3_text('w3-text-black w3-center', 'Set \'no\' for standard behavior.')
-			),
 			''
 		) +
 		'<hr>';
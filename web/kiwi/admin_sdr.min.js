@@ -1,4 +1,4 @@
 
 
 /* web/kiwi/admin_sdr.min.js */
-var sdr_hu_interval,ITU_region_i={0:"R1: Europe, Africa",1:"R2: North & South America",2:"R3: Asia / Pacific"},AM_BCB_chan_i={0:"9 kHz",1:"10 kHz"},max_freq_i={0:"30 MHz",1:"32 MHz"},SPI_clock_i={0:"48 MHz",1:"24 MHz"},led_brightness_i={0:"brighest",1:"medium",2:"dimmer",3:"dimmest",4:"off"},clone_host="",clone_pwd="",clone_files_s=["complete config","dx labels only"];function config_html(){kiwi_get_init_settings();var e=ext_get_cfg_param("init.mode",0),t=ext_get_cfg_param("init.AM_BCB_chan",0),i=ext_get_cfg_param("init.ITU_region",0),n=ext_get_cfg_param("max_freq",0),_=(n=ext_get_cfg_param("max_freq",0),"<hr>"+w3_third("w3-margin-bottom w3-text-teal w3-restart","w3-container",w3_input_get("","Initial frequency (kHz)","init.freq","admin_float_cb"),w3_div("w3-center",w3_select("","Initial mode","","init.mode",e,kiwi.modes_u,"admin_select_cb")),w3_input_get("","Initial CW offset (Hz)","init.cw_offset","admin_int_cb"))+w3_third("w3-margin-bottom w3-text-teal w3-restart","w3-container",w3_input_get("","Initial waterfall min (dBFS, fully zoomed-out)","init.min_dB","admin_int_cb"),w3_input_get("","Initial waterfall max (dBFS)","init.max_dB","admin_int_cb"),w3_input_get("","Initial zoom (0-13)","init.zoom","admin_int_cb"))),a=w3_third("w3-margin-bottom w3-text-teal","w3-container",w3_div("w3-restart",w3_input_get("","Frequency scale offset (kHz)","freq_offset","admin_int_cb"),w3_div("w3-text-black","Adds offset to frequency scale. <br> Useful when using a transverter, e.g. set to <br>116000 kHz when 144-148 maps to 28-32 MHz.")),w3_divs("w3-restart/w3-center w3-tspace-8",w3_select("","Max receiver frequency","","max_freq",n,max_freq_i,"admin_select_cb"),w3_div("w3-text-black")),w3_divs("w3-restart/w3-center w3-tspace-8",w3_select_get_param("","SPI clock","","SPI_clock",SPI_clock_i,"admin_select_cb",0),w3_div("w3-text-black","Set to 24 MHz to reduce interference <br> on 2 meters (144-148 MHz).")))+w3_third("w3-margin-bottom w3-text-teal","w3-container",w3_input_get("","S-meter calibration (dB)","S_meter_cal","admin_int_cb"),w3_slider("id-S_meter_OV_counts//","S-meter OV","cfg.S_meter_OV_counts",cfg.S_meter_OV_counts,0,15,1,"config_OV_counts_cb"),w3_input_get("","Waterfall calibration (dB)","waterfall_cal","admin_int_cb"))+w3_third("w3-margin-bottom w3-text-teal","w3-container",w3_div("w3-center w3-tspace-8",w3_select("","ITU region","","init.ITU_region",i,ITU_region_i,"admin_select_cb"),w3_div("w3-text-black","Configures LW/NDB, MW and <br> amateur band allocations, etc.")),w3_div("w3-center w3-tspace-8",w3_select("","Initial AM BCB channel spacing","","init.AM_BCB_chan",t,AM_BCB_chan_i,"admin_select_cb")),w3_divs("w3-restart/w3-center w3-tspace-8",w3_select_get_param("","Status LED brightness","","led_brightness",led_brightness_i,"admin_select_cb",0),w3_div("w3-text-black","Sets brightness of the 4 LEDs <br> that show status info."))),r="<hr>"+w3_div("w3-valign w3-container w3-section",'<header class="w3-container w3-yellow"><h6>Clone configuration from another Kiwi. <b>Use with care.</b> Current configuration is <b><i>not</i></b> saved. This Kiwi immediately restarts after cloning.</h6></header>')+w3_inline_percent("w3-text-teal/w3-container",w3_input("","Clone config from Kiwi host","clone_host","","w3_string_cb","enter hostname (no port number)"),25,w3_input("","Kiwi host root password","clone_pwd","","w3_string_cb","can be blank"),25,w3_select("w3-center//","Config to clone","","clone_files",0,clone_files_s,"w3_num_cb"),15,w3_button("w3-center//w3-red","Clone","config_clone_cb"),10,w3_label("w3-show-inline-block w3-margin-R-16 w3-text-teal","Status:")+w3_div("id-config-clone-status w3-show-inline-block w3-text-black w3-background-pale-aqua",""),25)+w3_inline_percent("w3-margin-bottom w3-text-teal/w3-container","",25,w3_div("w3-center w3-text-black","Not the same as Kiwi admin password.<br>Leave blank unless you've explicitly changed host's Beagle root password."),25),o="<hr>"+w3_div("w3-valign w3-container w3-section",'<header class="w3-container w3-yellow"><h6>If the Kiwi doesn\'t like your external clock you can still connect (user and admin). However the waterfall will be dark and the audio silent.</h6></header>')+w3_third("w3-margin-bottom w3-text-teal","w3-container",w3_divs("w3-restart/w3-center w3-tspace-8",w3_div("","<b>External ADC clock?</b>"),w3_switch("","Yes","No","ext_ADC_clk",cfg.ext_ADC_clk,"config_ext_clk_sel_cb"),w3_text("w3-text-black w3-center","Set when external 66.666600 MHz (nominal) <br> clock connected to J5 connector/pad.")),w3_divs("w3-restart/w3-tspace-8",w3_input("","External clock frequency (enter in MHz or Hz)","ext_ADC_freq",cfg.ext_ADC_freq,"config_ext_freq_cb"),w3_text("w3-text-black","Set exact clock frequency applied. <br> Input value stored in Hz.")),w3_divs("w3-restart/w3-center w3-tspace-8",w3_div("","<b>Enable GPS correction of ADC clock?</b>"),w3_switch("","Yes","No","ADC_clk_corr",cfg.ADC_clk_corr,"admin_radio_YN_cb"),w3_text("w3-text-black w3-center",'Set "no" to keep the Kiwi GPS from correcting for <br>errors in the ADC clock (internal or external).')))+"<hr>"+w3_div("w3-container",w3_div("w3-valign",'<header class="w3-container w3-yellow"><h6>To manually adjust/calibrate the ADC clock (e.g. when there is no GPS signal or GPS correction is disabled) follow these steps:</h6></header>'),w3_label("w3-text-teal","<ul><li>Open a normal user connection to the SDR</li><li>Tune to a time station or other accurate signal and zoom all the way in</li><li>Higher frequency shortwave stations are better because they will show more offset than LF/VLF stations</li><li>Click exactly on the signal carrier line in the waterfall</li><li>On the right-click menu select the <i>cal ADC clock (admin)</i> entry</li><li>You may have to give the admin password if not already authenticated</li><li>The adjustment is calculated and the carrier on the waterfall should move to the nearest 1 kHz marker</li><li>Use the fine-tuning controls on the IQ extension panel if necessary</li></ul>"),w3_label("w3-text-teal","You can fine-tune after the above steps as follows:<ul><li>Open IQ display extension</li><li>Set the receive frequency to the exact nominal carrier (e.g. 15000 kHz for WWV)</li><li>Press the <i>40</i> button (i.e. sets mode to AM with 40 Hz passband)</li><li>Set menus: Draw = points, Mode = carrier, PLL = off</li><li>Adjust the gain until you see a point rotating in a circle</li><li>Use the <i>Fcal</i> buttons to slow the rotation as much as possible</li><li>The total accumulated Fcal adjustment is shown</li><li>A full rotation in less than two seconds is good calibration</li></ul>")),s="<hr>",c=adm.firmware_sel==kiwi.RX3_WF3?1:0;console.log("mode_20kHz="+c);var w="DC_offset"+(c?"_20kHz":"")+"_I",l="DC_offset"+(c?"_20kHz":"")+"_Q";return dbgUs&&(s=s+w3_div("w3-section w3-text-teal w3-bold","Development settings")+w3_third("w3-margin-bottom w3-text-teal w3-restart","w3-container",w3_input_get("","I balance (DC offset)",w,"admin_float_cb"),w3_input_get("","Q balance (DC offset)",l,"admin_float_cb"),"")+w3_third("w3-margin-bottom w3-text-teal w3-restart","w3-container",w3_divs("w3-center w3-tspace-8",w3_div("","<b>Increase web server priority?</b>"),w3_switch("","Yes","No","test_webserver_prio",cfg.test_webserver_prio,"admin_radio_YN_cb"),w3_text("w3-text-black w3-center","Set 'no' for standard behavior.")),w3_divs("w3-center w3-tspace-8",w3_div("","<b>New deadline update scheme?</b>"),w3_switch("","Yes","No","test_deadline_update",cfg.test_deadline_update,"admin_radio_YN_cb"),w3_text("w3-text-black w3-center","Set 'no' for standard behavior.")),"")+"<hr>"),w3_div("id-config w3-hide",_+a+r+o+s)}function config_OV_counts_cb(e,t,i,n){var _=1<<(t=+t);admin_int_cb(e,t),w3_set_label("S-meter OV if &ge; "+_+" ADC OV per 64k samples",e),ext_send("SET ov_counts="+_)}function config_clone_cb(e,t){var i;""==clone_host?i="please enter host to clone from":(i="cloning from "+clone_host,ext_send("SET config_clone host="+encodeURIComponent(clone_host)+" pwd=x"+encodeURIComponent(clone_pwd)+" files="+clone_files)),w3_innerHTML("id-config-clone-status",i)}function config_clone_status_cb(e){var t;0==e?(t="clone complete, restarting Kiwi",ext_send("SET restart"),admin_wait_then_reload(60,"Configuration cloned, restarting KiwiSDR server")):t=1280==e?"wrong password":256==e?"host unknown/unresponsive":"clone error #"+e,w3_innerHTML("id-config-clone-status",t)}function config_ext_clk_sel_cb(e,t){t=+t,admin_radio_YN_cb(e,t),w3_num_set_cfg_cb("cfg.clk_adj",0)}function config_ext_freq_cb(e,t,i){if(!i){var n=parseFloat(t);isNaN(n)?n=null:(n<70?n*=1e6:n<7e4&&(n*=1e3),((n=Math.floor(n))<65e6||n>69e6)&&(n=null)),admin_int_cb(e,n,i)}}function channels_html(){return w3_div("id-channels w3-hide","<hr>"+w3_third("w3-margin-bottom w3-text-teal w3-restart","w3-container","foo","bar","baz"))}function webpage_html(){var e="<hr>"+w3_divs("w3-margin-bottom/w3-container",w3_input("","Top bar title","index_html_params.RX_TITLE","","webpage_title_cb"))+w3_div("w3-container","<label><b>Top bar title HTML preview</b></label>",w3_div("id-webpage-title-preview w3-text-black w3-background-pale-aqua",""))+w3_divs("w3-margin-top w3-margin-bottom/w3-container",w3_input("","Owner info (appears in center of top bar; can use HTML like &lt;br&gt; for line break if line is too long)","owner_info","","webpage_owner_info_cb"))+w3_div("w3-container","<label><b>Owner info HTML preview</b></label>",w3_div("id-webpage-owner-info-preview w3-text-black w3-background-pale-aqua",""))+w3_divs("w3-margin-top w3-margin-bottom/w3-container",w3_input("","Status","status_msg","","webpage_status_cb"))+w3_div("w3-container","<label><b>Status HTML preview</b></label>",w3_div("id-webpage-status-preview w3-text-black w3-background-pale-aqua",""))+w3_divs("w3-margin-top/w3-container",w3_input("","Window/tab title","index_html_params.PAGE_TITLE","","webpage_string_cb")),t="<hr>"+w3_half("w3-margin-bottom","w3-container",w3_input("","Location","index_html_params.RX_LOC","","webpage_string_cb"),w3_input("",w3_label("w3-bold","Grid square (4 or 6 char) ")+w3_div("id-webpage-grid-check cl-admin-check w3-show-inline-block w3-green w3-btn w3-round-large"),"index_html_params.RX_QRA","","webpage_input_grid"))+w3_half("","w3-container",w3_input("","Altitude (ASL meters)","index_html_params.RX_ASL","","webpage_string_cb"),w3_input("",w3_label("w3-bold","Map (Google format or lat, lon) ")+w3_div("id-webpage-map-check cl-admin-check w3-show-inline-block w3-green w3-btn w3-round-large"),"index_html_params.RX_GMAP","","webpage_input_map"))+"<hr>"+w3_half("w3-margin-bottom","w3-container",w3_half("","",w3_div("",w3_label("w3-bold","Photo file"),'<input id="id-photo-file" type="file" accept="image/*" onchange="webpage_photo_file_upload()"/>',w3_div("id-photo-error","")),w3_checkbox_get_param("w3-restart w3-label-inline","Photo left margin","index_html_params.RX_PHOTO_LEFT_MARGIN","admin_bool_cb",!0)),w3_input("","Photo maximum height (pixels)","index_html_params.RX_PHOTO_HEIGHT","","webpage_string_cb"))+w3_half("","w3-container",w3_input("","Photo title","index_html_params.RX_PHOTO_TITLE","","webpage_string_cb"),w3_input("","Photo description","index_html_params.RX_PHOTO_DESC","","webpage_string_cb")),i="<hr>"+w3_half("w3-margin-bottom w3-text-teal","w3-container",w3_divs("/w3-center w3-tspace-8",w3_div("","<b>Web server caching?</b>"),w3_switch("","Yes","No","webserver_caching",cfg.webserver_caching,"admin_radio_YN_cb"),w3_text("w3-text-black w3-center",'Set "No" when there are caching problems in your <br>network path, e.g. user interface icons don\'t load.')))+"<hr>"+w3_div("w3-container",w3_textarea_get_param("w3-input-any-change|width:100%",w3_label("w3-show-inline-block w3-bold w3-text-teal","Additional HTML/Javascript for HTML &lt;head&gt; element (e.g. Google analytics or user customization)"),"index_html_params.HTML_HEAD",10,100,"webpage_string_cb",""))+w3_divs("w3-margin-bottom/w3-container","");return w3_div("id-webpage w3-text-teal w3-hide",e+t+i)}function webpage_input_grid(e,t){webpage_string_cb(e,t),webpage_update_check_grid()}function webpage_update_check_grid(){var e=ext_get_cfg_param("index_html_params.RX_QRA");w3_el("webpage-grid-check").innerHTML='<a href="http://www.levinecentral.com/ham/grid_square.php?Grid='+e+'" target="_blank">check grid</a>'}function webpage_input_map(e,t){webpage_string_cb(e,t),webpage_update_check_map()}function webpage_update_check_map(){var e=ext_get_cfg_param("index_html_params.RX_GMAP");w3_el("webpage-map-check").innerHTML='<a href="https://google.com/maps/place/'+e+'" target="_blank">check map</a>'}function webpage_photo_uploaded(e){var t;0==(t=null!=e.AJAX_error?-1:e.r)&&webpage_string_cb("index_html_params.RX_PHOTO_FILE","kiwi.config/photo.upload");var i,n=w3_el("photo-error");switch(t){case-1:i="Communication error";break;case 0:i="Upload successful";break;case 1:i="Authentication failed";break;case 2:i="Not an image file?";break;case 3:i="Unable to determine file type";break;case 4:i="File too large";break;default:i="Undefined error?"}n.innerHTML=i,w3_add(n,0==t?"w3-text-green":"w3-text-red"),w3_show_block(n)}function webpage_photo_file_upload(){ext_get_authkey(function(e){webpage_photo_file_upload2(e)})}function webpage_photo_file_upload2(e){var t=w3_el("id-photo-file");t.innerHTML="Uploading...";var i=t.files[0],n=new FormData;n.append("photo",i,i.name);var _=w3_el("photo-error");w3_hide(_),w3_remove(_,"w3-text-red"),w3_remove(_,"w3-text-green"),kiwi_ajax_send(n,"/PIX?"+e,"webpage_photo_uploaded")}function webpage_title_cb(e,t){webpage_string_cb(e,t),w3_el("id-webpage-title-preview").innerHTML=admin_preview_status_box(cfg.index_html_params.RX_TITLE)}function webpage_owner_info_cb(e,t){webpage_string_cb(e,t),w3_el("id-webpage-owner-info-preview").innerHTML=admin_preview_status_box(cfg.owner_info)}function webpage_status_cb(e,t){w3_string_set_cfg_cb(e,t),w3_el("id-webpage-status-preview").innerHTML=admin_preview_status_box(cfg.status_msg)}function webpage_focus(){admin_set_decoded_value("index_html_params.RX_TITLE"),w3_el("id-webpage-title-preview").innerHTML=admin_preview_status_box(cfg.index_html_params.RX_TITLE),admin_set_decoded_value("status_msg"),w3_el("id-webpage-status-preview").innerHTML=admin_preview_status_box(cfg.status_msg),admin_set_decoded_value("index_html_params.PAGE_TITLE"),admin_set_decoded_value("index_html_params.RX_LOC"),admin_set_decoded_value("index_html_params.RX_QRA"),admin_set_decoded_value("index_html_params.RX_ASL"),admin_set_decoded_value("index_html_params.RX_GMAP"),admin_set_decoded_value("index_html_params.RX_PHOTO_HEIGHT"),admin_set_decoded_value("index_html_params.RX_PHOTO_TITLE"),admin_set_decoded_value("index_html_params.RX_PHOTO_DESC"),admin_set_decoded_value("owner_info"),w3_el("id-webpage-owner-info-preview").innerHTML=admin_preview_status_box(cfg.owner_info),webpage_update_check_grid(),webpage_update_check_map()}function webpage_string_cb(e,t){w3_string_set_cfg_cb(e,t),ext_send("SET reload_index_params")}function sdr_hu_html(){var e=w3_div("w3-tspace-16",w3_div("id-need-gps w3-valign w3-hide",'<header class="w3-container w3-yellow"><h5>Warning: GPS location field set to the default, please update</h5></header>'),w3_div("w3-valign",'<header class="w3-container w3-yellow"><h5>More information on <a href="http://kiwisdr.com/quickstart/index.html#id-sdr_hu" target="_blank">kiwisdr.com</a><br><br>To list your Kiwi on <a href="http://kiwisdr.com/public" target="_blank">kiwisdr.com/public</a> edit the fields below and set the register switch to <b>Yes</b>.<br>Look for a successful status result after a few minutes.<br><br>To list your Kiwi on <a href="https://sdr.hu" target="_blank">sdr.hu</a> edit the fields below and obtain an API key from <a href="https://sdr.hu/register" target="_blank">sdr.hu/register</a> and enter it into the <b>API key</b> field.<br>Then set the register switch to <b>Yes</b> and look for a status result of "SUCCESS ..." after a few minutes.</h5></header>'))+"<hr>"+w3_half("w3-margin-bottom","w3-container",w3_div("",'<b>Register on <a href="http://kiwisdr.com/public" target="_blank">kiwisdr.com/public</a>?</b> '+w3_switch("","Yes","No","adm.kiwisdr_com_register",adm.kiwisdr_com_register,"kiwisdr_com_register_cb")),w3_div("",'<b>Register on <a href="https://sdr.hu/?top=kiwi" target="_blank">sdr.hu</a>?</b> '+w3_switch("","Yes","No","adm.sdr_hu_register",adm.sdr_hu_register,"sdr_hu_register_cb")))+w3_half("w3-margin-bottom","w3-container",w3_div(),w3_div("w3-restart",w3_input("","sdr.hu API key","adm.api_key","","w3_string_set_cfg_cb","enter value returned from sdr.hu/register process")))+w3_half("","",w3_div("id-kiwisdr_com-reg-status-container",w3_div("w3-container",w3_label("w3-show-inline-block w3-margin-R-16 w3-text-teal","kiwisdr.com registration status:")+w3_div("id-kiwisdr_com-reg-status w3-show-inline-block w3-text-black",""))),w3_div("id-sdr_hu-reg-status-container",w3_div("w3-container",w3_label("w3-show-inline-block w3-margin-R-16 w3-text-teal","sdr.hu registration status:")+w3_div("id-sdr_hu-reg-status w3-show-inline-block w3-text-black","")))),t="<hr>"+w3_half("w3-margin-bottom w3-restart","w3-container",w3_input("","Name","rx_name","","w3_string_set_cfg_cb"),w3_input("","Location","rx_location","","w3_string_set_cfg_cb"))+w3_half("w3-margin-bottom w3-restart","w3-container",w3_input("","Admin email","admin_email","","w3_string_set_cfg_cb"),w3_input("","Antenna","rx_antenna","","w3_string_set_cfg_cb"))+w3_third("w3-margin-bottom w3-restart","w3-container",w3_input("",w3_label("w3-bold","Grid square (4/6 char) ")+w3_div("id-public-grid-check cl-admin-check w3-show-inline-block w3-green w3-btn w3-round-large")+" "+w3_div("id-public-grid-set cl-admin-check w3-blue w3-btn w3-round-large w3-hide","set from GPS"),"rx_grid","","sdr_hu_input_grid"),w3_div("",w3_input("",w3_label("w3-bold","Location (lat, lon) ")+w3_div("id-public-gps-check cl-admin-check w3-show-inline-block w3-green w3-btn w3-round-large")+" "+w3_div("id-public-gps-set cl-admin-check w3-blue w3-btn w3-round-large w3-hide","set from GPS"),"rx_gps","","sdr_hu_check_gps"),w3_div("w3-text-black","Format: (nn.nnnnnn, nn.nnnnnn)")),w3_input_get("","Altitude (ASL meters)","rx_asl","admin_int_cb"))+"<hr>"+w3_half("w3-margin-bottom","w3-container","<b>Display owner/admin email link on KiwiSDR main page?</b> "+w3_switch("","Yes","No","contact_admin",cfg.contact_admin,"admin_radio_YN_cb"),"")+"<hr>"+w3_half("w3-margin-bottom","w3-container",w3_div("",w3_input_get("","Coverage frequency low (kHz)","sdr_hu_lo_kHz","admin_int_cb"),w3_div("w3-text-black",'These two settings effect the frequency coverage label displayed on sdr.hu <br>e.g. when set to 0 and 30000 sdr.hu shows "HF". If you\'re using a transverter <br>then appropriate entries will cause "2m" or "70cm" to be shown. Other labels will be <br>shown if you limit the range at HF due to antenna or filtering limitations. <br>These settings don\'t apply to listings at kiwisdr.com/public')),w3_input_get("","Coverage frequency high (kHz)","sdr_hu_hi_kHz","admin_int_cb"));return w3_div("id-sdr_hu w3-text-teal w3-hide",e+t)}function kiwisdr_com_register_cb(e,t){var i,n;(t=+t)==w3_SWITCH_YES_IDX&&""==cfg.server_url?(i='Error, you must first setup a valid Kiwi connection URL on the admin "connect" tab',n="#ffeb3b",w3_switch_set_value(e,w3_SWITCH_NO_IDX),t=w3_SWITCH_NO_IDX):t==w3_SWITCH_YES_IDX?(i="(waiting for kiwisdr.com response, can take several minutes in some cases)",n="hsl(180, 100%, 95%)"):(i="(registration not enabled)",n="hsl(180, 100%, 95%)"),w3_innerHTML("id-kiwisdr_com-reg-status",i),w3_color("id-kiwisdr_com-reg-status",null,n),admin_radio_YN_cb(e,t)}function sdr_hu_register_cb(e,t){var i,n;(t=+t)==w3_SWITCH_YES_IDX&&""==cfg.server_url?(i='Error, you must first setup a valid Kiwi connection URL on the admin "connect" tab',n="#ffeb3b",w3_switch_set_value(e,w3_SWITCH_NO_IDX),t=w3_SWITCH_NO_IDX):t==w3_SWITCH_YES_IDX?(i="(waiting for sdr.hu response, can take several minutes in some cases)",n="hsl(180, 100%, 95%)"):(i="(registration not enabled)",n="hsl(180, 100%, 95%)"),w3_innerHTML("id-sdr_hu-reg-status",i),w3_color("id-sdr_hu-reg-status",null,n),admin_radio_YN_cb(e,t)}function sdr_hu_focus(){admin_set_decoded_value("rx_name"),admin_set_decoded_value("rx_location"),admin_set_decoded_value("rx_antenna"),admin_set_decoded_value("rx_grid"),admin_set_decoded_value("rx_gps"),admin_set_decoded_value("admin_email"),admin_set_decoded_value("adm.api_key"),sdr_hu_check_gps("rx_gps",decodeURIComponent(ext_get_cfg_param("rx_gps")),!0),public_update_check_grid(),public_update_check_map(),w3_el("id-public-grid-set").onclick=function(){var e=admin.reg_status.grid;w3_set_value("rx_grid",e),w3_input_change("rx_grid","sdr_hu_input_grid")},w3_el("id-public-gps-set").onclick=function(){var e="("+admin.reg_status.lat+", "+admin.reg_status.lon+")";w3_set_value("rx_gps",e),w3_input_change("rx_gps","sdr_hu_check_gps")},ext_send("SET public_update"),sdr_hu_interval=setInterval(function(){ext_send("SET public_update")},5e3),kiwisdr_com_register_cb("adm.kiwisdr_com_register",adm.kiwisdr_com_register?w3_SWITCH_YES_IDX:w3_SWITCH_NO_IDX),sdr_hu_register_cb("adm.sdr_hu_register",adm.sdr_hu_register?w3_SWITCH_YES_IDX:w3_SWITCH_NO_IDX)}function sdr_hu_input_grid(e,t){w3_string_set_cfg_cb(e,t),public_update_check_grid()}function public_update_check_grid(){var e=ext_get_cfg_param("rx_grid");w3_el("id-public-grid-check").innerHTML='<a href="http://www.levinecentral.com/ham/grid_square.php?Grid='+e+'" target="_blank">check grid</a>'}function sdr_hu_check_gps(e,t,i){for(var n=0,_=0,a=/([-]?\d*\.?\d+)/g,r=0;r<2;r++){var o=a.exec(t);o&&(r?_=parseFloat(o[0]):n=parseFloat(o[0]))}"(-37.631120, 176.172210)"==(t="("+n.toFixed(6)+", "+_.toFixed(6)+")")||"(-37.631120%2C%20176.172210)"==t?(w3_show_block("id-need-gps"),w3_flag("rx_gps")):(w3_hide("id-need-gps"),w3_unflag("rx_gps")),w3_string_set_cfg_cb(e,t,i),w3_set_value(e,t),public_update_check_map()}function public_update_check_map(){var e=decodeURIComponent(ext_get_cfg_param("rx_gps"));e=e.substring(1,e.length-1),w3_el("id-public-gps-check").innerHTML='<a href="https://google.com/maps/place/'+e+'" target="_blank">check map</a>'}function sdr_hu_blur(e){kiwi_clearInterval(sdr_hu_interval)}function public_update(e){var t=decodeURIComponent(e);admin.reg_status=JSON.parse(t),adm.kiwisdr_com_register&&null!=admin.reg_status.kiwisdr_com&&""!=admin.reg_status.kiwisdr_com&&w3_innerHTML("id-kiwisdr_com-reg-status","kiwisdr.com/public registration: successful"),adm.sdr_hu_register&&null!=admin.reg_status.sdr_hu&&""!=admin.reg_status.sdr_hu&&w3_innerHTML("id-sdr_hu-reg-status",admin.reg_status.sdr_hu),null!=admin.reg_status.lat&&(w3_show_inline_block("id-public-grid-set"),w3_show_inline_block("id-public-gps-set"))}function dx_html(){return w3_div("id-dx w3-hide",w3_div("w3-container w3-margin-top","TODO.."))}function dx_focus(){}function dx_hide(){}var ext_cur_nav,dxo={};function dx_json(e){}function dx_json2(e){e.dx.length;var t,i="";for(dxo.tags=[],t=-1;t<4;t++){var n=null,_="",a=0,r="",o="",s="",c=0,w="",l="",d="",g=function(e){return-1==t?"w3-hide":e},u=function(e){return-1==t?e:""};if(-1!=t){_=(n=e.dx[t])[0],a=kiwi.modes_s[n[1].toLowerCase()],r=decodeURIComponent(n[2]),o=decodeURIComponent(n[3]),n[4],d=n[5],dxo.tags[t]=d;var b=0,m=0,p=n[6];p&&(c=1==p.WL?types_s.watch_list:1==p.SB?types_s.sub_band:1==p.DG?types_s.DGPS:1==p.NoN?types_s.special_event:1==p.SE?types_s.special_event:1==p.XX?types_s.interference:1==p.MK?types_s.masked:0,p.lo&&(b=+p.lo),p.hi&&(m=+p.hi),p.o&&(w=p.o),p.p&&(l=p.p)),(b||m)&&(s=b==-m?(2*Math.abs(m)).toFixed(0):b.toFixed(0)+", "+m.toFixed(0))}console.log("i="+t+" mo="+a+" ty="+c),console.log(n);var h=w3_divs("w3-text-teal/w3-margin-T-8",w3_col_percent("",w3_col_percent("w3-valign/w3-hspace-16",-1==t?"":w3_button("w3-font-fixed w3-padding-tiny w3-selection-green","+","dx_add_cb",t),1,-1==t?"":w3_button("w3-font-fixed w3-padding-tiny w3-red","-","dx_rem_cb",t),1,w3_input(g("w3-padding-small||size=8"),u("Freq"),"dxo.f_"+t,_,"dx_num_cb"),19,w3_select(g(""),u("Mode"),"","dxo.m_"+t,a,kiwi.modes_u,"dx_sel_cb"),19,w3_input(g("w3-padding-small||size=4"),u("Passband"),"dxo.pb_"+t,s,"dx_passband_cb"),19,w3_select(g(""),u("Type"),"","dxo.y_"+t,c,types,"dx_sel_cb"),19,w3_input(g("w3-padding-small||size=2"),u("Offset"),"dxo.o_"+t,w,"dx_num_cb"),19),45,w3_col_percent("w3-valign/w3-margin-left",w3_input(g("w3-padding-small"),u("Ident"),"dxo.i_"+t,r,"dx_string_cb"),40,w3_input(g("w3-padding-small"),u("Notes"),"dxo.n_"+t,o,"dx_string_cb"),40,w3_input(g("w3-padding-small"),u("Extension"),"dxo.p_"+t,l,"dx_string_cb"),20),54));-1==t?w3_innerHTML("id-dx-list-legend",h):i+=h}w3_el("id-dx-list").style.overflowY="scroll",w3_innerHTML("id-dx-list",i)}function dx_filter_cb(e,t){console.log("dx_filter_cb p="+t)}function dx_add_cb(e,t){console.log("dx_add p="+t)}function dx_rem_cb(e,t){console.log("dx_rem p="+t)}function extensions_html(){return w3_div("id-extensions w3-hide w3-section",w3_sidenav("id-extensions-nav"),w3_div("id-extensions-config"))}function extensions_focus(){w3_el("id-nav-wspr")&&w3_click_nav(kiwi_toggle(toggle_e.FROM_COOKIE|toggle_e.SET,"wspr","wspr","last_admin_ext_nav"),"extensions_nav")}function extensions_blur(){ext_cur_nav&&w3_call(ext_cur_nav+"_config_blur")}function extensions_nav_focus(e,t){writeCookie("last_admin_ext_nav",e),w3_show(e+"-container"),w3_call(e+"_config_focus"),ext_cur_nav=e}function extensions_nav_blur(e,t){w3_hide(e+"-container"),w3_call(e+"_config_blur")}var ext_seq=0;function ext_admin_config(e,t,i,n){null==n&&(n=null);var _=ext_seq%admin_colors.length;w3_el("id-extensions-nav").innerHTML+=w3_nav(admin_colors[_]+" w3-border",t,e,"extensions_nav"),ext_seq++,w3_el("id-extensions-config").innerHTML+=w3_div("id-"+e+"-container w3-hide|width:95%",i)}function ext_config_html(e,t,i,n,_){var a=e.ext_name;e.enable=ext_get_cfg_param(t+".enable",!0,EXT_SAVE),ext_admin_config(a,i,w3_div("id-"+a+" w3-text-teal w3-hide",w3_col_percent("w3-valign/",w3_div("w3-bold",n),40,w3_inline("",w3_div("w3-bold w3-margin-R-8","User enabled?"),w3_switch("","Yes","No",t+".enable",e.enable,"admin_radio_YN_cb"),w3_div("w3-text-black w3-margin-L-32","Local connections exempt.")))+"<hr>"+(_||"")))}
\ No newline at end of file
+var sdr_hu_interval,ITU_region_i={0:"R1: Europe, Africa",1:"R2: North & South America",2:"R3: Asia / Pacific"},AM_BCB_chan_i={0:"9 kHz",1:"10 kHz"},max_freq_i={0:"30 MHz",1:"32 MHz"},SPI_clock_i={0:"48 MHz",1:"24 MHz"},led_brightness_i={0:"brighest",1:"medium",2:"dimmer",3:"dimmest",4:"off"},clone_host="",clone_pwd="",clone_files_s=["complete config","dx labels only"];function config_html(){kiwi_get_init_settings();var e=ext_get_cfg_param("init.mode",0),t=ext_get_cfg_param("init.AM_BCB_chan",0),i=ext_get_cfg_param("init.ITU_region",0),n=ext_get_cfg_param("max_freq",0),_=(n=ext_get_cfg_param("max_freq",0),"<hr>"+w3_third("w3-margin-bottom w3-text-teal w3-restart","w3-container",w3_input_get("","Initial frequency (kHz)","init.freq","admin_float_cb"),w3_div("w3-center",w3_select("","Initial mode","","init.mode",e,kiwi.modes_u,"admin_select_cb")),w3_input_get("","Initial CW offset (Hz)","init.cw_offset","admin_int_cb"))+w3_third("w3-margin-bottom w3-text-teal w3-restart","w3-container",w3_input_get("","Initial waterfall min (dBFS, fully zoomed-out)","init.min_dB","admin_int_cb"),w3_input_get("","Initial waterfall max (dBFS)","init.max_dB","admin_int_cb"),w3_input_get("","Initial zoom (0-13)","init.zoom","admin_int_cb"))),a=w3_third("w3-margin-bottom w3-text-teal","w3-container",w3_div("w3-restart",w3_input_get("","Frequency scale offset (kHz)","freq_offset","admin_int_cb"),w3_div("w3-text-black","Adds offset to frequency scale. <br> Useful when using a transverter, e.g. set to <br>116000 kHz when 144-148 maps to 28-32 MHz.")),w3_divs("w3-restart/w3-center w3-tspace-8",w3_select("","Max receiver frequency","","max_freq",n,max_freq_i,"admin_select_cb"),w3_div("w3-text-black")),w3_divs("w3-restart/w3-center w3-tspace-8",w3_select_get_param("","SPI clock","","SPI_clock",SPI_clock_i,"admin_select_cb",0),w3_div("w3-text-black","Set to 24 MHz to reduce interference <br> on 2 meters (144-148 MHz).")))+w3_third("w3-margin-bottom w3-text-teal","w3-container",w3_input_get("","S-meter calibration (dB)","S_meter_cal","admin_int_cb"),w3_slider("id-S_meter_OV_counts//","S-meter OV","cfg.S_meter_OV_counts",cfg.S_meter_OV_counts,0,15,1,"config_OV_counts_cb"),w3_input_get("","Waterfall calibration (dB)","waterfall_cal","admin_int_cb"))+w3_third("w3-margin-bottom w3-text-teal","w3-container",w3_div("w3-center w3-tspace-8",w3_select("","ITU region","","init.ITU_region",i,ITU_region_i,"admin_select_cb"),w3_div("w3-text-black","Configures LW/NDB, MW and <br> amateur band allocations, etc.")),w3_div("w3-center w3-tspace-8",w3_select("","Initial AM BCB channel spacing","","init.AM_BCB_chan",t,AM_BCB_chan_i,"admin_select_cb")),w3_divs("w3-restart/w3-center w3-tspace-8",w3_select_get_param("","Status LED brightness","","led_brightness",led_brightness_i,"admin_select_cb",0),w3_div("w3-text-black","Sets brightness of the 4 LEDs <br> that show status info."))),r="<hr>"+w3_div("w3-valign w3-container w3-section",'<header class="w3-container w3-yellow"><h6>Clone configuration from another Kiwi. <b>Use with care.</b> Current configuration is <b><i>not</i></b> saved. This Kiwi immediately restarts after cloning.</h6></header>')+w3_inline_percent("w3-text-teal/w3-container",w3_input("","Clone config from Kiwi host","clone_host","","w3_string_cb","enter hostname (no port number)"),25,w3_input("","Kiwi host root password","clone_pwd","","w3_string_cb","can be blank"),25,w3_select("w3-center//","Config to clone","","clone_files",0,clone_files_s,"w3_num_cb"),15,w3_button("w3-center//w3-red","Clone","config_clone_cb"),10,w3_label("w3-show-inline-block w3-margin-R-16 w3-text-teal","Status:")+w3_div("id-config-clone-status w3-show-inline-block w3-text-black w3-background-pale-aqua",""),25)+w3_inline_percent("w3-margin-bottom w3-text-teal/w3-container","",25,w3_div("w3-center w3-text-black","Not the same as Kiwi admin password.<br>Leave blank unless you've explicitly changed host's Beagle root password."),25),o="<hr>"+w3_div("w3-valign w3-container w3-section",'<header class="w3-container w3-yellow"><h6>If the Kiwi doesn\'t like your external clock you can still connect (user and admin). However the waterfall will be dark and the audio silent.</h6></header>')+w3_third("w3-margin-bottom w3-text-teal","w3-container",w3_divs("w3-restart/w3-center w3-tspace-8",w3_div("","<b>External ADC clock?</b>"),w3_switch("","Yes","No","ext_ADC_clk",cfg.ext_ADC_clk,"config_ext_clk_sel_cb"),w3_text("w3-text-black w3-center","Set when external 66.666600 MHz (nominal) <br> clock connected to J5 connector/pad.")),w3_divs("w3-restart/w3-tspace-8",w3_input("","External clock frequency (enter in MHz or Hz)","ext_ADC_freq",cfg.ext_ADC_freq,"config_ext_freq_cb"),w3_text("w3-text-black","Set exact clock frequency applied. <br> Input value stored in Hz.")),w3_divs("w3-restart/w3-center w3-tspace-8",w3_div("","<b>Enable GPS correction of ADC clock?</b>"),w3_switch("","Yes","No","ADC_clk_corr",cfg.ADC_clk_corr,"admin_radio_YN_cb"),w3_text("w3-text-black w3-center",'Set "no" to keep the Kiwi GPS from correcting for <br>errors in the ADC clock (internal or external).')))+"<hr>"+w3_div("w3-container",w3_div("w3-valign",'<header class="w3-container w3-yellow"><h6>To manually adjust/calibrate the ADC clock (e.g. when there is no GPS signal or GPS correction is disabled) follow these steps:</h6></header>'),w3_label("w3-text-teal","<ul><li>Open a normal user connection to the SDR</li><li>Tune to a time station or other accurate signal and zoom all the way in</li><li>Higher frequency shortwave stations are better because they will show more offset than LF/VLF stations</li><li>Click exactly on the signal carrier line in the waterfall</li><li>On the right-click menu select the <i>cal ADC clock (admin)</i> entry</li><li>You may have to give the admin password if not already authenticated</li><li>The adjustment is calculated and the carrier on the waterfall should move to the nearest 1 kHz marker</li><li>Use the fine-tuning controls on the IQ extension panel if necessary</li></ul>"),w3_label("w3-text-teal","You can fine-tune after the above steps as follows:<ul><li>Open IQ display extension</li><li>Set the receive frequency to the exact nominal carrier (e.g. 15000 kHz for WWV)</li><li>Press the <i>40</i> button (i.e. sets mode to AM with 40 Hz passband)</li><li>Set menus: Draw = points, Mode = carrier, PLL = off</li><li>Adjust the gain until you see a point rotating in a circle</li><li>Use the <i>Fcal</i> buttons to slow the rotation as much as possible</li><li>The total accumulated Fcal adjustment is shown</li><li>A full rotation in less than two seconds is good calibration</li></ul>")),s="<hr>",c=adm.firmware_sel==kiwi.RX3_WF3?1:0;console.log("mode_20kHz="+c);var w="DC_offset"+(c?"_20kHz":"")+"_I",l="DC_offset"+(c?"_20kHz":"")+"_Q";return dbgUs&&(s=s+w3_div("w3-section w3-text-teal w3-bold","Development settings")+w3_third("w3-margin-bottom w3-text-teal w3-restart","w3-container",w3_input_get("","I balance (DC offset)",w,"admin_float_cb"),w3_input_get("","Q balance (DC offset)",l,"admin_float_cb"),"")+w3_third("w3-margin-bottom w3-text-teal w3-restart","w3-container",w3_divs("w3-center w3-tspace-8",w3_div("","<b>Increase web server priority?</b>"),w3_switch("","Yes","No","test_webserver_prio",cfg.test_webserver_prio,"admin_radio_YN_cb"),w3_text("w3-text-black w3-center","Set 'no' for standard behavior.")),"")+"<hr>"),w3_div("id-config w3-hide",_+a+r+o+s)}function config_OV_counts_cb(e,t,i,n){var _=1<<(t=+t);admin_int_cb(e,t),w3_set_label("S-meter OV if &ge; "+_+" ADC OV per 64k samples",e),ext_send("SET ov_counts="+_)}function config_clone_cb(e,t){var i;""==clone_host?i="please enter host to clone from":(i="cloning from "+clone_host,ext_send("SET config_clone host="+encodeURIComponent(clone_host)+" pwd=x"+encodeURIComponent(clone_pwd)+" files="+clone_files)),w3_innerHTML("id-config-clone-status",i)}function config_clone_status_cb(e){var t;0==e?(t="clone complete, restarting Kiwi",ext_send("SET restart"),admin_wait_then_reload(60,"Configuration cloned, restarting KiwiSDR server")):t=1280==e?"wrong password":256==e?"host unknown/unresponsive":"clone error #"+e,w3_innerHTML("id-config-clone-status",t)}function config_ext_clk_sel_cb(e,t){t=+t,admin_radio_YN_cb(e,t),w3_num_set_cfg_cb("cfg.clk_adj",0)}function config_ext_freq_cb(e,t,i){if(!i){var n=parseFloat(t);isNaN(n)?n=null:(n<70?n*=1e6:n<7e4&&(n*=1e3),((n=Math.floor(n))<65e6||n>69e6)&&(n=null)),admin_int_cb(e,n,i)}}function channels_html(){return w3_div("id-channels w3-hide","<hr>"+w3_third("w3-margin-bottom w3-text-teal w3-restart","w3-container","foo","bar","baz"))}function webpage_html(){var e="<hr>"+w3_divs("w3-margin-bottom/w3-container",w3_input("","Top bar title","index_html_params.RX_TITLE","","webpage_title_cb"))+w3_div("w3-container","<label><b>Top bar title HTML preview</b></label>",w3_div("id-webpage-title-preview w3-text-black w3-background-pale-aqua",""))+w3_divs("w3-margin-top w3-margin-bottom/w3-container",w3_input("","Owner info (appears in center of top bar; can use HTML like &lt;br&gt; for line break if line is too long)","owner_info","","webpage_owner_info_cb"))+w3_div("w3-container","<label><b>Owner info HTML preview</b></label>",w3_div("id-webpage-owner-info-preview w3-text-black w3-background-pale-aqua",""))+w3_divs("w3-margin-top w3-margin-bottom/w3-container",w3_input("","Status","status_msg","","webpage_status_cb"))+w3_div("w3-container","<label><b>Status HTML preview</b></label>",w3_div("id-webpage-status-preview w3-text-black w3-background-pale-aqua",""))+w3_divs("w3-margin-top/w3-container",w3_input("","Window/tab title","index_html_params.PAGE_TITLE","","webpage_string_cb")),t="<hr>"+w3_half("w3-margin-bottom","w3-container",w3_input("","Location","index_html_params.RX_LOC","","webpage_string_cb"),w3_input("",w3_label("w3-bold","Grid square (4 or 6 char) ")+w3_div("id-webpage-grid-check cl-admin-check w3-show-inline-block w3-green w3-btn w3-round-large"),"index_html_params.RX_QRA","","webpage_input_grid"))+w3_half("","w3-container",w3_input("","Altitude (ASL meters)","index_html_params.RX_ASL","","webpage_string_cb"),w3_input("",w3_label("w3-bold","Map (Google format or lat, lon) ")+w3_div("id-webpage-map-check cl-admin-check w3-show-inline-block w3-green w3-btn w3-round-large"),"index_html_params.RX_GMAP","","webpage_input_map"))+"<hr>"+w3_half("w3-margin-bottom","w3-container",w3_half("","",w3_div("",w3_label("w3-bold","Photo file"),'<input id="id-photo-file" type="file" accept="image/*" onchange="webpage_photo_file_upload()"/>',w3_div("id-photo-error","")),w3_checkbox_get_param("w3-restart w3-label-inline","Photo left margin","index_html_params.RX_PHOTO_LEFT_MARGIN","admin_bool_cb",!0)),w3_input("","Photo maximum height (pixels)","index_html_params.RX_PHOTO_HEIGHT","","webpage_string_cb"))+w3_half("","w3-container",w3_input("","Photo title","index_html_params.RX_PHOTO_TITLE","","webpage_string_cb"),w3_input("","Photo description","index_html_params.RX_PHOTO_DESC","","webpage_string_cb")),i="<hr>"+w3_half("w3-margin-bottom w3-text-teal","w3-container",w3_divs("/w3-center w3-tspace-8",w3_div("","<b>Web server caching?</b>"),w3_switch("","Yes","No","webserver_caching",cfg.webserver_caching,"admin_radio_YN_cb"),w3_text("w3-text-black w3-center",'Set "No" when there are caching problems in your <br>network path, e.g. user interface icons don\'t load.')))+"<hr>"+w3_div("w3-container",w3_textarea_get_param("w3-input-any-change|width:100%",w3_label("w3-show-inline-block w3-bold w3-text-teal","Additional HTML/Javascript for HTML &lt;head&gt; element (e.g. Google analytics or user customization)"),"index_html_params.HTML_HEAD",10,100,"webpage_string_cb",""))+w3_divs("w3-margin-bottom/w3-container","");return w3_div("id-webpage w3-text-teal w3-hide",e+t+i)}function webpage_input_grid(e,t){webpage_string_cb(e,t),webpage_update_check_grid()}function webpage_update_check_grid(){var e=ext_get_cfg_param("index_html_params.RX_QRA");w3_el("webpage-grid-check").innerHTML='<a href="http://www.levinecentral.com/ham/grid_square.php?Grid='+e+'" target="_blank">check grid</a>'}function webpage_input_map(e,t){webpage_string_cb(e,t),webpage_update_check_map()}function webpage_update_check_map(){var e=ext_get_cfg_param("index_html_params.RX_GMAP");w3_el("webpage-map-check").innerHTML='<a href="https://google.com/maps/place/'+e+'" target="_blank">check map</a>'}function webpage_photo_uploaded(e){var t;0==(t=null!=e.AJAX_error?-1:e.r)&&webpage_string_cb("index_html_params.RX_PHOTO_FILE","kiwi.config/photo.upload");var i,n=w3_el("photo-error");switch(t){case-1:i="Communication error";break;case 0:i="Upload successful";break;case 1:i="Authentication failed";break;case 2:i="Not an image file?";break;case 3:i="Unable to determine file type";break;case 4:i="File too large";break;default:i="Undefined error?"}n.innerHTML=i,w3_add(n,0==t?"w3-text-green":"w3-text-red"),w3_show_block(n)}function webpage_photo_file_upload(){ext_get_authkey(function(e){webpage_photo_file_upload2(e)})}function webpage_photo_file_upload2(e){var t=w3_el("id-photo-file");t.innerHTML="Uploading...";var i=t.files[0],n=new FormData;n.append("photo",i,i.name);var _=w3_el("photo-error");w3_hide(_),w3_remove(_,"w3-text-red"),w3_remove(_,"w3-text-green"),kiwi_ajax_send(n,"/PIX?"+e,"webpage_photo_uploaded")}function webpage_title_cb(e,t){webpage_string_cb(e,t),w3_el("id-webpage-title-preview").innerHTML=admin_preview_status_box(cfg.index_html_params.RX_TITLE)}function webpage_owner_info_cb(e,t){webpage_string_cb(e,t),w3_el("id-webpage-owner-info-preview").innerHTML=admin_preview_status_box(cfg.owner_info)}function webpage_status_cb(e,t){w3_string_set_cfg_cb(e,t),w3_el("id-webpage-status-preview").innerHTML=admin_preview_status_box(cfg.status_msg)}function webpage_focus(){admin_set_decoded_value("index_html_params.RX_TITLE"),w3_el("id-webpage-title-preview").innerHTML=admin_preview_status_box(cfg.index_html_params.RX_TITLE),admin_set_decoded_value("status_msg"),w3_el("id-webpage-status-preview").innerHTML=admin_preview_status_box(cfg.status_msg),admin_set_decoded_value("index_html_params.PAGE_TITLE"),admin_set_decoded_value("index_html_params.RX_LOC"),admin_set_decoded_value("index_html_params.RX_QRA"),admin_set_decoded_value("index_html_params.RX_ASL"),admin_set_decoded_value("index_html_params.RX_GMAP"),admin_set_decoded_value("index_html_params.RX_PHOTO_HEIGHT"),admin_set_decoded_value("index_html_params.RX_PHOTO_TITLE"),admin_set_decoded_value("index_html_params.RX_PHOTO_DESC"),admin_set_decoded_value("owner_info"),w3_el("id-webpage-owner-info-preview").innerHTML=admin_preview_status_box(cfg.owner_info),webpage_update_check_grid(),webpage_update_check_map()}function webpage_string_cb(e,t){w3_string_set_cfg_cb(e,t),ext_send("SET reload_index_params")}function sdr_hu_html(){var e=w3_div("w3-tspace-16",w3_div("id-need-gps w3-valign w3-hide",'<header class="w3-container w3-yellow"><h5>Warning: GPS location field set to the default, please update</h5></header>'),w3_div("w3-valign",'<header class="w3-container w3-yellow"><h5>More information on <a href="http://kiwisdr.com/quickstart/index.html#id-sdr_hu" target="_blank">kiwisdr.com</a><br><br>To list your Kiwi on <a href="http://kiwisdr.com/public" target="_blank">kiwisdr.com/public</a> edit the fields below and set the register switch to <b>Yes</b>.<br>Look for a successful status result after a few minutes.<br><br>To list your Kiwi on <a href="https://sdr.hu" target="_blank">sdr.hu</a> edit the fields below and obtain an API key from <a href="https://sdr.hu/register" target="_blank">sdr.hu/register</a> and enter it into the <b>API key</b> field.<br>Then set the register switch to <b>Yes</b> and look for a status result of "SUCCESS ..." after a few minutes.</h5></header>'))+"<hr>"+w3_half("w3-margin-bottom","w3-container",w3_div("",'<b>Register on <a href="http://kiwisdr.com/public" target="_blank">kiwisdr.com/public</a>?</b> '+w3_switch("","Yes","No","adm.kiwisdr_com_register",adm.kiwisdr_com_register,"kiwisdr_com_register_cb")),w3_div("",'<b>Register on <a href="https://sdr.hu/?top=kiwi" target="_blank">sdr.hu</a>?</b> '+w3_switch("","Yes","No","adm.sdr_hu_register",adm.sdr_hu_register,"sdr_hu_register_cb")))+w3_half("w3-margin-bottom","w3-container",w3_div(),w3_div("w3-restart",w3_input("","sdr.hu API key","adm.api_key","","w3_string_set_cfg_cb","enter value returned from sdr.hu/register process")))+w3_half("","",w3_div("id-kiwisdr_com-reg-status-container",w3_div("w3-container",w3_label("w3-show-inline-block w3-margin-R-16 w3-text-teal","kiwisdr.com registration status:")+w3_div("id-kiwisdr_com-reg-status w3-show-inline-block w3-text-black",""))),w3_div("id-sdr_hu-reg-status-container",w3_div("w3-container",w3_label("w3-show-inline-block w3-margin-R-16 w3-text-teal","sdr.hu registration status:")+w3_div("id-sdr_hu-reg-status w3-show-inline-block w3-text-black","")))),t="<hr>"+w3_half("w3-margin-bottom w3-restart","w3-container",w3_input("","Name","rx_name","","w3_string_set_cfg_cb"),w3_input("","Location","rx_location","","w3_string_set_cfg_cb"))+w3_half("w3-margin-bottom w3-restart","w3-container",w3_input("","Admin email","admin_email","","w3_string_set_cfg_cb"),w3_input("","Antenna","rx_antenna","","w3_string_set_cfg_cb"))+w3_third("w3-margin-bottom w3-restart","w3-container",w3_input("",w3_label("w3-bold","Grid square (4/6 char) ")+w3_div("id-public-grid-check cl-admin-check w3-show-inline-block w3-green w3-btn w3-round-large")+" "+w3_div("id-public-grid-set cl-admin-check w3-blue w3-btn w3-round-large w3-hide","set from GPS"),"rx_grid","","sdr_hu_input_grid"),w3_div("",w3_input("",w3_label("w3-bold","Location (lat, lon) ")+w3_div("id-public-gps-check cl-admin-check w3-show-inline-block w3-green w3-btn w3-round-large")+" "+w3_div("id-public-gps-set cl-admin-check w3-blue w3-btn w3-round-large w3-hide","set from GPS"),"rx_gps","","sdr_hu_check_gps"),w3_div("w3-text-black","Format: (nn.nnnnnn, nn.nnnnnn)")),w3_input_get("","Altitude (ASL meters)","rx_asl","admin_int_cb"))+"<hr>"+w3_half("w3-margin-bottom","w3-container","<b>Display owner/admin email link on KiwiSDR main page?</b> "+w3_switch("","Yes","No","contact_admin",cfg.contact_admin,"admin_radio_YN_cb"),"")+"<hr>"+w3_half("w3-margin-bottom","w3-container",w3_div("",w3_input_get("","Coverage frequency low (kHz)","sdr_hu_lo_kHz","admin_int_cb"),w3_div("w3-text-black",'These two settings effect the frequency coverage label displayed on sdr.hu <br>e.g. when set to 0 and 30000 sdr.hu shows "HF". If you\'re using a transverter <br>then appropriate entries will cause "2m" or "70cm" to be shown. Other labels will be <br>shown if you limit the range at HF due to antenna or filtering limitations. <br>These settings don\'t apply to listings at kiwisdr.com/public')),w3_input_get("","Coverage frequency high (kHz)","sdr_hu_hi_kHz","admin_int_cb"));return w3_div("id-sdr_hu w3-text-teal w3-hide",e+t)}function kiwisdr_com_register_cb(e,t){var i,n;(t=+t)==w3_SWITCH_YES_IDX&&""==cfg.server_url?(i='Error, you must first setup a valid Kiwi connection URL on the admin "connect" tab',n="#ffeb3b",w3_switch_set_value(e,w3_SWITCH_NO_IDX),t=w3_SWITCH_NO_IDX):t==w3_SWITCH_YES_IDX?(i="(waiting for kiwisdr.com response, can take several minutes in some cases)",n="hsl(180, 100%, 95%)"):(i="(registration not enabled)",n="hsl(180, 100%, 95%)"),w3_innerHTML("id-kiwisdr_com-reg-status",i),w3_color("id-kiwisdr_com-reg-status",null,n),admin_radio_YN_cb(e,t)}function sdr_hu_register_cb(e,t){var i,n;(t=+t)==w3_SWITCH_YES_IDX&&""==cfg.server_url?(i='Error, you must first setup a valid Kiwi connection URL on the admin "connect" tab',n="#ffeb3b",w3_switch_set_value(e,w3_SWITCH_NO_IDX),t=w3_SWITCH_NO_IDX):t==w3_SWITCH_YES_IDX?(i="(waiting for sdr.hu response, can take several minutes in some cases)",n="hsl(180, 100%, 95%)"):(i="(registration not enabled)",n="hsl(180, 100%, 95%)"),w3_innerHTML("id-sdr_hu-reg-status",i),w3_color("id-sdr_hu-reg-status",null,n),admin_radio_YN_cb(e,t)}function sdr_hu_focus(){admin_set_decoded_value("rx_name"),admin_set_decoded_value("rx_location"),admin_set_decoded_value("rx_antenna"),admin_set_decoded_value("rx_grid"),admin_set_decoded_value("rx_gps"),admin_set_decoded_value("admin_email"),admin_set_decoded_value("adm.api_key"),sdr_hu_check_gps("rx_gps",decodeURIComponent(ext_get_cfg_param("rx_gps")),!0),public_update_check_grid(),public_update_check_map(),w3_el("id-public-grid-set").onclick=function(){var e=admin.reg_status.grid;w3_set_value("rx_grid",e),w3_input_change("rx_grid","sdr_hu_input_grid")},w3_el("id-public-gps-set").onclick=function(){var e="("+admin.reg_status.lat+", "+admin.reg_status.lon+")";w3_set_value("rx_gps",e),w3_input_change("rx_gps","sdr_hu_check_gps")},ext_send("SET public_update"),sdr_hu_interval=setInterval(function(){ext_send("SET public_update")},5e3),kiwisdr_com_register_cb("adm.kiwisdr_com_register",adm.kiwisdr_com_register?w3_SWITCH_YES_IDX:w3_SWITCH_NO_IDX),sdr_hu_register_cb("adm.sdr_hu_register",adm.sdr_hu_register?w3_SWITCH_YES_IDX:w3_SWITCH_NO_IDX)}function sdr_hu_input_grid(e,t){w3_string_set_cfg_cb(e,t),public_update_check_grid()}function public_update_check_grid(){var e=ext_get_cfg_param("rx_grid");w3_el("id-public-grid-check").innerHTML='<a href="http://www.levinecentral.com/ham/grid_square.php?Grid='+e+'" target="_blank">check grid</a>'}function sdr_hu_check_gps(e,t,i){for(var n=0,_=0,a=/([-]?\d*\.?\d+)/g,r=0;r<2;r++){var o=a.exec(t);o&&(r?_=parseFloat(o[0]):n=parseFloat(o[0]))}"(-37.631120, 176.172210)"==(t="("+n.toFixed(6)+", "+_.toFixed(6)+")")||"(-37.631120%2C%20176.172210)"==t?(w3_show_block("id-need-gps"),w3_flag("rx_gps")):(w3_hide("id-need-gps"),w3_unflag("rx_gps")),w3_string_set_cfg_cb(e,t,i),w3_set_value(e,t),public_update_check_map()}function public_update_check_map(){var e=decodeURIComponent(ext_get_cfg_param("rx_gps"));e=e.substring(1,e.length-1),w3_el("id-public-gps-check").innerHTML='<a href="https://google.com/maps/place/'+e+'" target="_blank">check map</a>'}function sdr_hu_blur(e){kiwi_clearInterval(sdr_hu_interval)}function public_update(e){var t=decodeURIComponent(e);admin.reg_status=JSON.parse(t),adm.kiwisdr_com_register&&null!=admin.reg_status.kiwisdr_com&&""!=admin.reg_status.kiwisdr_com&&w3_innerHTML("id-kiwisdr_com-reg-status","kiwisdr.com/public registration: successful"),adm.sdr_hu_register&&null!=admin.reg_status.sdr_hu&&""!=admin.reg_status.sdr_hu&&w3_innerHTML("id-sdr_hu-reg-status",admin.reg_status.sdr_hu),null!=admin.reg_status.lat&&(w3_show_inline_block("id-public-grid-set"),w3_show_inline_block("id-public-gps-set"))}function dx_html(){return w3_div("id-dx w3-hide",w3_div("w3-container w3-margin-top","TODO.."))}function dx_focus(){}function dx_hide(){}var ext_cur_nav,dxo={};function dx_json(e){}function dx_json2(e){e.dx.length;var t,i="";for(dxo.tags=[],t=-1;t<4;t++){var n=null,_="",a=0,r="",o="",s="",c=0,w="",l="",d="",g=function(e){return-1==t?"w3-hide":e},u=function(e){return-1==t?e:""};if(-1!=t){_=(n=e.dx[t])[0],a=kiwi.modes_s[n[1].toLowerCase()],r=decodeURIComponent(n[2]),o=decodeURIComponent(n[3]),n[4],d=n[5],dxo.tags[t]=d;var b=0,m=0,p=n[6];p&&(c=1==p.WL?types_s.watch_list:1==p.SB?types_s.sub_band:1==p.DG?types_s.DGPS:1==p.NoN?types_s.special_event:1==p.SE?types_s.special_event:1==p.XX?types_s.interference:1==p.MK?types_s.masked:0,p.lo&&(b=+p.lo),p.hi&&(m=+p.hi),p.o&&(w=p.o),p.p&&(l=p.p)),(b||m)&&(s=b==-m?(2*Math.abs(m)).toFixed(0):b.toFixed(0)+", "+m.toFixed(0))}console.log("i="+t+" mo="+a+" ty="+c),console.log(n);var h=w3_divs("w3-text-teal/w3-margin-T-8",w3_col_percent("",w3_col_percent("w3-valign/w3-hspace-16",-1==t?"":w3_button("w3-font-fixed w3-padding-tiny w3-selection-green","+","dx_add_cb",t),1,-1==t?"":w3_button("w3-font-fixed w3-padding-tiny w3-red","-","dx_rem_cb",t),1,w3_input(g("w3-padding-small||size=8"),u("Freq"),"dxo.f_"+t,_,"dx_num_cb"),19,w3_select(g(""),u("Mode"),"","dxo.m_"+t,a,kiwi.modes_u,"dx_sel_cb"),19,w3_input(g("w3-padding-small||size=4"),u("Passband"),"dxo.pb_"+t,s,"dx_passband_cb"),19,w3_select(g(""),u("Type"),"","dxo.y_"+t,c,types,"dx_sel_cb"),19,w3_input(g("w3-padding-small||size=2"),u("Offset"),"dxo.o_"+t,w,"dx_num_cb"),19),45,w3_col_percent("w3-valign/w3-margin-left",w3_input(g("w3-padding-small"),u("Ident"),"dxo.i_"+t,r,"dx_string_cb"),40,w3_input(g("w3-padding-small"),u("Notes"),"dxo.n_"+t,o,"dx_string_cb"),40,w3_input(g("w3-padding-small"),u("Extension"),"dxo.p_"+t,l,"dx_string_cb"),20),54));-1==t?w3_innerHTML("id-dx-list-legend",h):i+=h}w3_el("id-dx-list").style.overflowY="scroll",w3_innerHTML("id-dx-list",i)}function dx_filter_cb(e,t){console.log("dx_filter_cb p="+t)}function dx_add_cb(e,t){console.log("dx_add p="+t)}function dx_rem_cb(e,t){console.log("dx_rem p="+t)}function extensions_html(){return w3_div("id-extensions w3-hide w3-section",w3_sidenav("id-extensions-nav"),w3_div("id-extensions-config"))}function extensions_focus(){w3_el("id-nav-wspr")&&w3_click_nav(kiwi_toggle(toggle_e.FROM_COOKIE|toggle_e.SET,"wspr","wspr","last_admin_ext_nav"),"extensions_nav")}function extensions_blur(){ext_cur_nav&&w3_call(ext_cur_nav+"_config_blur")}function extensions_nav_focus(e,t){writeCookie("last_admin_ext_nav",e),w3_show(e+"-container"),w3_call(e+"_config_focus"),ext_cur_nav=e}function extensions_nav_blur(e,t){w3_hide(e+"-container"),w3_call(e+"_config_blur")}var ext_seq=0;function ext_admin_config(e,t,i,n){null==n&&(n=null);var _=ext_seq%admin_colors.length;w3_el("id-extensions-nav").innerHTML+=w3_nav(admin_colors[_]+" w3-border",t,e,"extensions_nav"),ext_seq++,w3_el("id-extensions-config").innerHTML+=w3_div("id-"+e+"-container w3-hide|width:95%",i)}function ext_config_html(e,t,i,n,_){var a=e.ext_name;e.enable=ext_get_cfg_param(t+".enable",!0,EXT_SAVE),ext_admin_config(a,i,w3_div("id-"+a+" w3-text-teal w3-hide",w3_col_percent("w3-valign/",w3_div("w3-bold",n),40,w3_inline("",w3_div("w3-bold w3-margin-R-8","User enabled?"),w3_switch("","Yes","No",t+".enable",e.enable,"admin_radio_YN_cb"),w3_div("w3-text-black w3-margin-L-32","Local connections exempt.")))+"<hr>"+(_||"")))}
\ No newline at end of file
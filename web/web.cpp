@@ -41,6 +41,7 @@ Boston, MA  02110-1301, USA.
 #include <stdlib.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <zlib.h>
 
 // This file is compiled twice into two different object files:
 // Once with EDATA_EMBED defined when installed as the production server in /usr/local/bin
@@ -192,7 +193,7 @@ static const char* edata(const char *uri, bool cache_check, size_t *size, time_t
 	// so this code is not enclosed in an "#ifdef EDATA_DEVEL".
 	if (!data) {
 
-        // Since the file content must be known during the cache_check pass (for "%[" substitution dirty testing)
+        // Since the file content must be known during the cache_check pass (for the "%[" substitution render)
         // keep the content buffer for the possible fetch_file pass which might happen immediately after.
 		static char *last_uri2_read;
 		static const char *last_data, *last_free;
@@ -420,6 +421,9 @@ typedef struct {
 static iparams_t iparams[N_IPARAMS];
 static int n_iparams;
 
+// Bumped whenever iparams[] changes so pre-rendered %[] substitutions are redone.
+static int iparams_gen;
+
 void iparams_add(const char *id, char *encoded)
 {
     // Save encoded in case it's a string. This is needed for
@@ -432,6 +436,8 @@ void iparams_add(const char *id, char *encoded)
     mg_url_decode(ip->encoded, n, ip->decoded, n + SPACE_FOR_NULL, 0);
     //printf("iparams_add: %d %s <%s>\n", n_iparams, ip->id, ip->decoded);
 	n_iparams++;
+
+	iparams_gen++;
 }
 
 bool index_params_cb(cfg_t *cfg, void *param, jsmntok_t *jt, int seq, int hit, int lvl, int rem, void **rval)
@@ -549,6 +555,136 @@ void reload_index_params()
 }
 
 
+// NB: returns NULL if gzip isn't smaller
+char *web_gzip(const char *s, int len, int *gz_len)
+{
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15+16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return NULL;        // 15+16: gzip header and trailer rather than zlib
+
+    int size = deflateBound(&zs, len);
+    char *gz = (char *) malloc(size);
+    zs.next_in = (Bytef *) s;
+    zs.avail_in = len;
+    zs.next_out = (Bytef *) gz;
+    zs.avail_out = size;
+    int rc = deflate(&zs, Z_FINISH);
+    *gz_len = size - zs.avail_out;
+    deflateEnd(&zs);
+
+    if (rc != Z_STREAM_END || *gz_len >= len) {
+        free(gz);
+        return NULL;
+    }
+    return gz;
+}
+
+
+// Pre-rendered %[] substitutions of .html and .css files containing any.
+// A file is rendered once per iparams generation and file version (size, mtime) and then served
+// from memory, together with a gzip'd copy. The etag is a hash of the rendered content, so a
+// render gets 304 handling like any other file and a changed substitution is always re-sent.
+// The least recently used entry is replaced when the cache is full.
+
+#define N_RENDER_CACHE      16
+#define RENDER_GZIP_MIN     256
+
+typedef struct {
+    char *uri;
+    size_t src_size;
+    time_t src_mtime;
+    int gen;
+    u4_t last_used;
+    char *raw, *gz;
+    int raw_len, gz_len;
+    char etag[N_ETAG], etag_gz[N_ETAG];
+} render_cache_t;
+
+static render_cache_t render_cache[N_RENDER_CACHE];
+static u4_t render_cache_seq;
+
+static char *iparams_render(const char *data, int size, int *len)
+{
+    int i, cl, nl, pl, sl;
+    int nsize = size + 1;
+    char *html_data = (char *) malloc(nsize);
+    const char *cp = data, *pp;
+
+    for (cl=nl=0; cl < size;) {
+        if (*cp == '%' && cl+1 < size && *(cp+1) == '[') {
+            cp += 2; cl += 2; pp = cp; pl = 0;
+            while (cl < size && *cp != ']') { cp++; cl++; pl++; }
+            cp++; cl++;
+
+            for (i=0; i < n_iparams; i++) {
+                iparams_t *ip = &iparams[i];
+                if (strncmp(pp, ip->id, pl) == 0) {
+                    sl = strlen(ip->decoded);
+                    nsize += sl;
+                    html_data = (char *) realloc(html_data, nsize);
+                    memcpy(html_data + nl, ip->decoded, sl); nl += sl;
+                    break;
+                }
+            }
+
+            if (i == n_iparams) {
+                // not found, put back original
+                memcpy(html_data + nl, "%[", 2);
+                memcpy(html_data + nl + 2, pp, pl);
+                html_data[nl + 2 + pl] = ']';
+                nl += pl + 3;
+            }
+        } else {
+            html_data[nl++] = *cp++; cl++;
+        }
+
+        assert(nl <= nsize);
+    }
+
+    *len = nl;
+    return html_data;
+}
+
+static render_cache_t *render_cache_lookup(const char *uri, const char *data, size_t size, time_t mtime)
+{
+    int i;
+    render_cache_t *rc, *lru = &render_cache[0];
+
+    for (i = 0; i < N_RENDER_CACHE; i++) {
+        rc = &render_cache[i];
+        if (rc->uri != NULL && strcmp(rc->uri, uri) == 0) break;
+        if (rc->last_used < lru->last_used) lru = rc;     // free entries have last_used == 0
+    }
+    
+    if (i == N_RENDER_CACHE) {
+        rc = lru;
+        free(rc->uri);
+        rc->uri = strdup(uri);
+    }
+    rc->last_used = ++render_cache_seq;
+    if (i != N_RENDER_CACHE && rc->gen == iparams_gen && rc->src_size == size && rc->src_mtime == mtime)
+        return rc;
+
+    free(rc->raw);
+    free(rc->gz);
+    rc->raw = iparams_render(data, size, &rc->raw_len);
+    rc->gz = (rc->raw_len >= RENDER_GZIP_MIN)? web_gzip(rc->raw, rc->raw_len, &rc->gz_len) : NULL;
+    rc->src_size = size;
+    rc->src_mtime = mtime;
+    rc->gen = iparams_gen;
+
+    // FNV-1a of the content, as for the AJAX cache
+    u4_t hash = 2166136261U;
+    for (i = 0; i < rc->raw_len; i++)
+        hash = (hash ^ (u1_t) rc->raw[i]) * 16777619U;
+    snprintf(rc->etag, sizeof(rc->etag), "\"%08x.%x\"", hash, rc->raw_len);
+    snprintf(rc->etag_gz, sizeof(rc->etag_gz), "\"%08x.%x.gz\"", hash, rc->raw_len);
+    web_printf_all("%-16s %s size=%d gz=%d gen=%d\n", "RENDER", uri, rc->raw_len, rc->gz? rc->gz_len : 0, rc->gen);
+    return rc;
+}
+
+
 // event requests _from_ web server:
 // (prompted by data coming into web server)
 //	1) handle incoming websocket data
@@ -842,6 +978,8 @@ int web_request(struct mg_connection *mc, enum mg_event evt) {
 
     // try as AJAX request
     char *ajax_data;
+    ajax_cache_rsp_t ajax_rsp;
+    memset(&ajax_rsp, 0, sizeof(ajax_rsp));
     bool isAJAX = false, free_ajax_data = false;
     if (!edata_data) {
     
@@ -852,7 +990,7 @@ int web_request(struct mg_connection *mc, enum mg_event evt) {
             return MG_FALSE;
         }
         //printf("rx_server_ajax: %s\n", mc->uri);
-        ajax_data = rx_server_ajax(mc);     // mc->uri is o_uri without ui->name prefix
+        ajax_data = rx_server_ajax(mc, &ajax_rsp);     // mc->uri is o_uri without ui->name prefix
         if (ajax_data) {
             if (FROM_VOID_PARAM(ajax_data) == -1) {
                 if (free_uri) free(uri);
@@ -861,9 +999,15 @@ int web_request(struct mg_connection *mc, enum mg_event evt) {
             }
             
             edata_data = ajax_data;
-            edata_size = kstr_len((char *) ajax_data);
             isAJAX = true;
-            free_ajax_data = true;
+            if (ajax_rsp.etag) {
+                // snapshot owned by the AJAX cache, possibly gzip'd
+                edata_size = ajax_rsp.size;
+                is_gzip = ajax_rsp.is_gzip;
+            } else {
+                edata_size = kstr_len((char *) ajax_data);
+                free_ajax_data = true;
+            }
         }
     }
 
@@ -875,60 +1019,20 @@ int web_request(struct mg_connection *mc, enum mg_event evt) {
         return MG_FALSE;
     }
     
-    // for *.html and *.css process %[substitution]
-    char *html_data;
-    bool free_html_data = false;
+    // for *.html and *.css with %[substitutions] serve the cached render
+    // (an already gzip'd file can't have any substitutions so is sent as-is)
     suffix = strrchr(uri, '.');     // NB: can't use previous suffix -- uri may have changed recently in some cases
-    
-    bool dirty = false;		// must never return a 304 if a %[] substitution was made!
-    if (!isAJAX && suffix && (strcmp(suffix, ".html") == 0 || strcmp(suffix, ".css") == 0)) {
-        int nsize = edata_size;
-        html_data = (char *) kiwi_malloc("html_data", nsize);
-        free_html_data = true;
-        char *cp = (char *) edata_data, *np = html_data, *pp;
-        int cl, sl, pl, nl;
-
-        //printf("checking for \"%%[\": %s %d\n", uri, nsize);
-
-        for (cl=nl=0; cl < edata_size;) {
-            if (*cp == '%' && *(cp+1) == '[') {
-                cp += 2; cl += 2; pp = cp; pl = 0;
-                while (*cp != ']' && cl < edata_size) { cp++; cl++; pl++; }
-                cp++; cl++;
-                
-                for (i=0; i < n_iparams; i++) {
-                    iparams_t *ip = &iparams[i];
-                    if (strncmp(pp, ip->id, pl) == 0) {
-                        sl = strlen(ip->decoded);
-
-                        // expand buffer
-                        html_data = (char *) kiwi_realloc("html_data", html_data, nsize+sl);
-                        np = html_data + nl;		// in case buffer moved
-                        nsize += sl;
-                        //printf("%d %%[%s] %d <%s> %s\n", nsize, ip->id, sl, ip->decoded, uri);
-                        strcpy(np, ip->decoded); np += sl; nl += sl;
-                        dirty = true;
-                        break;
-                    }
-                }
-                
-                if (i == n_iparams) {
-                    // not found, put back original
-                    strcpy(np, "%["); np += 2;
-                    strncpy(np, pp, pl); np += pl;
-                    *np++ = ']';
-                    nl += pl + 3;
-                }
-            } else {
-                *np++ = *cp++; nl++; cl++;
-            }
-
-            assert(nl <= nsize);
-        }
-        
-        assert((np - html_data) == nl);
-        edata_data = html_data;
-        edata_size = nl;
+    bool vary_gzip = false;
+    mc->cache_info.etag_content[0] = '\0';
+    if (!isAJAX && !is_gzip && suffix && (strcmp(suffix, ".html") == 0 || strcmp(suffix, ".css") == 0) &&
+        memmem(edata_data, edata_size, "%[", 2) != NULL) {
+        render_cache_t *rc = render_cache_lookup(uri, edata_data, edata_size, mtime);
+        const char *ae = mg_get_header(mc, "Accept-Encoding");
+        is_gzip = (rc->gz != NULL && ae != NULL && strstr(ae, "gzip") != NULL);
+        edata_data = is_gzip? rc->gz : rc->raw;
+        edata_size = is_gzip? rc->gz_len : rc->raw_len;
+        kiwi_strncpy(mc->cache_info.etag_content, is_gzip? rc->etag_gz : rc->etag, N_ETAG);
+        vary_gzip = (rc->gz != NULL);
     }
     
     // Add version checking to each .js file served.
@@ -947,36 +1051,53 @@ int web_request(struct mg_connection *mc, enum mg_event evt) {
     //		server running in background (production) mode: build time of server binary.
     //		server running in foreground (development) mode: stat is fetched from filesystems, else build time of server binary.
     
-    // NB: Will see cases of etag_match=N but not_mod_since=Y because of %[] substitution.
-    // The size in the etag is different due to the substitution, but the underlying file mtime hasn't changed.
+    // NB: A %[] render keeps the mtime of the file but its etag is a hash of the render,
+    // and its size is that of the (possibly gzip'd) render actually sent.
     
     mc->cache_info.st.st_size = edata_size + ver_size;
     if (!isAJAX) assert(mtime != 0);
     mc->cache_info.st.st_mtime = mtime;
 
     if (!(isAJAX && evt == MG_CACHE_INFO)) {		// don't print for isAJAX + MG_CACHE_INFO nop case
-        web_printf_all("%-16s %s:%05d%s size=%6d dirty=%d mtime=[%s] %s %s %s%s\n", (evt == MG_CACHE_INFO)? "MG_CACHE_INFO" : "MG_REQUEST",
+        web_printf_all("%-16s %s:%05d%s size=%6d mtime=[%s] %s %s %s%s\n", (evt == MG_CACHE_INFO)? "MG_CACHE_INFO" : "MG_REQUEST",
             remote_ip, mc->remote_port, is_sdr_hu? "[sdr.hu]":"",
-            mc->cache_info.st.st_size, dirty, var_ctime_static(&mtime), isAJAX? mc->uri : uri, mg_get_mime_type(isAJAX? mc->uri : uri, "text/plain"),
+            mc->cache_info.st.st_size, var_ctime_static(&mtime), isAJAX? mc->uri : uri, mg_get_mime_type(isAJAX? mc->uri : uri, "text/plain"),
             (mc->query_string != NULL)? "qs:" : "", (mc->query_string != NULL)? mc->query_string : "");
     }
 
     bool isImage = (suffix && (strcmp(suffix, ".png") == 0 || strcmp(suffix, ".jpg") == 0 || strcmp(suffix, ".ico") == 0));
     int rtn = MG_TRUE;
+    const char *inm;
     if (evt == MG_CACHE_INFO) {
-        if (dirty || isAJAX || is_sdr_hu || web_nocache || !webserver_caching) {
+        if (isAJAX || is_sdr_hu || web_nocache || !webserver_caching) {
             //web_printf_all("%-16s NO CACHE %s%s\n", "MG_CACHE_INFO", is_sdr_hu? "sdr.hu " : "", uri);
-            web_printf_all("%-16s NO CACHE %s%s%s%s\n", "MG_CACHE_INFO",
-                dirty? "dirty-%[] " : "", isAJAX? "AJAX " : "", is_sdr_hu? "sdr.hu " : "", uri);
+            web_printf_all("%-16s NO CACHE %s%s%s\n", "MG_CACHE_INFO",
+                isAJAX? "AJAX " : "", is_sdr_hu? "sdr.hu " : "", uri);
             rtn = MG_FALSE;		// returning false here will prevent any 304 decision based on the mtime set above
         }
+    } else
+    if (isAJAX && ajax_rsp.etag && (inm = mg_get_header(mc, "If-None-Match")) != NULL && strstr(inm, ajax_rsp.etag) != NULL) {
+        // Cached AJAX snapshot is unchanged since the client's copy.
+        // Headers only, no body or terminating chunk, so the connection stays usable for keep-alive.
+        mg_send_status(mc, 304);
+        mg_send_header(mc, "Etag", ajax_rsp.etag);
+        mg_send_header(mc, "Access-Control-Allow-Origin", "*");
+        mg_write(mc, "\r\n", 2);
+        web_printf_sent("%-16s %6d %11s %s\n", "webserver", 0, "AJAX-304", mc->uri);
+        edata_size = 0;
     } else {
         const char *hdr_type;
     
         // NB: prevent AJAX responses from getting cached by not sending standard headers which include etag etc!
+        // Cached AJAX snapshots send their own etag with "no-cache" so clients must revalidate every time.
         if (isAJAX) {
             //printf("AJAX: %s %s\n", mc->uri, uri);
             mg_send_header(mc, "Content-Type", "text/plain");
+            if (ajax_rsp.etag) {
+                mg_send_header(mc, "Etag", ajax_rsp.etag);
+                mg_send_header(mc, "Cache-Control", "no-cache");
+                mg_send_header(mc, "Vary", "Accept-Encoding");
+            }
             
             // needed by, e.g., auto-discovery port scanner
             // SECURITY FIXME: can we detect a special request header in the pre-flight and return this selectively?
@@ -1001,6 +1122,7 @@ int web_request(struct mg_connection *mc, enum mg_event evt) {
         }
         
         if (is_gzip) mg_send_header(mc, "Content-Encoding", "gzip");
+        if (vary_gzip) mg_send_header(mc, "Vary", "Accept-Encoding");
         
         web_printf_all("%-16s %11s %s%s\n", "sending", hdr_type, is_min? "MIN ":"", is_gzip? "GZIP":"");
 
@@ -1034,7 +1156,6 @@ int web_request(struct mg_connection *mc, enum mg_event evt) {
     }
     
     if (ver != NULL) free(ver);
-    if (free_html_data) kiwi_free("html_data", (void *) html_data);
     if (free_ajax_data) kstr_free((char *) ajax_data);
     if (free_uri) free(uri);
     
@@ -89,8 +89,19 @@ void web_to_app_done(conn_t *c, nbuf_t *nb);
 
 // server to client
 void app_to_web(conn_t *c, char *s, int sl);
-char *rx_server_ajax(struct mg_connection *mc);
+void app_to_web_pkt(conn_t *c, char *hdr, int hl, nbuf_pkt_t *pkt, int off, int len);
+
+// set by rx_server_ajax() when the reply is a snapshot from its cache
+typedef struct {
+	const char *etag;	// NULL if not a cached reply
+	int size;
+	bool is_gzip;
+} ajax_cache_rsp_t;
+
+char *rx_server_ajax(struct mg_connection *mc, ajax_cache_rsp_t *rsp);
+void rx_server_ajax_invalidate();
 int web_request(struct mg_connection *mc, enum mg_event ev);
+char *web_gzip(const char *s, int len, int *gz_len);
 void reload_index_params();
 void iparams_add(const char *id, char *val);
 
@@ -64,6 +64,8 @@ void webserver_connection_cleanup(conn_t *c)
 		// server demand push of websocket stream data
 		app_to_web(buf)
 			buf => nbuf_allocq(s2c)
+		app_to_web_pkt(hdr, pkt)
+			pkt reference (no copy) => nbuf_allocq_pkt(s2c)
 
 		// server demand push of websocket message data (no need to use nbufs)
 		send_msg*()
@@ -92,10 +94,11 @@ void webserver_connection_cleanup(conn_t *c)
 		TASK:
 		web_server()
 			mg_poll_server()	// also forces mongoose internal buffering to write to sockets
-			mg_iterate_over_connections()
+								// (epoll: only visits ready sockets and connections with pending output)
+			for each connection marked s2c dirty by app_to_web*()
 				iterate_callback()
 					is_websocket:
-						[app_to_web() =>] nbuf_dequeue(s2c) => mg_websocket_write()
+						[app_to_web() =>] nbuf_dequeue(s2c) => mg_websocket_writev(hdr, buf)
 					other:
 						ERROR
 			LOOP
@@ -135,6 +138,16 @@ void web_to_app_done(conn_t *c, nbuf_t *nb)
 }
 
 
+// Connections with s2c nbufs queued by app_to_web*() since the last web_server() pass,
+// indexed by conn_t.self_idx. Only these are visited rather than every connection.
+static u4_t s2c_dirty[(N_CONNS + 31) / 32];
+
+static void s2c_mark_dirty(conn_t *c)
+{
+	s2c_dirty[c->self_idx / 32] |= 1U << (c->self_idx % 32);
+}
+
+
 // s2c
 // server to client
 // 1) websocket: {SND, W/F} data streams received by .js via (ws).onmessage()
@@ -149,9 +162,19 @@ void app_to_web(conn_t *c, char *s, int sl)
 	    return;
 	}
 	nbuf_allocq(&c->s2c, s, sl);
+	s2c_mark_dirty(c);
 	//NextTask("s2c");
 }
 
+// Zero-copy version for stream data: the producer fills pkt->buf in place and keeps its reference.
+// Only the small per-connection hdr is copied, so the same pkt can be sent to several connections.
+void app_to_web_pkt(conn_t *c, char *hdr, int hl, nbuf_pkt_t *pkt, int off, int len)
+{
+	if (c->stop_data || c->internal_connection) return;
+	nbuf_allocq_pkt(&c->s2c, hdr, hl, pkt, off, len);
+	s2c_mark_dirty(c);
+}
+
 
 // event requests _from_ web server:
 // (prompted by data coming into web server)
@@ -200,7 +223,7 @@ static int iterate_callback(struct mg_connection *mc, enum mg_event evt)
 
 				#ifdef SND_TIMING_CK
 				// check timing of audio output (assumes non-IQ mode always selected)
-				snd_pkt_real_t *out = (snd_pkt_real_t *) nb->buf;
+				snd_pkt_real_t *out = (snd_pkt_real_t *) (nb->hdr_len? nb->hdr : nb->buf);
 				if (c->type == STREAM_SOUND && strncmp(out->h.id, "SND", 3) == 0) {
 					u4_t now = timer_ms();
 					if (!c->audio_check) {
@@ -233,8 +256,17 @@ static int iterate_callback(struct mg_connection *mc, enum mg_event evt)
 				}
 				#endif
 
-				//printf("s2c %d WEBSOCKET: %d %p\n", mc->remote_port, nb->len, nb->buf);
-				ret = mg_websocket_write(mc, WS_OPCODE_BINARY, nb->buf, nb->len);
+				//printf("s2c %d WEBSOCKET: %d+%d %p\n", mc->remote_port, nb->hdr_len, nb->len, nb->buf);
+				struct iovec iov[2], *v = iov;
+				if (nb->hdr_len) {
+					v->iov_base = nb->hdr;
+					v->iov_len = nb->hdr_len;
+					v++;
+				}
+				v->iov_base = nb->buf;
+				v->iov_len = nb->len;
+				v++;
+				ret = mg_websocket_writev(mc, WS_OPCODE_BINARY, iov, v - iov);
 				if (ret<=0) printf("$$$$$$$$ socket write ret %d\n", ret);
 				nb->done = TRUE;
 			} else {
@@ -259,7 +291,22 @@ void web_server(void *param)
 	
 	while (1) {
 		mg_poll_server(server, 0);		// passing 0 effects a poll
-		mg_iterate_over_connections(server, iterate_callback);
+
+		// The bits are taken before draining so anything queued meanwhile marks them again.
+		// iterate_callback() leaves the queue alone while the conn isn't a websocket yet or has stop_data set,
+		// so a conn with data still queued afterwards is marked again for the next pass.
+		for (int i = 0; i < ARRAY_LEN(s2c_dirty); i++) {
+			u4_t dirty = s2c_dirty[i];
+			s2c_dirty[i] = 0;
+			while (dirty) {
+				int b = ffs(dirty) - 1;
+				dirty &= ~(1U << b);
+				conn_t *c = &conns[i*32 + b];
+				if (!c->valid) continue;
+				if (c->mc != NULL) iterate_callback(c->mc, MG_POLL);
+				if (c->s2c.cnt != 0) s2c_mark_dirty(c);     // number not yet dequeued
+			}
+		}
 		
 		//#define MEAS_WEB_SERVER
 		#ifdef MEAS_WEB_SERVER